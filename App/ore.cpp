@@ -26,6 +26,7 @@
 
 
 #include <orea/app/oreapp.hpp>
+#include <orea/app/oreappservice.hpp>
 
 #include <orea/app/initbuilders.hpp>
 
@@ -66,20 +67,29 @@ int main(int argc, char** argv) {
         exit(0);
     }
 
-    if (argc != 2) {
-        std::cout << endl << "usage: ORE path/to/ore.xml" << endl << endl;
+    bool service = argc == 3 && string(argv[1]) == "--service";
+
+    if (argc != 2 && !service) {
+        std::cout << endl << "usage: ORE path/to/ore.xml" << endl;
+        std::cout << "       ORE --service path/to/ore.xml" << endl << endl;
         return -1;
     }
 
     ore::analytics::initBuilders();
 
-    string inputFile(argv[1]);
+    string inputFile(argv[argc - 1]);
 
     try {
         auto params = QuantLib::ext::make_shared<Parameters>();
         params->fromFile(inputFile);
-        OREApp ore(params, true);
-        ore.run();
+        if (service) {
+            // process requests from stdin until quit or end of input
+            OREAppService ore(params);
+            ore.run();
+        } else {
+            OREApp ore(params, true);
+            ore.run();
+        }
         return 0;
     } catch (const exception& e) {
         cout << endl << "an error occurred: " << e.what() << endl;
@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+
+#include <ql/errors.hpp>
+#include <qle/version.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+using QuantLib::Size;
+
+namespace ore {
+namespace benchmark {
+
+void BenchmarkRunner::add(const std::string& name, const std::string& description, Size defaultSize, Setup setup) {
+    benchmarks_.push_back({name, description, defaultSize, setup});
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::run(const std::string& filter, double scale, Size repetitions,
+                                                  std::ostream& log) const {
+    QL_REQUIRE(repetitions > 0, "BenchmarkRunner: repetitions must be positive");
+    QL_REQUIRE(scale > 0.0, "BenchmarkRunner: scale must be positive");
+    std::vector<BenchmarkResult> results;
+    for (auto const& b : benchmarks_) {
+        if (b.name.find(filter) == std::string::npos)
+            continue;
+        BenchmarkResult r;
+        r.name = b.name;
+        r.size = std::max<Size>(static_cast<Size>(std::lround(b.defaultSize * scale)), 1);
+        r.repetitions = repetitions;
+        log << std::left << std::setw(24) << b.name << " size " << std::setw(8) << r.size << std::flush;
+        std::function<void()> f = b.setup(r.size);
+        f(); // warm up
+        std::vector<double> times;
+        for (Size i = 0; i < repetitions; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            f();
+            times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        r.min = times.front();
+        r.max = times.back();
+        r.median = times.size() % 2 == 1 ? times[times.size() / 2]
+                                         : 0.5 * (times[times.size() / 2 - 1] + times[times.size() / 2]);
+        log << " median " << std::fixed << std::setprecision(6) << r.median << "s min " << r.min << "s max " << r.max
+            << "s" << std::endl;
+        results.push_back(r);
+    }
+    return results;
+}
+
+void BenchmarkRunner::list(std::ostream& out) const {
+    for (auto const& b : benchmarks_)
+        out << std::left << std::setw(24) << b.name << std::setw(8) << b.defaultSize << b.description << std::endl;
+}
+
+void writeResults(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    out << "{\n  \"oreVersion\": \"" << OPEN_SOURCE_RISK_VERSION << "\",\n  \"benchmarks\": [";
+    out << std::setprecision(9);
+    for (Size i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    { \"name\": \"" << r.name << "\", \"size\": " << r.size
+            << ", \"repetitions\": " << r.repetitions << ", \"median\": " << r.median << ", \"min\": " << r.min
+            << ", \"max\": " << r.max << " }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+std::map<std::string, BenchmarkResult> readResults(const std::string& filename) {
+    boost::property_tree::ptree tree;
+    try {
+        boost::property_tree::read_json(filename, tree);
+    } catch (const std::exception& e) {
+        QL_FAIL("readResults(): could not read benchmark results from '" << filename << "': " << e.what());
+    }
+    std::map<std::string, BenchmarkResult> results;
+    for (auto const& node : tree.get_child("benchmarks")) {
+        BenchmarkResult r;
+        r.name = node.second.get<std::string>("name");
+        r.size = node.second.get<Size>("size");
+        r.repetitions = node.second.get<Size>("repetitions");
+        r.median = node.second.get<double>("median");
+        r.min = node.second.get<double>("min");
+        r.max = node.second.get<double>("max");
+        results[r.name] = r;
+    }
+    return results;
+}
+
+Size compareResults(const std::vector<BenchmarkResult>& results, const std::map<std::string, BenchmarkResult>& baseline,
+                    double tolerance, std::ostream& out) {
+    Size regressions = 0;
+    for (auto const& r : results) {
+        out << std::left << std::setw(24) << r.name;
+        auto b = baseline.find(r.name);
+        if (b == baseline.end()) {
+            out << " not in baseline" << std::endl;
+            continue;
+        }
+        if (b->second.size != r.size) {
+            out << " size " << r.size << " differs from baseline size " << b->second.size << ", not compared"
+                << std::endl;
+            continue;
+        }
+        double ratio = r.median / b->second.median;
+        bool regressed = ratio > 1.0 + tolerance;
+        if (regressed)
+            ++regressions;
+        out << " median " << std::fixed << std::setprecision(6) << r.median << "s baseline " << b->second.median
+            << "s ratio " << std::setprecision(3) << ratio << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressions;
+}
+
+} // namespace benchmark
+} // namespace ore
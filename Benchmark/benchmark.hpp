@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file benchmark.hpp
+    \brief Benchmark runner with JSON output and baseline comparison
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace benchmark {
+
+//! Timing of a benchmark, the times are wall clock seconds per repetition
+struct BenchmarkResult {
+    std::string name;
+    //! problem size, e.g. the number of trades or samples, see the benchmark description
+    QuantLib::Size size = 0;
+    QuantLib::Size repetitions = 0;
+    double median = 0.0, min = 0.0, max = 0.0;
+};
+
+/*! Runs registered benchmarks
+
+    A benchmark is given by a setup function, which builds the problem of the requested size outside of the timed
+    section and returns the function to be timed. All synthetic inputs are generated from fixed seeds, so that runs
+    on the same machine are comparable. Each benchmark is run once for warm up, the median over the repetitions is
+    the reported time.
+*/
+class BenchmarkRunner {
+public:
+    typedef std::function<std::function<void()>(QuantLib::Size)> Setup;
+
+    //! Register a benchmark with its default problem size
+    void add(const std::string& name, const std::string& description, QuantLib::Size defaultSize, Setup setup);
+
+    /*! Run the benchmarks whose name contains the filter, the default sizes are multiplied with the scale, progress
+        is written to the log stream */
+    std::vector<BenchmarkResult> run(const std::string& filter, double scale, QuantLib::Size repetitions,
+                                     std::ostream& log) const;
+
+    //! Write the names, sizes and descriptions of the benchmarks
+    void list(std::ostream& out) const;
+
+private:
+    struct Benchmark {
+        std::string name, description;
+        QuantLib::Size defaultSize;
+        Setup setup;
+    };
+    std::vector<Benchmark> benchmarks_;
+};
+
+//! Register the benchmarks of the ORE hot paths
+void registerBenchmarks(BenchmarkRunner& runner);
+
+//! Write the results as JSON
+void writeResults(std::ostream& out, const std::vector<BenchmarkResult>& results);
+
+//! Read results written by writeResults(), keyed by benchmark name
+std::map<std::string, BenchmarkResult> readResults(const std::string& filename);
+
+/*! Compare the results with a baseline, a benchmark has regressed if its median time exceeds the baseline median by
+    more than the relative tolerance. Benchmarks with a different size than in the baseline are not compared. The
+    comparison is written to out, the number of regressions is returned. */
+QuantLib::Size compareResults(const std::vector<BenchmarkResult>& results,
+                              const std::map<std::string, BenchmarkResult>& baseline, double tolerance,
+                              std::ostream& out);
+
+} // namespace benchmark
+} // namespace ore
@@ -0,0 +1,318 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+
+#include <orea/cube/cube_io.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/scenariogenerator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/simm/crif.hpp>
+#include <orea/simm/simmbucketmapperbase.hpp>
+#include <orea/simm/simmcalculator.hpp>
+#include <orea/simm/utilities.hpp>
+#include <ored/marketdata/marketimpl.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/swap.hpp>
+#include <ored/utilities/dategrid.hpp>
+#include <ored/utilities/indexparser.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <qle/ad/computationgraph.hpp>
+#include <qle/ad/forwardevaluation.hpp>
+#include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_ops.hpp>
+
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/settings.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace ore {
+namespace benchmark {
+
+namespace {
+
+const Date benchmarkAsof(14, April, 2016);
+
+struct SyntheticCurrency {
+    std::string ccy, index;
+    Real rate, fxEur;
+};
+
+const std::vector<SyntheticCurrency> syntheticCurrencies = {{"EUR", "EUR-EURIBOR-6M", 0.010, 1.0},
+                                                            {"USD", "USD-LIBOR-3M", 0.025, 0.90},
+                                                            {"GBP", "GBP-LIBOR-6M", 0.020, 1.15},
+                                                            {"CHF", "CHF-LIBOR-6M", 0.000, 0.92},
+                                                            {"JPY", "JPY-LIBOR-6M", 0.001, 0.0082}};
+
+//! Market with flat discount and forwarding curves for the synthetic currencies, base currency EUR
+class SyntheticMarket : public MarketImpl {
+public:
+    SyntheticMarket(const Date& asof) : MarketImpl(false) {
+        asof_ = asof;
+        std::map<std::string, Handle<Quote>> fxSpots;
+        for (auto const& c : syntheticCurrencies) {
+            yieldCurves_[std::make_tuple(Market::defaultConfiguration, YieldCurveType::Discount, c.ccy)] =
+                Handle<YieldTermStructure>(QuantLib::ext::make_shared<FlatForward>(asof, c.rate, Actual365Fixed()));
+            Handle<YieldTermStructure> forwarding(
+                QuantLib::ext::make_shared<FlatForward>(asof, c.rate + 0.002, Actual365Fixed()));
+            iborIndices_[std::make_pair(Market::defaultConfiguration, c.index)] =
+                Handle<IborIndex>(parseIborIndex(c.index, forwarding));
+            if (c.ccy != "EUR")
+                fxSpots[c.ccy + "EUR"] = Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(c.fxEur));
+        }
+        fx_ = QuantLib::ext::make_shared<FXTriangulation>(fxSpots);
+    }
+};
+
+//! Scenarios with uniformly perturbed base scenario values, reproducible after reset()
+class PerturbedScenarioGenerator : public ScenarioGenerator {
+public:
+    PerturbedScenarioGenerator(const QuantLib::ext::shared_ptr<Scenario>& baseScenario, const Size seed)
+        : baseScenario_(baseScenario), seed_(seed), rng_(seed) {}
+    QuantLib::ext::shared_ptr<Scenario> next(const Date& d) override {
+        auto s = baseScenario_->clone();
+        s->setAsof(d);
+        s->setNumeraire(1.0);
+        for (auto const& k : baseScenario_->keys())
+            s->add(k, baseScenario_->get(k) * (1.0 + 0.02 * (rng_.nextReal() - 0.5)));
+        return s;
+    }
+    void reset() override { rng_ = MersenneTwisterUniformRng(seed_); }
+
+private:
+    QuantLib::ext::shared_ptr<Scenario> baseScenario_;
+    Size seed_;
+    MersenneTwisterUniformRng rng_;
+};
+
+QuantLib::ext::shared_ptr<ScenarioSimMarket> syntheticSimMarket() {
+    Settings::instance().evaluationDate() = benchmarkAsof;
+    auto parameters = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    parameters->baseCcy() = "EUR";
+    std::vector<std::string> ccys, indices, fxPairs;
+    for (auto const& c : syntheticCurrencies) {
+        ccys.push_back(c.ccy);
+        indices.push_back(c.index);
+        if (c.ccy != "EUR")
+            fxPairs.push_back(c.ccy + "EUR");
+    }
+    parameters->setDiscountCurveNames(ccys);
+    parameters->setYieldCurveTenors("", {1 * Months, 3 * Months, 6 * Months, 1 * Years, 2 * Years, 3 * Years,
+                                         5 * Years, 7 * Years, 10 * Years, 15 * Years, 20 * Years, 30 * Years});
+    parameters->setIndices(indices);
+    parameters->interpolation() = "LogLinear";
+    parameters->setSimulateSwapVols(false);
+    parameters->setSimulateFXVols(false);
+    parameters->setFxCcyPairs(fxPairs);
+    auto market = QuantLib::ext::make_shared<SyntheticMarket>(benchmarkAsof);
+    return QuantLib::ext::make_shared<ScenarioSimMarket>(market, parameters);
+}
+
+//! Forward starting vanilla swaps in the synthetic currencies, so that no historical fixings are required
+QuantLib::ext::shared_ptr<Portfolio> syntheticSwapPortfolio(const Size size,
+                                                            const QuantLib::ext::shared_ptr<EngineFactory>& factory) {
+    MersenneTwisterUniformRng rng(5);
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    Calendar cal = TARGET();
+    for (Size i = 0; i < size; ++i) {
+        const SyntheticCurrency& c = syntheticCurrencies[rng.nextInt32() % syntheticCurrencies.size()];
+        Date start = cal.adjust(benchmarkAsof + 7 + rng.nextInt32() % 60);
+        Date end = cal.adjust(start + (2 + rng.nextInt32() % 29) * Years);
+        bool payer = rng.nextReal() < 0.5;
+        std::string floatTenor = c.index.substr(c.index.rfind('-') + 1);
+        ScheduleData fixedSchedule(ScheduleRules(to_string(start), to_string(end), "1Y", "TARGET", "MF", "MF", "Forward"));
+        ScheduleData floatSchedule(
+            ScheduleRules(to_string(start), to_string(end), floatTenor, "TARGET", "MF", "MF", "Forward"));
+        LegData fixedLeg(QuantLib::ext::make_shared<FixedLegData>(std::vector<double>(1, 0.001 + 0.04 * rng.nextReal())),
+                         payer, c.ccy, fixedSchedule, "30/360", std::vector<double>(1, 1.0E6));
+        LegData floatLeg(QuantLib::ext::make_shared<FloatingLegData>(c.index, 2, false, std::vector<double>(1, 0.0)),
+                         !payer, c.ccy, floatSchedule, "ACT/365", std::vector<double>(1, 1.0E6));
+        auto swap = QuantLib::ext::make_shared<ore::data::Swap>(Envelope("CP"), floatLeg, fixedLeg);
+        swap->id() = "Trade_" + std::to_string(i + 1);
+        portfolio->add(swap);
+    }
+    portfolio->build(factory);
+    QL_REQUIRE(portfolio->size() == size, "syntheticSwapPortfolio(): built " << portfolio->size() << " trades, expected "
+                                                                            << size);
+    return portfolio;
+}
+
+QuantLib::ext::shared_ptr<EngineFactory> swapEngineFactory(const QuantLib::ext::shared_ptr<Market>& market) {
+    auto data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    return QuantLib::ext::make_shared<EngineFactory>(data, market);
+}
+
+// size = number of samples
+std::function<void()> randomVariableBenchmark(const Size size) {
+    MersenneTwisterUniformRng rng(42);
+    auto x = QuantLib::ext::make_shared<RandomVariable>(size), y = QuantLib::ext::make_shared<RandomVariable>(size);
+    for (Size i = 0; i < size; ++i) {
+        x->set(i, rng.nextReal());
+        y->set(i, 1.0 + rng.nextReal());
+    }
+    return [x, y]() {
+        RandomVariable z(x->size(), 0.0);
+        for (Size i = 0; i < 20; ++i) {
+            z += *x * *y - exp(-*x) + max(*x - RandomVariable(x->size(), 0.5), RandomVariable(x->size(), 0.0));
+            z = z / *y;
+        }
+    };
+}
+
+// size = number of samples, the graph has 20 inputs and 4000 operation nodes
+std::function<void()> forwardEvaluationBenchmark(const Size size) {
+    auto g = QuantLib::ext::make_shared<ComputationGraph>();
+    MersenneTwisterUniformRng rng(42);
+    std::vector<std::size_t> nodes;
+    for (Size i = 0; i < 20; ++i)
+        nodes.push_back(cg_var(*g, "x" + std::to_string(i), ComputationGraph::VarDoesntExist::Create));
+    std::size_t half = cg_const(*g, 0.5);
+    // ops keep the values in the range of the inputs: arithmetic and geometric means, min and max
+    for (Size i = 0; i < 1000; ++i) {
+        std::size_t a = nodes[rng.nextInt32() % nodes.size()], b = nodes[rng.nextInt32() % nodes.size()];
+        nodes.push_back(cg_mult(*g, cg_add(*g, a, b), half));
+        nodes.push_back(cg_sqrt(*g, cg_mult(*g, a, b)));
+        nodes.push_back(i % 2 == 0 ? cg_min(*g, a, b) : cg_max(*g, a, b));
+    }
+    auto inputs = QuantLib::ext::make_shared<std::vector<RandomVariable>>(g->size(), RandomVariable(size, 0.0));
+    for (Size i = 0; i < 20; ++i) {
+        for (Size k = 0; k < size; ++k)
+            (*inputs)[nodes[i]].set(k, 0.5 + rng.nextReal());
+    }
+    for (auto const& c : g->constants())
+        (*inputs)[c.second] = RandomVariable(size, c.first);
+    auto ops = getRandomVariableOps(size);
+    return [g, inputs, ops]() {
+        std::vector<RandomVariable> values(*inputs);
+        forwardEvaluation(*g, values, ops, RandomVariable::deleter, false);
+    };
+}
+
+// size = number of scenarios applied to the simulation market
+std::function<void()> applyScenarioBenchmark(const Size size) {
+    auto simMarket = syntheticSimMarket();
+    PerturbedScenarioGenerator generator(simMarket->baseScenario(), 42);
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios;
+    for (Size i = 0; i < size; ++i)
+        scenarios.push_back(generator.next(benchmarkAsof));
+    return [simMarket, scenarios]() {
+        for (auto const& s : scenarios)
+            simMarket->applyScenario(s);
+    };
+}
+
+// size = number of trades, 20 quarterly dates and 100 samples
+std::function<void()> buildCubeBenchmark(const Size size) {
+    auto simMarket = syntheticSimMarket();
+    simMarket->scenarioGenerator() = QuantLib::ext::make_shared<PerturbedScenarioGenerator>(simMarket->baseScenario(), 42);
+    auto portfolio = syntheticSwapPortfolio(size, swapEngineFactory(simMarket));
+    auto dg = QuantLib::ext::make_shared<DateGrid>("20,3M");
+    auto engine = QuantLib::ext::make_shared<ValuationEngine>(benchmarkAsof, dg, simMarket);
+    return [portfolio, dg, engine]() {
+        Settings::instance().evaluationDate() = benchmarkAsof;
+        auto cube =
+            QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(benchmarkAsof, portfolio->ids(), dg->dates(), 100);
+        std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators = {
+            QuantLib::ext::make_shared<NPVCalculator>("EUR")};
+        engine->buildCube(portfolio, cube, calculators);
+    };
+}
+
+// size = number of trades, each with 12 IR delta and one FX delta sensitivity
+std::function<void()> simmBenchmark(const Size size) {
+    auto config = buildSimmConfiguration("2.6", QuantLib::ext::make_shared<SimmBucketMapperBase>());
+    auto crif = QuantLib::ext::make_shared<Crif>();
+    MersenneTwisterUniformRng rng(42);
+    std::vector<std::string> tenors = {"2w", "1m", "3m", "6m", "1y", "2y", "3y", "5y", "10y", "15y", "20y", "30y"};
+    NettingSetDetails nettingSet("CP");
+    for (Size i = 0; i < size; ++i) {
+        std::string tradeId = "Trade_" + std::to_string(i + 1);
+        const std::string& ccy = syntheticCurrencies[rng.nextInt32() % syntheticCurrencies.size()].ccy;
+        for (auto const& t : tenors) {
+            Real amount = 1.0E4 * (rng.nextReal() - 0.5);
+            crif->addRecord(CrifRecord(tradeId, "Swap", nettingSet, CrifRecord::ProductClass::RatesFX,
+                                       CrifRecord::RiskType::IRCurve, ccy,
+                                       config->bucket(CrifRecord::RiskType::IRCurve, ccy), t, "Libor3m", "USD",
+                                       amount, amount, "SIMM", "USPR", "USPR"));
+        }
+        if (ccy != "USD") {
+            Real amount = 1.0E5 * (rng.nextReal() - 0.5);
+            crif->addRecord(CrifRecord(tradeId, "Swap", nettingSet, CrifRecord::ProductClass::RatesFX,
+                                       CrifRecord::RiskType::FX, ccy, "", "", "", "USD", amount, amount, "SIMM",
+                                       "USPR", "USPR"));
+        }
+    }
+    return [crif, config]() { SimmCalculator simm(*crif, config, "USD", "USD", "USD", nullptr, true, false, true); };
+}
+
+// size = number of trades, 50 dates and 100 samples, the cube is written to and read from a temporary file
+std::function<void()> cubeIOBenchmark(const Size size) {
+    std::set<std::string> ids;
+    for (Size i = 0; i < size; ++i)
+        ids.insert("Trade_" + std::to_string(i + 1));
+    auto dg = QuantLib::ext::make_shared<DateGrid>("50,3M");
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(benchmarkAsof, ids, dg->dates(), 100);
+    MersenneTwisterUniformRng rng(42);
+    for (Size i = 0; i < cube->numIds(); ++i)
+        for (Size j = 0; j < cube->numDates(); ++j)
+            for (Size k = 0; k < cube->samples(); ++k)
+                cube->set(1.0E6 * (rng.nextReal() - 0.5), i, j, k);
+    std::string file =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("ore-benchmark-%%%%%%%%.csv.gz"))
+            .string();
+    return [cube, file]() {
+        NPVCubeWithMetaData data;
+        data.cube = cube;
+        saveCube(file, data, true);
+        NPVCubeWithMetaData loaded = loadCube(file, true);
+        boost::filesystem::remove(file);
+    };
+}
+
+} // namespace
+
+void registerBenchmarks(BenchmarkRunner& runner) {
+    runner.add("RandomVariable", "arithmetic on random variables, size = samples", 100000, randomVariableBenchmark);
+    runner.add("ForwardEvaluation", "computation graph with 4000 nodes, size = samples", 2000,
+               forwardEvaluationBenchmark);
+    runner.add("ApplyScenario", "scenario sim market with 5 currencies, size = scenarios", 1000,
+               applyScenarioBenchmark);
+    runner.add("BuildCube", "swap exposure cube, 20 dates x 100 samples, size = trades", 50, buildCubeBenchmark);
+    runner.add("SimmCalculator", "SIMM 2.6 on IR and FX delta CRIF, size = trades", 2000, simmBenchmark);
+    runner.add("CubeIO", "save and load a cube, 50 dates x 100 samples, size = trades", 200, cubeIOBenchmark);
+}
+
+} // namespace benchmark
+} // namespace ore
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+
+#include <orea/app/initbuilders.hpp>
+#include <ored/utilities/parsers.hpp>
+#include <ql/errors.hpp>
+
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace ore::benchmark;
+
+namespace {
+
+void usage() {
+    cout << endl
+         << "usage: ore-benchmark [options]" << endl
+         << "  --list                 list the benchmarks and their default sizes" << endl
+         << "  --filter <string>      run the benchmarks whose name contains the string" << endl
+         << "  --scale <factor>       multiply the default problem sizes, default 1" << endl
+         << "  --repetitions <n>      timed repetitions per benchmark, default 5" << endl
+         << "  --output <file>        write the results as JSON" << endl
+         << "  --baseline <file>      compare the results with a JSON baseline, fails on regressions" << endl
+         << "  --tolerance <ratio>    relative slowdown against the baseline treated as regression, default 0.1"
+         << endl
+         << endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+
+    string filter, output, baseline;
+    double scale = 1.0, tolerance = 0.1;
+    QuantLib::Size repetitions = 5;
+    bool list = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg(argv[i]);
+            if (arg == "--list") {
+                list = true;
+                continue;
+            }
+            QL_REQUIRE(i + 1 < argc, "missing value for option " << arg);
+            string value(argv[++i]);
+            if (arg == "--filter")
+                filter = value;
+            else if (arg == "--scale")
+                scale = ore::data::parseReal(value);
+            else if (arg == "--repetitions")
+                repetitions = static_cast<QuantLib::Size>(ore::data::parseInteger(value));
+            else if (arg == "--output")
+                output = value;
+            else if (arg == "--baseline")
+                baseline = value;
+            else if (arg == "--tolerance")
+                tolerance = ore::data::parseReal(value);
+            else
+                QL_FAIL("unknown option " << arg);
+        }
+    } catch (const exception& e) {
+        cout << endl << e.what() << endl;
+        usage();
+        return -1;
+    }
+
+    try {
+        ore::analytics::initBuilders();
+
+        BenchmarkRunner runner;
+        registerBenchmarks(runner);
+        if (list) {
+            runner.list(cout);
+            return 0;
+        }
+
+        vector<BenchmarkResult> results = runner.run(filter, scale, repetitions, cout);
+
+        if (!output.empty()) {
+            ofstream out(output);
+            QL_REQUIRE(out.is_open(), "could not open output file " << output);
+            writeResults(out, results);
+            cout << "results written to " << output << endl;
+        }
+
+        if (!baseline.empty()) {
+            cout << endl << "comparison with baseline " << baseline << endl;
+            QuantLib::Size regressions = compareResults(results, readResults(baseline), tolerance, cout);
+            if (regressions > 0) {
+                cout << regressions << " benchmark(s) regressed by more than " << tolerance * 100.0 << "%" << endl;
+                return 1;
+            }
+        }
+        return 0;
+    } catch (const exception& e) {
+        cout << endl << "an error occurred: " << e.what() << endl;
+        return -1;
+    }
+}
@@ -19,11 +19,75 @@
 #include <orea/aggregation/collatexposurehelper.hpp>
 #include <ql/errors.hpp>
 
+#include <algorithm>
+
 using namespace std;
 using namespace QuantLib;
 
 #define FLAT_INTERPOLATION 1
 
+namespace {
+
+// Position of a simulation date on the date grid, v = v1 + (v2 - v1) * w reproduces estimateUncollatValue(), where v1
+// is the value at t0 or on date i1 and v2 is the value on date i2
+struct GridWeight {
+    bool t0 = false;
+    Size i1 = 0, i2 = 0;
+    Real w = 0.0;
+};
+
+GridWeight gridWeight(const Date& simulationDate, const Date& date_t0, const vector<Date>& dateGrid) {
+    QL_REQUIRE(simulationDate >= date_t0, "CollatExposureHelper error: simulation date < start date");
+    QL_REQUIRE(dateGrid[0] >= date_t0, "CollatExposureHelper error: cube dateGrid starts before t0");
+
+    GridWeight g;
+    if (simulationDate >= dateGrid.back()) {
+        g.i1 = g.i2 = dateGrid.size() - 1;
+        return g;
+    }
+    if (simulationDate == date_t0) {
+        g.t0 = true;
+        return g;
+    }
+    for (Size i = 0; i < dateGrid.size(); i++) {
+        if (dateGrid[i] == simulationDate) {
+            g.i1 = g.i2 = i;
+            return g;
+        }
+#ifdef FLAT_INTERPOLATION
+        else if (simulationDate < dateGrid.front()) {
+            g.i1 = g.i2 = 0;
+            return g;
+        } else if (i < dateGrid.size() - 1 && simulationDate > dateGrid[i] && simulationDate < dateGrid[i + 1]) {
+            g.i1 = g.i2 = i + 1;
+            return g;
+        }
+#endif
+    }
+
+    Date t1;
+    if (simulationDate <= dateGrid[0]) {
+        g.t0 = true;
+        t1 = date_t0;
+    } else {
+        vector<Date>::const_iterator it = lower_bound(dateGrid.begin(), dateGrid.end(), simulationDate);
+        QL_REQUIRE(it != dateGrid.end() && it != dateGrid.begin(),
+                   "CollatExposureHelper error; date interpolation points not found");
+        g.i1 = (it - 1) - dateGrid.begin();
+        g.i2 = it - dateGrid.begin();
+        t1 = dateGrid[g.i1];
+    }
+    g.w = double(simulationDate - t1) / double(dateGrid[g.i2] - t1);
+    return g;
+}
+
+inline Real gridValue(const GridWeight& g, const Real value_t0, const vector<vector<Real>>& values, const Size k) {
+    Real v1 = g.t0 ? value_t0 : values[g.i1][k];
+    return g.w == 0.0 ? v1 : v1 + (values[g.i2][k] - v1) * g.w;
+}
+
+} // namespace
+
 namespace ore {
 using namespace data;
 namespace analytics {
@@ -264,5 +328,149 @@ QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
         QL_FAIL("CollateralExposureHelper - unknown error when generating collateralBalancePaths");
     }
 }
+
+vector<vector<Real>> CollateralExposureHelper::collateralBalanceGrid(
+    const QuantLib::ext::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
+    const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
+    const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
+    const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType,
+    const QuantLib::ext::shared_ptr<CollateralBalance>& balance) {
+
+    const QuantLib::ext::shared_ptr<CSA>& csa = csaDef->csaDetails();
+    Size numScenarios = nettingSetValues.front().size();
+    QL_REQUIRE(numScenarios == csaFxScenarioRates.front().size(), "netting values -v- scenario FX rate mismatch");
+
+    // t0 balance as in collateralBalancePaths()
+    Real initialBalance = 0.0;
+    if (balance && balance->variationMargin() != Null<Real>())
+        initialBalance = balance->variationMargin();
+    auto tmpAcc = QuantLib::ext::make_shared<CollateralAccount>(csaDef, initialBalance, date_t0);
+    Real bal_t0 = marginRequirementCalc(tmpAcc, nettingSetPv, date_t0);
+    DLOG("initial collateral balance: " << initialBalance << ", base collateral balance: " << bal_t0);
+
+    // margin call schedule, shared by all scenarios
+    struct Step {
+        Date date;
+        bool eligUs, eligCtp;
+        GridWeight weight;
+        Date callPayDate, postPayDate;
+    };
+    Period lag = (calcType == NoLag ? 0 * Days : csa->marginPeriodOfRisk());
+    Date simEndDate = std::min(nettingSet_maturity, dateGrid.back()) + csa->marginPeriodOfRisk();
+    vector<Step> steps;
+    Date nextMarginReqDateUs = date_t0, nextMarginReqDateCtp = date_t0;
+    for (Date d = date_t0; d <= simEndDate; d = std::min(nextMarginReqDateUs, nextMarginReqDateCtp)) {
+        Step step;
+        step.date = d;
+        step.eligUs = d == nextMarginReqDateUs;
+        step.eligCtp = d == nextMarginReqDateCtp;
+        step.weight = gridWeight(d, date_t0, dateGrid);
+        step.callPayDate = calcType == AsymmetricDVA ? d : d + lag;
+        step.postPayDate = calcType == AsymmetricCVA ? d : d + lag;
+        steps.push_back(step);
+        if (step.eligUs)
+            nextMarginReqDateUs = d + csa->marginCallFrequency();
+        if (step.eligCtp)
+            nextMarginReqDateCtp = d + csa->marginPostFrequency();
+        QL_REQUIRE(std::min(nextMarginReqDateUs, nextMarginReqDateCtp) > d,
+                   "collateral balance path generation error; invalid time stepping");
+    }
+
+    // open margin calls by request step, an amount of zero means no call in that scenario
+    struct MarginCalls {
+        Size step;
+        vector<Real> amount;
+    };
+    vector<MarginCalls> openCalls;
+
+    vector<vector<Real>> result(dateGrid.size(), vector<Real>(numScenarios, 0.0));
+    vector<Size> nextGridDate(numScenarios, 0);
+    vector<Real> accountBalance(numScenarios, bal_t0);
+
+    // the balance of scenario k is b on all grid dates before d, that have not been set yet
+    auto setGridBalance = [&result, &nextGridDate, &dateGrid](const Size k, const Date& d, const Real b) {
+        for (Size& j = nextGridDate[k]; j < dateGrid.size() && dateGrid[j] < d; ++j)
+            result[j][k] = b;
+    };
+    auto accrue = [&csa](const Real b, const Real rate, const Integer days) {
+        Real accrualRate = b >= 0.0 ? rate - csa->collatSpreadRcv() : rate - csa->collatSpreadPay();
+        return b * std::pow(1.0 + accrualRate / 365.0, days);
+    };
+
+    Real ia = csa->independentAmountHeld();
+    std::vector<std::pair<Date, std::pair<Size, Real>>> calls;
+    for (Size s = 0; s < steps.size(); ++s) {
+        const Step& step = steps[s];
+        Date previousDate = s == 0 ? date_t0 : steps[s - 1].date;
+        openCalls.push_back({s, vector<Real>(numScenarios, 0.0)});
+        for (Size k = 0; k < numScenarios; ++k) {
+            Real rate = gridValue(step.weight, csaTodayCollatCurve, csaScenCollatCurves, k);
+
+            // open margin calls of this scenario sorted by pay date, see CollateralAccount::updateMarginCall()
+            calls.clear();
+            for (Size c = 0; c < openCalls.size(); ++c) {
+                Real amount = openCalls[c].amount[k];
+                if (amount != 0.0) {
+                    const Step& requestStep = steps[openCalls[c].step];
+                    calls.push_back({amount > 0.0 ? requestStep.callPayDate : requestStep.postPayDate, {c, amount}});
+                }
+            }
+            std::stable_sort(calls.begin(), calls.end(),
+                             [](const std::pair<Date, std::pair<Size, Real>>& c1,
+                                const std::pair<Date, std::pair<Size, Real>>& c2) { return c1.first < c2.first; });
+
+            // settle the margin calls due, see CollateralAccount::updateAccountBalance()
+            Real b = accountBalance[k];
+            Date balanceDate = previousDate;
+            Real openMargin = 0.0;
+            for (auto const& [payDate, call] : calls) {
+                if (payDate <= step.date) {
+                    if (payDate == balanceDate) {
+                        b += call.second;
+                    } else {
+                        setGridBalance(k, payDate, b);
+                        b = accrue(b, rate, payDate - balanceDate) + call.second;
+                        balanceDate = payDate;
+                    }
+                    openCalls[call.first].amount[k] = 0.0;
+                } else {
+                    openMargin += call.second;
+                }
+            }
+            if (step.date > balanceDate) {
+                setGridBalance(k, step.date, b);
+                b = accrue(b, rate, step.date - balanceDate);
+            }
+            accountBalance[k] = b;
+
+            // new margin call, see marginRequirementCalc() and updateMarginCall()
+            Real uncollatValue = gridValue(step.weight, nettingSetPv, nettingSetValues, k) /
+                                 gridValue(step.weight, csaFxTodayRate, csaFxScenarioRates, k);
+            Real csaAmount = uncollatValue + ia >= 0 ? std::max(uncollatValue + ia - csa->thresholdRcv(), 0.0)
+                                                     : std::min(uncollatValue + ia + csa->thresholdPay(), 0.0);
+            Real collatShortfall = csaAmount - b - openMargin;
+            Real mta = collatShortfall >= 0.0 ? csa->mtaRcv() : csa->mtaPay();
+            Real margin = fabs(collatShortfall) >= mta ? collatShortfall : 0.0;
+            if ((margin > 0.0 && step.eligUs) || (margin < 0.0 && step.eligCtp))
+                openCalls.back().amount[k] = margin;
+        }
+
+        // remove margin calls that are settled in all scenarios, calls requested in this step are settled in the
+        // next step at the earliest
+        openCalls.erase(std::remove_if(openCalls.begin(), openCalls.end(),
+                                       [&steps, s](const MarginCalls& c) {
+                                           return c.step < s && std::max(steps[c.step].callPayDate,
+                                                                         steps[c.step].postPayDate) <= steps[s].date;
+                                       }),
+                        openCalls.end());
+    }
+
+    // set account balance to zero after maturity of portfolio
+    for (Size k = 0; k < numScenarios; ++k)
+        setGridBalance(k, simEndDate + Period(1, Days), accountBalance[k]);
+
+    return result;
+}
+
 } // namespace analytics
 } // namespace ore
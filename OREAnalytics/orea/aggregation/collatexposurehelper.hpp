@@ -110,6 +110,21 @@ public:
         const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
         const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType = Symmetric,
         const QuantLib::ext::shared_ptr<CollateralBalance>& balance = QuantLib::ext::shared_ptr<CollateralBalance>());
+
+    /*!
+      Vectorised version of collateralBalancePaths(), returns the collateral balances by date of the dateGrid and
+      scenario, i.e. collateralBalancePaths(...)->at(k)->accountBalance(dateGrid[j]) for date j and scenario k.
+
+      All scenarios are advanced together through the margin call schedule, which is the same for all scenarios,
+      using interpolation weights precomputed per margin call date. Margin calls with the same pay date are settled
+      in the order in which they were requested.
+    */
+    static vector<vector<Real>> collateralBalanceGrid(
+        const QuantLib::ext::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
+        const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
+        const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
+        const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType = Symmetric,
+        const QuantLib::ext::shared_ptr<CollateralBalance>& balance = QuantLib::ext::shared_ptr<CollateralBalance>());
 };
 
 //! Convert text representation to CollateralExposureHelper::CalculationType
@@ -19,6 +19,8 @@
 #include <orea/aggregation/creditmigrationcalculator.hpp>
 #include <orea/aggregation/creditmigrationhelper.hpp>
 
+#include <qle/utilities/profiler.hpp>
+
 namespace ore {
 namespace analytics {
 
@@ -29,16 +31,18 @@ CreditMigrationCalculator::CreditMigrationCalculator(
     const QuantLib::ext::shared_ptr<NPVCube>& nettedCube,
     const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData,
     const std::vector<Real>& creditMigrationDistributionGrid, const std::vector<Size>& creditMigrationTimeSteps,
-    const Matrix& creditStateCorrelationMatrix, const std::string baseCurrency)
+    const Matrix& creditStateCorrelationMatrix, const std::string baseCurrency, const Size nThreads)
     : portfolio_(portfolio), creditSimulationParameters_(creditSimulationParameters), cube_(cube),
       cubeInterpretation_(cubeInterpretation), nettedCube_(nettedCube),
       aggregationScenarioData_(aggregationScenarioData),
       creditMigrationDistributionGrid_(creditMigrationDistributionGrid),
       creditMigrationTimeSteps_(creditMigrationTimeSteps), creditStateCorrelationMatrix_(creditStateCorrelationMatrix),
-      baseCurrency_(baseCurrency) {}
+      baseCurrency_(baseCurrency), nThreads_(nThreads) {}
 
 void CreditMigrationCalculator::build() {
 
+    QLE_PROFILE_ZONE("CreditMigrationCalculator::build");
+
     LOG("Credit migration computation started.");
 
     // checks
@@ -66,7 +70,7 @@ void CreditMigrationCalculator::build() {
                               cubeInterpretation_->mporFlowsIndex(), cubeInterpretation_->creditStateNPVsIndex(),
                               creditMigrationDistributionGrid_[0], creditMigrationDistributionGrid_[1],
                               static_cast<Size>(creditMigrationDistributionGrid_[2]), creditStateCorrelationMatrix_,
-                              baseCurrency_);
+                              baseCurrency_, nThreads_);
 
     hlp.build(portfolio_->trades());
 
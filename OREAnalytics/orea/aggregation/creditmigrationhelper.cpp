@@ -32,6 +32,11 @@
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <boost/optional.hpp>
+
+#include <exception>
+#include <thread>
+
 using namespace QuantLib;
 using namespace QuantExt;
 
@@ -45,10 +50,10 @@ CreditMigrationHelper::CreditMigrationHelper(const QuantLib::ext::shared_ptr<Cre
                                              const Size cubeIndexCashflows, const Size cubeIndexStateNpvs,
                                              const Real distributionLowerBound, const Real distributionUpperBound,
                                              const Size buckets, const Matrix& globalFactorCorrelation,
-                                             const string& baseCurrency)
+                                             const string& baseCurrency, const Size nThreads)
     : parameters_(parameters), cube_(cube), nettedCube_(nettedCube), aggData_(aggData),
       cubeIndexCashflows_(cubeIndexCashflows), cubeIndexStateNpvs_(cubeIndexStateNpvs),
-      globalFactorCorrelation_(globalFactorCorrelation), baseCurrency_(baseCurrency),
+      globalFactorCorrelation_(globalFactorCorrelation), baseCurrency_(baseCurrency), nThreads_(nThreads),
       creditMode_(parseCreditMode(parameters_->creditMode())),
       loanExposureMode_(parseLoanExposureMode(parameters_->loanExposureMode())),
       evaluation_(parseEvaluation(parameters_->evaluation())),
@@ -56,23 +61,21 @@ CreditMigrationHelper::CreditMigrationHelper(const QuantLib::ext::shared_ptr<Cre
 
     rescaledTransitionMatrices_.resize(cube_->numDates());
     init();
-    if (evaluation_ == Evaluation::TerminalSimulation)
-        initEntityStateSimulation();
 } // CreditMigrationHelper()
 
 namespace {
 
-Real conditionalProb(const Real p, const Real m, const Real v) {
-    QuantLib::CumulativeNormalDistribution nd;
-    QuantLib::InverseCumulativeNormal icn;
-    if (close_enough(p, 0.0))
+// conditional probability of X_i below the threshold, given the systemic part m of X_i with variance v,
+// see transitionThresholds() for the thresholds
+Real conditionalProb(const Real threshold, const Real m, const Real v) {
+    if (threshold == -QL_MAX_REAL)
         return 0.0;
-    if (close_enough(p, 1.0))
+    if (threshold == QL_MAX_REAL)
         return 1.0;
-    Real icnP = icn(p);
     if (close_enough(v, 1.0))
-        return icnP >= m ? 1.0 : 0.0;
-    return nd((icnP - m) / std::sqrt(1.0 - v));
+        return threshold >= m ? 1.0 : 0.0;
+    QuantLib::CumulativeNormalDistribution nd;
+    return nd((threshold - m) / std::sqrt(1.0 - v));
 }
 
 Real prob_tauA_lt_tauB_lt_T(const Real pa, const Real pb, const Real T) {
@@ -197,154 +200,125 @@ void CreditMigrationHelper::init() {
 
 } // init
 
-void CreditMigrationHelper::initEntityStateSimulation() {
-
-    LOG("Init entity state simulation");
-
-    simulatedEntityState_ =
-        std::vector<std::vector<Size>>(parameters_->entities().size(), std::vector<Size>(cube_->samples()));
-
-    LOG("Init entity state simulation done.");
-
-} // initEntityStatesSimulation
-
-std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path) {
-    std::vector<Matrix> res = std::vector<Matrix>(parameters_->entities().size(), Matrix(n_, n_, 0.0));
-
+std::vector<std::vector<Real>>
+CreditMigrationHelper::transitionThresholds(const std::map<string, Matrix>& transMat) const {
     const std::vector<string>& matrixNames = parameters_->transitionMatrices();
+    InverseCumulativeNormal icn;
+    std::vector<std::vector<Real>> thresholds(parameters_->entities().size(), std::vector<Real>(n_));
+    for (Size i = 0; i < parameters_->entities().size(); ++i) {
+        Size initialState = parameters_->initialStates()[i];
+        const Matrix& m = transMat.at(matrixNames[i]);
+        Real p = 0.0;
+        for (Size j = 0; j < n_; ++j) {
+            p += m[initialState][j];
+            if (close_enough(p, 0.0))
+                thresholds[i][j] = -QL_MAX_REAL;
+            else if (close_enough(p, 1.0))
+                thresholds[i][j] = QL_MAX_REAL;
+            else
+                thresholds[i][j] = icn(p);
+        }
+    }
+    return thresholds;
+} // transitionThresholds
+
+std::vector<Array>
+CreditMigrationHelper::conditionalCumulativeProbabilities(const Size date, const Size path,
+                                                          const std::vector<std::vector<Real>>& thresholds) const {
+    std::vector<Array> res(parameters_->entities().size(), Array(n_, 0.0));
 
-    // build terminal matrices conditional on global states
+    // conditional transition probabilities from the initial state, given the global state on the path
     Size numWarnings = 0;
-    auto transMat = rescaledTransitionMatrices(date);
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
-        const Matrix& m = transMat.at(matrixNames[i]);
-        for (Size ii = 0; ii < m.rows(); ++ii) {
-            Real p = 0.0, condProb0 = 0.0;
-            for (Size jj = 0; jj < m.columns(); ++jj) {
-                p += m[ii][jj];
-                Real condProb = conditionalProb(p, globalStates_[date][i][path], globalVar_[i]);
-                res[i][ii][jj] = condProb - condProb0;
-                condProb0 = condProb;
-            }
+        Size initialState = parameters_->initialStates()[i];
+        Real condProb0 = 0.0, sum = 0.0;
+        bool valid = true;
+        for (Size j = 0; j < n_; ++j) {
+            Real condProb = conditionalProb(thresholds[i][j], globalStates_[date][i][path], globalVar_[i]);
+            res[i][j] = condProb - condProb0;
+            condProb0 = condProb;
+            sum += res[i][j];
+            valid = valid && (res[i][j] > 0.0 || close_enough(res[i][j], 0.0));
         }
-        try {
-            checkTransitionMatrix(res[i]);
-        } catch (const std::exception& e) {
+        if (!valid || !close_enough(sum, 1.0)) {
             if (++numWarnings <= 10) {
-                WLOG("Invalid conditional transition matrix (path=" << path << ", date=" << date << ", entity =" << i
-                                                                    << ": " << e.what());
+                WLOG("Invalid conditional transition probabilities (path=" << path << ", date=" << date
+                                                                          << ", entity =" << i << "), sum " << sum);
             } else if (numWarnings == 11) {
-                WLOG("Suppress further warnings on invalid conditional transition matrices");
+                WLOG("Suppress further warnings on invalid conditional transition probabilities");
             }
-            sanitiseTransitionMatrix(res[i]);
+            sanitiseTransitionMatrixRow(res[i].begin(), res[i].end(), initialState);
         }
+        // partial sums for the simulation
+        for (Size j = 1; j < n_; ++j)
+            res[i][j] += res[i][j - 1];
     }
 
-    // ... and finally build partial sums over columns for the simulation
-    for (Size i = 0; i < parameters_->entities().size(); ++i) {
-        Matrix& m = res[i];
-        for (Size ii = 0; ii < m.rows(); ++ii) {
-            for (Size jj = 1; jj < m.columns(); ++jj) {
-                m[ii][jj] += m[ii][jj - 1];
+    return res;
+} // conditionalCumulativeProbabilities
+
+Real CreditMigrationHelper::issuerTradePnl(const Size t, const Size date, const Size path, const Size j) const {
+    const IssuerTrade& trade = issuerTrades_[t];
+    Real baseValue = cube_->get(trade.cubeIndex, date, path, 0);
+    Real stateValue = cube_->get(trade.cubeIndex, date, path, cubeIndexStateNpvs_ + j);
+    if (loanExposureMode_ == LoanExposureMode::Notional) {
+        if (trade.bond) {
+            Real fx = 1.0;
+            if (!trade.fxPair.empty()) {
+                QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, trade.fxPair),
+                           "FX spot data not found in aggregation data for currency pair " << trade.fxPair);
+                fx = aggData_->get(date, path, AggregationScenarioDataType::FXSpot, trade.fxPair);
             }
+            // FIXME: We actually need the correct current notional as of the future horizon date,
+            // but we have the current notional as of today
+            baseValue = trade.notional * fx;
+            // FIXME: get the bond's recovery rate
+            Real rr = 0.0;
+            stateValue = j == n_ - 1 ? rr * baseValue : baseValue;
+        }
+        if (trade.cdsCptyIdx != Null<Size>()) {
+            // this is a cds
+            baseValue = 0.0;
+            if (j < n_ - 1)
+                stateValue = 0.0;
+            else
+                stateValue *= aggData_->get(date, path, AggregationScenarioDataType::Numeraire);
         }
     }
-
-    return res;
-}
-
-void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, const Size path,
-                                                 const MersenneTwisterUniformRng& mt) {
-
-    QL_REQUIRE(evaluation_ != Evaluation::Analytic,
-               "CreditMigrationHelper::simulateEntityStates() unexpected call, not in simulation mode");
-
-    for (Size i = 0; i < parameters_->entities().size(); ++i) {
-        Size initialState = parameters_->initialStates()[i];
-            Real tmp = mt.next().value;
-            Size entityState =
-                std::lower_bound(cond[i].row_begin(initialState), cond[i].row_end(initialState), tmp) -
-                cond[i].row_begin(initialState);
-            entityState = std::min(entityState, cond[i].columns() - 1); // play safe
-            simulatedEntityState_[i][path] = entityState;
-            initialState = entityState;
+    if (creditMode_ == CreditMode::Default && j < n_ - 1) {
+        stateValue = baseValue;
     }
+    return stateValue - baseValue;
+} // issuerTradePnl
 
-} // simulateEntityStates
+std::vector<Array> CreditMigrationHelper::entityStatePnl(const Size date, const Size path) const {
 
-Size CreditMigrationHelper::simulatedEntityState(const Size i, const Size path) const {
-    QL_REQUIRE(evaluation_ != Evaluation::Analytic,
-               "CreditMigrationHelper::simulatedEntityState() unexpected call, not in simulation mode");
-    return simulatedEntityState_[i][path];
-} // simulatedEntityState
+    std::vector<Array> pnl(parameters_->entities().size(), Array(n_, 0.0));
 
-Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path, const Size n) const {
-
-    QL_REQUIRE(!parameters_->doubleDefault(),
-               "CreditMigrationHelper::generateMigrationPnl() does not support double default");
-
-    const std::vector<string>& entities = parameters_->entities();
-    Real pnl = 0.0;
-
-    for (Size i = 0; i < entities.size(); ++i) {
-        // compute credit state of entitiy
+    for (Size i = 0; i < parameters_->entities().size(); ++i) {
         // issuer migration risk
-        Size simEntityState = simulatedEntityState(i, path);
-        for (auto const& tradeId : issuerTradeIds_[i]) {
-            try {
-                Size tid = cube_->idsAndIndexes().at(tradeId);
-                Real baseValue = cube_->get(tid, date, path, 0);
-                Real stateValue = cube_->get(tid, date, path, cubeIndexStateNpvs_ + simEntityState);
-                if (loanExposureMode_ == LoanExposureMode::Notional) {
-                    if (tradeNotionals_.find(tradeId) != tradeNotionals_.end()) {
-                        // this is a bond
-                        string tradeCcy = tradeCurrencies_.at(tradeId);
-                        string ccypair = tradeCcy + baseCurrency_;
-                        Real fx = 1.0;
-                        if (tradeCcy != baseCurrency_) {
-                            QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, ccypair),
-                                       "FX spot data not found in aggregation data for currency pair " << ccypair);
-                            fx = aggData_->get(date, path, AggregationScenarioDataType::FXSpot, ccypair);
-                        }
-                        // FIXME: We actually need the correct current notional as of the future horizon date,
-                        // but we have the current notional as of today
-                        baseValue = tradeNotionals_.at(tradeId) * fx;
-                        // FIXME: get the bond's recovery rate
-                        Real rr = 0.0;
-                        stateValue = simEntityState == n - 1 ? rr * baseValue : baseValue;
-                    }
-                    if (tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
-                        // this is a cds
-                        baseValue = 0.0;
-                        if (simEntityState < n - 1)
-                            stateValue = 0.0;
-                        else
-                            stateValue *= aggData_->get(date, path, AggregationScenarioDataType::Numeraire);
-                    }
-                }
-                if (creditMode_ == CreditMode::Default && simEntityState < n - 1) {
-                    stateValue = baseValue;
+        for (auto const t : entityIssuerTrades_[i]) {
+            for (Size j = 0; j < n_; ++j) {
+                try {
+                    pnl[i][j] += issuerTradePnl(t, date, path, j);
+                } catch (const std::exception& e) {
+                    ALOG("can not get state npv for trade " << issuerTrades_[t].id << " (reason:" << e.what()
+                                                            << "), state " << j
+                                                            << ", assume zero credit migration pnl");
                 }
-                pnl += stateValue - baseValue;
-            } catch (const std::exception& e) {
-                ALOG("can not get state npv for trade " << tradeId << " (reason:" << e.what() << "), state "
-                                                        << simEntityState << ", assume zero credit migration pnl");
             }
         }
         // default risk for derivative exposure
         // TODO, assuming a zero recovery here...
-        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
-            Size nid = nettedCube_->idsAndIndexes().at(nettingSetId);
-            QL_REQUIRE(nettedCube_, "empty netted cube");
-            if (simEntityState == n - 1)
-                pnl -= std::max(nettedCube_->get(nid, date, path), 0.0);
-        }
+        for (auto const nid : entityNettingSetIndices_[i])
+            pnl[i][n_ - 1] -= std::max(nettedCube_->get(nid, date, path), 0.0);
     }
     return pnl;
-} // generateMigrationPnl
+} // entityStatePnl
 
 void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, const Size path,
                                                             const std::map<string, Matrix>& transMat,
+                                                            const std::vector<std::vector<Real>>& thresholds,
                                                             std::vector<Array>& condProbs,
                                                             std::vector<Array>& pnl) const {
 
@@ -356,226 +330,235 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
     for (Size i = 0; i < entities.size(); ++i) {
         // compute conditional migration prob
         Size initialState = parameters_->initialStates()[i];
-        Real p = 0.0, condProb0 = 0.0;
-        const Matrix& m = transMat.at(matrixNames[i]);
+        Real condProb0 = 0.0;
         for (Size j = 0; j < n_; ++j) {
-            p += m[initialState][j];
-            Real condProb = conditionalProb(p, globalStates_[date][i][path], globalVar_[i]);
+            Real condProb = conditionalProb(thresholds[i][j], globalStates_[date][i][path], globalVar_[i]);
             condProbs[i][j] = condProb - condProb0;
             condProb0 = condProb;
         }
         // issuer migration risk
         Size cdsCptyIdx = Null<Size>();
-        for (auto const& tradeId : issuerTradeIds_[i]) {
+        for (auto const t0 : entityIssuerTrades_[i]) {
+            const IssuerTrade& trade = issuerTrades_[t0];
             for (Size j = 0; j < n_; ++j) {
                 try {
-                    Size tid = cube_->idsAndIndexes().at(tradeId);
-                    Real baseValue = cube_->get(tid, date, path, 0);
-                    Real stateValue = cube_->get(tid, date, path, cubeIndexStateNpvs_ + j);
-                    if (loanExposureMode_ == LoanExposureMode::Notional) {
-                        if (tradeNotionals_.find(tradeId) != tradeNotionals_.end()) {
-                            // this is a bond
-                            string tradeCcy = tradeCurrencies_.at(tradeId);
-                            string ccypair = tradeCcy + baseCurrency_;
-                            Real fx = 1.0;
-                            if (tradeCcy != baseCurrency_) {
-                                QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, ccypair),
-                                           "FX spot data not found in aggregation data for currency pair " << ccypair);
-                                fx = aggData_->get(date, path, AggregationScenarioDataType::FXSpot, ccypair);
-                            }
-                            // FIXME: We actually need the correct current notional as of the future horizon date,
-                            // but we have the current notional as of today
-                            baseValue = tradeNotionals_.at(tradeId) * fx;
-                            // FIXME: get the bond's recovery rate
-                            Real rr = 0.0;
-                            stateValue = j == n_ - 1 ? rr * baseValue : baseValue;
-                        }
-                        if (tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
-                            // this is a cds
-                            baseValue = 0.0;
-                            if (j < n_ - 1)
-                                stateValue = 0.0;
-                            else
-                                stateValue *= aggData_->get(date, path, AggregationScenarioDataType::Numeraire);
-                        }
-                    }
-                    if (creditMode_ == CreditMode::Default && j < n_ - 1) {
-                        stateValue = baseValue;
-                    }
-                    pnl[i][j] += stateValue - baseValue;
+                    Real tradePnl = issuerTradePnl(t0, date, path, j);
+                    pnl[i][j] += tradePnl;
                     // pnl for additional double default state
                     if (j == n_ - 1)
-                        pnl[i][n_] += stateValue - baseValue;
+                        pnl[i][n_] += tradePnl;
                     // for a CDS we have to subdivide the default migration event into two events (see above)
-                    if (parameters_->doubleDefault() && j == n_ - 1 &&
-                        tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
+                    if (parameters_->doubleDefault() && j == n_ - 1 && trade.cdsCptyIdx != Null<Size>()) {
                         // FIXME currently we can not handle two CDS cptys for same underlying issuer
-                        QL_REQUIRE(cdsCptyIdx == Null<Size>() || cdsCptyIdx == tradeCdsCptyIdx_.at(tradeId),
+                        QL_REQUIRE(cdsCptyIdx == Null<Size>() || cdsCptyIdx == trade.cdsCptyIdx,
                                    "CreditMigrationHelper: Two different CDS cptys found for same issuer "
                                        << entities[i]);
                         // only adjust probability once
                         if (cdsCptyIdx == Null<Size>()) {
-                            Real cptyDefaultPd =
-                                transMat.at(matrixNames[tradeCdsCptyIdx_.at(tradeId)])[initialState][n_ - 1];
+                            Real cptyDefaultPd = transMat.at(matrixNames[trade.cdsCptyIdx])[initialState][n_ - 1];
                             Real pd = prob_tauA_lt_tauB_lt_T(cptyDefaultPd, condProbs[i][n_ - 1], t);
                             QL_REQUIRE(pd <= condProbs[i][n_ - 1],
                                        "CreditMigrationHelper: unexpected probability for double default event "
                                            << pd << " > " << condProbs[i][n_ - 1]);
                             condProbs[i][n_ - 1] -= pd;
                             condProbs[i][n_] = pd;
-                            cdsCptyIdx = tradeCdsCptyIdx_.at(tradeId);
+                            cdsCptyIdx = trade.cdsCptyIdx;
                             // pnl for new state is zero
-                            pnl[i][n_] -= stateValue - baseValue;
+                            pnl[i][n_] -= tradePnl;
                         }
                     }
                 } catch (const std::exception& e) {
-                    ALOG("can not get state npv for trade " << tradeId << " (reason:" << e.what() << "), state " << j
+                    ALOG("can not get state npv for trade " << trade.id << " (reason:" << e.what() << "), state " << j
                                                             << ", assume zero credit migration pnl");
                 }
             }
         }
         // default risk for derivative exposure
         // TODO, assuming a zero recovery here...
-        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
-            auto nid = nettedCube_->idsAndIndexes().at(nettingSetId);
-            QL_REQUIRE(nettedCube_, "empty netted cube");
+        for (auto const nid : entityNettingSetIndices_[i])
             pnl[i][n_ - 1] -= std::max(nettedCube_->get(nid, date, path), 0.0);
-        }
     }
 } // generateConditionalMigrationPnl
 
-Array CreditMigrationHelper::pnlDistribution(const Size date) {
+Real CreditMigrationHelper::pathPnlDistribution(const Size date, const Size path,
+                                                const std::map<string, Matrix>& transMat,
+                                                const std::vector<std::vector<Real>>& thresholds,
+                                                MersenneTwisterUniformRng* mt, HullWhiteBucketing& hwBucketing,
+                                                Array& dist) const {
+
+    // 2a market pnl (t0 to horizon date, over whole cube)
+
+    Real cash = 0.0;
+
+    if (parameters_->marketRisk()) {
+        for (Size j = 0; j <= date + 1; ++j) {
+            for (auto const& [i, creditCurve] : marketTrades_) {
+                // get cumulative survival probability on the path
+                Real sp = 1.0;
+                // FIXME 1
+                // Methodology question: Do we need/want to multiply with the stochastic discount factor
+                // here if we do an explicit credit default simulation at horizon?
+                // FIXME 2
+                // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
+                // with default prob
+                if (parameters_->zeroMarketPnl() && j > 0 && !creditCurve.empty()) {
+                    sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
+                }
+                if (j == 0) {
+                    // at t0 we flip the sign of the npvs to get the initial cash balance
+                    cash -= cube_->getT0(i, 0);
+                    // collect intermediate cashflows
+                    if (cubeIndexCashflows_ != Null<Size>())
+                        cash += cube_->getT0(i, cubeIndexCashflows_);
+                } else if (j <= date) {
+                    // collect intermediate cashflows
+                    if (cubeIndexCashflows_ != Null<Size>())
+                        cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
+                } else {
+                    // at the horizon date we realise the npv
+                    cash += sp * cube_->get(i, j - 1, path, 0);
+                }
+            }
+        } // for data
+    }     // if market risk
+
+    if (!parameters_->creditRisk()) {
+        // if we just add scalar market pnl realisations, we don't really need
+        // the bucketing algorithm to do that, we just update the result
+        // distribution directly
+        std::fill(dist.begin(), dist.end(), 0.0);
+        dist[hwBucketing.index(cash)] = 1.0;
+        return cash;
+    }
+
+    // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
+
+    std::vector<Array> condProbs, pnl;
+
+    if (evaluation_ != Evaluation::Analytic) {
+        // 2b-1 generate pnl on the path using simulated idiosyncratic factors
+        condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
+        // we could build the distribution more efficiently here, but later in 2c we add the market pnl
+        // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
+        // these with additional data?
+        pnl.resize(1, Array(parameters_->paths(), 0.0));
+        // the pnl of an entity only depends on its own state, so we tabulate it by entity and state once
+        // per global path and map the idiosyncratic draws to states using the conditional thresholds
+        QL_REQUIRE(mt != nullptr, "CreditMigrationHelper: no generator for idiosyncratic factors given");
+        std::vector<Array> cond = conditionalCumulativeProbabilities(date, path, thresholds);
+        std::vector<Array> statePnl = entityStatePnl(date, path);
+        for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
+            Real p = 0.0;
+            for (Size i = 0; i < cond.size(); ++i) {
+                Real u = mt->next().value;
+                Size entityState = std::lower_bound(cond[i].begin(), cond[i].end(), u) - cond[i].begin();
+                entityState = std::min(entityState, n_ - 1); // play safe
+                p += statePnl[i][entityState];
+            }
+            pnl[0][path2] = p;
+        }
+    } else {
+        // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
+        // independence of migration on the path / systemic factors
+
+        // n+1 states, since for CDS we have to subdivide the issuer default into
+        // i) default of issuer and non-default of CDS cpty
+        // ii) default of issuer, default of CDS cpty (but after the issuer default)
+        // iii) default of issuer, default of CDS cpty (before the issuer default)
+        // for non-CDS trades for all sub-states the pnl will be set to the same value
+        // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
+        // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
+        // additional state
+
+        condProbs.resize(parameters_->entities().size(), Array(n_ + 1, 0.0));
+        pnl.resize(parameters_->entities().size(), Array(n_ + 1, 0.0));
+        generateConditionalMigrationPnl(date, path, transMat, thresholds, condProbs, pnl);
+    }
+
+    // 2c aggregate market pnl and credit migration pnl
 
-    // FIXME if we ask this method for more than one time step, it might be more efficient to
-    // pass a vector of those time steps and compute the distirbutions in one sweep here
-    // in particular step 2b-1 (in forward simulation mode)
+    if (parameters_->marketRisk()) {
+        condProbs.push_back(Array(1, 1.0));
+        pnl.push_back(Array(1, cash));
+    }
+
+    hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
+    dist = hwBucketing.probability();
+
+    return cash;
+} // pathPnlDistribution
+
+Array CreditMigrationHelper::pnlDistribution(const Size date) {
 
     LOG("Compute PnL distribution for date " << date);
     QL_REQUIRE(date < cube_->numDates(), "date index " << date << " out of range 0..." << cube_->numDates() - 1);
-    const std::vector<string>& entities = parameters_->entities();
 
-    // 1 get transition matrices for entities and rescale them to horizon
+    // 1 get transition matrices for entities and rescale them to horizon, and the thresholds of the entity
+    //   states for the transitions from the initial states
 
     std::map<string, Matrix> transMat; // rescaled transition matrix per (matrix) name
-
-    // 1 get transition matrices for time step and compute variance of global factors for each entiity
+    std::vector<std::vector<Real>> thresholds;
 
     if (parameters_->creditRisk()) {
         transMat = rescaledTransitionMatrices(date);
+        thresholds = transitionThresholds(transMat);
+        QL_REQUIRE(evaluation_ == Evaluation::Analytic || !parameters_->doubleDefault(),
+                   "CreditMigrationHelper::pnlDistribution(): simulation does not support double default");
     }
 
-    // 2 compute conditional pnl distributions and average over paths
-
-    const std::set<std::string>& tradeIds = cube_->ids();
-    Array res(bucketing_.buckets(), 0.0);
+    // 2 compute conditional pnl distributions and sum them over paths, each thread processes a contiguous range of
+    //   paths and accumulates its own sums, the idiosyncratic factors of a path are drawn from a generator seeded
+    //   with the seed and the path number, so that the draws do not depend on the number of threads
 
     Size numPaths = cube_->samples();
-    Real avgCash = 0.0;
+    Size nThreads = std::max<Size>(std::min<Size>(nThreads_, numPaths), 1);
+    bool simulation = parameters_->creditRisk() && evaluation_ != Evaluation::Analytic;
 
-    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
-
-    MersenneTwisterUniformRng mt(parameters_->seed());
-
-    for (Size path = 0; path < numPaths; ++path) {
-
-        // 2a market pnl (t0 to horizon date, over whole cube)
-
-        Real cash = 0.0;
-
-        if (parameters_->marketRisk()) {
-            for (Size j = 0; j <= date + 1; ++j) {
-                for (auto const& tradeId : tradeIds) {
-                    Size i = cube_->idsAndIndexes().at(tradeId);
-                    // get cumulative survival probability on the path
-                    Real sp = 1.0;
-                    //Real rr = 0.0;
-                    // FIXME 1
-                    // Methodology question: Do we need/want to multiply with the stochastic discount factor
-                    // here if we do an explicit credit default simulation at horizon?
-                    // FIXME 2
-                    // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
-                    // with default prob
-                    if (parameters_->zeroMarketPnl() && j > 0 &&
-                        tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
-                        string creditCurve = tradeCreditCurves_.at(tradeId);
-                        sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
-                        //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
-                    }
-                    if (j == 0) {
-                        // at t0 we flip the sign of the npvs to get the initial cash balance
-                        cash -= cube_->getT0(i, 0);
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += cube_->getT0(i, cubeIndexCashflows_);
-                    } else if (j <= date) {
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
-                    } else {
-                        // at the horizon date we realise the npv
-                        cash += sp * cube_->get(i, j - 1, path, 0);
-                    }
-                }
-            } // for data
-        }     // if market risk
-
-        if (!parameters_->creditRisk()) {
-            // if we just add scalar market pnl realisations, we don't really need
-            // the bucketing algorithm to do that, we just update the result
-            // distribution directly
-            res[hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
-            continue;
-        }
+    std::vector<Array> threadDist(nThreads, Array(bucketing_.buckets(), 0.0));
+    std::vector<Real> threadCash(nThreads, 0.0);
+    std::vector<std::exception_ptr> errors(nThreads);
 
-        // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
-
-        std::vector<Array> condProbs, pnl;
-
-        if (evaluation_ != Evaluation::Analytic) {
-            // 2b-1 generate pnl on the path using simulated idiosyncratic factors
-            condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
-            // we could build the distribution more efficiently here, but later in 2c we add the market pnl
-            // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
-            // these with additional data?
-            pnl.resize(1, Array(parameters_->paths(), 0.0));
-            auto cond = initEntityStateSimulation(date, path);
-            for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
-                simulateEntityStates(cond, path, mt);
-                pnl[0][path2] = generateMigrationPnl(date, path, n_);
+    auto worker = [this, date, numPaths, nThreads, simulation, &transMat, &thresholds, &threadDist, &threadCash,
+                   &errors](const Size thread) {
+        try {
+            HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
+            Array dist(bucketing_.buckets(), 0.0);
+            boost::optional<MersenneTwisterUniformRng> mt;
+            for (Size path = thread * numPaths / nThreads; path < (thread + 1) * numPaths / nThreads; ++path) {
+                if (simulation)
+                    mt = MersenneTwisterUniformRng(std::vector<unsigned long>{
+                        static_cast<unsigned long>(parameters_->seed()), static_cast<unsigned long>(path)});
+                threadCash[thread] +=
+                    pathPnlDistribution(date, path, transMat, thresholds, mt ? &*mt : nullptr, hwBucketing, dist);
+                threadDist[thread] += dist;
             }
-        } else {
-            // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
-            // independence of migration on the path / systemic factors
-
-            // n+1 states, since for CDS we have to subdivide the issuer default into
-            // i) default of issuer and non-default of CDS cpty
-            // ii) default of issuer, default of CDS cpty (but after the issuer default)
-            // iii) default of issuer, default of CDS cpty (before the issuer default)
-            // for non-CDS trades for all sub-states the pnl will be set to the same value
-            // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
-            // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
-            // additional state
-
-            condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
-            pnl.resize(entities.size(), Array(n_ + 1, 0.0));
-            generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
-        }
-
-        // 2c aggregate market pnl and credit migration pnl
-
-        if (parameters_->marketRisk()) {
-            condProbs.push_back(Array(1, 1.0));
-            pnl.push_back(Array(1, cash));
+        } catch (...) {
+            errors[thread] = std::current_exception();
         }
+    };
+
+    std::vector<std::thread> workers;
+    for (Size t = 1; t < nThreads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers)
+        w.join();
+
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
 
-        hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
-
-        // 2d add pnl contribution of path to result distribution
-        res += hwBucketing.probability() / static_cast<Real>(numPaths);
-        // average market risk pnl
-        avgCash += cash / static_cast<Real>(numPaths);
+    // 2d merge the sums of the threads and average over the paths
 
-    } // for path
+    Array res(bucketing_.buckets(), 0.0);
+    Real avgCash = 0.0;
+    for (Size t = 0; t < nThreads; ++t) {
+        res += threadDist[t];
+        avgCash += threadCash[t];
+    }
+    res /= static_cast<Real>(numPaths);
+    avgCash /= static_cast<Real>(numPaths);
 
     DLOG("Expected Market Risk PnL at date " << date << ": " << avgCash);
     return res;
@@ -624,6 +607,45 @@ void CreditMigrationHelper::build(const std::map<std::string, QuantLib::ext::sha
     }
     LOG("CreditMigrationHelper: Built issuer and cpty trade ID sets for " << parameters_->entities().size()
                                                                           << " entities.");
+
+    // look up the trade data needed on each path once
+    issuerTrades_.clear();
+    entityIssuerTrades_.assign(parameters_->entities().size(), std::vector<Size>());
+    entityNettingSetIndices_.assign(parameters_->entities().size(), std::vector<Size>());
+    for (Size i = 0; i < parameters_->entities().size(); ++i) {
+        for (auto const& tradeId : issuerTradeIds_[i]) {
+            auto c = cube_->idsAndIndexes().find(tradeId);
+            if (c == cube_->idsAndIndexes().end()) {
+                ALOG("can not get state npv for trade " << tradeId
+                                                        << " (reason: not in cube), assume zero credit migration pnl");
+                continue;
+            }
+            IssuerTrade t{tradeId, c->second, false, 0.0, std::string(), Null<Size>()};
+            auto notional = tradeNotionals_.find(tradeId);
+            if (notional != tradeNotionals_.end()) {
+                t.bond = true;
+                t.notional = notional->second;
+                const string& tradeCcy = tradeCurrencies_.at(tradeId);
+                if (tradeCcy != baseCurrency_)
+                    t.fxPair = tradeCcy + baseCurrency_;
+            }
+            auto cds = tradeCdsCptyIdx_.find(tradeId);
+            if (cds != tradeCdsCptyIdx_.end())
+                t.cdsCptyIdx = cds->second;
+            entityIssuerTrades_[i].push_back(issuerTrades_.size());
+            issuerTrades_.push_back(t);
+        }
+        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
+            QL_REQUIRE(nettedCube_, "empty netted cube");
+            entityNettingSetIndices_[i].push_back(nettedCube_->idsAndIndexes().at(nettingSetId));
+        }
+    }
+    marketTrades_.clear();
+    for (auto const& tradeId : cube_->ids()) {
+        auto creditCurve = tradeCreditCurves_.find(tradeId);
+        marketTrades_.emplace_back(cube_->idsAndIndexes().at(tradeId),
+                                   creditCurve == tradeCreditCurves_.end() ? std::string() : creditCurve->second);
+    }
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         DLOG("Entity " << parameters_->entities()[i] << ": " << issuerTradeIds_[i].size()
                        << " trades with issuer risk, " << cptyNettingSetIds_[i].size()
@@ -47,7 +47,11 @@ namespace analytics {
      - n correlated global factors \f$ G_j \f$
      - entity specific factor loadings \f$ \beta_{ij} \f$
      - idiosyncratic part \f$ dZ_i = \sigma_i dW_i \f$
-     - independent  Wiener processes W, i.e. \f$ dW_k dW_l = 0 \f$ and \f$ dW_k dG_j = 0 \f$ */
+     - independent  Wiener processes W, i.e. \f$ dW_k dW_l = 0 \f$ and \f$ dW_k dG_j = 0 \f$
+
+   The pnl distribution is computed in parallel over the global paths using nThreads threads. The global paths are
+   processed in blocks, the contributions of the paths are added in path order and the idiosyncratic draws of a path
+   are the same as in a serial run, so that the result does not depend on the number of threads. */
 class CreditMigrationHelper {
 public:
     enum class CreditMode { Migration, Default };
@@ -59,7 +63,7 @@ public:
                           const QuantLib::ext::shared_ptr<AggregationScenarioData> aggData, const Size cubeIndexCashflows,
                           const Size cubeIndexStateNpvs, const Real distributionLowerBound,
                           const Real distributionUpperBound, const Size buckets, const Matrix& globalFactorCorrelation,
-                          const std::string& baseCurrency);
+                          const std::string& baseCurrency, const Size nThreads = 1);
 
     //! builds the helper for a specific subset of trades stored in the cube
     void build(const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades);
@@ -81,37 +85,43 @@ private:
         using the simulated global state paths stored in the aggregation scenario data object */
     void init();
 
-    //! Allocate 3d storage for the simulated idiosyncratic factors by entity, date and sample
-    void initEntityStateSimulation();
+    /*! Inverse cumulative normal of the cumulated transition probabilities from the initial state of each entity to
+        the states 0, ..., j, i.e. the thresholds of the entity state X_i for the given date. Cumulated probabilities
+        close to 0 resp. 1 are mapped to -inf resp. +inf. */
+    std::vector<std::vector<Real>> transitionThresholds(const std::map<string, Matrix>& transMat) const;
 
-    /*! Initialise the entity state simulationn for a given date for
-        Evaluation = TerminalSimulation:
-        Return transition matrix for each entity for the given date,
+    /*! Evaluation = TerminalSimulation:
+        Return the cumulated transition probabilities from the initial state of each entity for the given date,
         conditional on the global terminal state on the given path */
-    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path);
-
-    /*! Generate one entity state sample path for all entities given the global state path
-        and given the conditional transition matrices for all entities at the terminal date. */
-    void simulateEntityStates(const std::vector<Matrix>& cond, const Size path, const MersenneTwisterUniformRng& mt);
+    std::vector<Array> conditionalCumulativeProbabilities(const Size date, const Size path,
+                                                          const std::vector<std::vector<Real>>& thresholds) const;
 
-    //! Look up the simulated entity credit state for the given entity, date and path
-    Size simulatedEntityState(const Size i, const Size path) const;
+    //! PnL impact of issuer trade t if the issuer is in state j on the given path, throws if not available
+    Real issuerTradePnl(const Size t, const Size date, const Size path, const Size j) const;
 
-    /*! Return a single PnL impact due to credit migration or default of Bond/CDS issuers and default of
-      netting set counterparties on the given global path */
-    Real generateMigrationPnl(const Size date, const Size path, const Size n) const;
+    /*! Return the PnL impact due to credit migration or default of Bond/CDS issuers and default of netting set
+        counterparties on the given global path, for each entity and credit state of the entity */
+    std::vector<Array> entityStatePnl(const Size date, const Size path) const;
 
     /*! Return a vector of PnL impacts and associated conditional probabilities for the specified global path,
       due to credit migration or default of Bond/CDS issuers and default of netting set counterparties */
     void generateConditionalMigrationPnl(const Size date, const Size path, const std::map<string, Matrix>& transMat,
+                                         const std::vector<std::vector<Real>>& thresholds,
                                          std::vector<Array>& condProbs, std::vector<Array>& pnl) const;
 
+    /*! Contribution of the given global path to the pnl distribution, mt is the generator for the idiosyncratic
+        factors of the path (only required in simulation mode), returns the market risk pnl on the path */
+    Real pathPnlDistribution(const Size date, const Size path, const std::map<string, Matrix>& transMat,
+                             const std::vector<std::vector<Real>>& thresholds, MersenneTwisterUniformRng* mt,
+                             QuantExt::HullWhiteBucketing& hwBucketing, Array& dist) const;
+
     QuantLib::ext::shared_ptr<CreditSimulationParameters> parameters_;
     QuantLib::ext::shared_ptr<NPVCube> cube_, nettedCube_;
     QuantLib::ext::shared_ptr<AggregationScenarioData> aggData_;
     Size cubeIndexCashflows_, cubeIndexStateNpvs_;
     Matrix globalFactorCorrelation_;
     std::string baseCurrency_;
+    Size nThreads_;
 
     CreditMode creditMode_;
     LoanExposureMode loanExposureMode_;
@@ -128,15 +138,28 @@ private:
     std::map<std::string, std::string> tradeCurrencies_;
     std::map<std::string, Size> tradeCdsCptyIdx_;
 
+    // Issuer trades by entity, with the trade data needed on each path looked up once
+    struct IssuerTrade {
+        std::string id;
+        Size cubeIndex;
+        bool bond;
+        Real notional;
+        // currency pair trade ccy + base ccy if the bond currency is not the base currency
+        std::string fxPair;
+        // index of the cds cpty in the entities or null
+        Size cdsCptyIdx;
+    };
+    std::vector<IssuerTrade> issuerTrades_;
+    std::vector<std::vector<Size>> entityIssuerTrades_;
+    std::vector<std::vector<Size>> entityNettingSetIndices_;
+    // cube index and credit curve (possibly empty) of all trades in the cube, for the market pnl
+    std::vector<std::pair<Size, std::string>> marketTrades_;
+
     // Transition matrix rows
     Size n_;
     std::vector<std::map<string, Matrix>> rescaledTransitionMatrices_;
     // Variance of the systemic part (Y_i) of entity state X_i
     std::vector<Real> globalVar_;
-    // Storage for the simulated idiosyncratic factors Z by entity, sample number
-    std::vector<std::vector<Size>> simulatedEntityState_;
-
-    std::vector<std::vector<Matrix>> entityStateSimulationMatrices_;
     // Systemic part (Y_i) of entity state X_i by date index, entity index, sample number
     std::vector<std::vector<std::vector<Real>>> globalStates_;
 };
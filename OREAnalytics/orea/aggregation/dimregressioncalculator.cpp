@@ -29,13 +29,17 @@
 #include <ql/time/daycounters/actualactual.hpp>
 
 #include <qle/math/nadarayawatson.hpp>
-#include <qle/math/stabilisedglls.hpp>
+#include <qle/math/randomvariable.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/error_of_mean.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -103,19 +107,15 @@ void RegressionDynamicInitialMarginCalculator::build() {
     Size stopDatesLoop = datesLoopSize_;
     Size samples = cube_->samples();
 
-    Size polynomOrder = regressionOrder_;
     LOG("DIM regression polynom order = " << regressionOrder_);
-    LsmBasisSystem::PolynomialType polynomType = LsmBasisSystem::Monomial;
     Size regressionDimension = regressors_.empty() ? 1 : regressors_.size();
     LOG("DIM regression dimension = " << regressionDimension);
-    std::vector<ext::function<Real(Array)>> v(
-        LsmBasisSystem::multiPathBasisSystem(regressionDimension, polynomOrder, polynomType));
     Real confidenceLevel = QuantLib::InverseCumulativeNormal()(quantile_);
     LOG("DIM confidence level " << confidenceLevel);
 
-    Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
-    Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
+    // Collect the netting sets that require a regression, apply external IM evolutions and t0 scaling on the way
 
+    std::vector<std::pair<string, Size>> regressionNettingSets;
     Size nettingSetCount = 0;
     for (auto n : nettingSetIds_) {
         LOG("Process netting set " << n);
@@ -152,6 +152,7 @@ void RegressionDynamicInitialMarginCalculator::build() {
                 }
                 WLOG("Overriding DIM for netting set " << n << " succeeded");
                 // continue to the next netting set
+                nettingSetCount++;
                 continue;
             }
         }
@@ -170,136 +171,211 @@ void RegressionDynamicInitialMarginCalculator::build() {
             nettingSetScaling_.find(n) == nettingSetScaling_.end() ? 1.0 : nettingSetScaling_[n];
         LOG("Netting set DIM scaling factor: " << nettingSetDimScaling);
 
-        for (Size j = 0; j < stopDatesLoop; ++j) {
-            accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
-            accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real npvDefault = nettingSetNPV_[n][j][k];
-                Real flow = nettingSetFLOW_[n][j][k];
-                Real npvCloseOut = nettingSetCloseOutNPV_[n][j][k];
-                accDiff((npvCloseOut * numCloseOut) + (flow * numDefault) - (npvDefault * numDefault));
-                accOneOverNumeraire(1.0 / numDefault);
-            }
+        regressionNettingSets.push_back(std::make_pair(n, nettingSetCount));
+        nettingSetCount++;
+    }
 
-            Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
-            Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
-
-            Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
-            Real E_OneOverNumeraire =
-                mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
-
-            nettingSetZeroOrderDIM_[n][j] = stdevDiff * horizonScaling * confidenceLevel;
-            nettingSetZeroOrderDIM_[n][j] *= E_OneOverNumeraire;
-
-            vector<Real> rx0(samples, 0.0);
-            vector<Array> rx(samples, Array());
-            vector<Real> ry1(samples, 0.0);
-            vector<Real> ry2(samples, 0.0);
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real x = nettingSetNPV_[n][j][k] * numDefault;
-                Real f = nettingSetFLOW_[n][j][k] * numDefault;
-                Real y = nettingSetCloseOutNPV_[n][j][k] * numCloseOut;
-                Real z = (y + f - x);
-                rx[k] = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                rx0[k] = rx[k][0];
-                ry1[k] = z;     // for local regression
-                ry2[k] = z * z; // for least squares regression
-                nettingSetDeltaNPV_[n][j][k] = z;
-                regressorArray_[n][j][k] = rx[k];
-            }
-            vector<Real> delNpvVec_copy = nettingSetDeltaNPV_[n][j];
-            sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
-            Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
-            Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
-            simpleDim_h *= horizonScaling;                                  // the usual scaling factors
-            simpleDim_p *= horizonScaling;                                  // the usual scaling factors
-            nettingSetSimpleDIMh_[n][j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
-            nettingSetSimpleDIMp_[n][j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
-
-            QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
-            if (close_enough(stdevDiff, 0.0)) {
-                LOG("DIM: Zero std dev estimation at step " << j);
-                // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
-                for (Size k = 0; k < samples; ++k) {
-                    nettingSetDIM_[n][j][k] = 0.0;
-                    nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
-            } else {
-                // Least squares polynomial regression with specified polynom order
-                QuantExt::StabilisedGLLS ls(rx, ry2, v, QuantExt::StabilisedGLLS::MeanStdDev);
-                LOG("DIM data normalisation at time step "
-                    << j << ": " << scientific << setprecision(6) << " x-shift = " << ls.xShift() << " x-multiplier = "
-                    << ls.xMultiplier() << " y-shift = " << ls.yShift() << " y-multiplier = " << ls.yMultiplier());
-                LOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6)
-                                                                << ls.transformedCoefficients());
-
-                // Local regression versus first regression variable (i.e. we do not perform a
-                // multidimensional local regression):
-                // We evaluate this at a limited number of samples only for validation purposes.
-                // Note that computational effort scales quadratically with number of samples.
-                // NadarayaWatson needs a large number of samples for good results.
-                QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(),
-                                            GaussianKernel(0.0, localRegressionBandWidth_));
-                Size localRegressionSamples = samples;
-                if (localRegressionEvaluations_ > 0)
-                    localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
-
-                // Evaluate regression function to compute DIM for each scenario
-                for (Size k = 0; k < samples; ++k) {
-                    // Real num1 = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                        AggregationScenarioDataType::Numeraire, j, k);
-                    Array regressor = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                    Real e = ls.eval(regressor, v);
-                    if (e < 0.0)
-                        LOG("Negative variance regression for date " << j << ", sample " << k
-                                                                     << ", regressor = " << regressor);
-
-                    // Note:
-                    // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
-                    //    and to avoid a second regression for the conditional mean
-                    // 2) In particular the linear regression function can yield negative variance values in
-                    //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
-                    //    variance approaching zero. We correct this here by taking the positive part.
-                    Real std = sqrt(std::max(e, 0.0));
-                    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
-                    // Real dim = std * scalingFactor / num1;
-                    Real dim = std * scalingFactor / numDefault;
-                    dimCube_->set(dim, nettingSetCount, j, k);
-                    nettingSetDIM_[n][j][k] = dim;
-                    nettingSetExpectedDIM_[n][j] += dim / samples;
-
-                    // Evaluate the Kernel regression for a subset of the samples only (performance)
-                    if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
-                        // nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / num1;
-                        nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / numDefault;
-                    else
-                        nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
+    // Run the regressions for all netting sets and dates, each (netting set, date) pair is an independent job
+    // writing to its own slots in the result containers, so the jobs can be distributed over several threads
+
+    Size nJobs = regressionNettingSets.size() * stopDatesLoop;
+    Size nThreads = std::max<Size>(std::min<Size>(inputs_ ? inputs_->nThreads() : 1, nJobs), 1);
+    LOG("DIM regression for " << regressionNettingSets.size() << " netting sets and " << stopDatesLoop
+                              << " dates using " << nThreads << " threads");
+
+    std::atomic<Size> nextJob(0);
+    std::vector<std::exception_ptr> errors(nThreads);
+    auto worker = [this, &regressionNettingSets, &nextJob, &errors, nJobs, stopDatesLoop,
+                   confidenceLevel](const Size thread) {
+        try {
+            for (Size job = nextJob++; job < nJobs; job = nextJob++) {
+                const auto& [n, index] = regressionNettingSets[job / stopDatesLoop];
+                auto s = nettingSetScaling_.find(n);
+                regress(n, index, job % stopDatesLoop, confidenceLevel, s == nettingSetScaling_.end() ? 1.0 : s->second);
             }
+        } catch (...) {
+            errors[thread] = std::current_exception();
         }
-
-        nettingSetCount++;
+    };
+
+    std::vector<std::thread> workers;
+    for (Size t = 1; t < nThreads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers)
+        w.join();
+
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
     }
+
     LOG("DIM by polynomial regression done");
 }
 
-Array RegressionDynamicInitialMarginCalculator::regressorArray(string nettingSet, Size dateIndex,
-                                                                           Size sampleIndex) {
+void RegressionDynamicInitialMarginCalculator::regress(const string& n, const Size nettingSetIndex, const Size j,
+                                                       const Real confidenceLevel, const Real nettingSetDimScaling) {
+
+    // only use find() / at() on the maps below, this method is called concurrently from several threads
+
+    Size samples = cube_->samples();
+    const vector<Real>& npv = nettingSetNPV_.at(n)[j];
+    const vector<Real>& closeOutNpv = nettingSetCloseOutNPV_.at(n)[j];
+    const vector<Real>& flow = nettingSetFLOW_.at(n)[j];
+    vector<Real>& deltaNpv = nettingSetDeltaNPV_.at(n)[j];
+    vector<Real>& dimValues = nettingSetDIM_.at(n)[j];
+    vector<Real>& localDim = nettingSetLocalDIM_.at(n)[j];
+    vector<Array>& regressorValues = regressorArray_.at(n)[j];
+
+    vector<Real> numDefault(samples), numCloseOut(samples);
+    accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
+    accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
+    for (Size k = 0; k < samples; ++k) {
+        numDefault[k] =
+            cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        numCloseOut[k] =
+            cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        accDiff((closeOutNpv[k] * numCloseOut[k]) + (flow[k] * numDefault[k]) - (npv[k] * numDefault[k]));
+        accOneOverNumeraire(1.0 / numDefault[k]);
+    }
+
+    Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
+    Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
+
+    Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
+    Real E_OneOverNumeraire =
+        mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
+
+    nettingSetZeroOrderDIM_.at(n)[j] = stdevDiff * horizonScaling * confidenceLevel * E_OneOverNumeraire;
+
+    // Regressors are stored column-wise in contiguous random variables, each of them standardised to mean zero and
+    // unit standard deviation, the same applies to the regressand, see StabilisedGLLS::MeanStdDev
+
+    Size regressionDimension = regressors_.empty() ? 1 : regressors_.size();
+    vector<RandomVariable> rx(regressionDimension, RandomVariable(samples));
+    RandomVariable ry2(samples);
+    vector<Real> rx0(samples, 0.0);
+    vector<Real> ry1(samples, 0.0);
+    for (Size k = 0; k < samples; ++k) {
+        Real x = npv[k] * numDefault[k];
+        Real f = flow[k] * numDefault[k];
+        Real y = closeOutNpv[k] * numCloseOut[k];
+        Real z = (y + f - x);
+        regressorValues[k] = regressors_.empty() ? Array(1, npv[k]) : regressorArray(n, j, k);
+        for (Size i = 0; i < regressionDimension; ++i)
+            rx[i].set(k, regressorValues[k][i]);
+        rx0[k] = regressorValues[k][0];
+        ry1[k] = z;         // for local regression
+        ry2.set(k, z * z);  // for least squares regression
+        deltaNpv[k] = z;
+    }
+
+    Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
+    Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
+    vector<Real> delNpvVec_copy = deltaNpv;
+    sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
+    Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
+    Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
+    simpleDim_h *= horizonScaling;                                      // the usual scaling factors
+    simpleDim_p *= horizonScaling;                                      // the usual scaling factors
+    nettingSetSimpleDIMh_.at(n)[j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
+    nettingSetSimpleDIMp_.at(n)[j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
+
+    std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>> v;
+    if (regressionOrder_ == 0)
+        v.push_back([](const std::vector<const RandomVariable*>& x) { return RandomVariable(x.front()->size(), 1.0); });
+    else
+        v = multiPathBasisSystem(regressionDimension, regressionOrder_, LsmBasisSystem::Monomial);
+
+    QL_REQUIRE(samples > v.size(), "not enough points for regression with polynom order " << regressionOrder_);
+    if (close_enough(stdevDiff, 0.0)) {
+        LOG("DIM: Zero std dev estimation at step " << j);
+        // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
+        for (Size k = 0; k < samples; ++k) {
+            dimValues[k] = 0.0;
+            localDim[k] = 0.0;
+        }
+        return;
+    }
+
+    // Least squares polynomial regression with specified polynom order
+
+    auto standardise = [samples](RandomVariable& r, Real& shift, Real& multiplier) {
+        accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> acc;
+        for (Size k = 0; k < samples; ++k)
+            acc(r[k]);
+        shift = -mean(acc);
+        Real var = boost::accumulators::variance(acc);
+        multiplier = close_enough(var, 0.0) ? 1.0 : 1.0 / std::sqrt(var);
+        r = (r + RandomVariable(samples, shift)) * RandomVariable(samples, multiplier);
+    };
+
+    Array xShift(regressionDimension), xMultiplier(regressionDimension);
+    for (Size i = 0; i < regressionDimension; ++i)
+        standardise(rx[i], xShift[i], xMultiplier[i]);
+    Real yShift, yMultiplier;
+    standardise(ry2, yShift, yMultiplier);
+
+    std::vector<const RandomVariable*> rxPtr = vec2vecptr(rx);
+    Array coefficients = regressionCoefficients(ry2, rxPtr, v, Filter(), RandomVariableRegressionMethod::QR);
+    RandomVariable condVariance = conditionalExpectation(rxPtr, v, coefficients);
+    condVariance = condVariance / RandomVariable(samples, yMultiplier) - RandomVariable(samples, yShift);
+
+    LOG("DIM data normalisation for netting set " << n << " at time step " << j << ": " << scientific
+                                                  << setprecision(6) << " x-shift = " << xShift
+                                                  << " x-multiplier = " << xMultiplier << " y-shift = " << yShift
+                                                  << " y-multiplier = " << yMultiplier);
+    LOG("DIM regression coefficients for netting set " << n << " at time step " << j << ": " << fixed
+                                                       << setprecision(6) << coefficients);
+
+    // Local regression versus first regression variable (i.e. we do not perform a
+    // multidimensional local regression):
+    // We evaluate this at a limited number of samples only for validation purposes.
+    // Note that computational effort scales quadratically with number of samples.
+    // NadarayaWatson needs a large number of samples for good results.
+    QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(), GaussianKernel(0.0, localRegressionBandWidth_));
+    Size localRegressionSamples = samples;
+    if (localRegressionEvaluations_ > 0)
+        localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
+
+    // Evaluate regression function to compute DIM for each scenario
+    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
+    Real expectedDim = 0.0;
+    for (Size k = 0; k < samples; ++k) {
+        Real e = condVariance[k];
+        if (e < 0.0)
+            LOG("Negative variance regression for date " << j << ", sample " << k
+                                                         << ", regressor = " << regressorValues[k]);
+
+        // Note:
+        // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
+        //    and to avoid a second regression for the conditional mean
+        // 2) In particular the linear regression function can yield negative variance values in
+        //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
+        //    variance approaching zero. We correct this here by taking the positive part.
+        Real std = sqrt(std::max(e, 0.0));
+        Real dim = std * scalingFactor / numDefault[k];
+        dimCube_->set(dim, nettingSetIndex, j, k);
+        dimValues[k] = dim;
+        expectedDim += dim / samples;
+
+        // Evaluate the Kernel regression for a subset of the samples only (performance)
+        if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
+            localDim[k] = lr.standardDeviation(regressorValues[k][0]) * scalingFactor / numDefault[k];
+        else
+            localDim[k] = 0.0;
+    }
+    nettingSetExpectedDIM_.at(n)[j] += expectedDim;
+}
+
+Array RegressionDynamicInitialMarginCalculator::regressorArray(const string& nettingSet, Size dateIndex,
+                                                               Size sampleIndex) const {
     Array a(regressors_.size());
     for (Size i = 0; i < regressors_.size(); ++i) {
         string variable = regressors_[i];
         if (boost::to_upper_copy(variable) ==
             "NPV") // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
-            a[i] = nettingSetNPV_[nettingSet][dateIndex][sampleIndex];
+            a[i] = nettingSetNPV_.at(nettingSet)[dateIndex][sampleIndex];
         else if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
             a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::IndexFixing,
                                                                       dateIndex, sampleIndex, variable);
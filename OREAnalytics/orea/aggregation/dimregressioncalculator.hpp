@@ -36,6 +36,10 @@ using namespace std;
 /*!
   Dynamic IM is estimated using polynomial and local regression methods applied to the NPV moves over simulation time
   steps across all paths.
+
+  The regressions for the netting sets and simulation dates are independent and are distributed over the number of
+  threads given by the input parameters. The polynomial regression uses the RandomVariable regression of the AMC
+  framework on standardised regressors and regressand.
 */
 class RegressionDynamicInitialMarginCalculator : public DynamicInitialMarginCalculator {
 public:
@@ -79,7 +83,10 @@ public:
 
 private:
     //! Compile the array of DIM regressors for the specified netting set, date and sample index
-    Array regressorArray(string nettingSet, Size dateIndex, Size sampleIndex);
+    Array regressorArray(const string& nettingSet, Size dateIndex, Size sampleIndex) const;
+    //! Run the DIM regression for the specified netting set and date index
+    void regress(const string& nettingSet, const Size nettingSetIndex, const Size dateIndex, const Real confidenceLevel,
+                 const Real nettingSetDimScaling);
 
     Size regressionOrder_;
     vector<string> regressors_;
@@ -24,6 +24,8 @@
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
+#include <qle/utilities/profiler.hpp>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -69,6 +71,7 @@ ExposureCalculator::ExposureCalculator(
 }
 
 void ExposureCalculator::build() {
+    QLE_PROFILE_ZONE("ExposureCalculator::build");
     LOG("Compute trade exposure profiles, " << (flipViewXVA_ ? "inverted (flipViewXVA = Y)" : "regular (flipViewXVA = N)"));
     size_t i = 0;
     for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end(); ++tradeIt, ++i) {
@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/aggregation/incrementalxva.hpp>
+#include <orea/cube/jointnpvcube.hpp>
+
+#include <ored/utilities/log.hpp>
+
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace analytics {
+
+IncrementalXva::IncrementalXva(const QuantLib::ext::shared_ptr<Portfolio>& basePortfolio,
+                               const QuantLib::ext::shared_ptr<NPVCube>& baseCube,
+                               const QuantLib::ext::shared_ptr<PostProcess>& basePostProcess,
+                               const PostProcessBuilder& postProcessBuilder)
+    : basePortfolio_(basePortfolio), baseCube_(baseCube), basePostProcess_(basePostProcess),
+      postProcessBuilder_(postProcessBuilder) {
+    QL_REQUIRE(basePortfolio_, "IncrementalXva: base portfolio is null");
+    QL_REQUIRE(baseCube_, "IncrementalXva: base cube is null");
+    QL_REQUIRE(postProcessBuilder_, "IncrementalXva: post process builder is not set");
+}
+
+void IncrementalXva::build(const QuantLib::ext::shared_ptr<Portfolio>& addedTrades,
+                           const QuantLib::ext::shared_ptr<NPVCube>& addedCube,
+                           const std::set<std::string>& removedTradeIds) {
+
+    std::set<std::string> addedIds;
+    if (addedTrades)
+        addedIds = addedTrades->ids();
+    QL_REQUIRE(addedIds.empty() || addedCube, "IncrementalXva: cube of the added trades required");
+    for (auto const& id : addedIds) {
+        QL_REQUIRE(addedCube->idsAndIndexes().find(id) != addedCube->idsAndIndexes().end(),
+                   "IncrementalXva: added trade '" << id << "' not found in the cube of the added trades");
+    }
+
+    // a replaced trade affects the netting sets of both the base and the added trade
+    affectedNettingSets_.clear();
+    for (auto const& id : removedTradeIds) {
+        if (auto trade = basePortfolio_->get(id))
+            affectedNettingSets_.insert(trade->envelope().nettingSetId());
+        else
+            WLOG("IncrementalXva: removed trade '" << id << "' not found in base portfolio, ignored");
+    }
+    for (auto const& id : addedIds) {
+        affectedNettingSets_.insert(addedTrades->get(id)->envelope().nettingSetId());
+        if (auto trade = basePortfolio_->get(id))
+            affectedNettingSets_.insert(trade->envelope().nettingSetId());
+    }
+
+    // the remaining base trades of the affected netting sets and the added trades
+    whatIfPortfolio_ = QuantLib::ext::make_shared<Portfolio>();
+    std::set<std::string> baseIds;
+    for (auto const& [id, trade] : basePortfolio_->trades()) {
+        if (affectedNettingSets_.find(trade->envelope().nettingSetId()) != affectedNettingSets_.end() &&
+            removedTradeIds.find(id) == removedTradeIds.end() && addedIds.find(id) == addedIds.end()) {
+            whatIfPortfolio_->add(trade);
+            baseIds.insert(id);
+        }
+    }
+    for (auto const& id : addedIds)
+        whatIfPortfolio_->add(addedTrades->get(id));
+
+    // the base trades are taken from a view on the base cube restricted to the remaining trades
+    std::vector<QuantLib::ext::shared_ptr<NPVCube>> cubes;
+    if (!baseIds.empty()) {
+        std::vector<QuantLib::ext::shared_ptr<NPVCube>> base = {baseCube_};
+        cubes.push_back(QuantLib::ext::make_shared<JointNPVCube>(base, baseIds));
+    }
+    if (!addedIds.empty())
+        cubes.push_back(addedCube);
+    whatIfCube_ = cubes.empty() ? nullptr : QuantLib::ext::make_shared<JointNPVCube>(cubes, whatIfPortfolio_->ids());
+    whatIfPostProcess_ = nullptr;
+
+    LOG("IncrementalXva: " << affectedNettingSets_.size() << " affected netting sets with " << baseIds.size()
+                           << " base trades and " << addedIds.size() << " added trades, " << removedTradeIds.size()
+                           << " trades removed");
+}
+
+void IncrementalXva::run() {
+    QL_REQUIRE(whatIfPortfolio_, "IncrementalXva::run(): build() must be called first");
+    if (whatIfPortfolio_->size() > 0)
+        whatIfPostProcess_ = postProcessBuilder_(whatIfPortfolio_, whatIfCube_);
+    else
+        whatIfPostProcess_ = nullptr;
+}
+
+void IncrementalXva::report(ore::data::Report& report) const {
+    QL_REQUIRE(basePostProcess_, "IncrementalXva::report(): base post process is null");
+    typedef std::function<Real(PostProcess&, const std::string&)> Metric;
+    static const std::vector<std::pair<std::string, Metric>> metrics = {
+        {"EEPE", [](PostProcess& p, const std::string& n) { return p.netEEPE_B(n); }},
+        {"CVA", [](PostProcess& p, const std::string& n) { return p.nettingSetCVA(n); }},
+        {"DVA", [](PostProcess& p, const std::string& n) { return p.nettingSetDVA(n); }},
+        {"FBA", [](PostProcess& p, const std::string& n) { return p.nettingSetFBA(n); }},
+        {"FCA", [](PostProcess& p, const std::string& n) { return p.nettingSetFCA(n); }},
+        {"COLVA", [](PostProcess& p, const std::string& n) { return p.nettingSetCOLVA(n); }},
+        {"MVA", [](PostProcess& p, const std::string& n) { return p.nettingSetMVA(n); }}};
+
+    std::set<std::string> baseNettingSets, whatIfNettingSets;
+    for (auto const& [id, n] : basePortfolio_->nettingSetMap())
+        baseNettingSets.insert(n);
+    if (whatIfPostProcess_) {
+        for (auto const& [id, n] : whatIfPortfolio_->nettingSetMap())
+            whatIfNettingSets.insert(n);
+    }
+
+    Size precision = 2;
+    report.addColumn("NettingSetId", std::string())
+        .addColumn("Metric", std::string())
+        .addColumn("Base", double(), precision)
+        .addColumn("WhatIf", double(), precision)
+        .addColumn("Change", double(), precision);
+
+    for (auto const& n : affectedNettingSets_) {
+        bool inBase = baseNettingSets.find(n) != baseNettingSets.end();
+        bool inWhatIf = whatIfNettingSets.find(n) != whatIfNettingSets.end();
+        for (auto const& [name, metric] : metrics) {
+            Real base = inBase ? metric(*basePostProcess_, n) : 0.0;
+            Real whatIf = inWhatIf ? metric(*whatIfPostProcess_, n) : 0.0;
+            report.next().add(n).add(name).add(base).add(whatIf).add(whatIf - base);
+        }
+    }
+    report.end();
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/aggregation/incrementalxva.hpp
+    \brief Incremental what-if XVA on top of a resident base run
+    \ingroup analytics
+*/
+
+#pragma once
+
+#include <orea/aggregation/postprocess.hpp>
+#include <orea/cube/npvcube.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/report/report.hpp>
+
+#include <ql/shared_ptr.hpp>
+
+#include <functional>
+#include <set>
+
+namespace ore {
+namespace analytics {
+
+//! Incremental what-if XVA
+/*! The trade level cube and the post processor of a base run are kept resident. For a what-if change of the
+    portfolio (added and removed trades) only the added trades have to be priced on the scenarios of the base run.
+
+    Netting set exposures and XVAs only depend on the trades of the netting set, so the netting sets not touched by
+    the change keep their base results. The post processor is rerun on the trades of the affected netting sets only,
+    using a view of the base cube without the removed and replaced trades joined with the cube of the added trades.
+
+    \ingroup analytics
+*/
+class IncrementalXva {
+public:
+    //! Builds the post processor for the given (sub-)portfolio and a cube holding exactly its trades
+    typedef std::function<QuantLib::ext::shared_ptr<PostProcess>(const QuantLib::ext::shared_ptr<Portfolio>&,
+                                                                 const QuantLib::ext::shared_ptr<NPVCube>&)>
+        PostProcessBuilder;
+
+    //! The base portfolio and cube must hold the same trades, the base post process is only required for the report
+    IncrementalXva(const QuantLib::ext::shared_ptr<Portfolio>& basePortfolio,
+                   const QuantLib::ext::shared_ptr<NPVCube>& baseCube,
+                   const QuantLib::ext::shared_ptr<PostProcess>& basePostProcess,
+                   const PostProcessBuilder& postProcessBuilder);
+
+    /*! Sets up the what-if portfolio and cube of the affected netting sets. Added trades with the id of a base trade
+        replace the base trade. The added cube holds the added trades and may be null if no trades are added. */
+    void build(const QuantLib::ext::shared_ptr<Portfolio>& addedTrades,
+               const QuantLib::ext::shared_ptr<NPVCube>& addedCube, const std::set<std::string>& removedTradeIds);
+
+    //! Runs the post processor on the what-if portfolio of the affected netting sets
+    void run();
+
+    //! Netting sets with added, removed or replaced trades
+    const std::set<std::string>& affectedNettingSets() const { return affectedNettingSets_; }
+    //! Trades of the affected netting sets after the change
+    const QuantLib::ext::shared_ptr<Portfolio>& whatIfPortfolio() const { return whatIfPortfolio_; }
+    //! Cube of the trades in the what-if portfolio, null if the what-if portfolio is empty
+    const QuantLib::ext::shared_ptr<NPVCube>& whatIfCube() const { return whatIfCube_; }
+    //! Post processor of the what-if portfolio, null if the what-if portfolio is empty
+    const QuantLib::ext::shared_ptr<PostProcess>& whatIfPostProcess() const { return whatIfPostProcess_; }
+
+    /*! Writes the base and what-if netting set EEPE, CVA, DVA, FBA, FCA, COLVA and MVA and their change for the
+        affected netting sets, netting sets without trades contribute zero */
+    void report(ore::data::Report& report) const;
+
+private:
+    QuantLib::ext::shared_ptr<Portfolio> basePortfolio_;
+    QuantLib::ext::shared_ptr<NPVCube> baseCube_;
+    QuantLib::ext::shared_ptr<PostProcess> basePostProcess_;
+    PostProcessBuilder postProcessBuilder_;
+
+    std::set<std::string> affectedNettingSets_;
+    QuantLib::ext::shared_ptr<Portfolio> whatIfPortfolio_;
+    QuantLib::ext::shared_ptr<NPVCube> whatIfCube_;
+    QuantLib::ext::shared_ptr<PostProcess> whatIfPostProcess_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -23,6 +23,12 @@
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
+#include <qle/utilities/profiler.hpp>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -44,7 +50,8 @@ NettedExposureCalculator::NettedExposureCalculator(
     const QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator, const bool fullInitialCollateralisation,
     const bool marginalAllocation, const Real marginalAllocationLimit,
     const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode)
+    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+    const Size nThreads)
     : portfolio_(portfolio), market_(market), cube_(cube), baseCurrency_(baseCurrency), configuration_(configuration),
       quantile_(quantile), calcType_(calcType), multiPath_(multiPath), nettingSetManager_(nettingSetManager),
       collateralBalances_(collateralBalances),
@@ -55,7 +62,7 @@ NettedExposureCalculator::NettedExposureCalculator(
       marginalAllocation_(marginalAllocation), marginalAllocationLimit_(marginalAllocationLimit),
       tradeExposureCube_(tradeExposureCube), allocatedEpeIndex_(allocatedEpeIndex),
       allocatedEneIndex_(allocatedEneIndex), flipViewXVA_(flipViewXVA), withMporStickyDate_(withMporStickyDate),
-      mporCashFlowMode_(mporCashFlowMode) {
+      mporCashFlowMode_(mporCashFlowMode), nThreads_(nThreads) {
 
     set<string> nettingSetIds;
     for (auto nettingSet : nettingSetDefaultValue) {
@@ -82,6 +89,7 @@ NettedExposureCalculator::NettedExposureCalculator(
 };
 
 void NettedExposureCalculator::build() {
+    QLE_PROFILE_ZONE("NettedExposureCalculator::build");
     LOG("Compute netting set exposure profiles");
 
     const Date today = market_->asofDate();
@@ -128,6 +136,9 @@ void NettedExposureCalculator::build() {
     vector<vector<Real>> averagePositiveAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
     vector<vector<Real>> averageNegativeAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
 
+    // Get the collateral account balance paths for all netting sets with an active CSA
+    map<string, vector<vector<Real>>> collateralBalances = collateralPaths(nettingSetValueToday, nettingSetMaturity);
+
     Size nettingSetCount = 0;
     for (auto n : nettingSetDefaultValue_) {
         string nettingSetId = n.first;
@@ -149,13 +160,9 @@ void NettedExposureCalculator::build() {
         vector<vector<Real>> nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_[nettingSetId];
 
         LOG("Aggregate exposure for netting set " << nettingSetId);
-        // Get the collateral account balance paths for the netting set.
-        // The pointer may remain empty if there is no CSA or if it is inactive.
-        QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral =
-            collateralPaths(nettingSetId,
-                            nettingSetValueToday[nettingSetId],
-                            nettingSetDefaultValue_[nettingSetId],
-                            nettingSetMaturity[nettingSetId]);
+        // The collateral balances by date and sample, the pointer remains empty if there is no CSA or if it is inactive.
+        auto c = collateralBalances.find(nettingSetId);
+        const vector<vector<Real>>* collateral = c == collateralBalances.end() ? nullptr : &c->second;
 
 	// Get the CSA index for Eonia Floor calculation below
         colva_[nettingSetId] = 0.0;
@@ -247,7 +254,7 @@ void NettedExposureCalculator::build() {
             for (Size k = 0; k < cube_->samples(); ++k) {
                 Real balance = 0.0;
                 if (collateral) {
-                    balance = collateral->at(k)->accountBalance(date);
+                    balance = (*collateral)[j][k];
                     if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
                         // Convert from CSACurrency to baseCurrency
                         double fxRate = scenarioData_->get(j, k, AggregationScenarioDataType::FXSpot,
@@ -430,18 +437,11 @@ void NettedExposureCalculator::build() {
     }
 }
 
-QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
-NettedExposureCalculator::collateralPaths(
-    const string& nettingSetId,
-    const Real& nettingSetValueToday,
-    const vector<vector<Real>>& nettingSetValue,
-    const Date& nettingSetMaturity) {
-
-    QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral;
+bool NettedExposureCalculator::collateralInputs(const string& nettingSetId, CollateralInputs& inputs) {
 
     if (!nettingSetManager_->has(nettingSetId) || !nettingSetManager_->get(nettingSetId)->activeCsaFlag()) {
         LOG("CSA missing or inactive for netting set " << nettingSetId);
-        return collateral;
+        return false;
     }
 
     // retrieve collateral balances object, if possible
@@ -451,7 +451,7 @@ NettedExposureCalculator::collateralPaths(
         LOG("got collateral balances for netting set " << nettingSetId);
     }
     
-    LOG("Build collateral account balance paths for netting set " << nettingSetId);
+    LOG("Collect collateral account inputs for netting set " << nettingSetId);
     QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
     string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
     Real csaFxRateToday = 1.0;
@@ -494,20 +494,74 @@ NettedExposureCalculator::collateralPaths(
         }
     }
 
-    collateral = CollateralExposureHelper::collateralBalancePaths(
-        netting,              // this netting set's definition
-        nettingSetValueToday, // today's netting set NPV
-        market_->asofDate(),  // original evaluation date
-        nettingSetValue,      // matrix of netting set values by date and sample
-        nettingSetMaturity,   // netting set's maximum maturity date
-        cube_->dates(),               // vector of future evaluation dates
-        csaFxRateToday,       // today's FX rate for CSA to base currency, possibly 1
-        csaScenFxRates,       // matrix of fx rates by date and sample, possibly 1
-        csaRateToday,         // today's collateral compounding rate in CSA currency
-        csaScenRates,         // matrix of CSA ccy short rates by date and sample
-        calcType_,
-        balance);             // initial collateral balances (VM, IM, IA) for the netting set
-    LOG("Collateral account balance paths for netting set " << nettingSetId << " done");
+    inputs.netting = netting;
+    inputs.balance = balance;
+    inputs.csaFxRateToday = csaFxRateToday;
+    inputs.csaRateToday = csaRateToday;
+    inputs.csaScenFxRates = std::move(csaScenFxRates);
+    inputs.csaScenRates = std::move(csaScenRates);
+    return true;
+}
+
+map<string, vector<vector<Real>>>
+NettedExposureCalculator::collateralPaths(const map<string, Real>& nettingSetValueToday,
+                                          const map<string, Date>& nettingSetMaturity) {
+
+    // The market and scenario data are read sequentially, the balance paths only depend on the collected inputs
+    // and are computed in parallel, one job per netting set
+    vector<pair<string, CollateralInputs>> jobs;
+    map<string, vector<vector<Real>>> collateral;
+    for (auto const& n : nettingSetDefaultValue_) {
+        CollateralInputs inputs;
+        if (collateralInputs(n.first, inputs)) {
+            jobs.push_back(std::make_pair(n.first, std::move(inputs)));
+            collateral[n.first] = vector<vector<Real>>();
+        }
+    }
+
+    Size nThreads = std::max<Size>(std::min<Size>(nThreads_, jobs.size()), 1);
+    LOG("Build collateral account balance paths for " << jobs.size() << " netting sets using " << nThreads
+                                                      << " threads");
+
+    std::atomic<Size> nextJob(0);
+    std::vector<std::exception_ptr> errors(nThreads);
+    auto worker = [this, &jobs, &collateral, &nettingSetValueToday, &nettingSetMaturity, &nextJob,
+                   &errors](const Size thread) {
+        try {
+            for (Size job = nextJob++; job < jobs.size(); job = nextJob++) {
+                const string& nettingSetId = jobs[job].first;
+                const CollateralInputs& inputs = jobs[job].second;
+                collateral.at(nettingSetId) = CollateralExposureHelper::collateralBalanceGrid(
+                    inputs.netting,                           // this netting set's definition
+                    nettingSetValueToday.at(nettingSetId),    // today's netting set NPV
+                    market_->asofDate(),                      // original evaluation date
+                    nettingSetDefaultValue_.at(nettingSetId), // matrix of netting set values by date and sample
+                    nettingSetMaturity.at(nettingSetId),      // netting set's maximum maturity date
+                    cube_->dates(),                           // vector of future evaluation dates
+                    inputs.csaFxRateToday, // today's FX rate for CSA to base currency, possibly 1
+                    inputs.csaScenFxRates, // matrix of fx rates by date and sample, possibly 1
+                    inputs.csaRateToday,   // today's collateral compounding rate in CSA currency
+                    inputs.csaScenRates,   // matrix of CSA ccy short rates by date and sample
+                    calcType_,
+                    inputs.balance); // initial collateral balances (VM, IM, IA) for the netting set
+                LOG("Collateral account balance paths for netting set " << nettingSetId << " done");
+            }
+        } catch (...) {
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (Size t = 1; t < nThreads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers)
+        w.join();
+
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
 
     return collateral;
 }
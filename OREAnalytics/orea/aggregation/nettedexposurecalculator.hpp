@@ -60,7 +60,8 @@ public:
         // Marginal Allocation
         const bool marginalAllocation, const Real marginalAllocationLimit,
         const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode);
+        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+        const Size nThreads = 1);
 
     virtual ~NettedExposureCalculator() {}
     const QuantLib::ext::shared_ptr<NPVCube>& exposureCube() { return exposureCube_; }
@@ -137,14 +138,24 @@ protected:
     map<string, Real> collateralFloor_;
     vector<Real> getMeanExposure(const string& tid, ExposureIndex index);
 
-    QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
-    collateralPaths(const string& nettingSetId,
-        const Real& nettingSetValueToday,
-        const vector<vector<Real>>& nettingSetValue,
-        const Date& nettingSetMaturity);
+    //! Inputs to the collateral balance simulation of a netting set, taken from the market and the scenario data
+    struct CollateralInputs {
+        QuantLib::ext::shared_ptr<NettingSetDefinition> netting;
+        QuantLib::ext::shared_ptr<CollateralBalance> balance;
+        Real csaFxRateToday, csaRateToday;
+        vector<vector<Real>> csaScenFxRates, csaScenRates;
+    };
+    //! Returns false if the CSA is missing or inactive for the netting set
+    bool collateralInputs(const string& nettingSetId, CollateralInputs& inputs);
+
+    /*! Collateral balances by cube date and sample for all netting sets with an active CSA, the netting sets are
+        processed in parallel */
+    map<string, vector<vector<Real>>> collateralPaths(const map<string, Real>& nettingSetValueToday,
+                                                      const map<string, Date>& nettingSetMaturity);
 
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    Size nThreads_;
 };
 
 } // namespace analytics
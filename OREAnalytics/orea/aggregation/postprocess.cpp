@@ -37,6 +37,7 @@
 
 #include <qle/math/nadarayawatson.hpp>
 #include <qle/math/stabilisedglls.hpp>
+#include <qle/utilities/profiler.hpp>
 
 #include <boost/range/adaptors.hpp>
 #include <boost/accumulators/accumulators.hpp>
@@ -67,7 +68,8 @@ PostProcess::PostProcess(
     const string& flipViewLendingCurvePostfix,
     const QuantLib::ext::shared_ptr<CreditSimulationParameters>& creditSimulationParameters,
     const std::vector<Real>& creditMigrationDistributionGrid, const std::vector<Size>& creditMigrationTimeSteps,
-    const Matrix& creditStateCorrelationMatrix, bool withMporStickyDate, MporCashFlowMode mporCashFlowMode)
+    const Matrix& creditStateCorrelationMatrix, bool withMporStickyDate, MporCashFlowMode mporCashFlowMode,
+    Size nThreads)
 : portfolio_(portfolio), nettingSetManager_(nettingSetManager), collateralBalances_(collateralBalances),
       market_(market), configuration_(configuration),
       cube_(cube), cptyCube_(cptyCube), scenarioData_(scenarioData), analytics_(analytics), baseCurrency_(baseCurrency),
@@ -81,7 +83,10 @@ PostProcess::PostProcess(
       creditSimulationParameters_(creditSimulationParameters),
       creditMigrationDistributionGrid_(creditMigrationDistributionGrid),
       creditMigrationTimeSteps_(creditMigrationTimeSteps), creditStateCorrelationMatrix_(creditStateCorrelationMatrix),
-      withMporStickyDate_(withMporStickyDate), mporCashFlowMode_(mporCashFlowMode) {
+      withMporStickyDate_(withMporStickyDate), mporCashFlowMode_(mporCashFlowMode),
+      nThreads_(nThreads) {
+
+    QLE_PROFILE_ZONE("PostProcess");
 
     QL_REQUIRE(cubeInterpretation_ != nullptr, "PostProcess: cubeInterpretation is not given.");
 
@@ -200,7 +205,7 @@ PostProcess::PostProcess(
         dimCalculator_, fullInitialCollateralisation_,
         allocationMethod == ExposureAllocator::AllocationMethod::Marginal, marginalAllocationLimit,
         exposureCalculator_->exposureCube(), ExposureCalculator::allocatedEPE, ExposureCalculator::allocatedENE,
-        analytics_["flipViewXVA"], withMporStickyDate_, mporCashFlowMode_);
+        analytics_["flipViewXVA"], withMporStickyDate_, mporCashFlowMode_, nThreads_);
     nettedExposureCalculator_->build();
 
     /********************************************************
@@ -324,7 +329,7 @@ PostProcess::PostProcess(
         creditMigrationCalculator_ = QuantLib::ext::make_shared<CreditMigrationCalculator>(
             portfolio_, creditSimulationParameters_, cube_, cubeInterpretation_,
             nettedExposureCalculator_->nettedCube(), scenarioData_, creditMigrationDistributionGrid_,
-            creditMigrationTimeSteps_, creditStateCorrelationMatrix_, baseCurrency_);
+            creditMigrationTimeSteps_, creditStateCorrelationMatrix_, baseCurrency_, nThreads_);
         creditMigrationCalculator_->build();
         creditMigrationUpperBucketBounds_ = creditMigrationCalculator_->upperBucketBounds();
         creditMigrationCdf_ = creditMigrationCalculator_->cdf();
@@ -169,7 +169,9 @@ public:
         //! If set to true, cash flows in the margin period of risk are ignored in the collateral modelling
         bool withMporStickyDate = false,
         //! Treatment of cash flows over the margin period of risk
-        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified);
+        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified,
+        //! Number of threads used to build the collateral balance paths of the netting sets
+        const QuantLib::Size nThreads = 1);
 
     void setDimCalculator(QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator> dimCalculator) {
         dimCalculator_ = dimCalculator;
@@ -381,6 +383,7 @@ protected:
     std::vector<std::vector<Real>> creditMigrationPdf_;
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    QuantLib::Size nThreads_;
 };
 
 } // namespace analytics
@@ -25,6 +25,8 @@
 
 #include <ql/errors.hpp>
 
+#include <qle/utilities/profiler.hpp>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -271,6 +273,7 @@ const Real& ValueAdjustmentCalculator::nettingSetMva(const std::string& nettingS
 }
 
 void ValueAdjustmentCalculator::build() {
+    QLE_PROFILE_ZONE("ValueAdjustmentCalculator::build");
     const auto& numDates = dates().size();
     const auto& today = asof();
 
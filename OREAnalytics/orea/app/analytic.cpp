@@ -30,6 +30,7 @@
 #include <orea/aggregation/dimregressioncalculator.hpp>
 
 #include <ored/marketdata/compositeloader.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/marketdata/bondspreadimply.hpp>
 #include <ored/portfolio/builders/currencyswap.hpp>
@@ -38,6 +39,8 @@
 #include <ored/portfolio/builders/swaption.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
 
+#include <qle/utilities/profiler.hpp>
+
 #include <boost/timer/timer.hpp>
 
 #include <iostream>
@@ -82,6 +85,7 @@ Analytic::Analytic(std::unique_ptr<Impl> impl,
 
 void Analytic::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
                            const std::set<std::string>& runTypes) {
+    QLE_PROFILE_ZONE_CAT("analytic " + label(), "analytic");
     MEM_LOG_USING_LEVEL(ORE_WARNING)
     if (impl_) {
         impl_->runAnalytic(loader, runTypes);
@@ -178,6 +182,7 @@ QuantLib::ext::shared_ptr<EngineFactory> Analytic::Impl::engineFactory() {
 void Analytic::buildMarket(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
                            const bool marketRequired) {
     LOG("Analytic::buildMarket called");    
+    QLE_PROFILE_ZONE("Analytic::buildMarket");
     cpu_timer mtimer;
 
     QL_REQUIRE(loader, "market data loader not set");
@@ -196,11 +201,58 @@ void Analytic::buildMarket(const QuantLib::ext::shared_ptr<ore::data::InMemoryLo
             // Check that the loader has quotes
             QL_REQUIRE(loader_->hasQuotes(configurations().asofDate),
                        "There are no quotes available for date " << configurations().asofDate);
-            // Build the market
-            market_ = QuantLib::ext::make_shared<TodaysMarket>(
-                configurations().asofDate, configurations().todaysMarketParams, loader_, configurations().curveConfig,
-                inputs()->continueOnError(), true, inputs()->lazyMarketBuilding(), inputs()->refDataManager(), false,
-                *inputs()->iborFallbackConfig());
+            // Take the market from the market cache or restore it from a snapshot, if they hold a market built
+            // from the same market inputs
+            QuantLib::ext::shared_ptr<Market> market;
+            const QuantLib::ext::shared_ptr<MarketCache>& marketCache = inputs()->marketCache();
+            std::string snapshotFile = inputs()->marketSnapshotFile(), marketKey;
+            bool useSnapshot = !snapshotFile.empty() &&
+                               MarketSnapshot::supported(configurations().asofDate,
+                                                         *configurations().todaysMarketParams,
+                                                         *inputs()->iborFallbackConfig());
+            auto buildTodaysMarket = [this]() -> QuantLib::ext::shared_ptr<Market> {
+                return QuantLib::ext::make_shared<TodaysMarket>(
+                    configurations().asofDate, configurations().todaysMarketParams, loader_,
+                    configurations().curveConfig, inputs()->continueOnError(), true, inputs()->lazyMarketBuilding(),
+                    inputs()->refDataManager(), false, *inputs()->iborFallbackConfig());
+            };
+            if (marketCache || useSnapshot)
+                marketKey = MarketSnapshot::key(configurations().asofDate, configurations().todaysMarketParams,
+                                                configurations().curveConfig, *loader_, inputs()->refDataManager(),
+                                                *inputs()->iborFallbackConfig(), inputs()->continueOnError(),
+                                                inputs()->lazyMarketBuilding());
+            if (marketCache) {
+                market = marketCache->get(marketKey);
+                if (market)
+                    LOG("Market taken from market cache");
+            }
+            if (!market && useSnapshot) {
+                if (MarketSnapshot::fileKey(snapshotFile) == marketKey) {
+                    try {
+                        market = QuantLib::ext::make_shared<MarketSnapshot>(snapshotFile, marketKey,
+                                                                            configurations().asofDate, loader_);
+                        LOG("Market restored from snapshot " << snapshotFile);
+                    } catch (const std::exception& e) {
+                        WLOG("Failed to restore market from snapshot " << snapshotFile << ": " << e.what());
+                    }
+                } else {
+                    LOG("Market snapshot " << snapshotFile << " does not exist or is outdated, build the market");
+                }
+                if (!market) {
+                    market = buildTodaysMarket();
+                    try {
+                        MarketSnapshot::write(snapshotFile, marketKey, configurations().asofDate, *market,
+                                              *configurations().todaysMarketParams);
+                    } catch (const std::exception& e) {
+                        WLOG("Failed to write market snapshot " << snapshotFile << ": " << e.what());
+                    }
+                }
+            }
+            if (!market)
+                market = buildTodaysMarket();
+            if (marketCache)
+                marketCache->add(marketKey, market);
+            market_ = market;
         } catch (const std::exception& e) {
             if (marketRequired)
                 QL_FAIL("Failed to build market: " << e.what());
@@ -220,6 +272,7 @@ void Analytic::marketCalibration(const QuantLib::ext::shared_ptr<MarketCalibrati
 }
 
 void Analytic::buildPortfolio() {
+    QLE_PROFILE_ZONE("Analytic::buildPortfolio");
     QuantLib::ext::shared_ptr<Portfolio> tmp = portfolio_ ? portfolio_ : inputs()->portfolio();
         
     // create a new empty portfolio
@@ -172,6 +172,7 @@ void PricingAnalyticImpl::runAnalytic(
                     inputs_->asof(), analytic()->configurations().simMarketParams,
                     *analytic()->configurations().sensiScenarioData, "",
                     true, typesDisabled);
+                parAnalysis->setSparseJacobian(inputs_->parSensiSparseJacobian());
                 if (inputs_->alignPillars()) {
                     LOG("Sensi analysis - align pillars (for the par conversion or because alignPillars is enabled)");
                     parAnalysis->alignPillars();
@@ -88,11 +88,20 @@ void StressTestAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::da
     std::string marketConfig = inputs_->marketConfig("pricing");
     std::vector<QuantLib::ext::shared_ptr<ore::data::EngineBuilder>> extraEngineBuilders;
     std::vector<QuantLib::ext::shared_ptr<ore::data::LegBuilder>> extraLegBuilders;
-    QuantLib::ext::shared_ptr<StressTest> stressTest = QuantLib::ext::make_shared<StressTest>(
-        analytic()->portfolio(), analytic()->market(), marketConfig, inputs_->pricingEngine(),
-        analytic()->configurations().simMarketParams, scenarioData, *analytic()->configurations().curveConfig,
-        *analytic()->configurations().todaysMarketParams, nullptr, inputs_->refDataManager(),
-        *inputs_->iborFallbackConfig(), inputs_->continueOnError());
+    QuantLib::ext::shared_ptr<StressTest> stressTest;
+    if (inputs_->nThreads() == 1) {
+        stressTest = QuantLib::ext::make_shared<StressTest>(
+            analytic()->portfolio(), analytic()->market(), marketConfig, inputs_->pricingEngine(),
+            analytic()->configurations().simMarketParams, scenarioData, *analytic()->configurations().curveConfig,
+            *analytic()->configurations().todaysMarketParams, nullptr, inputs_->refDataManager(),
+            *inputs_->iborFallbackConfig(), inputs_->continueOnError());
+    } else {
+        stressTest = QuantLib::ext::make_shared<StressTest>(
+            inputs_->nThreads(), inputs_->asof(), loader, analytic()->portfolio(), analytic()->market(), marketConfig,
+            inputs_->pricingEngine(), analytic()->configurations().simMarketParams, scenarioData,
+            analytic()->configurations().curveConfig, analytic()->configurations().todaysMarketParams, nullptr,
+            inputs_->refDataManager(), *inputs_->iborFallbackConfig(), inputs_->continueOnError());
+    }
     stressTest->writeReport(report, inputs_->stressThreshold());
     analytic()->reports()[label()]["stress"] = report;
     CONSOLE("OK");
@@ -86,7 +86,7 @@ void ParametricVarAnalyticImpl::setUpConfigurations() {
 void ParametricVarAnalyticImpl::setVarReport(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader) {
     LOG("Build trade to portfolio id mapping");
     ParametricVarCalculator::ParametricVarParams varParams(inputs_->varMethod(), inputs_->mcVarSamples(),
-                                                           inputs_->mcVarSeed());
+                                                           inputs_->mcVarSeed(), inputs_->nThreads());
 
     QuantLib::ext::shared_ptr<SensitivityStream> ss = sensiStream(loader);
 
@@ -18,6 +18,7 @@
 
 #include <orea/aggregation/dimflatcalculator.hpp>
 #include <orea/aggregation/dimregressioncalculator.hpp>
+#include <orea/aggregation/incrementalxva.hpp>
 #include <orea/app/analytics/xvaanalytic.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
@@ -36,6 +37,8 @@
 #include <ored/model/crossassetmodelbuilder.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
 
+#include <algorithm>
+
 using namespace ore::data;
 using namespace boost::filesystem;
 
@@ -237,7 +240,7 @@ void XvaAnalyticImpl::initCube(QuantLib::ext::shared_ptr<NPVCube>& cube, const s
                                                                         samples_, cubeDepth, 0.0f);
 }
 
-void XvaAnalyticImpl::initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
+void XvaAnalyticImpl::initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, bool ownCounterparties) {
 
     LOG("XVA: initClassicRun");
 
@@ -259,8 +262,10 @@ void XvaAnalyticImpl::initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>&
         nettingSetCube_ = nullptr;
         // Init counterparty cube for the storage of survival probabilities
         if (inputs_->storeSurvivalProbabilities()) {
-            // Use full list of counterparties, not just those in the sub-portflio
-            auto counterparties = inputs_->portfolio()->counterparties();
+            // Use full list of counterparties, not just those in the sub-portflio, unless the sub-portfolio may contain
+            // counterparties not in the full portfolio (what-if trades)
+            auto counterparties =
+                ownCounterparties ? portfolio->counterparties() : inputs_->portfolio()->counterparties();
             counterparties.insert(inputs_->dvaName());
             initCube(cptyCube_, counterparties, 1);
         } else {
@@ -272,7 +277,7 @@ void XvaAnalyticImpl::initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>&
 }
 
 QuantLib::ext::shared_ptr<Portfolio>
-XvaAnalyticImpl::classicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
+XvaAnalyticImpl::classicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, bool ownCounterparties) {
     LOG("XVA: classicRun");
 
     Size n = portfolio->size();
@@ -298,7 +303,7 @@ XvaAnalyticImpl::classicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfoli
     ProgressMessage(msg, 1, 1).log();
 
     // Allocate cubes for the sub-portfolio we are processing here
-    initClassicRun(classicPortfolio_);
+    initClassicRun(classicPortfolio_, ownCounterparties);
 
     // This is where the valuation work is done
     buildClassicCube(classicPortfolio_);
@@ -559,9 +564,7 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
     LOG("XVA: amcRun completed");
 }
 
-void XvaAnalyticImpl::runPostProcessor() {
-    QuantLib::ext::shared_ptr<NettingSetManager> netting = inputs_->nettingSetManager();
-    QuantLib::ext::shared_ptr<CollateralBalances> balances = inputs_->collateralBalances();
+map<string, bool> XvaAnalyticImpl::postProcessAnalytics() const {
     map<string, bool> analytics;
     analytics["exerciseNextBreak"] = inputs_->exerciseNextBreak();
     analytics["cva"] = inputs_->cvaAnalytic();
@@ -576,6 +579,48 @@ void XvaAnalyticImpl::runPostProcessor() {
     analytics["cvaSensi"] = inputs_->cvaSensi();
     analytics["flipViewXVA"] = inputs_->flipViewXVA();
     analytics["creditMigration"] = inputs_->creditMigrationAnalytic();
+    return analytics;
+}
+
+QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>
+XvaAnalyticImpl::buildDimCalculator(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                    const QuantLib::ext::shared_ptr<NPVCube>& cube) {
+    string baseCurrency = inputs_->xvaBaseCurrency();
+    string marketConfiguration = inputs_->marketConfig("simulation");
+
+    if (inputs_->dimModel() == "Regression") {
+        LOG("dim calculator not set, create RegressionDynamicInitialMarginCalculator");
+        std::map<std::string, Real> currentIM;
+        if (inputs_->collateralBalances()) {
+            for (auto const& [n, b] : inputs_->collateralBalances()->collateralBalances()) {
+                currentIM[n.nettingSetId()] =
+                    b->initialMargin() * (b->currency() == baseCurrency
+                                              ? 1.0
+                                              : analytic()
+                                                    ->market()
+                                                    ->fxRate(b->currency() + baseCurrency, marketConfiguration)
+                                                    ->value());
+            }
+        }
+        return QuantLib::ext::make_shared<RegressionDynamicInitialMarginCalculator>(
+            inputs_, portfolio, cube, cubeInterpreter_, *scenarioData_, inputs_->dimQuantile(),
+            inputs_->dimHorizonCalendarDays(), inputs_->dimRegressionOrder(), inputs_->dimRegressors(),
+            inputs_->dimLocalRegressionEvaluations(), inputs_->dimLocalRegressionBandwidth(), currentIM);
+    } else {
+        LOG("dim calculator not set, create FlatDynamicInitialMarginCalculator");
+        return QuantLib::ext::make_shared<FlatDynamicInitialMarginCalculator>(inputs_, portfolio, cube,
+                                                                              cubeInterpreter_, *scenarioData_);
+    }
+}
+
+QuantLib::ext::shared_ptr<PostProcess>
+XvaAnalyticImpl::buildPostProcessor(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                    const QuantLib::ext::shared_ptr<NPVCube>& cube,
+                                    const QuantLib::ext::shared_ptr<NPVCube>& cptyCube,
+                                    const QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator) {
+    QuantLib::ext::shared_ptr<NettingSetManager> netting = inputs_->nettingSetManager();
+    QuantLib::ext::shared_ptr<CollateralBalances> balances = inputs_->collateralBalances();
+    map<string, bool> analytics = postProcessAnalytics();
 
     string baseCurrency = inputs_->xvaBaseCurrency();
     string calculationType = inputs_->collateralCalculationType();
@@ -586,13 +631,6 @@ void XvaAnalyticImpl::runPostProcessor() {
     string fvaLendingCurve = inputs_->fvaLendingCurve();
     string fvaBorrowingCurve = inputs_->fvaBorrowingCurve();
 
-    Real dimQuantile = inputs_->dimQuantile();
-    Size dimHorizonCalendarDays = inputs_->dimHorizonCalendarDays();
-    Size dimRegressionOrder = inputs_->dimRegressionOrder();
-    vector<string> dimRegressors = inputs_->dimRegressors();
-    Size dimLocalRegressionEvaluations = inputs_->dimLocalRegressionEvaluations();
-    Real dimLocalRegressionBandwidth = inputs_->dimLocalRegressionBandwidth();
-
     Real kvaCapitalDiscountRate = inputs_->kvaCapitalDiscountRate();
     Real kvaAlpha = inputs_->kvaAlpha();
     Real kvaRegAdjustment = inputs_->kvaRegAdjustment();
@@ -606,34 +644,6 @@ void XvaAnalyticImpl::runPostProcessor() {
 
     bool fullInitialCollateralisation = inputs_->fullInitialCollateralisation();
 
-    checkConfigurations(analytic()->portfolio());
-
-    if (!dimCalculator_ && (analytics["mva"] || analytics["dim"])) {
-        if (inputs_->dimModel() == "Regression") {
-            LOG("dim calculator not set, create RegressionDynamicInitialMarginCalculator");
-            std::map<std::string, Real> currentIM;
-            if (inputs_->collateralBalances()) {
-                for (auto const& [n, b] : inputs_->collateralBalances()->collateralBalances()) {
-                    currentIM[n.nettingSetId()] =
-                        b->initialMargin() * (b->currency() == baseCurrency
-                                                  ? 1.0
-                                                  : analytic()
-                                                        ->market()
-                                                        ->fxRate(b->currency() + baseCurrency, marketConfiguration)
-                                                        ->value());
-                }
-            }
-            dimCalculator_ = QuantLib::ext::make_shared<RegressionDynamicInitialMarginCalculator>(
-                inputs_, analytic()->portfolio(), cube_, cubeInterpreter_, *scenarioData_, dimQuantile,
-                dimHorizonCalendarDays, dimRegressionOrder, dimRegressors, dimLocalRegressionEvaluations,
-                dimLocalRegressionBandwidth, currentIM);
-        } else {
-            LOG("dim calculator not set, create FlatDynamicInitialMarginCalculator");
-            dimCalculator_ = QuantLib::ext::make_shared<FlatDynamicInitialMarginCalculator>(
-                inputs_, analytic()->portfolio(), cube_, cubeInterpreter_, *scenarioData_);
-        }
-    }
-
     std::vector<Period> cvaSensiGrid = inputs_->cvaSensiGrid();
     Real cvaSensiShiftSize = inputs_->cvaSensiShiftSize();
 
@@ -644,18 +654,109 @@ void XvaAnalyticImpl::runPostProcessor() {
 
     auto market = offsetScenario_ == nullptr ? analytic()->market() : offsetSimMarket_;
 
-    postProcess_ = QuantLib::ext::make_shared<PostProcess>(
-        analytic()->portfolio(), netting, balances, market, marketConfiguration, cube_, *scenarioData_, analytics,
-        baseCurrency, allocationMethod, marginalAllocationLimit, quantile, calculationType, dvaName, fvaBorrowingCurve,
-        fvaLendingCurve, dimCalculator_, cubeInterpreter_, fullInitialCollateralisation, cvaSensiGrid,
+    return QuantLib::ext::make_shared<PostProcess>(
+        portfolio, netting, balances, market, marketConfiguration, cube, *scenarioData_, analytics, baseCurrency,
+        allocationMethod, marginalAllocationLimit, quantile, calculationType, dvaName, fvaBorrowingCurve,
+        fvaLendingCurve, dimCalculator, cubeInterpreter_, fullInitialCollateralisation, cvaSensiGrid,
         cvaSensiShiftSize, kvaCapitalDiscountRate, kvaAlpha, kvaRegAdjustment, kvaCapitalHurdle, kvaOurPdFloor,
-        kvaTheirPdFloor, kvaOurCvaRiskWeight, kvaTheirCvaRiskWeight, cptyCube_, flipViewBorrowingCurvePostfix,
+        kvaTheirPdFloor, kvaOurCvaRiskWeight, kvaTheirCvaRiskWeight, cptyCube, flipViewBorrowingCurvePostfix,
         flipViewLendingCurvePostfix, inputs_->creditSimulationParameters(), inputs_->creditMigrationDistributionGrid(),
         inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(),
-        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode());
+        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode(),
+        inputs_->nThreads());
+}
+
+void XvaAnalyticImpl::runPostProcessor() {
+    checkConfigurations(analytic()->portfolio());
+
+    map<string, bool> analytics = postProcessAnalytics();
+    if (!dimCalculator_ && (analytics["mva"] || analytics["dim"]))
+        dimCalculator_ = buildDimCalculator(analytic()->portfolio(), cube_);
+
+    postProcess_ = buildPostProcessor(analytic()->portfolio(), cube_, cptyCube_, dimCalculator_);
     LOG("post done");
 }
 
+void XvaAnalyticImpl::runWhatIf(const QuantLib::ext::shared_ptr<Portfolio>& addedTrades,
+                                const std::set<std::string>& removedTradeIds) {
+    LOG("XVA: runWhatIf");
+    QL_REQUIRE(postProcess_ && cube_ && !scenarioData_.empty(),
+               "XvaAnalytic::runWhatIf(): requires a previous exposure and xva run");
+
+    Settings::instance().evaluationDate() = inputs_->asof();
+
+    // price the added trades on the scenarios of the base run, the cubes of the base run are kept
+    auto added = QuantLib::ext::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    QuantLib::ext::shared_ptr<NPVCube> addedCube, addedCptyCube;
+    if (addedTrades && addedTrades->size() > 0) {
+        QL_REQUIRE(simMarket_, "XvaAnalytic::runWhatIf(): added trades require the simulation market of the base run");
+        if (inputs_->amc()) {
+            for (auto const& [tradeId, trade] : addedTrades->trades()) {
+                QL_REQUIRE(inputs_->amcTradeTypes().find(trade->tradeType()) == inputs_->amcTradeTypes().end(),
+                           "XvaAnalytic::runWhatIf(): added trade " << tradeId << " of type " << trade->tradeType()
+                                                                     << " would require an amc run, not supported");
+            }
+        }
+        auto baseCube = cube_, baseNettingSetCube = nettingSetCube_, baseCptyCube = cptyCube_;
+        auto baseClassicPortfolio = classicPortfolio_;
+        try {
+            added = classicRun(addedTrades, true);
+            if (added->size() > 0) {
+                addedCube = cube_;
+                addedCptyCube = cptyCube_;
+            }
+        } catch (...) {
+            cube_ = baseCube;
+            nettingSetCube_ = baseNettingSetCube;
+            cptyCube_ = baseCptyCube;
+            classicPortfolio_ = baseClassicPortfolio;
+            throw;
+        }
+        cube_ = baseCube;
+        nettingSetCube_ = baseNettingSetCube;
+        cptyCube_ = baseCptyCube;
+        classicPortfolio_ = baseClassicPortfolio;
+    }
+
+    auto postProcessBuilder = [this, addedCptyCube](const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                                    const QuantLib::ext::shared_ptr<NPVCube>& cube) {
+        QuantLib::ext::shared_ptr<NPVCube> cptyCube;
+        if (cptyCube_) {
+            std::vector<QuantLib::ext::shared_ptr<NPVCube>> cptyCubes = {cptyCube_};
+            if (addedCptyCube)
+                cptyCubes.push_back(addedCptyCube);
+            // the multi-threaded engine does not store the dva name, the ids must exist in one of the cubes
+            std::set<std::string> candidates = portfolio->counterparties(), ids;
+            candidates.insert(inputs_->dvaName());
+            for (auto const& id : candidates) {
+                if (std::any_of(cptyCubes.begin(), cptyCubes.end(),
+                                [&id](const QuantLib::ext::shared_ptr<NPVCube>& c) {
+                                    return c->idsAndIndexes().count(id) > 0;
+                                }))
+                    ids.insert(id);
+            }
+            cptyCube = QuantLib::ext::make_shared<JointNPVCube>(
+                cptyCubes, ids, false, [](Real a, Real x) { return std::max(a, x); }, 0.0);
+        }
+        map<string, bool> analytics = postProcessAnalytics();
+        QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator> dimCalculator;
+        if (analytics["mva"] || analytics["dim"])
+            dimCalculator = buildDimCalculator(portfolio, cube);
+        return buildPostProcessor(portfolio, cube, cptyCube, dimCalculator);
+    };
+
+    IncrementalXva incrementalXva(analytic()->portfolio(), cube_, postProcess_, postProcessBuilder);
+    incrementalXva.build(added, addedCube, removedTradeIds);
+    checkConfigurations(incrementalXva.whatIfPortfolio());
+    incrementalXva.run();
+
+    auto report = QuantLib::ext::make_shared<InMemoryReport>();
+    incrementalXva.report(*report);
+    analytic()->reports()["XVA"]["whatif"] = report;
+
+    LOG("XVA: runWhatIf completed");
+}
+
 void XvaAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
                                   const std::set<std::string>& runTypes) {
 
@@ -671,7 +772,7 @@ void XvaAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InM
             inputs_->xvaCgSensiScenarioData(), inputs_->refDataManager(), *inputs_->iborFallbackConfig(),
             inputs_->xvaCgBumpSensis(), inputs_->xvaCgUseExternalComputeDevice(),
             inputs_->xvaCgExternalDeviceCompatibilityMode(), inputs_->xvaCgUseDoublePrecisionForExternalCalculation(),
-            inputs_->xvaCgExternalComputeDevice(), true, true);
+            inputs_->xvaCgExternalComputeDevice(), true, true, "xva engine cg", inputs_->xvaCgGraphCacheDirectory());
 
         analytic()->reports()["XVA"]["xvacg-exposure"] = engine.exposureReport();
         if (inputs_->xvaCgSensiScenarioData())
@@ -46,6 +46,12 @@ public:
 
     void checkConfigurations(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
 
+    /*! What-if run on top of a completed exposure and xva run: the added trades are priced on the scenarios of the
+        run, removed trades are dropped and the post processor is rerun for the affected netting sets only, see
+        IncrementalXva. Added trades with the id of an existing trade replace the latter. Writes the whatif report. */
+    void runWhatIf(const QuantLib::ext::shared_ptr<Portfolio>& addedTrades,
+                   const std::set<std::string>& removedTradeIds);
+
 protected:
     QuantLib::ext::shared_ptr<ore::data::EngineFactory> engineFactory() override;
     void buildScenarioSimMarket();
@@ -55,9 +61,12 @@ protected:
     void initCubeDepth();
     void initCube(QuantLib::ext::shared_ptr<NPVCube>& cube, const std::set<std::string>& ids, Size cubeDepth);
 
-    void initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
+    /*! The counterparty cube covers the counterparties of the full portfolio and the dva name, or only those of the
+        given portfolio if ownCounterparties is true */
+    void initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, bool ownCounterparties = false);
     void buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
-    QuantLib::ext::shared_ptr<Portfolio> classicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
+    QuantLib::ext::shared_ptr<Portfolio> classicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                                    bool ownCounterparties = false);
 
     QuantLib::ext::shared_ptr<EngineFactory>
     amcEngineFactory(const QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel>& cam, const std::vector<Date>& grid);
@@ -65,6 +74,15 @@ protected:
     void amcRun(bool doClassicRun);
 
     void runPostProcessor();
+    std::map<std::string, bool> postProcessAnalytics() const;
+    QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>
+    buildDimCalculator(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                       const QuantLib::ext::shared_ptr<NPVCube>& cube);
+    QuantLib::ext::shared_ptr<PostProcess>
+    buildPostProcessor(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                       const QuantLib::ext::shared_ptr<NPVCube>& cube,
+                       const QuantLib::ext::shared_ptr<NPVCube>& cptyCube,
+                       const QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator);
 
     Matrix creditStateCorrelationMatrix() const;
 
@@ -34,6 +34,7 @@
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
 
+#include <ored/report/columnarreport.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
 
@@ -246,7 +247,8 @@ bool endsWith(const std::string& name, const std::string& suffix) {
 void AnalyticsManager::toFile(const ore::analytics::Analytic::analytic_reports& rpts, const std::string& outputPath,
                               const std::map<std::string, std::string>& reportNames, const char sep,
                               const bool commentCharacter, char quoteChar, const string& nullString,
-                              const std::set<std::string>& lowerHeaderReportNames) {
+                              const std::set<std::string>& lowerHeaderReportNames,
+                              const std::set<std::string>& binaryReportNames) {
     std::map<std::string, Size> hits = checkReportNames(rpts);    
     for (const auto& rep : rpts) {
         string analytic = rep.first;
@@ -266,14 +268,24 @@ void AnalyticsManager::toFile(const ore::analytics::Analytic::analytic_reports&
                 fileName = analytic + "_" + reportName + "_" + to_string(hits[fileName]);
             }
 
+            bool binary = binaryReportNames.find(reportName) != binaryReportNames.end();
+
             // attach a suffix only if it does not have one already
             string suffix = "";
-            if (!endsWith(fileName,".csv") && !endsWith(fileName, ".txt"))
+            if (binary && !endsWith(fileName, ".bin"))
+                suffix = ".bin";
+            else if (!binary && !endsWith(fileName,".csv") && !endsWith(fileName, ".txt"))
                 suffix = ".csv";
             std::string fullFileName = outputPath + "/" + fileName + suffix;
 
-            report->toFile(fullFileName, sep, commentCharacter, quoteChar, nullString,
-                           lowerHeaderReportNames.find(reportName) != lowerHeaderReportNames.end());
+            if (binary) {
+                ColumnarReport columnarReport;
+                report->writeTo(columnarReport);
+                columnarReport.toBinaryFile(fullFileName);
+            } else {
+                report->toFile(fullFileName, sep, commentCharacter, quoteChar, nullString,
+                               lowerHeaderReportNames.find(reportName) != lowerHeaderReportNames.end());
+            }
             LOG("report " << reportName << " written to " << fullFileName); 
         }
     }
@@ -461,6 +461,12 @@ void InputParameters::setHistoricalScenarioReader(const std::string& fileName) {
         fileName, QuantLib::ext::make_shared<SimpleScenarioFactory>(false));
 }
 
+void InputParameters::setBinaryReports(const std::string& s) {
+    // parse to set<string>
+    auto v = parseListOfValues(s);
+    binaryReports_ = std::set<std::string>(v.begin(), v.end());
+}
+
 void InputParameters::setAmcTradeTypes(const std::string& s) {
     // parse to set<string>
     auto v = parseListOfValues(s);
@@ -46,6 +46,7 @@
 #include <ored/configuration/curveconfigurations.hpp>
 #include <ored/configuration/iborfallbackconfig.hpp>
 #include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/marketcache.hpp>
 #include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/model/crossassetmodeldata.hpp>
 #include <ored/portfolio/collateralbalance.hpp>
@@ -75,6 +76,8 @@ public:
     void setBaseCurrency(const std::string& s) { baseCurrency_ = s; }
     void setContinueOnError(bool b) { continueOnError_ = b; }
     void setLazyMarketBuilding(bool b) { lazyMarketBuilding_ = b; }
+    void setMarketSnapshotFile(const std::string& s) { marketSnapshotFile_ = s; }
+    void setMarketCache(const QuantLib::ext::shared_ptr<ore::data::MarketCache>& c) { marketCache_ = c; }
     void setBuildFailedTrades(bool b) { buildFailedTrades_ = b; }
     void setObservationModel(const std::string& s) { observationModel_ = s; }
     void setImplyTodaysFixings(bool b) { implyTodaysFixings_ = b; }
@@ -106,6 +109,7 @@ public:
     void setCsvQuoteChar(const char& c){ csvQuoteChar_ = c; }
     void setCsvSeparator(const char& c) { csvSeparator_ = c; }
     void setCsvCommentCharacter(const char& c) { csvCommentCharacter_ = c; }
+    void setBinaryReports(const std::string& s); // parse to set<string>
     void setDryRun(bool b) { dryRun_ = b; }
     void setMporDays(Size s) { mporDays_ = s; }
     void setMporOverlappingPeriods(bool b) { mporOverlappingPeriods_ = b; }
@@ -130,6 +134,7 @@ public:
     void setParSensi(bool b) { parSensi_ = b; }
     void setOptimiseRiskFactors(bool b) { optimiseRiskFactors_ = b; }
     void setAlignPillars(bool b) { alignPillars_ = b; }
+    void setParSensiSparseJacobian(bool b) { parSensiSparseJacobian_ = b; }
     void setOutputJacobi(bool b) { outputJacobi_ = b; }
     void setUseSensiSpreadedTermStructures(bool b) { useSensiSpreadedTermStructures_ = b; }
     void setSensiThreshold(Real r) { sensiThreshold_ = r; }
@@ -198,6 +203,7 @@ public:
     void setXvaCgExternalDeviceCompatibilityMode(bool b) { xvaCgExternalDeviceCompatibilityMode_ = b; }
     void setXvaCgUseDoublePrecisionForExternalCalculation(bool b) { xvaCgUseDoublePrecisionForExternalCalculation_ = b; }
     void setXvaCgExternalComputeDevice(string s) { xvaCgExternalComputeDevice_ = std::move(s); }
+    void setXvaCgGraphCacheDirectory(const std::string& s) { xvaCgGraphCacheDirectory_ = s; }
     void setXvaCgSensiScenarioData(const std::string& xml);
     void setXvaCgSensiScenarioDataFromFile(const std::string& fileName);
     void setAmcTradeTypes(const std::string& s); // parse to set<string>
@@ -433,6 +439,8 @@ public:
     const std::string& resultCurrency() const { return resultCurrency_; }
     bool continueOnError() const { return continueOnError_; }
     bool lazyMarketBuilding() const { return lazyMarketBuilding_; }
+    const std::string& marketSnapshotFile() const { return marketSnapshotFile_; }
+    const QuantLib::ext::shared_ptr<ore::data::MarketCache>& marketCache() const { return marketCache_; }
     bool buildFailedTrades() const { return buildFailedTrades_; }
     const std::string& observationModel() const { return observationModel_; }
     bool implyTodaysFixings() const { return implyTodaysFixings_; }
@@ -462,6 +470,7 @@ public:
     char csvQuoteChar() const { return csvQuoteChar_; }
     char csvSeparator() const { return csvSeparator_; }
     char csvEscapeChar() const { return csvEscapeChar_; }
+    const std::set<std::string>& binaryReports() const { return binaryReports_; }
     bool dryRun() const { return dryRun_; }
     QuantLib::Size mporDays() const { return mporDays_; }
     QuantLib::Date mporDate();
@@ -501,6 +510,7 @@ public:
     bool parSensi() const { return parSensi_; };
     bool optimiseRiskFactors() const { return optimiseRiskFactors_; }
     bool alignPillars() const { return alignPillars_; };
+    bool parSensiSparseJacobian() const { return parSensiSparseJacobian_; }
     bool outputJacobi() const { return outputJacobi_; };
     bool useSensiSpreadedTermStructures() const { return useSensiSpreadedTermStructures_; }
     QuantLib::Real sensiThreshold() const { return sensiThreshold_; }
@@ -572,6 +582,7 @@ public:
         return xvaCgUseDoublePrecisionForExternalCalculation_;
     }
     const std::string& xvaCgExternalComputeDevice() const { return xvaCgExternalComputeDevice_; }
+    const std::string& xvaCgGraphCacheDirectory() const { return xvaCgGraphCacheDirectory_; }
     const QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData>& xvaCgSensiScenarioData() const { return xvaCgSensiScenarioData_; }
     const std::set<std::string>& amcTradeTypes() const { return amcTradeTypes_; }
     const std::string& exposureBaseCurrency() const { return exposureBaseCurrency_; }
@@ -797,6 +808,8 @@ protected:
     std::string resultCurrency_;
     bool continueOnError_ = true;
     bool lazyMarketBuilding_ = true;
+    std::string marketSnapshotFile_;
+    QuantLib::ext::shared_ptr<ore::data::MarketCache> marketCache_;
     bool buildFailedTrades_ = true;
     std::string observationModel_ = "None";
     bool implyTodaysFixings_ = false;
@@ -822,6 +835,7 @@ protected:
     char csvQuoteChar_ = '\0';
     char csvEscapeChar_ = '\\';
     std::string reportNaString_ = "#N/A";
+    std::set<std::string> binaryReports_;
     bool dryRun_ = false;
     QuantLib::Date mporDate_;
     QuantLib::Size mporDays_ = 10;
@@ -854,6 +868,7 @@ protected:
     bool optimiseRiskFactors_ = false;
     bool outputJacobi_ = false;
     bool alignPillars_ = false;
+    bool parSensiSparseJacobian_ = false;
     bool useSensiSpreadedTermStructures_ = true;
     QuantLib::Real sensiThreshold_ = 1e-6;
     bool sensiRecalibrateModels_ = true;
@@ -915,6 +930,7 @@ protected:
     bool xvaCgExternalDeviceCompatibilityMode_ = false;
     bool xvaCgUseDoublePrecisionForExternalCalculation_ = false;
     string xvaCgExternalComputeDevice_;
+    std::string xvaCgGraphCacheDirectory_;
     QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData> xvaCgSensiScenarioData_;
     std::set<std::string> amcTradeTypes_;
     std::string exposureBaseCurrency_ = "";
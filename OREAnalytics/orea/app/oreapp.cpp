@@ -36,9 +36,11 @@
 
 #include <ored/report/inmemoryreport.hpp>
 #include <ored/utilities/calendaradjustmentconfig.hpp>
+#include <ored/utilities/calendarparser.hpp>
 #include <ored/configuration/currencyconfig.hpp>
 #include <ored/portfolio/collateralbalance.hpp>
 
+#include <qle/utilities/profiler.hpp>
 #include <qle/version.hpp>
 
 
@@ -210,7 +212,8 @@ QuantLib::ext::shared_ptr<CSVLoader> OREApp::buildCsvLoader(const QuantLib::ext:
         WLOG("fixing cutoff date not set");
     }
     
-    auto loader = boost::make_shared<CSVLoader>(marketFiles, fixingFiles, dividendFiles, implyTodaysFixings, cutoff);
+    auto loader = boost::make_shared<CSVLoader>(marketFiles, fixingFiles, dividendFiles, implyTodaysFixings, cutoff,
+                                                inputs_ ? inputs_->nThreads() : 1);
 
     return loader;
 }
@@ -250,52 +253,8 @@ void OREApp::analytics() {
         // Run the requested analytics
         analyticsManager_->runAnalytics(mcr);
 
-        // Write reports to files in the results path
-        Analytic::analytic_reports reports = analyticsManager_->reports();
-        analyticsManager_->toFile(reports,
-                                  inputs_->resultsPath().string(), outputs_->fileNameMap(),
-                                  inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
-                                  inputs_->csvQuoteChar(), inputs_->reportNaString());
-
-        // Write npv cube(s)
-        for (auto a : analyticsManager_->npvCubes()) {
-            for (auto b : a.second) {
-                LOG("write npv cube " << b.first);
-                string reportName = b.first;
-                std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
-                LOG("write npv cube " << reportName << " to file " << fileName);
-                NPVCubeWithMetaData r;
-                r.cube = b.second;
-                if (b.first == "cube") {
-                    // store meta data together with npv cube
-                    r.scenarioGeneratorData = inputs_->scenarioGeneratorData();
-                    r.storeFlows = inputs_->storeFlows();
-                    r.storeCreditStateNPVs = inputs_->storeCreditStateNPVs();
-                }
-                saveCube(fileName, r);
-            }
-        }
-        
-        // Write market cube(s)
-        for (auto a : analyticsManager_->mktCubes()) {
-            for (auto b : a.second) {
-                string reportName = b.first;
-                std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
-                LOG("write market cube " << reportName << " to file " << fileName);
-                saveAggregationScenarioData(fileName, *b.second);
-            }
-        }
-
-        for (auto a: analyticsManager_->stressTests()){
-            for(auto b: a.second){
-                string reportName = b.first;
-                std::string fileName =
-                    inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "xml");
-                LOG("write converted stress test scenario definition " << reportName << " to file " << fileName);
-                b.second->toFile(fileName);
-            }
-        }
-
+        // Write reports and cubes to files in the results path
+        writeResults();
     }
     catch (std::exception& e) {
         ostringstream oss;
@@ -310,6 +269,54 @@ void OREApp::analytics() {
     LOG("ORE analytics done");
 }
 
+void OREApp::writeResults() {
+    // Write reports to files in the results path
+    Analytic::analytic_reports reports = analyticsManager_->reports();
+    analyticsManager_->toFile(reports,
+                              inputs_->resultsPath().string(), outputs_->fileNameMap(),
+                              inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
+                              inputs_->csvQuoteChar(), inputs_->reportNaString(), {}, inputs_->binaryReports());
+
+    // Write npv cube(s)
+    for (auto a : analyticsManager_->npvCubes()) {
+        for (auto b : a.second) {
+            LOG("write npv cube " << b.first);
+            string reportName = b.first;
+            std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
+            LOG("write npv cube " << reportName << " to file " << fileName);
+            NPVCubeWithMetaData r;
+            r.cube = b.second;
+            if (b.first == "cube") {
+                // store meta data together with npv cube
+                r.scenarioGeneratorData = inputs_->scenarioGeneratorData();
+                r.storeFlows = inputs_->storeFlows();
+                r.storeCreditStateNPVs = inputs_->storeCreditStateNPVs();
+            }
+            saveCube(fileName, r);
+        }
+    }
+    
+    // Write market cube(s)
+    for (auto a : analyticsManager_->mktCubes()) {
+        for (auto b : a.second) {
+            string reportName = b.first;
+            std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
+            LOG("write market cube " << reportName << " to file " << fileName);
+            saveAggregationScenarioData(fileName, *b.second);
+        }
+    }
+
+    for (auto a: analyticsManager_->stressTests()){
+        for(auto b: a.second){
+            string reportName = b.first;
+            std::string fileName =
+                inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "xml");
+            LOG("write converted stress test scenario definition " << reportName << " to file " << fileName);
+            b.second->toFile(fileName);
+        }
+    }
+}
+
 
 void OREApp::initFromParams() {
     if (console_) {
@@ -357,6 +364,26 @@ void OREApp::initFromParams() {
         if (!tmp.empty()) {
             structuredLogRotationSize_ = static_cast<Size>(parseInteger(tmp));
         }
+        tmp = params_->get("logging", "asyncLogging", false);
+        if (!tmp.empty()) {
+            asyncLogging_ = ore::data::parseBool(tmp);
+        }
+        tmp = params_->get("logging", "asyncLogBufferSize", false);
+        if (!tmp.empty()) {
+            asyncLogBufferSize_ = static_cast<Size>(parseInteger(tmp));
+        }
+        tmp = params_->get("logging", "profile", false);
+        if (!tmp.empty()) {
+            profile_ = ore::data::parseBool(tmp);
+        }
+        tmp = params_->get("logging", "profileFile", false);
+        if (!tmp.empty()) {
+            profileFile_ = tmp;
+        }
+        tmp = params_->get("logging", "profileSummaryFile", false);
+        if (!tmp.empty()) {
+            profileSummaryFile_ = tmp;
+        }
     }
     
     setupLog(outputPath_, logFile_, logMask_, logRootPath_, progressLogFile_, progressLogRotationSize_, progressLogToConsole_,
@@ -419,6 +446,9 @@ void OREApp::run() {
     }
 
     runTimer_.start();
+
+    if (profile_)
+        QuantExt::Profiler::instance().enable();
     
     try {
         structuredLogger_->clear();
@@ -426,11 +456,14 @@ void OREApp::run() {
     } catch (std::exception& e) {
         StructuredAnalyticsWarningMessage("OREApp::run()", "Error", e.what()).log();
         CONSOLE("Error: " << e.what());
+        writeProfile();
         return;
     }
 
     runTimer_.stop();
 
+    writeProfile();
+
     // cache the error messages because we reset the loggers 
     errorMessages_ = structuredLogger_->messages();
 
@@ -520,6 +553,21 @@ void OREApp::run(const std::vector<std::string>& marketData,
     LOG("ORE analytics done");
 }
 
+void OREApp::writeProfile() {
+    if (!profile_)
+        return;
+    QuantExt::Profiler::instance().disable();
+    try {
+        string traceFile = outputPath_ + "/" + profileFile_;
+        string summaryFile = outputPath_ + "/" + profileSummaryFile_;
+        LOG("Write profile trace to " << traceFile << " and summary to " << summaryFile);
+        QuantExt::Profiler::instance().writeChromeTrace(traceFile);
+        QuantExt::Profiler::instance().writeSummary(summaryFile);
+    } catch (const std::exception& e) {
+        WLOG("Could not write profile: " << e.what());
+    }
+}
+
 void OREApp::setupLog(const std::string& path, const std::string& file, Size mask,
                       const boost::filesystem::path& logRootPath, const std::string& progressLogFile,
                       Size progressLogRotationSize, bool progressLogToConsole, const std::string& structuredLogFile,
@@ -539,6 +587,7 @@ void OREApp::setupLog(const std::string& path, const std::string& file, Size mas
     Log::instance().setRootPath(oreRootPath);
     Log::instance().setMask(mask);
     Log::instance().switchOn();
+    Log::instance().setAsync(asyncLogging_, asyncLogBufferSize_);
 
     // Progress logger
     auto progressLogger = QuantLib::ext::make_shared<ProgressLogger>();
@@ -559,7 +608,10 @@ void OREApp::setupLog(const std::string& path, const std::string& file, Size mas
     ore::data::Log::instance().registerIndependentLogger(eventLogger);
 }
 
-void OREApp::closeLog() { Log::instance().removeAllLoggers(); }
+void OREApp::closeLog() {
+    Log::instance().setAsync(false);
+    Log::instance().removeAllLoggers();
+}
 
 std::string OREApp::version() { return std::string(OPEN_SOURCE_RISK_VERSION); }
 
@@ -589,6 +641,13 @@ void OREAppInputParameters::loadParameters() {
         WLOG("Calendar adjustments not found, using defaults");
     }
 
+    // Precompute the business days of the parsed calendars, after the calendar adjustments are applied
+    tmp = params_->get("setup", "businessDayCache", false);
+    if (tmp != "" && parseBool(tmp)) {
+        LOG("Enable business day cache for parsed calendars");
+        CalendarParser::instance().enableBusinessDayCache();
+    }
+
     // Load currency configs
     tmp = params_->get("setup", "currencyConfiguration", false);
     if (tmp != "") {
@@ -653,6 +712,10 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "")
         setLazyMarketBuilding(parseBool(tmp));
 
+    tmp = params_->get("setup", "marketSnapshotFile", false);
+    if (tmp != "")
+        setMarketSnapshotFile((filesystem::path(outputPath) / tmp).generic_string());
+
     tmp = params_->get("setup", "buildFailedTrades", false);
     if (tmp != "")
         setBuildFailedTrades(parseBool(tmp));
@@ -754,6 +817,10 @@ void OREAppInputParameters::loadParameters() {
         setCsvSeparator(tmp[0]);
     }
 
+    tmp = params_->get("setup", "binaryReports", false);
+    if (tmp != "")
+        setBinaryReports(tmp);
+
     /*************
      * NPV
      *************/
@@ -866,6 +933,10 @@ void OREAppInputParameters::loadParameters() {
         else
             setAlignPillars(parSensi());
 
+        tmp = params_->get("sensitivity", "parSensitivitySparseJacobian", false);
+        if (tmp != "")
+            setParSensiSparseJacobian(parseBool(tmp));
+
         tmp = params_->get("sensitivity", "marketConfigFile", false);
         if (tmp != "") {
             string file = (inputPath / tmp).generic_string();
@@ -1544,6 +1615,10 @@ void OREAppInputParameters::loadParameters() {
 
         setXvaCgExternalComputeDevice(params_->get("simulation", "xvaCgExternalComputeDevice", false));
 
+        tmp = params_->get("simulation", "xvaCgGraphCacheDirectory", false);
+        if (!tmp.empty())
+            setXvaCgGraphCacheDirectory((filesystem::path(outputPath) / tmp).generic_string());
+
         tmp = params_->get("simulation", "xvaCgBumpSensis", false);
 	if (!tmp.empty())
 	    setXvaCgBumpSensis(parseBool(tmp));
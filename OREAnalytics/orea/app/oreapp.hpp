@@ -89,6 +89,8 @@ protected:
     void buildInputParameters(QuantLib::ext::shared_ptr<InputParameters> inputs,
                               const QuantLib::ext::shared_ptr<Parameters>& params);
     QuantLib::ext::shared_ptr<CSVLoader> buildCsvLoader(const QuantLib::ext::shared_ptr<Parameters>& params);
+    //! write reports, npv cubes, market cubes and stress test scenarios of the last run to the results path
+    void writeResults();
     //! set up logging
     void setupLog(const std::string& path, const std::string& file, QuantLib::Size mask,
                   const boost::filesystem::path& logRootPath, const std::string& progressLogFile = "",
@@ -99,6 +101,8 @@ protected:
 
     void initFromParams();
     void initFromInputs();
+    //! write the profiler trace and summary to the output path, if profiling is enabled
+    void writeProfile();
       
     //! ORE Input parameters
     QuantLib::ext::shared_ptr<Parameters> params_;
@@ -120,6 +124,13 @@ protected:
     bool progressLogToConsole_ = false;
     string structuredLogFile_ = "";
     QuantLib::Size structuredLogRotationSize_ = 100 * 1024 * 1024;
+    bool asyncLogging_ = false;
+    QuantLib::Size asyncLogBufferSize_ = 4096;
+
+    //! Profiling
+    bool profile_ = false;
+    string profileFile_ = "profile.json";
+    string profileSummaryFile_ = "profile_summary.txt";
 
     // Cached error messages of a run
     std::vector<std::string> errorMessages_;
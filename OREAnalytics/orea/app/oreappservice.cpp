@@ -0,0 +1,223 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/app/analytics/xvaanalytic.hpp>
+#include <orea/app/cleanupsingletons.hpp>
+#include <orea/app/marketcalibrationreport.hpp>
+#include <orea/app/marketdatacsvloader.hpp>
+#include <orea/app/oreappservice.hpp>
+#include <orea/app/structuredanalyticswarning.hpp>
+
+#include <ored/report/inmemoryreport.hpp>
+#include <ored/utilities/parsers.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <boost/algorithm/string.hpp>
+
+#include <sstream>
+
+using namespace ore::data;
+using boost::timer::default_places;
+
+namespace ore {
+namespace analytics {
+
+OREAppService::OREAppService(QuantLib::ext::shared_ptr<Parameters> params, const QuantLib::Size marketCacheSize,
+                             const boost::filesystem::path& logRootPath)
+    // the console is reserved for the responses
+    : OREApp(params, false, logRootPath),
+      marketCache_(QuantLib::ext::make_shared<MarketCache>(marketCacheSize)) {}
+
+void OREAppService::run() { serve(std::cin, std::cout); }
+
+void OREAppService::serve(std::istream& in, std::ostream& out) {
+    std::string request;
+    while (!stopped_ && std::getline(in, request)) {
+        boost::algorithm::trim(request);
+        if (request.empty())
+            continue;
+        out << process(request) << std::endl;
+    }
+}
+
+std::string OREAppService::process(const std::string& request) {
+    std::vector<std::string> tokens;
+    boost::algorithm::split(tokens, request, boost::is_any_of(" \t"), boost::token_compress_on);
+    std::string command = tokens.front();
+    std::string argument = tokens.size() > 1 ? tokens[1] : std::string();
+    std::ostringstream response;
+    try {
+        QL_REQUIRE(tokens.size() <= (command == "whatIf" ? 3 : 2), "too many arguments");
+        if (command == "quit") {
+            stopped_ = true;
+            return "OK quit";
+        }
+        initialise();
+        LOG("OREAppService: process request '" << request << "'");
+        if (command == "run") {
+            runAnalytics(argument);
+            response << "OK run " << runTimer_.format(default_places, "%w");
+        } else if (command == "addTrades") {
+            QL_REQUIRE(!argument.empty(), "portfolio file required");
+            response << "OK addTrades " << addTrades(argument);
+        } else if (command == "removeTrades") {
+            QL_REQUIRE(!argument.empty(), "trade ids required");
+            response << "OK removeTrades " << removeTrades(argument);
+        } else if (command == "whatIf") {
+            QL_REQUIRE(!argument.empty(), "portfolio file or - required");
+            runWhatIf(argument, tokens.size() > 2 ? tokens[2] : std::string());
+            response << "OK whatIf " << runTimer_.format(default_places, "%w");
+        } else if (command == "reloadMarketData") {
+            reloadMarketData();
+            response << "OK reloadMarketData";
+        } else if (command == "clearCache") {
+            marketCache_->clear();
+            response << "OK clearCache";
+        } else if (command == "status") {
+            response << "OK status trades=" << inputs_->portfolio()->size() << " markets=" << marketCache_->size()
+                     << " hits=" << marketCache_->hits() << " misses=" << marketCache_->misses();
+        } else {
+            QL_FAIL("unknown request");
+        }
+    } catch (const std::exception& e) {
+        std::string msg = e.what();
+        boost::algorithm::replace_all(msg, "\n", " ");
+        ALOG("OREAppService: request '" << request << "' failed: " << msg);
+        return "ERROR " + command + " " + msg;
+    }
+    return response.str();
+}
+
+void OREAppService::initialise() {
+    if (initialised_)
+        return;
+
+    // Clean start, the singletons are left intact between requests
+    {
+        CleanUpThreadLocalSingletons cleanupThreadLocalSingletons;
+        CleanUpThreadGlobalSingletons cleanupThreadGloablSingletons;
+        CleanUpLogSingleton cleanupLogSingleton(true, true);
+    }
+
+    initFromParams();
+    defaultAnalytics_ = inputs_->analytics();
+    inputPath_ = params_->get("setup", "inputPath");
+    inputs_->setMarketCache(marketCache_);
+    if (!inputs_->portfolio())
+        inputs_->setPortfolio("<Portfolio/>");
+    csvLoader_ = buildCsvLoader(params_);
+
+    initialised_ = true;
+    LOG("OREAppService: initialised");
+}
+
+void OREAppService::runAnalytics(const std::string& analytics) {
+    runTimer_.start();
+    inputs_->setAnalytics(analytics.empty() ? boost::algorithm::join(defaultAnalytics_, ",") : analytics);
+
+    try {
+        LOG("ORE analytics starting");
+        structuredLogger_->clear();
+        Settings::instance().evaluationDate() = inputs_->asof();
+        GlobalPseudoCurrencyMarketParameters::instance().set(inputs_->pricingEngine()->globalParameters());
+        InstrumentConventions::instance().setConventions(inputs_->conventions());
+
+        // the market data files are not read again, see reloadMarketData()
+        auto loader = QuantLib::ext::make_shared<MarketDataCsvLoader>(inputs_, csvLoader_);
+        analyticsManager_ = QuantLib::ext::make_shared<AnalyticsManager>(inputs_, loader);
+        LOG("Requested analytics: " << to_string(inputs_->analytics()));
+
+        QuantLib::ext::shared_ptr<MarketCalibrationReportBase> mcr;
+        if (inputs_->outputTodaysMarketCalibration()) {
+            auto marketCalibrationReport = QuantLib::ext::make_shared<ore::data::InMemoryReport>();
+            mcr = QuantLib::ext::make_shared<MarketCalibrationReport>(string(), marketCalibrationReport);
+        }
+
+        analyticsManager_->runAnalytics(mcr);
+        writeResults();
+    } catch (const std::exception& e) {
+        runTimer_.stop();
+        StructuredAnalyticsWarningMessage("OREAppService::run()", "Error", e.what()).log();
+        throw;
+    }
+
+    runTimer_.stop();
+    errorMessages_ = structuredLogger_->messages();
+    LOG("ORE analytics done, market cache hits " << marketCache_->hits() << ", misses " << marketCache_->misses());
+}
+
+QuantLib::Size OREAppService::addTrades(const std::string& fileName) {
+    boost::filesystem::path file = inputPath_ / fileName;
+    Portfolio trades(inputs_->buildFailedTrades());
+    trades.fromFile(file.string());
+    for (const auto& [id, trade] : trades.trades()) {
+        if (inputs_->portfolio()->has(id))
+            inputs_->portfolio()->remove(id);
+        inputs_->portfolio()->add(trade);
+    }
+    LOG("OREAppService: added " << trades.size() << " trades from " << file);
+    return trades.size();
+}
+
+QuantLib::Size OREAppService::removeTrades(const std::string& tradeIds) {
+    QuantLib::Size n = 0;
+    for (auto const& id : parseListOfValues(tradeIds)) {
+        if (inputs_->portfolio()->remove(id))
+            ++n;
+        else
+            WLOG("OREAppService: trade " << id << " not in portfolio");
+    }
+    return n;
+}
+
+void OREAppService::runWhatIf(const std::string& fileName, const std::string& tradeIds) {
+    QL_REQUIRE(analyticsManager_, "whatIf requires a previous run of the XVA analytic");
+    const QuantLib::ext::shared_ptr<Analytic>& analytic = analyticsManager_->getAnalytic("XVA");
+    auto xva = dynamic_cast<XvaAnalyticImpl*>(analytic->impl().get());
+    QL_REQUIRE(xva, "whatIf requires a previous run of the XVA analytic");
+
+    runTimer_.start();
+    auto trades = QuantLib::ext::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    if (fileName != "-")
+        trades->fromFile((inputPath_ / fileName).string());
+    std::set<std::string> removed;
+    if (!tradeIds.empty()) {
+        for (auto const& id : parseListOfValues(tradeIds))
+            removed.insert(id);
+    }
+    xva->runWhatIf(trades, removed);
+
+    Analytic::analytic_reports reports;
+    reports["XVA"]["whatif"] = analytic->reports()["XVA"]["whatif"];
+    analyticsManager_->toFile(reports, inputs_->resultsPath().string(), outputs_->fileNameMap(),
+                              inputs_->csvSeparator(), inputs_->csvCommentCharacter(), inputs_->csvQuoteChar(),
+                              inputs_->reportNaString(), {}, inputs_->binaryReports());
+    runTimer_.stop();
+    LOG("OREAppService: what-if run with " << trades->size() << " added and " << removed.size()
+                                           << " removed trades done");
+}
+
+void OREAppService::reloadMarketData() {
+    csvLoader_ = buildCsvLoader(params_);
+    // markets built from the previous market data are not removed from the cache, they are keyed by their market
+    // data and only reused if the market data of a run is unchanged
+    LOG("OREAppService: market data reloaded");
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/oreappservice.hpp
+  \brief Resident ORE application processing a stream of requests
+  \ingroup app
+ */
+
+#pragma once
+
+#include <orea/app/oreapp.hpp>
+
+#include <ored/marketdata/marketcache.hpp>
+
+#include <iostream>
+
+namespace ore {
+namespace analytics {
+
+//! Resident ORE application processing a stream of requests
+/*! The service reads the ORE parameters, the configurations, the reference data, the portfolio and the market data
+    files once and keeps them resident. Requests are read line by line and answered with a single line starting with
+    OK or ERROR:
+
+    - run [analytics]: run the given comma separated analytics, or the analytics of the ORE parameters if none are
+      given, and write the results to the output path
+    - addTrades file: add the trades in the portfolio file (relative to the input path) to the portfolio, trades with
+      existing ids are replaced
+    - removeTrades ids: remove the trades with the given comma separated ids from the portfolio
+    - whatIf file [ids]: incremental what-if XVA on top of the last XVA run, the trades in the portfolio file (or none
+      if the file is given as -) are added and the trades with the given comma separated ids are removed, only the
+      whatif report is written, the resident portfolio is not changed
+    - reloadMarketData: read the market data, fixing and dividend files again
+    - clearCache: remove all resident markets
+    - status: the number of trades and resident markets
+    - quit: stop the service
+
+    Markets are kept in a MarketCache and are reused by subsequent runs as long as their market data, todays market
+    parameters and curve configurations are unchanged. Trades are rebuilt in each run, since the engine factories
+    depend on the analytic.
+
+    \ingroup app
+ */
+class OREAppService : public OREApp {
+public:
+    OREAppService(QuantLib::ext::shared_ptr<Parameters> params, const QuantLib::Size marketCacheSize = 4,
+                  const boost::filesystem::path& logRootPath = boost::filesystem::path());
+
+    //! Processes requests from std::cin and writes the responses to std::cout
+    void run() override;
+
+    //! Processes requests from the input stream and writes the responses to the output stream until quit is requested
+    void serve(std::istream& in, std::ostream& out);
+
+    //! Processes a single request and returns the response
+    std::string process(const std::string& request);
+
+    bool stopped() const { return stopped_; }
+    const QuantLib::ext::shared_ptr<ore::data::MarketCache>& marketCache() const { return marketCache_; }
+
+private:
+    void initialise();
+    void runAnalytics(const std::string& analytics);
+    QuantLib::Size addTrades(const std::string& fileName);
+    QuantLib::Size removeTrades(const std::string& tradeIds);
+    void runWhatIf(const std::string& fileName, const std::string& tradeIds);
+    void reloadMarketData();
+
+    bool initialised_ = false, stopped_ = false;
+    std::set<std::string> defaultAnalytics_;
+    boost::filesystem::path inputPath_;
+    QuantLib::ext::shared_ptr<ore::data::CSVLoader> csvLoader_;
+    QuantLib::ext::shared_ptr<ore::data::MarketCache> marketCache_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -42,7 +42,9 @@
 
 #include <boost/timer/timer.hpp>
 
+#include <condition_variable>
 #include <future>
+#include <mutex>
 
 using namespace ore::data;
 using namespace ore::analytics;
@@ -140,8 +142,20 @@ feeContributions(const Size j, const QuantLib::ext::shared_ptr<ScenarioGenerator
     return result;
 }
 
+// build the integral table of the model and the coefficient cache of its state process for the simulation grid
+QuantLib::ext::shared_ptr<const CrossAssetStateProcess::Cache>
+warmUpModelCaches(const QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel>& model,
+                  const QuantLib::ext::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd) {
+    const TimeGrid& grid = sgd->getGrid()->timeGrid();
+    model->warmUpCaches(std::vector<Time>(grid.begin(), grid.end()));
+    auto cache = model->stateProcess()->warmUpCache(grid);
+    model->stateProcess()->setCache(cache);
+    return cache;
+}
+
 void runCoreEngine(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
                    const QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel>& model,
+                   const QuantLib::ext::shared_ptr<const CrossAssetStateProcess::Cache>& processCache,
                    const QuantLib::ext::shared_ptr<ore::data::Market>& market,
                    const QuantLib::ext::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
                    const std::vector<string>& aggDataIndices, const std::vector<string>& aggDataCurrencies,
@@ -318,12 +332,11 @@ void runCoreEngine(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
         model->components(CrossAssetModel::AssetType::IR),
         std::vector<std::vector<Real>>(sgd->getGrid()->dates().size() + 1, std::vector<Real>(outputCube->samples())));
 
-    // set up cache for paths
+    // set up the state process, the model might be shared with other threads, so we use a process of our own that
+    // looks up the drift and diffusion coefficients in the cache built for the simulation grid
 
-    auto process = model->stateProcess();
-    if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
-        tmp->resetCache(sgd->getGrid()->timeGrid().size() - 1);
-    }
+    auto process = QuantLib::ext::make_shared<CrossAssetStateProcess>(model);
+    process->setCache(processCache);
     Size nStates = process->size();
     QL_REQUIRE(sgd->getGrid()->timeGrid().size() > 0, "AMCValuationEngine: empty time grid given");
     std::vector<Real> pathTimes(std::next(sgd->getGrid()->timeGrid().begin(), 1), sgd->getGrid()->timeGrid().end());
@@ -691,8 +704,9 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<Portfolio>& p
 
     try {
         // we can use the mt progress indicator here although we are running on a single thread
-        runCoreEngine(portfolio, model_, market_, scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_,
-                      aggDataNumberCreditStates_, asd_, outputCube,
+        runCoreEngine(portfolio, model_, warmUpModelCaches(model_, scenarioGeneratorData_), market_,
+                      scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_, aggDataNumberCreditStates_, asd_,
+                      outputCube,
                       QuantLib::ext::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators()));
     } catch (const std::exception& e) {
         QL_FAIL("Error during amc val engine run: " << e.what());
@@ -770,6 +784,51 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
             ? scenarioGeneratorData_->getGrid()->dates()
             : scenarioGeneratorData_->getGrid()->valuationDates();
 
+    // build the market and the cross asset model once, warm up the model caches on the simulation grid and share
+    // the model between all threads, which only read from it during the simulation
+
+    LOG("Build cross asset model shared by all threads...");
+    QuantLib::Settings::instance().evaluationDate() = today_;
+    auto buildMarket = [this](const QuantLib::ext::shared_ptr<ore::data::Loader>& loader) {
+        QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
+            today_, todaysMarketParams_, loader, curveConfigs_, true, true, true, referenceData_, false,
+            iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
+        QuantLib::ext::shared_ptr<ore::data::Market> market = initMarket;
+        if (offsetScenario_ != nullptr) {
+            QL_REQUIRE(simMarketParams_ != nullptr,
+                       "AMC Valuation Engine can not build simMarket without simMarketParam");
+            bool continueOnError = true;
+            std::string configuration = configurationFinalModel_;
+            market = QuantLib::ext::make_shared<ScenarioSimMarket>(
+                initMarket, simMarketParams_, QuantLib::ext::make_shared<FixingManager>(today_), configuration,
+                *curveConfigs_, *todaysMarketParams_, continueOnError, true, true, false, iborFallbackConfig_, false,
+                offsetScenario_);
+        }
+        return market;
+    };
+    auto camMarket = buildMarket(QuantLib::ext::make_shared<ore::data::ClonedLoader>(today_, loader_));
+    ore::data::CrossAssetModelBuilder modelBuilder(
+        camMarket, crossAssetModelData_, configurationLgmCalibration_, configurationFxCalibration_,
+        configurationEqCalibration_, configurationInfCalibration_, configurationCrCalibration_,
+        configurationFinalModel_, false, true, "", SalvagingAlgorithm::None, "xva/amc cam building");
+    QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> cam = *modelBuilder.model();
+    auto processCache = warmUpModelCaches(cam, scenarioGeneratorData_);
+
+    // The engines built in the threads register with the shared model components, and building them might update
+    // these. Building and destroying the portfolios is therefore serialised, and the simulations only start once all
+    // threads have built their portfolios.
+
+    std::mutex buildMutex;
+    std::condition_variable buildDone;
+    Size pendingBuilds = eff_nThreads;
+    auto finishBuild = [&buildMutex, &buildDone, &pendingBuilds]() {
+        std::unique_lock<std::mutex> lock(buildMutex);
+        if (--pendingBuilds == 0)
+            buildDone.notify_all();
+        else
+            buildDone.wait(lock, [&pendingBuilds]() { return pendingBuilds == 0; });
+    };
+
     // build progress indicator consolidating the results from the threads
 
     auto progressIndicator =
@@ -793,7 +852,8 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
 
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, &portfoliosAsString, &loaders, &simDates, &progressIndicator](int id) -> resultType {
+        auto job = [this, obsMode, &portfoliosAsString, &loaders, &simDates, &progressIndicator, &buildMarket, &cam,
+                    &processCache, &buildMutex, &finishBuild](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
@@ -802,39 +862,21 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
             LOG("Start thread " << id);
 
             int rc;
+            bool built = false;
+            QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio;
+            QuantLib::ext::shared_ptr<EngineFactory> engineFactory;
 
             try {
 
                 // build todays market using cloned market data
 
-                QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
-                    today_, todaysMarketParams_, loaders[id], curveConfigs_, true, true, true, referenceData_, false,
-                    iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
-
-                QuantLib::ext::shared_ptr<ore::data::Market> market = initMarket;
-
-                if(offsetScenario_ != nullptr){
-                    QL_REQUIRE(simMarketParams_ != nullptr,
-                               "AMC Valuation Engine can not build simMarket without simMarketParam");
-                    bool continueOnError = true;
-                    std::string configuration = configurationFinalModel_;
-                    market = QuantLib::ext::make_shared<ScenarioSimMarket>(
-                        initMarket, simMarketParams_, QuantLib::ext::make_shared<FixingManager>(today_), configuration,
-                        *curveConfigs_, *todaysMarketParams_, continueOnError, true, true, false, iborFallbackConfig_,
-                        false, offsetScenario_);
-                }
-
-                // build cam
-                ore::data::CrossAssetModelBuilder modelBuilder(
-                    market, crossAssetModelData_, configurationLgmCalibration_, configurationFxCalibration_,
-                    configurationEqCalibration_, configurationInfCalibration_, configurationCrCalibration_,
-                    configurationFinalModel_, false, true, "", SalvagingAlgorithm::None, "xva/amc cam building");
+                auto market = buildMarket(loaders[id]);
 
-                auto cam = *modelBuilder.model();
+                // build portfolio against init market using the shared cam
 
-                // build portfolio against init market
+                std::unique_lock<std::mutex> buildLock(buildMutex);
 
-                auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
+                portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
                 portfolio->fromXMLString(portfoliosAsString[id]);
 
                 QuantLib::ext::shared_ptr<EngineData> edCopy = QuantLib::ext::make_shared<EngineData>(*engineData_);
@@ -844,16 +886,21 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
                                                           {MarketContext::fxCalibration, configurationFxCalibration_},
                                                           {MarketContext::pricing, configurationFinalModel_}};
 
-                auto engineFactory = QuantLib::ext::make_shared<EngineFactory>(
+                engineFactory = QuantLib::ext::make_shared<EngineFactory>(
                     edCopy, market, configurations, referenceData_, iborFallbackConfig_,
                     EngineBuilderFactory::instance().generateAmcEngineBuilders(cam, simDates), true);
 
                 portfolio->build(engineFactory, "amc-val-engine", true);
 
+                buildLock.unlock();
+                built = true;
+                finishBuild();
+
                 // run core engine code (asd is written for thread id 0 only)
 
-                runCoreEngine(portfolio, cam, market, scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_,
-                              aggDataNumberCreditStates_, id == 0 ? asd_ : nullptr, miniCubes_[id], progressIndicator);
+                runCoreEngine(portfolio, cam, processCache, market, scenarioGeneratorData_, aggDataIndices_,
+                              aggDataCurrencies_, aggDataNumberCreditStates_, id == 0 ? asd_ : nullptr,
+                              miniCubes_[id], progressIndicator);
 
                 // return code 0 = ok
 
@@ -871,6 +918,17 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
                 rc = 1;
             }
 
+            if (!built)
+                finishBuild();
+
+            // release the portfolio and engines, i.e. deregister them from the shared model, one thread at a time
+
+            {
+                std::lock_guard<std::mutex> lock(buildMutex);
+                portfolio.reset();
+                engineFactory.reset();
+            }
+
             // exit
 
             return rc;
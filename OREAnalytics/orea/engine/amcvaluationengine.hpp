@@ -47,7 +47,8 @@ public:
                        const QuantLib::ext::shared_ptr<ore::data::Market>& market, const std::vector<string>& aggDataIndices,
                        const std::vector<string>& aggDataCurrencies, const Size aggDataNumberCreditStates);
 
-    //! Constructor for multi threaded runs
+    /*! Constructor for multi threaded runs, the cross asset model is built and calibrated once and shared by all
+        threads, each thread builds its own market and part of the portfolio */
     AMCValuationEngine(
         const QuantLib::Size nThreads, const QuantLib::Date& today, const QuantLib::Size nSamples,
         const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
@@ -39,8 +39,20 @@ using namespace std;
 namespace ore {
 namespace analytics {   
 
-ParametricVarCalculator::ParametricVarParams::ParametricVarParams(const string& m, Size samp, Size sd)
-    : method(parseParametricVarMethod(m)), samples(samp), seed(sd) {}
+ParametricVarCalculator::ParametricVarParams::ParametricVarParams(const string& m, Size samp, Size sd, Size thr)
+    : method(parseParametricVarMethod(m)), samples(samp), seed(sd), threads(thr) {}
+
+namespace {
+Real monteCarloVar(const ParametricVarCalculator::ParametricVarParams& params, const Matrix& omega, const Array& delta,
+                   const Matrix& gamma, const Real confidence, const QuantExt::CovarianceSalvage& salvage) {
+    if (params.threads > 1)
+        return QuantExt::deltaGammaVarMcMt<PseudoRandom>(omega, delta, gamma, confidence, params.samples, params.seed,
+                                                         params.threads, salvage);
+    else
+        return QuantExt::deltaGammaVarMc<PseudoRandom>(omega, delta, gamma, confidence, params.samples, params.seed,
+                                                       salvage);
+}
+} // namespace
 
 ParametricVarCalculator::ParametricVarParams::Method parseParametricVarMethod(const string& s) {
     static map<string, ParametricVarCalculator::ParametricVarParams::Method> m = {
@@ -116,8 +128,7 @@ Real ParametricVarCalculator::var(Real confidence, const bool isCall,
                     "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
         QL_REQUIRE(parametricVarParams_.seed != Null<Size>(),
                     "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
-        return QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence, parametricVarParams_.samples,
-                                                        parametricVarParams_.seed, *covarianceSalvage_);
+        return monteCarloVar(parametricVarParams_, omega_, delta, gamma, confidence, *covarianceSalvage_);
     } else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::CornishFisher)
         return QuantExt::deltaGammaVarCornishFisher(omega_, delta, gamma, confidence, *covarianceSalvage_);
     else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Saddlepoint) {
@@ -127,8 +138,7 @@ Real ParametricVarCalculator::var(Real confidence, const bool isCall,
         } catch (const std::exception& e) {
             ALOG("Saddlepoint VaR computation exited with an error: " << e.what()
                                                                         << ", falling back on Monte-Carlo");
-            res = QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence,
-                parametricVarParams_.samples, parametricVarParams_.seed, *covarianceSalvage_);
+            res = monteCarloVar(parametricVarParams_, omega_, delta, gamma, confidence, *covarianceSalvage_);
         }        
         return res;
     } else
@@ -300,17 +300,28 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
         parKeysCheck.insert(p.first);
     }
 
-    for (Size i = 1; i < scenarioGenerator->samples(); ++i) {
+    // latest relevant dates of the par helpers, used to skip entries of the jacobian that are zero by construction
+    std::map<RiskFactorKey, Date> parHelperLatestDates;
+    Size skippedRepricings = 0;
+    if (sparseJacobian_) {
+        for (auto const& p : instruments_.parHelpers_)
+            parHelperLatestDates[p.first] = latestRelevantDate(p.second);
+    }
 
-        simMarket->update(asof_);
+    for (Size i = 1; i < scenarioGenerator->samples(); ++i) {
 
         // use single "UP" shift scenarios only, use only scenarios relevant for par instruments,
         // use relevant scenarios only, if specified
         // ignore risk factor types that have been disabled
+        // skipped scenarios are not applied to the sim market, we only advance the scenario generator
         if (desc[i].type() != ShiftScenarioGenerator::ScenarioDescription::Type::Up ||
             !isParType(desc[i].key1().keytype) || typesDisabled_.count(desc[i].key1().keytype) == 1 ||
-            !(relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc[i].key1()) != relevantRiskFactors_.end()))
+            !(relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc[i].key1()) != relevantRiskFactors_.end())) {
+            scenarioGenerator->next(asof_);
             continue;
+        }
+
+        simMarket->update(asof_);
 
         // Since we are not using ValuationEngine we need to manually perform the trade updates here
         // TODO - explore means of utilising valuation engine
@@ -340,6 +351,10 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
             RiskFactorKey::KeyType::SurvivalProbability, RiskFactorKey::KeyType::DiscountCurve,
             RiskFactorKey::KeyType::YieldCurve, RiskFactorKey::KeyType::IndexCurve};
 
+        Date unchanged = sparseJacobian_ ? unchangedUntil(desc[i].key1(), *scenarioGenerator->scenarios()[i],
+                                                          *scenarioGenerator->baseScenario())
+                                         : Date();
+
         for (auto const& p : instruments_.parHelpers_) {
 
             // skip if par helper has no sensi to zero risk factor (except the special treatment below kicks in)
@@ -350,6 +365,13 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
                 continue;
             }
 
+            // skip if the par helper only depends on the part of the curve that is not changed by the shift
+
+            if (unchanged != Date() && p.first != desc[i].key1() && parHelperLatestDates.at(p.first) <= unchanged) {
+                ++skippedRepricings;
+                continue;
+            }
+
             // compute fair and base quotes
 
             Real fair = impliedQuote(p.second);
@@ -476,9 +498,39 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
              << ", zero value = " << (zeroFactorValue == Null<Real>() ? "na" : std::to_string(zeroFactorValue)));
     }
 
+    if (sparseJacobian_)
+        LOG("Skipped " << skippedRepricings << " par helper repricings using the sparsity of the jacobian");
+
     LOG("Computing par rate and flat vol sensitivities done");
 } // compute par instrument sensis
 
+Date ParSensitivityAnalysis::unchangedUntil(const RiskFactorKey& key, const Scenario& scenario,
+                                            const Scenario& baseScenario) const {
+    // the simulation market curves interpolate locally between their nodes, so that the curve is unchanged up to
+    // the node preceding the first changed node
+    const vector<Period>* tenors;
+    switch (key.keytype) {
+    case RiskFactorKey::KeyType::DiscountCurve:
+    case RiskFactorKey::KeyType::YieldCurve:
+    case RiskFactorKey::KeyType::IndexCurve:
+        tenors = &simMarketParams_->yieldCurveTenors(key.name);
+        break;
+    case RiskFactorKey::KeyType::SurvivalProbability:
+        tenors = &simMarketParams_->defaultTenors(key.name);
+        break;
+    default:
+        return Date();
+    }
+    for (Size j = 0; j < tenors->size(); ++j) {
+        RiskFactorKey k(key.keytype, key.name, j);
+        if (!scenario.has(k) || !baseScenario.has(k))
+            return Date();
+        if (!close_enough(scenario.get(k), baseScenario.get(k)))
+            return j == 0 ? Date() : asof_ + (*tenors)[j - 1];
+    }
+    return Date();
+}
+
 void ParSensitivityAnalysis::alignPillars() {
     LOG("Align simulation market pillars to actual latest relevant dates of par instruments");
     // If any of the yield curve types are still active, align the pillars.
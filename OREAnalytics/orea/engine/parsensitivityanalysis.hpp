@@ -99,6 +99,15 @@ public:
 
     const ParSensitivityInstrumentBuilder::Instruments& parInstruments() const { return instruments_; }
 
+    /*! If enabled, the structure of the par / zero jacobian implied by the curve construction is used to skip
+        the repricing of par instruments which can not be sensitive to a zero risk factor shift: the simulation
+        market curves use local interpolation schemes, so a shift of a curve node leaves the curve unchanged up to
+        the preceding node, and a par instrument that does not depend on the curve beyond this date has a zero
+        sensitivity to the shift by construction.
+    */
+    void setSparseJacobian(bool b) { sparseJacobian_ = b; }
+    bool sparseJacobian() const { return sparseJacobian_; }
+
 private:
     //! Augment relevant risk factors
     void augmentRelevantRiskFactors();
@@ -107,6 +116,11 @@ private:
     void populateShiftSizes(const ore::analytics::RiskFactorKey& key, QuantLib::Real parRate,
                             const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
 
+    /*! Returns the latest date up to which the curve of the given \p key is not changed by the \p scenario, or a
+        null date if this can not be determined or the curve is changed from the first node on */
+    QuantLib::Date unchangedUntil(const ore::analytics::RiskFactorKey& key, const ore::analytics::Scenario& scenario,
+                                  const ore::analytics::Scenario& baseScenario) const;
+
     //! As of date for the calculation of the par sensitivities
     QuantLib::Date asof_;
     //! Simulation market parameters
@@ -120,6 +134,7 @@ private:
     std::string marketConfiguration_;
     bool continueOnError_;
     std::set<ore::analytics::RiskFactorKey> relevantRiskFactors_;
+    bool sparseJacobian_ = false;
 
     static std::set<ore::analytics::RiskFactorKey::KeyType> parTypes_;
 
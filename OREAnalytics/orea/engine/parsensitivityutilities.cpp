@@ -19,6 +19,7 @@
 #include <orea/engine/parsensitivityinstrumentbuilder.hpp>
 #include <orea/engine/parsensitivityutilities.hpp>
 #include <ored/utilities/log.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
 #include <ql/instruments/creditdefaultswap.hpp>
 #include <ql/instruments/forwardrateagreement.hpp>
 #include <ql/instruments/makecapfloor.hpp>
@@ -272,6 +273,35 @@ Real impliedQuote(const QuantLib::ext::shared_ptr<Instrument>& i) {
                                                                                 << ")");
 }
 
+Date latestRelevantDate(const QuantLib::ext::shared_ptr<Instrument>& i) {
+    try {
+        if (auto s = QuantLib::ext::dynamic_pointer_cast<Swap>(i)) {
+            Date d = Date::minDate();
+            for (Size j = 0; j < s->numberOfLegs(); ++j) {
+                for (auto const& c : s->leg(j)) {
+                    d = std::max(d, c->date());
+                    if (auto ibor = QuantLib::ext::dynamic_pointer_cast<IborCoupon>(c)) {
+                        d = std::max(d, ibor->fixingEndDate());
+                    } else if (auto f = QuantLib::ext::dynamic_pointer_cast<FloatingRateCoupon>(c)) {
+                        // conservative estimate for coupons with several fixings (overnight, sub periods)
+                        d = std::max(d, f->index()->fixingCalendar().advance(f->accrualEndDate(), f->index()->tenor()));
+                    }
+                }
+            }
+            return d;
+        }
+        if (auto dep = QuantLib::ext::dynamic_pointer_cast<Deposit>(i))
+            return dep->maturityDate();
+        if (auto fxFwd = QuantLib::ext::dynamic_pointer_cast<FxForward>(i))
+            return fxFwd->maturityDate();
+        if (auto cds = QuantLib::ext::dynamic_pointer_cast<QuantExt::CreditDefaultSwap>(i))
+            return cds->coupons().empty() ? Date::maxDate() : cds->coupons().back()->date();
+    } catch (const std::exception& e) {
+        DLOG("latestRelevantDate(): could not determine latest relevant date: " << e.what());
+    }
+    return Date::maxDate();
+}
+
 Volatility impliedVolatility(const QuantLib::CapFloor& cap, Real targetValue, const Handle<YieldTermStructure>& d,
                              Volatility guess, VolatilityType type, Real displacement) {
     return impliedVolatilityWrapper(cap, targetValue, d, guess, type, displacement, Handle<Index>());
@@ -34,6 +34,10 @@ namespace analytics {
 //! Computes the implied quote
 Real impliedQuote(const QuantLib::ext::shared_ptr<QuantLib::Instrument>& i);
 
+/*! Returns the latest date on which the implied quote of the par instrument depends on the market curves, or
+    Date::maxDate() if this can not be determined for the instrument type */
+QuantLib::Date latestRelevantDate(const QuantLib::ext::shared_ptr<QuantLib::Instrument>& i);
+
 //! true if key type and name are equal, do not care about the index though
 bool riskFactorKeysAreSimilar(const ore::analytics::RiskFactorKey& x, const ore::analytics::RiskFactorKey& y);
 
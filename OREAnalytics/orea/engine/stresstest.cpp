@@ -17,6 +17,7 @@
 */
 
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/stresstest.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
@@ -28,6 +29,9 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -52,12 +56,8 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
         market, simMarketData, marketConfiguration, curveConfigs, todaysMarketParams, continueOnError,
         stressData->useSpreadedTermStructures(), false, false, iborFallbackConfig, true);
 
-    DLOG("Build Stress Scenario Generator");
-    Date asof = market->asofDate();
-    QuantLib::ext::shared_ptr<Scenario> baseScenario = simMarket->baseScenario();
-    scenarioFactory = scenarioFactory ? scenarioFactory : QuantLib::ext::make_shared<CloneScenarioFactory>(baseScenario);
-    QuantLib::ext::shared_ptr<StressScenarioGenerator> scenarioGenerator = QuantLib::ext::make_shared<StressScenarioGenerator>(
-        stressData, baseScenario, simMarketData, simMarket, scenarioFactory, simMarket->baseScenarioAbsolute());
+    QuantLib::ext::shared_ptr<StressScenarioGenerator> scenarioGenerator =
+        buildScenarioGenerator(simMarket, simMarketData, stressData, scenarioFactory);
     simMarket->scenarioGenerator() = scenarioGenerator;
 
     DLOG("Build Engine Factory");
@@ -73,6 +73,7 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
     portfolio->build(factory, "stress analysis");
 
     DLOG("Build the cube object to store sensitivities");
+    Date asof = market->asofDate();
     QuantLib::ext::shared_ptr<NPVCube> cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
         asof, portfolio->ids(), vector<Date>(1, asof), scenarioGenerator->samples());
 
@@ -82,37 +83,138 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
     calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData->baseCcy()));
     ValuationEngine engine(asof, dg, simMarket, factory->modelBuilders());
 
-    engine.registerProgressIndicator(QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
+    engine.registerProgressIndicator(
+        QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
     engine.buildCube(portfolio, cube, calculators);
 
-    /*****************
-     * Collect results
-     */
+    setResults(cube, scenarioGenerator);
+    LOG("Stress testing done");
+}
+
+StressTest::StressTest(const Size nThreads, const Date& asof,
+                       const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+                       const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                       const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
+                       const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData,
+                       const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+                       const QuantLib::ext::shared_ptr<StressTestScenarioData>& stressData,
+                       const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs,
+                       const QuantLib::ext::shared_ptr<TodaysMarketParameters>& todaysMarketParams,
+                       QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory,
+                       const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
+                       const IborFallbackConfig& iborFallbackConfig, bool continueOnError, const std::string& context) {
+
+    LOG("Run Stress Test with " << nThreads << " threads");
+    QL_REQUIRE(curveConfigs, "StressTest: curve configurations required for multi-threaded run");
+    QL_REQUIRE(todaysMarketParams, "StressTest: todays market parameters required for multi-threaded run");
+
+    // the scenarios are generated once on a simulation market in the calling thread and cloned for the workers
+    DLOG("Build Simulation Market");
+    QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(
+        market, simMarketData, marketConfiguration, *curveConfigs, *todaysMarketParams, continueOnError,
+        stressData->useSpreadedTermStructures(), false, false, iborFallbackConfig, true);
+
+    QuantLib::ext::shared_ptr<StressScenarioGenerator> scenarioGenerator =
+        buildScenarioGenerator(simMarket, simMarketData, stressData, scenarioFactory);
+    Size samples = scenarioGenerator->samples();
+
+    auto ed = QuantLib::ext::make_shared<EngineData>(*engineData);
+    ed->globalParameters()["RunType"] = "Stress";
+
+    DLOG("Build the cube object to store sensitivities");
+    QuantLib::ext::shared_ptr<NPVCube> cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
+        asof, portfolio->ids(), vector<Date>(1, asof), samples);
+
+    if (portfolio->size() > 0) {
+        DLOG("Run Stress Scenarios");
+        QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
+        MultiThreadedValuationEngine engine(nThreads, asof, dg, samples, loader, scenarioGenerator, ed, curveConfigs,
+                                            todaysMarketParams, marketConfiguration, simMarketData,
+                                            stressData->useSpreadedTermStructures(), false,
+                                            QuantLib::ext::make_shared<ScenarioFilter>(), referenceData,
+                                            iborFallbackConfig, true, true, true, {}, {}, {}, context);
+        engine.registerProgressIndicator(
+            QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
+        auto baseCcy = simMarketData->baseCcy();
+        engine.buildCube(portfolio, [&baseCcy]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
+            return {QuantLib::ext::make_shared<NPVCalculator>(baseCcy)};
+        });
+
+        // copy the mini cubes of the threads into the dense result cube
+        for (auto const& miniCube : engine.outputCubes()) {
+            for (auto const& [tradeId, i] : miniCube->idsAndIndexes()) {
+                auto index = cube->idsAndIndexes().find(tradeId);
+                QL_REQUIRE(index != cube->idsAndIndexes().end(),
+                           "StressTest: internal error, trade '" << tradeId << "' not found in result cube");
+                cube->setT0(miniCube->getT0(i, 0), index->second, 0);
+                for (Size j = 0; j < samples; ++j)
+                    cube->set(miniCube->get(i, 0, j, 0), index->second, 0, j, 0);
+            }
+        }
+    }
+
+    Settings::instance().evaluationDate() = asof;
+
+    setResults(cube, scenarioGenerator);
+    LOG("Stress testing done");
+}
+
+QuantLib::ext::shared_ptr<StressScenarioGenerator>
+StressTest::buildScenarioGenerator(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+                                   const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+                                   const QuantLib::ext::shared_ptr<StressTestScenarioData>& stressData,
+                                   QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory) {
+    DLOG("Build Stress Scenario Generator");
+    QuantLib::ext::shared_ptr<Scenario> baseScenario = simMarket->baseScenario();
+    if (!scenarioFactory)
+        scenarioFactory = QuantLib::ext::make_shared<CloneScenarioFactory>(baseScenario);
+    return QuantLib::ext::make_shared<StressScenarioGenerator>(stressData, baseScenario, simMarketData, simMarket,
+                                                               scenarioFactory, simMarket->baseScenarioAbsolute());
+}
+
+void StressTest::setResults(const QuantLib::ext::shared_ptr<NPVCube>& cube,
+                            const QuantLib::ext::shared_ptr<StressScenarioGenerator>& scenarioGenerator) {
+    cube_ = cube;
     baseNPV_.clear();
     shiftedNPV_.clear();
     delta_.clear();
+    scenarioLabels_.clear();
     labels_.clear();
     trades_.clear();
-    for (auto const& [tradeId, trade] : portfolio->trades()) {
-        auto index = cube->idsAndIndexes().find(tradeId);
-        if (index == cube->idsAndIndexes().end()) {
-            ALOG("cube does not contain tradeId '" << tradeId << "'");
-            continue;
-        }
-        Real npv0 = cube->getT0(index->second, 0);
+    for (Size j = 0; j < scenarioGenerator->samples(); ++j) {
+        scenarioLabels_.push_back(scenarioGenerator->scenarios()[j]->label());
+        labels_.insert(scenarioLabels_.back());
+    }
+    for (auto const& [tradeId, index] : cube_->idsAndIndexes())
         trades_.insert(tradeId);
-        baseNPV_[tradeId] = npv0;
-        for (Size j = 0; j < scenarioGenerator->samples(); ++j) {
-            const string& label = scenarioGenerator->scenarios()[j]->label();
-            TLOG("Adding stress test result for trade '" << tradeId << "' and scenario #" << j << " '" << label << "'");
-            Real npv = cube->get(index->second, 0, j, 0);
-            pair<string, string> p(tradeId, label);
-            shiftedNPV_[p] = npv;
-            delta_[p] = npv - npv0;
-            labels_.insert(label);
+}
+
+const std::map<std::string, Real>& StressTest::baseNPV() const {
+    if (baseNPV_.empty()) {
+        for (auto const& [tradeId, index] : cube_->idsAndIndexes())
+            baseNPV_[tradeId] = cube_->getT0(index, 0);
+    }
+    return baseNPV_;
+}
+
+const std::map<std::pair<std::string, std::string>, Real>& StressTest::shiftedNPV() const {
+    if (shiftedNPV_.empty()) {
+        for (auto const& [tradeId, index] : cube_->idsAndIndexes())
+            for (Size j = 0; j < scenarioLabels_.size(); ++j)
+                shiftedNPV_[std::make_pair(tradeId, scenarioLabels_[j])] = cube_->get(index, 0, j, 0);
+    }
+    return shiftedNPV_;
+}
+
+const std::map<std::pair<std::string, std::string>, Real>& StressTest::delta() const {
+    if (delta_.empty()) {
+        for (auto const& [tradeId, index] : cube_->idsAndIndexes()) {
+            Real npv0 = cube_->getT0(index, 0);
+            for (Size j = 0; j < scenarioLabels_.size(); ++j)
+                delta_[std::make_pair(tradeId, scenarioLabels_[j])] = cube_->get(index, 0, j, 0) - npv0;
         }
     }
-    LOG("Stress testing done");
+    return delta_;
 }
 
 void StressTest::writeReport(const QuantLib::ext::shared_ptr<ore::data::Report>& report, Real outputThreshold) {
@@ -123,20 +225,29 @@ void StressTest::writeReport(const QuantLib::ext::shared_ptr<ore::data::Report>&
     report->addColumn("Scenario NPV", double(), 2);
     report->addColumn("Sensitivity", double(), 2);
 
-    for (auto const& [id, npv] : shiftedNPV_) {
-        string tradeId = id.first;
-        string factor = id.second;
-        Real base = baseNPV_[tradeId];
-        Real sensi = npv - base;
-        TLOG("Adding stress report result for tradeId '" << tradeId << "' and scenario '" << factor << ": sensi = "
-                                                         << sensi << ", threshold = " << outputThreshold);
-        if (fabs(sensi) > outputThreshold || QuantLib::close_enough(sensi, outputThreshold)) {
-            report->next();
-            report->add(tradeId);
-            report->add(factor);
-            report->add(base);
-            report->add(npv);
-            report->add(sensi);
+    // the cube ids are sorted, the scenarios are visited in label order
+    vector<Size> order(scenarioLabels_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [this](Size i, Size j) { return scenarioLabels_[i] < scenarioLabels_[j]; });
+
+    for (auto const& [tradeId, index] : cube_->idsAndIndexes()) {
+        Real base = cube_->getT0(index, 0);
+        for (Size j : order) {
+            const string& factor = scenarioLabels_[j];
+            Real npv = cube_->get(index, 0, j, 0);
+            Real sensi = npv - base;
+            TLOG("Adding stress report result for tradeId '" << tradeId << "' and scenario '" << factor
+                                                             << ": sensi = " << sensi
+                                                             << ", threshold = " << outputThreshold);
+            if (fabs(sensi) > outputThreshold || QuantLib::close_enough(sensi, outputThreshold)) {
+                report->next();
+                report->add(tradeId);
+                report->add(factor);
+                report->add(base);
+                report->add(npv);
+                report->add(sensi);
+            }
         }
     }
 
@@ -28,6 +28,7 @@
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/stressscenariodata.hpp>
 #include <orea/scenario/stressscenariogenerator.hpp>
+#include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/report/report.hpp>
@@ -35,6 +36,7 @@
 #include <map>
 #include <set>
 #include <tuple>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -50,6 +52,10 @@ namespace analytics {
   - fill result structures that can be queried
   - write stress test report to a file
 
+  The results are stored in a dense trade x scenario cube, the base NPVs are the T0 values. With the multi-threaded
+  constructor the portfolio is split over the threads by a MultiThreadedValuationEngine, each thread building its
+  own market from the loader.
+
   \ingroup simulation
 */
 class StressTest {
@@ -67,31 +73,67 @@ public:
                const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
                bool continueOnError = false);
 
+    //! Constructor using a multi-threaded valuation engine, the market is only used to generate the stress scenarios
+    StressTest(const QuantLib::Size nThreads, const QuantLib::Date& asof,
+               const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+               const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+               const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
+               const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData,
+               const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+               const QuantLib::ext::shared_ptr<StressTestScenarioData>& stressData,
+               const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+               const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+               QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory = {},
+               const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData = nullptr,
+               const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
+               bool continueOnError = false, const std::string& context = "stress analysis");
+
     //! Return set of trades analysed
     const std::set<std::string>& trades() { return trades_; }
 
     //! Return unique set of factors shifted
     const std::set<std::string>& stressTests() { return labels_; }
 
+    //! Trade x scenario cube with one date, the base NPVs are stored as T0 values
+    const QuantLib::ext::shared_ptr<NPVCube>& cube() const { return cube_; }
+
+    //! Scenario labels by cube sample index
+    const std::vector<std::string>& scenarioLabels() const { return scenarioLabels_; }
+
+    /*! The maps below are built from the cube on first access and kept until the next run. For a large portfolio
+        and many scenarios they add a copy of the results keyed by strings, prefer cube() and scenarioLabels(). */
+    //@{
     //! Return base NPV by trade, before shift
-    const std::map<std::string, Real>& baseNPV() { return baseNPV_; }
+    const std::map<std::string, Real>& baseNPV() const;
 
     //! Return shifted NPVs by trade and scenario
-    const std::map<std::pair<std::string, std::string>, Real>& shiftedNPV() { return shiftedNPV_; }
+    const std::map<std::pair<std::string, std::string>, Real>& shiftedNPV() const;
 
     //! Return delta NPV by trade and scenario
-    const std::map<std::pair<std::string, std::string>, Real>& delta() { return delta_; }
+    const std::map<std::pair<std::string, std::string>, Real>& delta() const;
+    //@}
 
-    //! Write NPV by trade/scenario to a file (base and shifted NPVs, delta)
+    //! Write NPV by trade/scenario to a file (base and shifted NPVs, delta), sorted by trade id and scenario label
     void writeReport(const QuantLib::ext::shared_ptr<ore::data::Report>& report, Real outputThreshold = 0.0);
 
 private:
-    // base NPV by trade
-    std::map<std::string, Real> baseNPV_;
-    // NPV respectively sensitivity by trade and scenario
-    std::map<std::pair<string, string>, Real> shiftedNPV_, delta_;
-    // scenario labels
+    QuantLib::ext::shared_ptr<StressScenarioGenerator>
+    buildScenarioGenerator(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+                           const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+                           const QuantLib::ext::shared_ptr<StressTestScenarioData>& stressData,
+                           QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory);
+    void setResults(const QuantLib::ext::shared_ptr<NPVCube>& cube,
+                    const QuantLib::ext::shared_ptr<StressScenarioGenerator>& scenarioGenerator);
+
+    // trade x scenario results, base NPVs at T0
+    QuantLib::ext::shared_ptr<NPVCube> cube_;
+    // scenario labels by sample
+    std::vector<std::string> scenarioLabels_;
+    // scenario labels and trades
     std::set<std::string> labels_, trades_;
+    // result maps built from the cube on first access
+    mutable std::map<std::string, Real> baseNPV_;
+    mutable std::map<std::pair<std::string, std::string>, Real> shiftedNPV_, delta_;
 };
 } // namespace analytics
 } // namespace ore
@@ -31,6 +31,7 @@
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/progressbar.hpp>
 #include <ored/utilities/to_string.hpp>
+#include <qle/utilities/profiler.hpp>
 
 #include <ql/errors.hpp>
 
@@ -74,6 +75,8 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                                 QuantLib::ext::shared_ptr<analytics::NPVCube> outputCptyCube,
                                 vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>> cptyCalculators, bool dryRun) {
 
+    QLE_PROFILE_ZONE("ValuationEngine::buildCube");
+
     struct SimMarketResetter {
         SimMarketResetter(QuantLib::ext::shared_ptr<SimMarket> simMarket) : simMarket_(simMarket) {}
         ~SimMarketResetter() { simMarket_->reset(); }
@@ -178,6 +181,7 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
     for (Size sample = 0; sample < (dryRun ? std::min<Size>(1, outputCube->samples()) : outputCube->samples());
          ++sample) {
         TLOG("ValuationEngine: apply scenario sample #" << sample);
+        QLE_PROFILE_ZONE("sample");
 
         for (auto& [tradeId, trade] : portfolio->trades())
             trade->instrument()->reset();
@@ -365,36 +369,42 @@ std::pair<double, double> ValuationEngine::populateCube(
     QL_REQUIRE(cubeDateIndex >= 0, "first date should be a valuation date");
     cpu_timer timer;
     timer.start();
-    simMarket_->preUpdate();
-    if (isValueDate || !isStickyDate) {
-        simMarket_->updateDate(d);
-    }
-    // We can skip this step, if we have done that above in the close-out date section
-    if (!scenarioUpdated) {
-        simMarket_->updateScenario(d);
-    }
-    // Always with fixing update here, in contrast to the close-out date section
-    simMarket_->postUpdate(d, !isStickyDate || isValueDate);
-    // Aggregation scenario data update on valuation dates only
-    if (isValueDate) {
-        simMarket_->updateAsd(d);
+    {
+        QLE_PROFILE_ZONE("market update");
+        simMarket_->preUpdate();
+        if (isValueDate || !isStickyDate) {
+            simMarket_->updateDate(d);
+        }
+        // We can skip this step, if we have done that above in the close-out date section
+        if (!scenarioUpdated) {
+            simMarket_->updateScenario(d);
+        }
+        // Always with fixing update here, in contrast to the close-out date section
+        simMarket_->postUpdate(d, !isStickyDate || isValueDate);
+        // Aggregation scenario data update on valuation dates only
+        if (isValueDate) {
+            simMarket_->updateAsd(d);
+        }
+        recalibrateModels();
     }
-    recalibrateModels();
 
     timer.stop();
     updateTime += timer.elapsed().wall * 1e-9;
 
     timer.start();
-    if (isStickyDate && !isValueDate) // switch on again, if sticky
-        tradeExercisable(false, trades);
-    // loop over trades
-    runCalculators(!isValueDate, trades, tradeHasError, calculators, outputCube, outputCubeNettingSet, d, cubeDateIndex,
-                   sample, simMarket_->label());
-    if (isStickyDate && !isValueDate) // switch on again, if sticky
-        tradeExercisable(true, trades);
-    // loop over counterparty names
-    if (isValueDate) {
-        runCalculators(false, counterparties, cptyCalculators, outputCptyCube, d, cubeDateIndex, sample);
+    {
+        QLE_PROFILE_ZONE("pricing");
+        if (isStickyDate && !isValueDate) // switch on again, if sticky
+            tradeExercisable(false, trades);
+        // loop over trades
+        runCalculators(!isValueDate, trades, tradeHasError, calculators, outputCube, outputCubeNettingSet, d,
+                       cubeDateIndex, sample, simMarket_->label());
+        if (isStickyDate && !isValueDate) // switch on again, if sticky
+            tradeExercisable(true, trades);
+        // loop over counterparty names
+        if (isValueDate) {
+            runCalculators(false, counterparties, cptyCalculators, outputCptyCube, d, cubeDateIndex, sample);
+        }
     }
     timer.stop();
     pricingTime += timer.elapsed().wall * 1e-9;
@@ -27,9 +27,12 @@
 
 #include <ored/report/inmemoryreport.hpp>
 #include <ored/scripting/engines/scriptedinstrumentpricingenginecg.hpp>
+#include <ored/scripting/utilities.hpp>
 #include <ored/utilities/to_string.hpp>
+#include <ored/utilities/xmlutils.hpp>
 
 #include <qle/ad/backwardderivatives.hpp>
+#include <qle/ad/computationgraphfragment.hpp>
 #include <qle/ad/forwardderivatives.hpp>
 #include <qle/ad/forwardevaluation.hpp>
 #include <qle/ad/ssaform.hpp>
@@ -37,11 +40,20 @@
 #include <qle/math/randomvariable_ops.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 
+#include <ql/indexes/indexmanager.hpp>
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/weighted_sum.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 namespace ore {
 namespace analytics {
 
@@ -50,6 +62,80 @@ std::size_t numberOfStochasticRvs(const std::vector<RandomVariable>& v) {
     return std::count_if(v.begin(), v.end(),
                          [](const RandomVariable& r) { return r.initialised() && !r.deterministic(); });
 }
+
+// the trade key consists of the trade xml, the inputs of the scripted engine and the required past fixings, whose
+// values enter the graph as constants
+std::string graphCacheTradeKey(const Trade& trade, const ScriptedInstrumentPricingEngineCG& engine, const Date& asof) {
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<double>::max_digits10);
+    os << trade.toXMLString() << '\n' << engine.graphKey();
+    for (auto const& [name, dates] : trade.requiredFixings().fixingDatesIndices(asof)) {
+        TimeSeries<Real> history;
+        try {
+            history = IndexManager::instance().getHistory(IndexInfo(name).index()->name());
+        } catch (const std::exception& e) {
+            DLOG("XvaEngineCG: no fixing history for '" << name << "' in graph cache key: " << e.what());
+        }
+        for (auto const& [d, mandatory] : dates) {
+            os << "fixing: " << name << " " << ore::data::to_string(d) << " ";
+            if (Real v = history[d]; v != Null<Real>())
+                os << v;
+            os << '\n';
+        }
+    }
+    return os.str();
+}
+
+// graph cache file of a trade, keyed by the trade key and the model key
+std::string graphCacheFile(const std::string& directory, const std::string& tradeKey, const std::size_t modelKey) {
+    std::size_t seed = modelKey;
+    boost::hash_combine(seed, tradeKey);
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << seed << ".cgf";
+    return (boost::filesystem::path(directory) / name.str()).string();
+}
+
+// the file starts with the model key and the trade key, so that hash collisions are detected
+bool readGraphCacheFile(const std::string& fileName, const std::string& tradeKey, const std::size_t modelKey,
+                        ComputationGraphFragment& fragment) {
+    std::ifstream is(fileName, std::ios::binary);
+    if (!is)
+        return false;
+    try {
+        std::size_t key, n;
+        is >> key >> n;
+        is.get();
+        if (!is || key != modelKey || n != tradeKey.size())
+            return false;
+        std::string storedTradeKey(n, '\0');
+        is.read(&storedTradeKey[0], n);
+        if (!is || storedTradeKey != tradeKey)
+            return false;
+        fragment.read(is);
+        return true;
+    } catch (const std::exception& e) {
+        WLOG("XvaEngineCG: could not read graph cache file '" << fileName << "': " << e.what());
+        return false;
+    }
+}
+
+void writeGraphCacheFile(const std::string& fileName, const std::string& tradeKey, const std::size_t modelKey,
+                         const ComputationGraphFragment& fragment) {
+    // write to a temporary file first, so that concurrent runs never see a partial file
+    std::string tmpFileName = fileName + ".tmp";
+    try {
+        {
+            std::ofstream os(tmpFileName, std::ios::binary);
+            QL_REQUIRE(os, "could not open file");
+            os << modelKey << '\n' << tradeKey.size() << '\n';
+            os.write(tradeKey.data(), tradeKey.size());
+            fragment.write(os);
+        }
+        boost::filesystem::rename(tmpFileName, fileName);
+    } catch (const std::exception& e) {
+        WLOG("XvaEngineCG: could not write graph cache file '" << fileName << "': " << e.what());
+    }
+}
 } // namespace
 
 XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
@@ -67,7 +153,8 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
                          const IborFallbackConfig& iborFallbackConfig, const bool bumpCvaSensis,
                          const bool useExternalComputeDevice, const bool externalDeviceCompatibilityMode,
                          const bool useDoublePrecisionForExternalCalculation, const std::string& externalComputeDevice,
-                         const bool continueOnCalibrationError, const bool continueOnError, const std::string& context)
+                         const bool continueOnCalibrationError, const bool continueOnError, const std::string& context,
+                         const std::string& graphCacheDirectory)
     : asof_(asof), loader_(loader), curveConfigs_(curveConfigs), todaysMarketParams_(todaysMarketParams),
       simMarketData_(simMarketData), engineData_(engineData), crossAssetModelData_(crossAssetModelData),
       scenarioGeneratorData_(scenarioGeneratorData), portfolio_(portfolio), marketConfiguration_(marketConfiguration),
@@ -77,7 +164,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
       externalDeviceCompatibilityMode_(externalDeviceCompatibilityMode),
       useDoublePrecisionForExternalCalculation_(useDoublePrecisionForExternalCalculation),
       externalComputeDevice_(externalComputeDevice), continueOnCalibrationError_(continueOnCalibrationError),
-      continueOnError_(continueOnError), context_(context) {
+      continueOnError_(continueOnError), context_(context), graphCacheDirectory_(graphCacheDirectory) {
 
     // Just for performance testing, duplicate the trades in input portfolio as specified by env var N
 
@@ -164,6 +251,28 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         indices, indexCurrencies, simulationDates, timeStepsPerYear, iborFallbackConfig, std::vector<Size>(),
         std::vector<std::string>(), true);
     model_->calculate();
+
+    // The model key identifies the model part of the graph. Trade graphs contain constants depending on the asof
+    // date (e.g. past fixings, year fractions) and refer to absolute simulation dates, therefore the asof date is
+    // part of the key. This means that the cache only serves reruns for the same asof date, e.g. after a portfolio
+    // change, a new run on a later date rebuilds all trade graphs. Trades can depend on reference data, which is
+    // part of the key as well.
+
+    std::size_t modelSize = model_->computationGraph()->size();
+    std::size_t modelKey = 0;
+    if (!graphCacheDirectory_.empty()) {
+        modelKey = computationGraphHash(*model_->computationGraph(), modelSize);
+        boost::hash_combine(modelKey, asof_.serialNumber());
+        boost::hash_combine(modelKey, model_->size());
+        for (auto const& d : simulationDates)
+            boost::hash_combine(modelKey, d.serialNumber());
+        if (auto r = QuantLib::ext::dynamic_pointer_cast<XMLSerializable>(referenceData_))
+            boost::hash_combine(modelKey, r->toXMLString());
+        else
+            boost::hash_combine(modelKey, referenceData_.get());
+        boost::filesystem::create_directories(graphCacheDirectory_);
+    }
+
     boost::timer::nanosecond_type timing3 = timer.elapsed().wall;
 
     // Build trades against global cg cam model
@@ -195,6 +304,19 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     std::vector<std::vector<std::size_t>> amcNpvNodes; // includes time zero npv
 
     auto g = model_->computationGraph();
+    Size storedTrades = 0;
+    cachedTrades_ = 0;
+
+    // model parameters a cached trade graph refers to are created by the model if they are not present yet, the ids
+    // of model quantities start with a double underscore, other variables are local to the trade graphs
+
+    auto isModelParameter = [this](const std::string& id) {
+        return static_cast<bool>(model_->modelParameterFunctor(id));
+    };
+    auto createModelParameter = [this, &g](const std::string& id) {
+        auto f = model_->modelParameterFunctor(id);
+        return f ? addModelParameter(*g, model_->modelParameterFunctors(), id, f) : ComputationGraph::nan;
+    };
 
     for (auto const& [id, trade] : portfolio_->trades()) {
         auto qlInstr = QuantLib::ext::dynamic_pointer_cast<ScriptedInstrument>(trade->instrument()->qlInstrument());
@@ -202,17 +324,59 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         auto engine = QuantLib::ext::dynamic_pointer_cast<ScriptedInstrumentPricingEngineCG>(qlInstr->pricingEngine());
         QL_REQUIRE(engine, "XvaEngineCG: expected to get ScriptedInstrumentPricingEngineCG, trade '"
                                << id << "' has a different engine.");
+
+        // look up the trade graph in the cache, it can be used if the model quantities it refers to are present in
+        // the graph or can be created by the model, otherwise the trade graph is built
+
+        std::string tradeKey, cacheFile;
+        ComputationGraphFragment fragment;
+        if (!graphCacheDirectory_.empty()) {
+            try {
+                tradeKey = graphCacheTradeKey(*trade, *engine, asof_);
+                cacheFile = graphCacheFile(graphCacheDirectory_, tradeKey, modelKey);
+                readGraphCacheFile(cacheFile, tradeKey, modelKey, fragment);
+            } catch (const std::exception& e) {
+                DLOG("XvaEngineCG: trade '" << id << "' can not be serialised, graph is not cached: " << e.what());
+                cacheFile.clear();
+            }
+        }
+
         g->startRedBlock();
-        engine->buildComputationGraph();
         std::vector<std::size_t> tmp;
-        tmp.push_back(g->variable(engine->npvName() + "_0"));
-        for (std::size_t i = 0; i < simulationDates.size(); ++i) {
-            tmp.push_back(g->variable("_AMC_NPV_" + std::to_string(i)));
+        if (fragment.canInsert(*g, isModelParameter)) {
+            tmp = fragment.insert(*g, createModelParameter);
+            QL_REQUIRE(tmp.size() == simulationDates.size() + 1, "XvaEngineCG: cached graph of trade '"
+                                                                     << id << "' has " << tmp.size()
+                                                                     << " outputs, expected "
+                                                                     << simulationDates.size() + 1);
+            ++cachedTrades_;
+        } else {
+            std::size_t begin = g->size();
+            engine->buildComputationGraph();
+            tmp.push_back(g->variable(engine->npvName() + "_0"));
+            for (std::size_t i = 0; i < simulationDates.size(); ++i) {
+                tmp.push_back(g->variable("_AMC_NPV_" + std::to_string(i)));
+            }
+            if (!cacheFile.empty() && !fragment.valid()) {
+                ComputationGraphFragment newFragment(*g, begin, g->size(), tmp, modelSize, "__");
+                if (newFragment.valid()) {
+                    writeGraphCacheFile(cacheFile, tradeKey, modelKey, newFragment);
+                    ++storedTrades;
+                } else {
+                    DLOG("XvaEngineCG: graph of trade '" << id << "' refers to nodes of other trades, not cached");
+                }
+            }
         }
         amcNpvNodes.push_back(tmp);
         g->endRedBlock();
     }
 
+    if (!graphCacheDirectory_.empty()) {
+        LOG("XvaEngineCG: took " << cachedTrades_ << " trade graphs from cache, built "
+                                 << portfolio_->size() - cachedTrades_ << ", stored " << storedTrades << " in "
+                                 << graphCacheDirectory_);
+    }
+
     boost::timer::nanosecond_type timing5 = timer.elapsed().wall;
 
     // Add nodes that sum the exposure over trades, both pathwise and conditional expectations
@@ -251,6 +415,21 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         cvaNode = cg_add(*g, cvaNode, cg_mult(*g, defaultProb, cg_max(*g, pfExposureNodes[i], cg_const(*g, 0.0))));
     }
 
+    // Optimise the graph w.r.t. the exposure and cva nodes, node indices are kept stable by the optimisation, so the
+    // random variate and model parameter nodes of the model remain valid
+
+    std::vector<std::size_t> outputNodes(pfExposureNodes);
+    outputNodes.push_back(cvaNode);
+    auto optimisation = g->optimise(outputNodes);
+    for (auto& n : pfExposureNodes)
+        n = optimisation.replacement[n];
+    cvaNode = optimisation.replacement[cvaNode];
+
+    LOG("XvaEngineCG: optimised graph, op nodes " << optimisation.opNodesBefore << " -> " << optimisation.opNodesAfter
+                                                  << " (merged " << optimisation.merged << ", simplified "
+                                                  << optimisation.simplified << ", pruned " << optimisation.pruned
+                                                  << ")");
+
     boost::timer::nanosecond_type timing7 = timer.elapsed().wall;
 
     LOG("XvaEngineCG: graph building complete, size is " << g->size());
@@ -410,6 +589,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     }
 
     Real cva = expectation(values[cvaNode]).at(0);
+    cva_ = cva;
     LOG("XvaEngineCG: Calcuated CVA (node " << cvaNode << ") = " << cva);
 
     rvMemMax = std::max(rvMemMax, numberOfStochasticRvs(values) + numberOfStochasticRvs(derivatives));
@@ -66,10 +66,14 @@ public:
                 const bool externalDeviceCompatibilityMode = false,
                 const bool useDoublePrecisionForExternalCalculation = false,
                 const std::string& externalComputeDevice = std::string(), const bool continueOnCalibrationError = true,
-                const bool continueOnError = true, const std::string& context = "xva engine cg");
+                const bool continueOnError = true, const std::string& context = "xva engine cg",
+                const std::string& graphCacheDirectory = std::string());
 
     QuantLib::ext::shared_ptr<InMemoryReport> exposureReport() { return epeReport_; }
     QuantLib::ext::shared_ptr<InMemoryReport> sensiReport() { return sensiReport_; }
+    Real cva() const { return cva_; }
+    //! number of trade graphs taken from the graph cache
+    Size cachedTrades() const { return cachedTrades_; }
 
 private:
     void populateRandomVariates(std::vector<RandomVariable>& values,
@@ -103,6 +107,7 @@ private:
     bool continueOnCalibrationError_;
     bool continueOnError_;
     std::string context_;
+    std::string graphCacheDirectory_;
 
     // artefacts produced during run
     QuantLib::ext::shared_ptr<ore::data::Market> initMarket_;
@@ -118,8 +123,10 @@ private:
     std::vector<ExternalRandomVariableGrad> gradsExternal_;
     std::size_t externalCalculationId_;
 
-    // output reports
+    // output reports and cva
     QuantLib::ext::shared_ptr<InMemoryReport> epeReport_, sensiReport_;
+    Real cva_ = 0.0;
+    Size cachedTrades_ = 0;
 };
 
 } // namespace analytics
@@ -17,6 +17,7 @@
 #include <orea/aggregation/dynamiccreditxvacalculator.hpp>
 #include <orea/aggregation/exposureallocator.hpp>
 #include <orea/aggregation/exposurecalculator.hpp>
+#include <orea/aggregation/incrementalxva.hpp>
 #include <orea/aggregation/nettedexposurecalculator.hpp>
 #include <orea/aggregation/postprocess.hpp>
 #include <orea/aggregation/staticcreditxvacalculator.hpp>
@@ -47,6 +48,7 @@
 #include <orea/app/marketdatainmemoryloader.hpp>
 #include <orea/app/marketdataloader.hpp>
 #include <orea/app/oreapp.hpp>
+#include <orea/app/oreappservice.hpp>
 #include <orea/app/parameters.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/sensitivityrunner.hpp>
@@ -81,6 +81,7 @@
 #include <qle/termstructures/swaptionvolcubewithatm.hpp>
 #include <qle/termstructures/yoyinflationcurveobservermoving.hpp>
 #include <qle/termstructures/zeroinflationcurveobservermoving.hpp>
+#include <qle/utilities/profiler.hpp>
 
 #include <ql/instruments/makecapfloor.hpp>
 #include <ql/math/interpolations/loginterpolation.hpp>
@@ -2977,6 +2978,8 @@ void ScenarioSimMarket::reset() {
 
 void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>& scenario) {
 
+    QLE_PROFILE_ZONE("ScenarioSimMarket::applyScenario");
+
     currentScenario_ = scenario;
 
     // 1 handle delta scenario
@@ -3118,7 +3121,11 @@ void ScenarioSimMarket::updateDate(const Date& d) {
 
 void ScenarioSimMarket::updateScenario(const Date& d) {
     QL_REQUIRE(scenarioGenerator_ != nullptr, "ScenarioSimMarket::update: no scenario generator set");
-    auto scenario = scenarioGenerator_->next(d);
+    QuantLib::ext::shared_ptr<Scenario> scenario;
+    {
+        QLE_PROFILE_ZONE("scenario generation");
+        scenario = scenarioGenerator_->next(d);
+    }
     QL_REQUIRE(scenario->asof() == d,
                "Invalid Scenario date " << scenario->asof() << ", expected " << d);
     numeraire_ = scenario->getNumeraire();
@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/collatexposurehelper.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+void checkBalanceGrid(const string& callFrequency, const string& postFrequency, const string& mpor, Real threshold,
+                      Real mta, Real ia, const QuantLib::ext::shared_ptr<CollateralBalance>& balance) {
+
+    Date today(15, March, 2024);
+    Settings::instance().evaluationDate() = today;
+
+    // irregular grid, denser at the short end
+    vector<Date> dateGrid;
+    for (Size i = 1; i <= 20; ++i)
+        dateGrid.push_back(today + i * Weeks);
+    for (Size i = 6; i <= 24; ++i)
+        dateGrid.push_back(today + i * Months);
+    Date maturity = today + 20 * Months;
+
+    Size samples = 50;
+    MersenneTwisterUniformRng rng(42);
+    Real npv = 1.0E6;
+    vector<vector<Real>> values(dateGrid.size(), vector<Real>(samples));
+    vector<vector<Real>> fxRates(dateGrid.size(), vector<Real>(samples));
+    vector<vector<Real>> rates(dateGrid.size(), vector<Real>(samples));
+    for (Size k = 0; k < samples; ++k) {
+        Real v = npv, fx = 1.1, r = 0.02;
+        for (Size j = 0; j < dateGrid.size(); ++j) {
+            v += 4.0E5 * (rng.nextReal() - 0.5);
+            fx *= 1.0 + 0.02 * (rng.nextReal() - 0.5);
+            r += 0.002 * (rng.nextReal() - 0.5);
+            values[j][k] = dateGrid[j] <= maturity ? v : 0.0;
+            fxRates[j][k] = fx;
+            rates[j][k] = r;
+        }
+    }
+
+    auto netting = QuantLib::ext::make_shared<NettingSetDefinition>(
+        NettingSetDetails("NS"), "Bilateral", "USD", "USD-FedFunds", threshold, threshold, mta, mta, ia, "FIXED",
+        callFrequency, postFrequency, mpor, 0.0, 0.0, vector<string>{"USD"});
+
+    for (auto calcType : {CollateralExposureHelper::Symmetric, CollateralExposureHelper::AsymmetricCVA,
+                          CollateralExposureHelper::AsymmetricDVA, CollateralExposureHelper::NoLag}) {
+        auto paths = CollateralExposureHelper::collateralBalancePaths(netting, npv, today, values, maturity, dateGrid,
+                                                                      1.1, fxRates, 0.02, rates, calcType, balance);
+        vector<vector<Real>> grid = CollateralExposureHelper::collateralBalanceGrid(
+            netting, npv, today, values, maturity, dateGrid, 1.1, fxRates, 0.02, rates, calcType, balance);
+        BOOST_REQUIRE_EQUAL(grid.size(), dateGrid.size());
+        for (Size j = 0; j < dateGrid.size(); ++j) {
+            BOOST_REQUIRE_EQUAL(grid[j].size(), samples);
+            for (Size k = 0; k < samples; ++k) {
+                Real expected = paths->at(k)->accountBalance(dateGrid[j]);
+                BOOST_CHECK_SMALL(grid[j][k] - expected, 1.0E-6 * std::max(1.0, std::abs(expected)));
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CollateralBalancePathsTest)
+
+BOOST_AUTO_TEST_CASE(testDailyMarginCalls) {
+    BOOST_TEST_MESSAGE("Testing collateral balance grid against balance paths for daily margin calls...");
+    checkBalanceGrid("1D", "1D", "2W", 0.0, 0.0, 0.0, nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(testThresholdAndMta) {
+    BOOST_TEST_MESSAGE("Testing collateral balance grid against balance paths with threshold and MTA...");
+    checkBalanceGrid("1W", "1D", "2W", 2.0E5, 5.0E4, 1.0E5,
+                     QuantLib::ext::make_shared<CollateralBalance>("NS", "USD", 1.0E5, 8.0E5));
+}
+
+BOOST_AUTO_TEST_CASE(testSlowMarginCalls) {
+    BOOST_TEST_MESSAGE("Testing collateral balance grid against balance paths for monthly margin calls...");
+    checkBalanceGrid("1M", "2W", "3W", 1.0E5, 1.0E4, 0.0, nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/creditmigrationhelper.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <ored/portfolio/fxforward.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+QuantLib::ext::shared_ptr<CreditSimulationParameters> creditSimulationParameters(const string& evaluation) {
+    string xml = "<CreditSimulation>"
+                 "  <TransitionMatrices>"
+                 "    <TransitionMatrix>"
+                 "      <Name>TM</Name>"
+                 "      <Data>0.90, 0.08, 0.02, 0.05, 0.85, 0.10, 0.00, 0.00, 1.00</Data>"
+                 "    </TransitionMatrix>"
+                 "  </TransitionMatrices>"
+                 "  <Entities>"
+                 "    <Entity><Name>CPTY_A</Name><FactorLoadings>0.49</FactorLoadings>"
+                 "      <TransitionMatrix>TM</TransitionMatrix><InitialState>0</InitialState></Entity>"
+                 "    <Entity><Name>CPTY_B</Name><FactorLoadings>0.3</FactorLoadings>"
+                 "      <TransitionMatrix>TM</TransitionMatrix><InitialState>1</InitialState></Entity>"
+                 "    <Entity><Name>CPTY_C</Name><FactorLoadings>0.6</FactorLoadings>"
+                 "      <TransitionMatrix>TM</TransitionMatrix><InitialState>1</InitialState></Entity>"
+                 "  </Entities>"
+                 "  <NettingSetIds>NS_A,NS_B,NS_C</NettingSetIds>"
+                 "  <Risk>"
+                 "    <Market>true</Market>"
+                 "    <Credit>true</Credit>"
+                 "    <ZeroMarketPnl>false</ZeroMarketPnl>"
+                 "    <Evaluation>" +
+                 evaluation +
+                 "</Evaluation>"
+                 "    <DoubleDefault>false</DoubleDefault>"
+                 "    <Seed>42</Seed>"
+                 "    <Paths>100</Paths>"
+                 "    <CreditMode>Migration</CreditMode>"
+                 "    <LoanExposureMode>Value</LoanExposureMode>"
+                 "  </Risk>"
+                 "</CreditSimulation>";
+    auto p = QuantLib::ext::make_shared<CreditSimulationParameters>();
+    p->fromXMLString(xml);
+    return p;
+}
+
+struct TestData {
+    TestData() {
+        Date today(15, March, 2024);
+        Settings::instance().evaluationDate() = today;
+        vector<Date> dates = {today + 6 * Months, today + 1 * Years, today + 2 * Years};
+        Size samples = 150;
+
+        std::set<string> tradeIds = {"T_A", "T_B", "T_C"}, nettingSetIds = {"NS_A", "NS_B", "NS_C"};
+        cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, tradeIds, dates, samples);
+        nettedCube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, nettingSetIds, dates, samples);
+        aggData = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+
+        MersenneTwisterUniformRng rng(42);
+        for (Size i = 0; i < tradeIds.size(); ++i)
+            cube->setT0(1.0E5 * (rng.nextReal() - 0.5), i, 0);
+        for (Size k = 0; k < samples; ++k) {
+            Real state = 0.0;
+            for (Size j = 0; j < dates.size(); ++j) {
+                state += std::sqrt(j == 0 ? 0.5 : (j == 1 ? 0.5 : 1.0)) * (2.0 * rng.nextReal() - 1.0) * 1.7;
+                aggData->set(j, k, state, AggregationScenarioDataType::CreditState, "0");
+                for (Size i = 0; i < tradeIds.size(); ++i) {
+                    Real v = 1.0E6 * (rng.nextReal() - 0.4);
+                    cube->set(v, i, j, k, 0);
+                    nettedCube->set(v, i, j, k, 0);
+                }
+            }
+        }
+
+        for (auto const& c : {"A", "B", "C"}) {
+            Envelope env(string("CPTY_") + c, string("NS_") + c);
+            trades[string("T_") + c] =
+                QuantLib::ext::make_shared<FxForward>(env, "2025-03-15", "EUR", 1.0E6, "USD", 1.1E6);
+            trades[string("T_") + c]->id() = string("T_") + c;
+        }
+    }
+
+    Array pnlDistribution(const string& evaluation, Size date, Size nThreads) const {
+        CreditMigrationHelper hlp(creditSimulationParameters(evaluation), cube, nettedCube, aggData, Null<Size>(), 1,
+                                  -5.0E6, 5.0E6, 200, Matrix(1, 1, 1.0), "EUR", nThreads);
+        hlp.build(trades);
+        return hlp.pnlDistribution(date);
+    }
+
+    QuantLib::ext::shared_ptr<NPVCube> cube, nettedCube;
+    QuantLib::ext::shared_ptr<AggregationScenarioData> aggData;
+    map<string, QuantLib::ext::shared_ptr<Trade>> trades;
+};
+
+void checkThreadIndependence(const string& evaluation) {
+    TestData data;
+    for (Size date = 0; date < 3; ++date) {
+        Array serial = data.pnlDistribution(evaluation, date, 1);
+        Array parallel = data.pnlDistribution(evaluation, date, 4);
+        BOOST_REQUIRE_EQUAL(serial.size(), parallel.size());
+        Real sum = 0.0;
+        for (Size i = 0; i < serial.size(); ++i) {
+            // the paths draw the same numbers, only the order of the summation over the paths differs
+            BOOST_CHECK_SMALL(serial[i] - parallel[i], 1.0E-14);
+            sum += serial[i];
+        }
+        BOOST_CHECK_CLOSE(sum, 1.0, 1.0E-8);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CreditMigrationHelperTest)
+
+BOOST_AUTO_TEST_CASE(testAnalyticThreadIndependence) {
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution (analytic) with multiple threads...");
+    checkThreadIndependence("Analytic");
+}
+
+BOOST_AUTO_TEST_CASE(testTerminalSimulationThreadIndependence) {
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution (terminal simulation) with multiple threads...");
+    checkThreadIndependence("TerminalSimulation");
+}
+
+BOOST_AUTO_TEST_CASE(testSimulationConvergesToAnalytic) {
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution simulation against analytic evaluation...");
+    TestData data;
+    Array analytic = data.pnlDistribution("Analytic", 2, 2);
+    Array simulation = data.pnlDistribution("TerminalSimulation", 2, 2);
+    // compare the cumulative distributions, the simulation uses 100 idiosyncratic paths per global path
+    Real ca = 0.0, cs = 0.0, maxDiff = 0.0;
+    for (Size i = 0; i < analytic.size(); ++i) {
+        ca += analytic[i];
+        cs += simulation[i];
+        maxDiff = std::max(maxDiff, std::abs(ca - cs));
+    }
+    BOOST_TEST_MESSAGE("max difference of cumulative distributions: " << maxDiff);
+    BOOST_CHECK_SMALL(maxDiff, 0.02);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
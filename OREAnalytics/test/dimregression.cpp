@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/dimregressioncalculator.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <orea/cube/cubeinterpretation.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/swap.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/methods/montecarlo/lsmbasissystem.hpp>
+#include <qle/math/stabilisedglls.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// Synthetic regular cube for two netting sets with state dependent NPV moves, numeraires and one index fixing that
+// can be used as an additional DIM regressor
+struct DimTestData {
+    DimTestData() : asof(15, March, 2024), samples(500) {
+        Settings::instance().evaluationDate() = asof;
+
+        portfolio = QuantLib::ext::make_shared<Portfolio>();
+        vector<pair<string, string>> trades = {{"Trade_1", "NS1"}, {"Trade_2", "NS1"}, {"Trade_3", "NS2"}};
+        vector<string> ids;
+        for (auto const& [id, nettingSet] : trades) {
+            auto trade = QuantLib::ext::make_shared<ore::data::Swap>(Envelope("CP", nettingSet));
+            trade->id() = id;
+            portfolio->add(trade);
+            ids.push_back(id);
+        }
+
+        vector<Date> dates;
+        for (Size i = 1; i <= 10; ++i)
+            dates.push_back(asof + 2 * i * Weeks);
+
+        cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(asof, std::set<string>(ids.begin(), ids.end()),
+                                                                       dates, samples, 1);
+        scenarioData = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+
+        MersenneTwisterUniformRng rng(42);
+        InverseCumulativeNormal icn;
+        for (Size k = 0; k < samples; ++k) {
+            vector<Real> npv = {1.0E5, -5.0E4, 2.0E5};
+            Real fixing = 0.03;
+            for (Size j = 0; j < dates.size(); ++j) {
+                Real dw = icn(rng.nextReal());
+                fixing += 0.002 * dw;
+                npv[0] += (1.0E4 + 0.1 * std::fabs(npv[0])) * dw;
+                npv[1] += (5.0E3 + 0.2 * std::fabs(npv[1])) * icn(rng.nextReal());
+                npv[2] += (2.0E4 + 0.05 * std::fabs(npv[2])) * (0.5 * dw + 0.5 * icn(rng.nextReal()));
+                for (Size i = 0; i < ids.size(); ++i)
+                    cube->set(npv[i], i, j, k);
+                scenarioData->set(j, k, std::exp(0.01 * (j + 1) + 0.02 * dw), AggregationScenarioDataType::Numeraire);
+                scenarioData->set(j, k, fixing, AggregationScenarioDataType::IndexFixing, "EUR-EURIBOR-6M");
+            }
+        }
+
+        cubeInterpretation = QuantLib::ext::make_shared<CubeInterpretation>(
+            false, false, Handle<AggregationScenarioData>(scenarioData));
+    }
+
+    QuantLib::ext::shared_ptr<RegressionDynamicInitialMarginCalculator>
+    dimCalculator(const vector<string>& regressors, Size nThreads) const {
+        auto inputs = QuantLib::ext::make_shared<InputParameters>();
+        inputs->setThreads(nThreads);
+        auto dim = QuantLib::ext::make_shared<RegressionDynamicInitialMarginCalculator>(
+            inputs, portfolio, cube, cubeInterpretation, scenarioData, quantile, horizon, order, regressors);
+        dim->build();
+        return dim;
+    }
+
+    Date asof;
+    Size samples;
+    Real quantile = 0.99;
+    Size horizon = 14;
+    Size order = 2;
+    QuantLib::ext::shared_ptr<Portfolio> portfolio;
+    QuantLib::ext::shared_ptr<NPVCube> cube;
+    QuantLib::ext::shared_ptr<AggregationScenarioData> scenarioData;
+    QuantLib::ext::shared_ptr<CubeInterpretation> cubeInterpretation;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(DimRegressionTest)
+
+BOOST_AUTO_TEST_CASE(testRegressionAgainstStabilisedGLLS) {
+
+    BOOST_TEST_MESSAGE("Testing DIM regression against the StabilisedGLLS reference...");
+
+    DimTestData td;
+    Real confidenceLevel = InverseCumulativeNormal()(td.quantile);
+
+    for (auto const& regressors : vector<vector<string>>{{}, {"NPV", "EUR-EURIBOR-6M"}}) {
+        auto dim = td.dimCalculator(regressors, 1);
+        Size regressionDimension = regressors.empty() ? 1 : regressors.size();
+        vector<ext::function<Real(Array)>> v(
+            LsmBasisSystem::multiPathBasisSystem(regressionDimension, td.order, LsmBasisSystem::Monomial));
+
+        // rebuild the netting set aggregates from the cube and run the previous StabilisedGLLS regression on them
+        map<string, vector<Size>> tradeIndices = {{"NS1", {0, 1}}, {"NS2", {2}}};
+        for (auto const& [n, indices] : tradeIndices) {
+            const vector<vector<Real>>& dimValues = dim->dynamicIM(n);
+            for (Size j = 0; j + 1 < td.cube->dates().size(); ++j) {
+                vector<Array> rx(td.samples);
+                vector<Real> ry2(td.samples);
+                vector<Real> numDefault(td.samples);
+                for (Size k = 0; k < td.samples; ++k) {
+                    Real npv = 0.0, closeOutNpv = 0.0;
+                    for (auto i : indices) {
+                        npv += td.cube->get(i, j, k);
+                        closeOutNpv += td.cube->get(i, j + 1, k);
+                    }
+                    numDefault[k] = td.scenarioData->get(j, k, AggregationScenarioDataType::Numeraire);
+                    Real numCloseOut = td.scenarioData->get(j + 1, k, AggregationScenarioDataType::Numeraire);
+                    Real z = closeOutNpv * numCloseOut - npv * numDefault[k];
+                    ry2[k] = z * z;
+                    rx[k] = Array(regressionDimension, npv);
+                    if (!regressors.empty())
+                        rx[k][1] =
+                            td.scenarioData->get(j, k, AggregationScenarioDataType::IndexFixing, "EUR-EURIBOR-6M");
+                }
+                StabilisedGLLS ls(rx, ry2, v, StabilisedGLLS::MeanStdDev);
+                Size mporDays = td.cubeInterpretation->getMporCalendarDays(td.cube, j);
+                Real horizonScaling = std::sqrt(1.0 * td.horizon / mporDays);
+                for (Size k = 0; k < td.samples; ++k) {
+                    Real expected =
+                        std::sqrt(std::max(ls.eval(rx[k], v), 0.0)) * horizonScaling * confidenceLevel / numDefault[k];
+                    BOOST_CHECK_SMALL(dimValues[j][k] - expected, 1.0E-6 * std::max(std::fabs(expected), 1.0));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testThreadCountInvariance) {
+
+    BOOST_TEST_MESSAGE("Testing DIM regression results do not depend on the number of threads...");
+
+    DimTestData td;
+
+    for (auto const& regressors : vector<vector<string>>{{}, {"NPV", "EUR-EURIBOR-6M"}}) {
+        auto serial = td.dimCalculator(regressors, 1);
+        for (Size nThreads : {2, 3, 8}) {
+            auto threaded = td.dimCalculator(regressors, nThreads);
+            for (auto const& n : {"NS1", "NS2"}) {
+                BOOST_CHECK(threaded->dynamicIM(n) == serial->dynamicIM(n));
+                BOOST_CHECK(threaded->expectedIM(n) == serial->expectedIM(n));
+                BOOST_CHECK(threaded->zeroOrderResults(n) == serial->zeroOrderResults(n));
+                BOOST_CHECK(threaded->simpleResultsUpper(n) == serial->simpleResultsUpper(n));
+                BOOST_CHECK(threaded->simpleResultsLower(n) == serial->simpleResultsLower(n));
+            }
+            for (Size i = 0; i < serial->dimCube()->numIds(); ++i)
+                for (Size j = 0; j < serial->dimCube()->numDates(); ++j)
+                    for (Size k = 0; k < serial->dimCube()->samples(); ++k)
+                        BOOST_CHECK_EQUAL(threaded->dimCube()->get(i, j, k), serial->dimCube()->get(i, j, k));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
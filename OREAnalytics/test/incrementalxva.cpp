@@ -0,0 +1,184 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/incrementalxva.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <ored/portfolio/fxforward.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+QuantLib::ext::shared_ptr<Trade> trade(const string& id, const string& nettingSetId) {
+    Envelope env("CPTY_" + nettingSetId, nettingSetId);
+    auto t = QuantLib::ext::make_shared<FxForward>(env, "2025-03-15", "EUR", 1.0E6, "USD", 1.1E6);
+    t->id() = id;
+    return t;
+}
+
+// cube values encode the trade, date and sample
+Real value(Size trade, Size date, Size sample) { return 1000.0 * trade + 10.0 * date + sample; }
+
+QuantLib::ext::shared_ptr<NPVCube> cube(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, Size offset) {
+    Date today(15, March, 2024);
+    vector<Date> dates = {today + 6 * Months, today + 1 * Years};
+    auto c = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dates, 3);
+    for (auto const& [id, i] : c->idsAndIndexes()) {
+        c->setT0(value(offset + i, 0, 0), i);
+        for (Size d = 0; d < dates.size(); ++d)
+            for (Size s = 0; s < 3; ++s)
+                c->set(value(offset + i, d + 1, s), i, d, s);
+    }
+    return c;
+}
+
+struct TestData {
+    TestData() {
+        base = QuantLib::ext::make_shared<Portfolio>();
+        base->add(trade("T1", "NS_A"));
+        base->add(trade("T2", "NS_A"));
+        base->add(trade("T3", "NS_B"));
+        base->add(trade("T4", "NS_C"));
+        baseCube = cube(base, 0);
+    }
+    QuantLib::ext::shared_ptr<Portfolio> base;
+    QuantLib::ext::shared_ptr<NPVCube> baseCube;
+};
+
+void checkCubeEntries(const QuantLib::ext::shared_ptr<NPVCube>& whatIfCube,
+                      const QuantLib::ext::shared_ptr<NPVCube>& source, const string& id) {
+    Size i = whatIfCube->idsAndIndexes().at(id), j = source->idsAndIndexes().at(id);
+    BOOST_CHECK_EQUAL(whatIfCube->getT0(i), source->getT0(j));
+    for (Size d = 0; d < source->numDates(); ++d)
+        for (Size s = 0; s < source->samples(); ++s)
+            BOOST_CHECK_EQUAL(whatIfCube->get(i, d, s), source->get(j, d, s));
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(IncrementalXvaTest)
+
+BOOST_AUTO_TEST_CASE(testAddAndRemove) {
+    BOOST_TEST_MESSAGE("Testing incremental xva what-if portfolio and cube for added and removed trades...");
+
+    TestData data;
+    auto added = QuantLib::ext::make_shared<Portfolio>();
+    added->add(trade("N1", "NS_A"));
+    added->add(trade("N2", "NS_D"));
+    auto addedCube = cube(added, 100);
+
+    QuantLib::ext::shared_ptr<Portfolio> builderPortfolio;
+    QuantLib::ext::shared_ptr<NPVCube> builderCube;
+    IncrementalXva incrementalXva(data.base, data.baseCube, nullptr,
+                                  [&builderPortfolio, &builderCube](const QuantLib::ext::shared_ptr<Portfolio>& p,
+                                                                    const QuantLib::ext::shared_ptr<NPVCube>& c) {
+                                      builderPortfolio = p;
+                                      builderCube = c;
+                                      return QuantLib::ext::shared_ptr<PostProcess>();
+                                  });
+    incrementalXva.build(added, addedCube, {"T2", "T3"});
+
+    // NS_C is not affected, NS_B has no trades left
+    BOOST_CHECK(incrementalXva.affectedNettingSets() == set<string>({"NS_A", "NS_B", "NS_D"}));
+    BOOST_CHECK(incrementalXva.whatIfPortfolio()->ids() == set<string>({"N1", "N2", "T1"}));
+
+    auto whatIfCube = incrementalXva.whatIfCube();
+    BOOST_REQUIRE(whatIfCube);
+    BOOST_CHECK_EQUAL(whatIfCube->numIds(), 3);
+    BOOST_CHECK_EQUAL(whatIfCube->numDates(), data.baseCube->numDates());
+    BOOST_CHECK_EQUAL(whatIfCube->samples(), data.baseCube->samples());
+    checkCubeEntries(whatIfCube, data.baseCube, "T1");
+    checkCubeEntries(whatIfCube, addedCube, "N1");
+    checkCubeEntries(whatIfCube, addedCube, "N2");
+
+    incrementalXva.run();
+    BOOST_CHECK(builderPortfolio == incrementalXva.whatIfPortfolio());
+    BOOST_CHECK(builderCube == whatIfCube);
+}
+
+BOOST_AUTO_TEST_CASE(testReplace) {
+    BOOST_TEST_MESSAGE("Testing incremental xva what-if portfolio and cube for replaced trades...");
+
+    TestData data;
+    // the replacing trade moves from NS_B to NS_C
+    auto added = QuantLib::ext::make_shared<Portfolio>();
+    added->add(trade("T3", "NS_C"));
+    auto addedCube = cube(added, 100);
+
+    IncrementalXva incrementalXva(data.base, data.baseCube, nullptr,
+                                  [](const QuantLib::ext::shared_ptr<Portfolio>&,
+                                     const QuantLib::ext::shared_ptr<NPVCube>&) {
+                                      return QuantLib::ext::shared_ptr<PostProcess>();
+                                  });
+    incrementalXva.build(added, addedCube, {});
+
+    BOOST_CHECK(incrementalXva.affectedNettingSets() == set<string>({"NS_B", "NS_C"}));
+    BOOST_CHECK(incrementalXva.whatIfPortfolio()->ids() == set<string>({"T3", "T4"}));
+    BOOST_CHECK_EQUAL(incrementalXva.whatIfPortfolio()->get("T3")->envelope().nettingSetId(), "NS_C");
+    checkCubeEntries(incrementalXva.whatIfCube(), addedCube, "T3");
+    checkCubeEntries(incrementalXva.whatIfCube(), data.baseCube, "T4");
+}
+
+BOOST_AUTO_TEST_CASE(testRemoveNettingSet) {
+    BOOST_TEST_MESSAGE("Testing incremental xva removing all trades of a netting set...");
+
+    TestData data;
+    bool called = false;
+    IncrementalXva incrementalXva(data.base, data.baseCube, nullptr,
+                                  [&called](const QuantLib::ext::shared_ptr<Portfolio>&,
+                                            const QuantLib::ext::shared_ptr<NPVCube>&) {
+                                      called = true;
+                                      return QuantLib::ext::shared_ptr<PostProcess>();
+                                  });
+    incrementalXva.build(nullptr, nullptr, {"T4", "UNKNOWN"});
+
+    BOOST_CHECK(incrementalXva.affectedNettingSets() == set<string>({"NS_C"}));
+    BOOST_CHECK_EQUAL(incrementalXva.whatIfPortfolio()->size(), 0);
+    BOOST_CHECK(!incrementalXva.whatIfCube());
+
+    // nothing to post process
+    incrementalXva.run();
+    BOOST_CHECK(!called);
+    BOOST_CHECK(!incrementalXva.whatIfPostProcess());
+}
+
+BOOST_AUTO_TEST_CASE(testMissingAddedCube) {
+    BOOST_TEST_MESSAGE("Testing incremental xva requires the cube of the added trades...");
+
+    TestData data;
+    auto added = QuantLib::ext::make_shared<Portfolio>();
+    added->add(trade("N1", "NS_A"));
+    IncrementalXva incrementalXva(data.base, data.baseCube, nullptr,
+                                  [](const QuantLib::ext::shared_ptr<Portfolio>&,
+                                     const QuantLib::ext::shared_ptr<NPVCube>&) {
+                                      return QuantLib::ext::shared_ptr<PostProcess>();
+                                  });
+    BOOST_CHECK_THROW(incrementalXva.build(added, nullptr, {}), QuantLib::Error);
+    BOOST_CHECK_THROW(incrementalXva.build(added, data.baseCube, {}), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
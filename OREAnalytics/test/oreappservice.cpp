@@ -0,0 +1,231 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/algorithm/string.hpp>
+#include <boost/test/unit_test.hpp>
+#include <orea/app/oreappservice.hpp>
+#include <ored/portfolio/fxforward.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// the ORE parameters of the test input with the input and output paths of the test
+QuantLib::ext::shared_ptr<Parameters> serviceParameters(const string& fileName = "ore.xml", Size nThreads = 1) {
+    ifstream in(TEST_INPUT_FILE(fileName));
+    ostringstream s;
+    s << in.rdbuf();
+    string xml = s.str();
+    boost::algorithm::replace_all(xml, "@INPUT_PATH@", TEST_INPUT);
+    boost::algorithm::replace_all(xml, "@OUTPUT_PATH@", TEST_OUTPUT);
+    boost::algorithm::replace_all(xml, "@N_THREADS@", std::to_string(nThreads));
+    string file = TEST_OUTPUT_FILE(fileName);
+    {
+        ofstream out(file);
+        out << xml;
+    }
+    auto params = QuantLib::ext::make_shared<Parameters>();
+    params->fromFile(file);
+    return params;
+}
+
+bool startsWith(const string& s, const string& prefix) { return s.compare(0, prefix.size(), prefix) == 0; }
+
+set<string> npvTradeIds(OREAppService& service) {
+    auto ids = service.getReport("npv")->dataAsString(0);
+    return set<string>(ids.begin(), ids.end());
+}
+
+Size column(const PlainInMemoryReport& report, const string& header) {
+    for (Size i = 0; i < report.columns(); ++i) {
+        if (report.header(i) == header)
+            return i;
+    }
+    BOOST_FAIL("column " << header << " not found");
+    return 0;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(OREAppServiceTest)
+
+BOOST_AUTO_TEST_CASE(testRequestParsingAndErrors) {
+
+    BOOST_TEST_MESSAGE("Testing OREAppService request parsing and error responses...");
+
+    OREAppService service(serviceParameters());
+
+    BOOST_CHECK_EQUAL(service.process("status"), "OK status trades=2 markets=0 hits=0 misses=0");
+    // separators are blanks and tabs, repeated separators are ignored
+    BOOST_CHECK_EQUAL(service.process("removeTrades \t  NOT_IN_PORTFOLIO"), "OK removeTrades 0");
+
+    BOOST_CHECK_EQUAL(service.process("unknownCommand"), "ERROR unknownCommand unknown request");
+    BOOST_CHECK_EQUAL(service.process("removeTrades A B"), "ERROR removeTrades too many arguments");
+    BOOST_CHECK_EQUAL(service.process("whatIf - A B"), "ERROR whatIf too many arguments");
+    BOOST_CHECK_EQUAL(service.process("addTrades"), "ERROR addTrades portfolio file required");
+    BOOST_CHECK_EQUAL(service.process("removeTrades"), "ERROR removeTrades trade ids required");
+    BOOST_CHECK_EQUAL(service.process("whatIf"), "ERROR whatIf portfolio file or - required");
+    BOOST_CHECK_EQUAL(service.process("whatIf -"), "ERROR whatIf whatIf requires a previous run of the XVA analytic");
+    BOOST_CHECK(startsWith(service.process("addTrades nonexisting.xml"), "ERROR addTrades "));
+
+    // failed requests leave the service usable
+    BOOST_CHECK_EQUAL(service.process("status"), "OK status trades=2 markets=0 hits=0 misses=0");
+    BOOST_CHECK(!service.stopped());
+    BOOST_CHECK_EQUAL(service.process("quit"), "OK quit");
+    BOOST_CHECK(service.stopped());
+}
+
+BOOST_AUTO_TEST_CASE(testServe) {
+
+    BOOST_TEST_MESSAGE("Testing OREAppService request stream...");
+
+    OREAppService service(serviceParameters());
+
+    // blank lines are skipped, the requests after quit are not processed
+    istringstream in("status\n\n   \n  removeTrades FXFWD_1  \nfoo\nstatus\nquit\nstatus\n");
+    ostringstream out;
+    service.serve(in, out);
+
+    vector<string> responses;
+    boost::algorithm::split(responses, out.str(), boost::is_any_of("\n"));
+    BOOST_REQUIRE_EQUAL(responses.size(), 6);
+    BOOST_CHECK_EQUAL(responses[0], "OK status trades=2 markets=0 hits=0 misses=0");
+    BOOST_CHECK_EQUAL(responses[1], "OK removeTrades 1");
+    BOOST_CHECK_EQUAL(responses[2], "ERROR foo unknown request");
+    BOOST_CHECK_EQUAL(responses[3], "OK status trades=1 markets=0 hits=0 misses=0");
+    BOOST_CHECK_EQUAL(responses[4], "OK quit");
+    BOOST_CHECK_EQUAL(responses[5], "");
+    BOOST_CHECK(service.stopped());
+}
+
+BOOST_AUTO_TEST_CASE(testAddAndRemoveTrades) {
+
+    BOOST_TEST_MESSAGE("Testing OREAppService addTrades and removeTrades...");
+
+    OREAppService service(serviceParameters());
+
+    BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+    BOOST_CHECK(npvTradeIds(service) == set<string>({"FXFWD_1", "FXFWD_2"}));
+
+    // FXFWD_2 is replaced, FXFWD_3 is new
+    BOOST_CHECK_EQUAL(service.process("addTrades trades_add.xml"), "OK addTrades 2");
+    auto portfolio = service.getInputs()->portfolio();
+    BOOST_CHECK_EQUAL(portfolio->size(), 3);
+    auto fxFwd2 = QuantLib::ext::dynamic_pointer_cast<ore::data::FxForward>(portfolio->get("FXFWD_2"));
+    BOOST_REQUIRE(fxFwd2);
+    BOOST_CHECK_EQUAL(fxFwd2->boughtAmount(), 3000000.0);
+
+    BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+    BOOST_CHECK(npvTradeIds(service) == set<string>({"FXFWD_1", "FXFWD_2", "FXFWD_3"}));
+
+    // unknown ids are skipped
+    BOOST_CHECK_EQUAL(service.process("removeTrades FXFWD_1,FXFWD_3,UNKNOWN"), "OK removeTrades 2");
+    BOOST_CHECK_EQUAL(service.getInputs()->portfolio()->size(), 1);
+
+    BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+    BOOST_CHECK(npvTradeIds(service) == set<string>({"FXFWD_2"}));
+}
+
+BOOST_AUTO_TEST_CASE(testMarketCacheReuse) {
+
+    BOOST_TEST_MESSAGE("Testing OREAppService market reuse across runs...");
+
+    OREAppService service(serviceParameters());
+
+    BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+    BOOST_CHECK_EQUAL(service.process("status"), "OK status trades=2 markets=1 hits=0 misses=1");
+    vector<Real> npvs = service.getReport("npv")->dataAsReal(4);
+
+    // the second run takes the market from the cache and gives the same result
+    BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+    BOOST_CHECK_EQUAL(service.process("status"), "OK status trades=2 markets=1 hits=1 misses=1");
+    BOOST_CHECK(service.getReport("npv")->dataAsReal(4) == npvs);
+
+    // reloading unchanged market data keeps the market key, changes in the portfolio do not affect it
+    BOOST_CHECK_EQUAL(service.process("reloadMarketData"), "OK reloadMarketData");
+    BOOST_CHECK_EQUAL(service.process("addTrades trades_add.xml"), "OK addTrades 2");
+    BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+    BOOST_CHECK_EQUAL(service.process("status"), "OK status trades=3 markets=1 hits=2 misses=1");
+
+    // after clearing the cache the market is built again
+    BOOST_CHECK_EQUAL(service.process("clearCache"), "OK clearCache");
+    BOOST_CHECK_EQUAL(service.process("status"), "OK status trades=3 markets=0 hits=2 misses=1");
+    BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+    BOOST_CHECK_EQUAL(service.process("status"), "OK status trades=3 markets=1 hits=2 misses=2");
+    BOOST_CHECK_EQUAL(service.marketCache()->size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(testWhatIfAgainstFullRun) {
+
+    BOOST_TEST_MESSAGE("Testing OREAppService what-if XVA against a full rerun...");
+
+    for (Size nThreads : {1, 2}) {
+        BOOST_TEST_MESSAGE("Threads: " << nThreads);
+
+        OREAppService service(serviceParameters("ore_xva.xml", nThreads));
+        BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+
+        // FXFWD_3 is added to netting set CPTY_A, FXFWD_4 is the first trade with the new counterparty CPTY_C and
+        // removing FXFWD_2 closes netting set CPTY_B
+        BOOST_REQUIRE(startsWith(service.process("whatIf whatif_trades.xml FXFWD_2"), "OK whatIf "));
+        BOOST_CHECK_EQUAL(service.process("status").substr(0, 18), "OK status trades=2");
+        auto whatIf = service.getReport("whatif");
+        map<pair<string, string>, Real> whatIfValues;
+        for (Size r = 0; r < whatIf->rows(); ++r)
+            whatIfValues[{whatIf->dataAsString(r, column(*whatIf, "NettingSetId")),
+                          whatIf->dataAsString(r, column(*whatIf, "Metric"))}] =
+                whatIf->dataAsReal(r, column(*whatIf, "WhatIf"));
+
+        // the same portfolio changes applied to the resident portfolio and a full rerun
+        BOOST_CHECK_EQUAL(service.process("addTrades whatif_trades.xml"), "OK addTrades 2");
+        BOOST_CHECK_EQUAL(service.process("removeTrades FXFWD_2"), "OK removeTrades 1");
+        BOOST_REQUIRE(startsWith(service.process("run"), "OK run "));
+        auto xva = service.getReport("xva");
+        map<string, pair<Real, Real>> fullRunValues;
+        for (Size r = 0; r < xva->rows(); ++r) {
+            if (xva->dataAsString(r, column(*xva, "TradeId")).empty())
+                fullRunValues[xva->dataAsString(r, column(*xva, "NettingSetId"))] = {
+                    xva->dataAsReal(r, column(*xva, "BaselEEPE")), xva->dataAsReal(r, column(*xva, "CVA"))};
+        }
+
+        BOOST_REQUIRE_EQUAL(fullRunValues.size(), 2);
+        for (auto const& n : {"CPTY_A", "CPTY_C"}) {
+            BOOST_REQUIRE(fullRunValues.count(n) > 0);
+            auto [eepe, cva] = fullRunValues.at(n);
+            BOOST_CHECK(eepe > 0.0 && cva > 0.0);
+            BOOST_CHECK_CLOSE(whatIfValues.at({n, "EEPE"}), eepe, 1.0E-8);
+            BOOST_CHECK_CLOSE(whatIfValues.at({n, "CVA"}), cva, 1.0E-8);
+        }
+        BOOST_CHECK_EQUAL(whatIfValues.at({"CPTY_B", "EEPE"}), 0.0);
+        BOOST_CHECK_EQUAL(whatIfValues.at({"CPTY_B", "CVA"}), 0.0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
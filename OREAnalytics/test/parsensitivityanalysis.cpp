@@ -1059,7 +1059,7 @@ void ParSensitivityAnalysisTest::testPortfolioZeroSensitivity() {
     IndexManager::instance().clearHistories();
 }
 
-void testParConversion(ObservationMode::Mode om) {
+void testParConversion(ObservationMode::Mode om, bool sparseJacobian = false) {
 
     SavedSettings backup;
 
@@ -1154,6 +1154,7 @@ void testParConversion(ObservationMode::Mode om) {
     // first build the par analysis object, so that we can align the pillars for the zero sensi analysis
     ParSensitivityAnalysis parAnalysis(today, simMarketData, *sensiData, Market::defaultConfiguration);
     parAnalysis.alignPillars();
+    parAnalysis.setSparseJacobian(sparseJacobian);
     QuantLib::ext::shared_ptr<SensitivityAnalysis> zeroAnalysis = QuantLib::ext::make_shared<SensitivityAnalysis>(
         portfolio, initMarket, Market::defaultConfiguration, engineData, simMarketData, sensiData, false);
     BOOST_TEST_MESSAGE("SensitivityAnalysis object built");
@@ -1362,6 +1363,11 @@ void ParSensitivityAnalysisTest::testParConversionUnregisterObs() {
     testParConversion(ObservationMode::Mode::Unregister);
 }
 
+void ParSensitivityAnalysisTest::testParConversionSparseJacobian() {
+    BOOST_TEST_MESSAGE("Testing Sensitivity Par Conversion (sparse jacobian)");
+    testParConversion(ObservationMode::Mode::None, true);
+}
+
 void ParSensitivityAnalysisTest::test1dZeroShifts() {
     BOOST_TEST_MESSAGE("Testing 1d shifts");
 
@@ -1606,6 +1612,11 @@ BOOST_AUTO_TEST_CASE(ParConversionUnregisterObs) {
     ParSensitivityAnalysisTest::testParConversionUnregisterObs();
 }
 
+BOOST_AUTO_TEST_CASE(ParConversionSparseJacobian) {
+    BOOST_TEST_MESSAGE("Testing Par Conversion with sparse jacobian");
+    ParSensitivityAnalysisTest::testParConversionSparseJacobian();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
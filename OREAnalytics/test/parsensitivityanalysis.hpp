@@ -49,6 +49,8 @@ public:
     static void testParConversionDeferObs();
     //! Test par conversion of sensitivities ("Unregister" observation mode)
     static void testParConversionUnregisterObs();
+    //! Test par conversion of sensitivities using the sparsity of the jacobian
+    static void testParConversionSparseJacobian();
     static boost::unit_test_framework::test_suite* suite();
 };
 } // namespace testsuite
@@ -37,6 +37,8 @@
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/stressscenariogenerator.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
 #include <ored/model/lgmdata.hpp>
 #include <ored/portfolio/builders/capfloor.hpp>
 #include <ored/portfolio/builders/fxforward.hpp>
@@ -46,8 +48,10 @@
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/portfolio/swap.hpp>
 #include <ored/portfolio/swaption.hpp>
+#include <ored/report/inmemoryreport.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
+#include <oret/datapaths.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/time/calendars/target.hpp>
@@ -239,6 +243,70 @@ QuantLib::ext::shared_ptr<StressTestScenarioData> setupStressScenarioData() {
     return stressData;
 }
 
+// two currency setup that can be built from a loader, as required by the multi-threaded stress test
+QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> setupLoaderStressSimMarketData() {
+    auto simMarketData = QuantLib::ext::make_shared<analytics::ScenarioSimMarketParameters>();
+    simMarketData->baseCcy() = "EUR";
+    simMarketData->setDiscountCurveNames({"EUR", "USD"});
+    simMarketData->setYieldCurveTenors("", {6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years, 7 * Years,
+                                            10 * Years, 15 * Years, 20 * Years});
+    simMarketData->setIndices({"EUR-EURIBOR-6M", "USD-LIBOR-3M"});
+    simMarketData->interpolation() = "LogLinear";
+    simMarketData->extrapolation() = "FlatFwd";
+    simMarketData->setFxVolExpiries("", vector<Period>{6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years});
+    simMarketData->setFxVolDecayMode(string("ConstantVariance"));
+    simMarketData->setSimulateFXVols(true);
+    simMarketData->setFxVolIsSurface(false);
+    simMarketData->setFxVolMoneyness(vector<Real>{0.0});
+    simMarketData->setFxVolCcyPairs({"EURUSD"});
+    simMarketData->setFxCcyPairs({"EURUSD"});
+    return simMarketData;
+}
+
+QuantLib::ext::shared_ptr<StressTestScenarioData> setupLoaderStressScenarioData() {
+    auto stressData = QuantLib::ext::make_shared<StressTestScenarioData>();
+    auto curveShift = [](Real scale) {
+        StressTestScenarioData::CurveShiftData d;
+        d.shiftType = ShiftType::Absolute;
+        d.shiftTenors = {6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years, 7 * Years, 10 * Years};
+        d.shifts = {0.001, 0.002, 0.003, 0.004, 0.005, 0.006, 0.007};
+        for (auto& s : d.shifts)
+            s *= scale;
+        return d;
+    };
+    auto fxShift = [](Real size) {
+        StressTestScenarioData::SpotShiftData d;
+        d.shiftType = ShiftType::Relative;
+        d.shiftSize = size;
+        return d;
+    };
+    auto fxVolShift = [](Real scale) {
+        StressTestScenarioData::VolShiftData d;
+        d.shiftType = ShiftType::Absolute;
+        d.shiftExpiries = {6 * Months, 2 * Years, 3 * Years, 5 * Years};
+        d.shifts = {0.01 * scale, 0.02 * scale, 0.03 * scale, 0.04 * scale};
+        return d;
+    };
+    // curve, fx and combined scenarios, each thread runs all of them on its clone of the scenario generator
+    for (Size i = 0; i < 7; ++i) {
+        StressTestScenarioData::StressTestData data;
+        data.label = "stresstest_" + std::to_string(i + 1);
+        Real scale = i % 2 == 0 ? 1.0 + i : -1.0 - i;
+        if (i % 3 != 1) {
+            data.discountCurveShifts["EUR"] = curveShift(scale);
+            data.discountCurveShifts["USD"] = curveShift(-scale);
+            data.indexCurveShifts["EUR-EURIBOR-6M"] = curveShift(scale);
+            data.indexCurveShifts["USD-LIBOR-3M"] = curveShift(0.5 * scale);
+        }
+        if (i % 3 != 0) {
+            data.fxShifts["EURUSD"] = fxShift(0.01 * scale);
+            data.fxVolShifts["EURUSD"] = fxVolShift(std::fabs(scale));
+        }
+        stressData->data().push_back(data);
+    }
+    return stressData;
+}
+
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(StressTestingTest)
@@ -328,8 +396,8 @@ BOOST_AUTO_TEST_CASE(regression) {
     // build the sensitivity analysis object
     ore::analytics::StressTest analysis(portfolio, initMarket, "default", engineData, simMarketData, stressData);
 
-    std::map<std::string, Real> baseNPV = analysis.baseNPV();
-    std::map<std::pair<std::string, std::string>, Real> shiftedNPV = analysis.shiftedNPV();
+    const std::map<std::string, Real>& baseNPV = analysis.baseNPV();
+    const std::map<std::pair<std::string, std::string>, Real>& shiftedNPV = analysis.shiftedNPV();
 
     QL_REQUIRE(shiftedNPV.size() > 0, "no shifted results");
 
@@ -378,6 +446,106 @@ BOOST_AUTO_TEST_CASE(regression) {
     BOOST_CHECK_MESSAGE(count == cachedResults.size(), "number of non-zero stress impacts ("
                                                            << count << ") do not match regression data ("
                                                            << cachedResults.size() << ")");
+
+    // the results are stored in a trade x scenario cube with one date
+    BOOST_REQUIRE(analysis.cube());
+    BOOST_CHECK_EQUAL(analysis.cube()->numIds(), portfolio->size());
+    BOOST_CHECK_EQUAL(analysis.cube()->numDates(), 1);
+    BOOST_CHECK_EQUAL(analysis.cube()->samples(), analysis.scenarioLabels().size());
+    BOOST_CHECK_EQUAL(shiftedNPV.size(), portfolio->size() * analysis.scenarioLabels().size());
+
+    // the report lists the non-zero impacts
+    auto report = QuantLib::ext::make_shared<InMemoryReport>();
+    analysis.writeReport(report, 1.0E-6);
+    BOOST_CHECK_EQUAL(report->columns(), 5);
+    BOOST_CHECK_EQUAL(report->rows(), cachedResults.size());
+    IndexManager::instance().clearHistories();
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreaded) {
+    BOOST_TEST_MESSAGE("Testing multi-threaded stress test against the single-threaded run...");
+
+    SavedSettings backup;
+
+    Date today(5, February, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto loader = QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"));
+    auto market = QuantLib::ext::make_shared<TodaysMarket>(today, todaysMarketParams, loader, curveConfigs);
+
+    auto simMarketData = setupLoaderStressSimMarketData();
+    auto stressData = setupLoaderStressScenarioData();
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    engineData->model("FxOption") = "GarmanKohlhagen";
+    engineData->engine("FxOption") = "AnalyticEuropeanEngine";
+
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 1, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("2_Swap_USD", "USD", false, 10000000.0, 1, 5, 0.02, 0.00, "6M", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->add(buildFxOption("3_FxOption_EUR_USD", "Long", "Call", 1, "EUR", 10000000.0, "USD", 11000000.0));
+    portfolio->add(buildFxOption("4_FxOption_EUR_USD", "Short", "Put", 3, "EUR", 5000000.0, "USD", 5500000.0));
+    portfolio->add(buildSwap("5_Swap_EUR", "EUR", false, 5000000.0, 2, 7, 0.02, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+
+    StressTest serial(portfolio, market, "default", engineData, simMarketData, stressData, *curveConfigs,
+                      *todaysMarketParams);
+    auto serialReport = QuantLib::ext::make_shared<InMemoryReport>();
+    serial.writeReport(serialReport, 0.0);
+
+    BOOST_REQUIRE(serial.cube());
+    BOOST_REQUIRE_EQUAL(serial.cube()->numIds(), 5);
+    BOOST_REQUIRE_EQUAL(serial.scenarioLabels().size(), 7);
+    BOOST_REQUIRE_EQUAL(serialReport->rows(), 5 * 7);
+
+    Size nonZero = 0;
+    for (auto const& [key, delta] : serial.delta())
+        nonZero += std::fabs(delta) > 1.0 ? 1 : 0;
+    BOOST_CHECK(nonZero > 20);
+
+    // the portfolio is split over the threads, the last run has more threads than trades
+    for (Size nThreads : {2, 3, 8}) {
+        BOOST_TEST_MESSAGE("Threads: " << nThreads);
+        StressTest threaded(nThreads, today, loader, portfolio, market, "default", engineData, simMarketData,
+                            stressData, curveConfigs, todaysMarketParams);
+
+        // the cube entries one by one
+        BOOST_REQUIRE(threaded.cube());
+        BOOST_CHECK(threaded.scenarioLabels() == serial.scenarioLabels());
+        BOOST_REQUIRE(threaded.cube()->idsAndIndexes() == serial.cube()->idsAndIndexes());
+        BOOST_REQUIRE_EQUAL(threaded.cube()->samples(), serial.cube()->samples());
+        for (auto const& [id, i] : serial.cube()->idsAndIndexes()) {
+            BOOST_CHECK_CLOSE(threaded.cube()->getT0(i, 0), serial.cube()->getT0(i, 0), 1.0E-10);
+            for (Size k = 0; k < serial.cube()->samples(); ++k)
+                BOOST_CHECK_CLOSE(threaded.cube()->get(i, 0, k, 0), serial.cube()->get(i, 0, k, 0), 1.0E-10);
+        }
+
+        // the report rows one by one
+        auto report = QuantLib::ext::make_shared<InMemoryReport>();
+        threaded.writeReport(report, 0.0);
+        BOOST_REQUIRE_EQUAL(report->columns(), serialReport->columns());
+        BOOST_REQUIRE_EQUAL(report->rows(), serialReport->rows());
+        for (Size r = 0; r < report->rows(); ++r) {
+            for (Size c = 0; c < 2; ++c)
+                BOOST_CHECK_EQUAL(boost::get<string>(report->data(c)[r]),
+                                  boost::get<string>(serialReport->data(c)[r]));
+            for (Size c = 2; c < report->columns(); ++c)
+                BOOST_CHECK_SMALL(boost::get<Real>(report->data(c)[r]) -
+                                      boost::get<Real>(serialReport->data(c)[r]),
+                                  1.0E-6);
+        }
+    }
     IndexManager::instance().clearHistories();
 }
 
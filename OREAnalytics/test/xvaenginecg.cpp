@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/engine/xvaenginecg.hpp>
+#include <orea/scenario/scenariogeneratordata.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/fixings.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/scriptedtrade.hpp>
+#include <ored/utilities/indexparser.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+struct CgRunResult {
+    vector<Real> epe, ene;
+    Real cva;
+    Size trades, cachedTrades;
+};
+
+// number of trade graphs stored in the cache directory
+Size cachedGraphs(const string& directory) {
+    Size n = 0;
+    for (auto const& f : boost::filesystem::directory_iterator(directory))
+        n += f.path().extension() == ".cgf" ? 1 : 0;
+    return n;
+}
+
+void checkEqual(const CgRunResult& r, const CgRunResult& expected) {
+    BOOST_REQUIRE_EQUAL(r.epe.size(), expected.epe.size());
+    for (Size i = 0; i < r.epe.size(); ++i) {
+        BOOST_CHECK_EQUAL(r.epe[i], expected.epe[i]);
+        BOOST_CHECK_EQUAL(r.ene[i], expected.ene[i]);
+    }
+    BOOST_CHECK_EQUAL(r.cva, expected.cva);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(XvaEngineCGTest)
+
+BOOST_AUTO_TEST_CASE(testGraphCache) {
+
+    BOOST_TEST_MESSAGE("Testing XvaEngineCG results with cold and warm graph cache against an uncached run...");
+
+    Date asof(5, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto loader = QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"));
+    applyFixings(loader->loadFixings());
+
+    auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto crossAssetModelData = QuantLib::ext::make_shared<CrossAssetModelData>();
+    crossAssetModelData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto scenarioGeneratorData = QuantLib::ext::make_shared<ScenarioGeneratorData>();
+    scenarioGeneratorData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+
+    struct cleanup {
+        ~cleanup() { ScriptLibraryStorage::instance().clear(); }
+    } cleanup;
+    ScriptLibraryData library;
+    library.fromFile(TEST_INPUT_FILE("scriptlibrary.xml"));
+    ScriptLibraryStorage::instance().set(std::move(library));
+
+    auto run = [&](const string& graphCacheDirectory) {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+        XvaEngineCG engine(1, asof, loader, curveConfigs, todaysMarketParams, simMarketData, engineData,
+                           crossAssetModelData, scenarioGeneratorData, portfolio, Market::defaultConfiguration,
+                           Market::defaultConfiguration, nullptr, nullptr, IborFallbackConfig::defaultConfig(), false,
+                           false, false, false, string(), true, true, "xva engine cg", graphCacheDirectory);
+        CgRunResult result;
+        auto report = engine.exposureReport();
+        BOOST_REQUIRE(report);
+        for (Size i = 0; i < report->rows(); ++i) {
+            result.epe.push_back(boost::get<Real>(report->data(1)[i]));
+            result.ene.push_back(boost::get<Real>(report->data(2)[i]));
+        }
+        result.cva = engine.cva();
+        result.trades = portfolio->size();
+        result.cachedTrades = engine.cachedTrades();
+        return result;
+    };
+
+    string cacheDirectory = TEST_OUTPUT_FILE("graphcache");
+    boost::filesystem::remove_all(cacheDirectory);
+
+    CgRunResult uncached = run(string());
+    BOOST_REQUIRE_EQUAL(uncached.epe.size(), scenarioGeneratorData->getGrid()->dates().size() + 1);
+    BOOST_CHECK(uncached.cva > 0.0);
+
+    BOOST_TEST_MESSAGE("Cold cache");
+    CgRunResult cold = run(cacheDirectory);
+    BOOST_CHECK_EQUAL(cachedGraphs(cacheDirectory), 1);
+    BOOST_CHECK_EQUAL(cold.cachedTrades, 0);
+    checkEqual(cold, uncached);
+
+    BOOST_TEST_MESSAGE("Warm cache");
+    CgRunResult warm = run(cacheDirectory);
+    BOOST_CHECK_EQUAL(cachedGraphs(cacheDirectory), 1);
+    BOOST_CHECK_EQUAL(warm.cachedTrades, warm.trades);
+    checkEqual(warm, uncached);
+
+    // the past fixing enters the trade graph as a constant, a changed fixing must not hit the cached graph
+
+    BOOST_TEST_MESSAGE("Changed past fixing");
+    parseIborIndex("EUR-EURIBOR-6M")->addFixing(Date(28, August, 2015), 0.01, true);
+    CgRunResult uncachedNewFixing = run(string());
+    BOOST_CHECK(uncachedNewFixing.epe.front() != uncached.epe.front() ||
+                uncachedNewFixing.ene.front() != uncached.ene.front());
+    CgRunResult cachedNewFixing = run(cacheDirectory);
+    BOOST_CHECK_EQUAL(cachedGraphs(cacheDirectory), 2);
+    BOOST_CHECK_EQUAL(cachedNewFixing.cachedTrades, 0);
+    checkEqual(cachedNewFixing, uncachedNewFixing);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
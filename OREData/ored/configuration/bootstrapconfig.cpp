@@ -25,10 +25,10 @@ namespace ore {
 namespace data {
 
 BootstrapConfig::BootstrapConfig(Real accuracy, Real globalAccuracy, bool dontThrow, Size maxAttempts, Real maxFactor,
-                                 Real minFactor, Size dontThrowSteps)
+                                 Real minFactor, Size dontThrowSteps, bool globalSolver, bool incremental)
     : accuracy_(accuracy), globalAccuracy_(globalAccuracy == Null<Real>() ? accuracy_ : globalAccuracy),
       dontThrow_(dontThrow), maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor),
-      dontThrowSteps_(dontThrowSteps) {}
+      dontThrowSteps_(dontThrowSteps), globalSolver_(globalSolver), incremental_(incremental) {}
 
 void BootstrapConfig::fromXML(XMLNode* node) {
 
@@ -74,6 +74,16 @@ void BootstrapConfig::fromXML(XMLNode* node) {
         QL_REQUIRE(dontThrowSteps > 0, "DontThrowSteps (" << dontThrowSteps << ") must be a positive integer");
         dontThrowSteps_ = static_cast<Size>(dontThrowSteps);
     }
+
+    globalSolver_ = false;
+    if (XMLNode* n = XMLUtils::getChildNode(node, "GlobalSolver")) {
+        globalSolver_ = parseBool(XMLUtils::getNodeValue(n));
+    }
+
+    incremental_ = false;
+    if (XMLNode* n = XMLUtils::getChildNode(node, "Incremental")) {
+        incremental_ = parseBool(XMLUtils::getNodeValue(n));
+    }
 }
 
 XMLNode* BootstrapConfig::toXML(XMLDocument& doc) const {
@@ -86,6 +96,8 @@ XMLNode* BootstrapConfig::toXML(XMLDocument& doc) const {
     XMLUtils::addChild(doc, node, "MaxFactor", maxFactor_);
     XMLUtils::addChild(doc, node, "MinFactor", minFactor_);
     XMLUtils::addChild(doc, node, "DontThrowSteps", static_cast<int>(dontThrowSteps_));
+    XMLUtils::addChild(doc, node, "GlobalSolver", globalSolver_);
+    XMLUtils::addChild(doc, node, "Incremental", incremental_);
 
     return node;
 }
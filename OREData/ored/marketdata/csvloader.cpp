@@ -22,9 +22,13 @@
 */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string.hpp>
+#include <cctype>
+#include <exception>
 #include <fstream>
 #include <map>
+#include <thread>
 #include <ored/marketdata/csvloader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/utilities/log.hpp>
@@ -36,18 +40,21 @@ namespace ore {
 namespace data {
 
 CSVLoader::CSVLoader(const string& marketFilename, const string& fixingFilename, bool implyTodaysFixings,
-		     Date fixingCutOffDate)
-    : CSVLoader(marketFilename, fixingFilename, "", implyTodaysFixings, fixingCutOffDate) {}
+		     Date fixingCutOffDate, Size nThreads, Size chunkSize)
+    : CSVLoader(marketFilename, fixingFilename, "", implyTodaysFixings, fixingCutOffDate, nThreads, chunkSize) {}
 
-CSVLoader::CSVLoader(const vector<string>& marketFiles, const vector<string>& fixingFiles, bool implyTodaysFixings, Date fixingCutOffDate)
-    : CSVLoader(marketFiles, fixingFiles, {}, implyTodaysFixings, fixingCutOffDate) {}
+CSVLoader::CSVLoader(const vector<string>& marketFiles, const vector<string>& fixingFiles, bool implyTodaysFixings,
+                     Date fixingCutOffDate, Size nThreads, Size chunkSize)
+    : CSVLoader(marketFiles, fixingFiles, {}, implyTodaysFixings, fixingCutOffDate, nThreads, chunkSize) {}
 
 CSVLoader::CSVLoader(const string& marketFilename, const string& fixingFilename, const string& dividendFilename,
-                     bool implyTodaysFixings, Date fixingCutOffDate)
-    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate) {
+                     bool implyTodaysFixings, Date fixingCutOffDate, Size nThreads, Size chunkSize)
+    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate),
+      nThreads_(std::max<Size>(1, nThreads)), chunkSize_(std::max<Size>(1, chunkSize)) {
 
     // load market data
     loadFile(marketFilename, DataType::Market);
+    buildIndex();
     // log
     for (auto it : data_) {
         LOG("CSVLoader loaded " << it.second.size() << " market data points for " << it.first);
@@ -68,12 +75,14 @@ CSVLoader::CSVLoader(const string& marketFilename, const string& fixingFilename,
 
 CSVLoader::CSVLoader(const vector<string>& marketFiles, const vector<string>& fixingFiles,
                      const vector<string>& dividendFiles, bool implyTodaysFixings,
-		     Date fixingCutOffDate)
-    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate) {
+		     Date fixingCutOffDate, Size nThreads, Size chunkSize)
+    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate),
+      nThreads_(std::max<Size>(1, nThreads)), chunkSize_(std::max<Size>(1, chunkSize)) {
 
     for (auto marketFile : marketFiles)
         // load market data
         loadFile(marketFile, DataType::Market);
+    buildIndex();
 
     // log
     for (auto it : data_)
@@ -97,95 +106,224 @@ QuantLib::ext::shared_ptr<MarketDatum> makeDummyMarketDatum(const Date& d, const
                                            MarketDatum::InstrumentType::NONE);
 }
 
+namespace {
+
+// a token of a line, pointing into the file buffer
+struct Token {
+    const char* begin;
+    const char* end;
+    std::string str() const { return std::string(begin, end); }
+    bool operator==(const std::string& s) const {
+        return static_cast<std::size_t>(end - begin) == s.size() && std::equal(begin, end, s.begin());
+    }
+};
+
+inline bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; }
+inline bool isSeparator(char c) { return c == ',' || c == ';' || c == '\t' || c == ' '; }
+
+/* Splits the trimmed line [begin, end) into tokens without allocating, with the semantics of boost::split() with
+   separators ",;\t " and token_compress_on. Returns the number of tokens, only the first maxTokens are stored. */
+std::size_t tokenize(const char* begin, const char* end, Token* tokens, std::size_t maxTokens) {
+    std::size_t n = 0;
+    const char* start = begin;
+    for (const char* p = begin; p != end;) {
+        if (isSeparator(*p)) {
+            if (n < maxTokens)
+                tokens[n] = {start, p};
+            ++n;
+            while (p != end && isSeparator(*p))
+                ++p;
+            start = p;
+        } else {
+            ++p;
+        }
+    }
+    if (n < maxTokens)
+        tokens[n] = {start, end};
+    return n + 1;
+}
+
+// the data parsed from one chunk of a file, the merge into the loader happens in file order
+struct ParsedChunk {
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> data;
+    std::vector<Fixing> fixings;
+    std::vector<QuantExt::Dividend> dividends;
+    // parse warnings, logged before the data item with the given index
+    std::vector<std::pair<Size, std::string>> warnings;
+    std::exception_ptr error;
+};
+
+} // namespace
+
 void CSVLoader::loadFile(const string& filename, DataType dataType) {
     LOG("CSVLoader loading from " << filename);
 
     Date today = QuantLib::Settings::instance().evaluationDate();
 
+    // read the whole file into memory in one go
+
     ifstream file;
-    file.open(filename.c_str());
+    file.open(filename.c_str(), std::ios::in | std::ios::binary);
     QL_REQUIRE(file.is_open(), "error opening file " << filename);
+    std::string buffer;
+    file.seekg(0, std::ios::end);
+    buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(&buffer[0], buffer.size());
+    file.close();
 
-    while (!file.eof()) {
-        string line;
-        getline(file, line);
-        boost::trim(line);
-        // skip blank and comment lines
-        if (line.size() > 0 && line[0] != '#') {
-
-            vector<string> tokens;
-            boost::trim(line);
-            boost::split(tokens, line, boost::is_any_of(",;\t "), boost::token_compress_on);
-
-            // TODO: should we try, catch and log any invalid lines?
-            QL_REQUIRE(tokens.size() == 3 || tokens.size() == 4, "Invalid CSVLoader line, 3 tokens expected " << line);
-            if (tokens.size() == 4)
-                QL_REQUIRE(dataType == DataType::Dividend, "CSVLoader, dataType must be of type Dividend");
-            Date date = parseDate(tokens[0]);
-            const string& key = tokens[1];
-            Real value = parseReal(tokens[2]);
-
-            if (dataType == DataType::Market) {
-                // process market
-                // build market datum and add to map
-                try {
+    // split the buffer into chunks ending at a line break
+
+    std::vector<std::pair<const char*, const char*>> chunks;
+    const char* bufferEnd = buffer.data() + buffer.size();
+    for (const char* p = buffer.data(); p != bufferEnd;) {
+        const char* e = p + std::min<std::size_t>(chunkSize_, bufferEnd - p);
+        e = std::find(e, bufferEnd, '\n');
+        if (e != bufferEnd)
+            ++e;
+        chunks.push_back(std::make_pair(p, e));
+        p = e;
+    }
+
+    // parse the chunks, this does not touch the loader's state
+
+    auto parseChunk = [dataType](const char* begin, const char* end, ParsedChunk& result) {
+        // dates are usually repeated on consecutive lines, so we only parse them on change
+        std::string lastDateStr;
+        Date lastDate;
+        auto toDate = [&lastDateStr, &lastDate](const Token& t) {
+            if (!(t == lastDateStr) || lastDate == Date()) {
+                lastDateStr = t.str();
+                lastDate = parseDate(lastDateStr);
+            }
+            return lastDate;
+        };
+        Token tokens[4];
+        for (const char* lineBegin = begin; lineBegin != end;) {
+            const char* lineEnd = std::find(lineBegin, end, '\n');
+            const char* next = lineEnd == end ? end : lineEnd + 1;
+            // trim
+            while (lineBegin != lineEnd && isSpace(*lineBegin))
+                ++lineBegin;
+            while (lineEnd != lineBegin && isSpace(*(lineEnd - 1)))
+                --lineEnd;
+            // skip blank and comment lines
+            if (lineBegin != lineEnd && *lineBegin != '#') {
+                std::size_t n = tokenize(lineBegin, lineEnd, tokens, 4);
+                QL_REQUIRE(n == 3 || n == 4,
+                           "Invalid CSVLoader line, 3 tokens expected " << std::string(lineBegin, lineEnd));
+                if (n == 4)
+                    QL_REQUIRE(dataType == DataType::Dividend, "CSVLoader, dataType must be of type Dividend");
+                Date date = toDate(tokens[0]);
+                std::string key = tokens[1].str();
+                Real value = parseReal(tokens[2].str());
+                if (dataType == DataType::Market) {
                     QuantLib::ext::shared_ptr<MarketDatum> md;
                     try {
                         md = parseMarketDatum(date, key, value);
                     } catch (std::exception& e) {
-                        WLOG("Failed to parse MarketDatum " << key << ": " << e.what());
+                        result.warnings.push_back(std::make_pair(
+                            result.data.size(), "Failed to parse MarketDatum " + key + ": " + e.what()));
                     }
-                    if (md != nullptr) {
-                        std::pair<bool, string> addFX = {true, ""};
-                        if (md->instrumentType() == MarketDatum::InstrumentType::FX_SPOT &&
-                            md->quoteType() == MarketDatum::QuoteType::RATE) {
-                            addFX = checkFxDuplicate(md, date);
-                            if (!addFX.second.empty()) {
-                                auto it2 = data_[date].find(makeDummyMarketDatum(date, addFX.second));
-                                TLOG("Replacing MarketDatum " << addFX.second << " with " << key
-                                                                  << " due to FX Dominance.");
-                                if (it2 != data_[date].end())
-                                    data_[date].erase(it2);
-                            }
-                        }
-                        if (addFX.first && data_[date].insert(md).second) {
-                            LOG("Added MarketDatum " << key);
-                        } else if (!addFX.first) {
-                            LOG("Skipped MarketDatum " << key << " - dominant FX already present.")
-                        }
-						else {
-                            LOG("Skipped MarketDatum " << key << " - this is already present.");
+                    if (md != nullptr)
+                        result.data.push_back(md);
+                } else if (dataType == DataType::Fixing) {
+                    result.fixings.push_back(Fixing(date, key, value));
+                } else if (dataType == DataType::Dividend) {
+                    Date payDate = n == 4 ? parseDate(tokens[3].str()) : date;
+                    result.dividends.push_back(QuantExt::Dividend(date, key, value, payDate));
+                } else {
+                    QL_FAIL("unknown data type");
+                }
+            }
+            lineBegin = next;
+        }
+    };
+
+    std::vector<ParsedChunk> parsed(chunks.size());
+    Size nThreads = std::min<Size>(chunks.size(), nThreads_);
+    std::atomic<Size> nextChunk(0);
+    auto worker = [&chunks, &parsed, &nextChunk, &parseChunk]() {
+        for (Size c = nextChunk++; c < chunks.size(); c = nextChunk++) {
+            try {
+                parseChunk(chunks[c].first, chunks[c].second, parsed[c]);
+            } catch (...) {
+                parsed[c].error = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (Size t = 1; t < nThreads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+        t.join();
+
+    // merge the parsed data in file order, this is where duplicates and fx dominance are handled
+
+    for (auto& chunk : parsed) {
+        if (chunk.error)
+            std::rethrow_exception(chunk.error);
+        if (dataType == DataType::Market) {
+            auto w = chunk.warnings.begin();
+            for (Size i = 0; i < chunk.data.size(); ++i) {
+                for (; w != chunk.warnings.end() && w->first == i; ++w)
+                    WLOG(w->second);
+                const QuantLib::ext::shared_ptr<MarketDatum>& md = chunk.data[i];
+                const Date& date = md->asofDate();
+                const string& key = md->name();
+                try {
+                    std::pair<bool, string> addFX = {true, ""};
+                    if (md->instrumentType() == MarketDatum::InstrumentType::FX_SPOT &&
+                        md->quoteType() == MarketDatum::QuoteType::RATE) {
+                        addFX = checkFxDuplicate(md, date);
+                        if (!addFX.second.empty()) {
+                            auto it2 = data_[date].find(makeDummyMarketDatum(date, addFX.second));
+                            TLOG("Replacing MarketDatum " << addFX.second << " with " << key
+                                                              << " due to FX Dominance.");
+                            if (it2 != data_[date].end())
+                                data_[date].erase(it2);
                         }
                     }
+                    if (addFX.first && data_[date].insert(md).second) {
+                        LOG("Added MarketDatum " << key);
+                    } else if (!addFX.first) {
+                        LOG("Skipped MarketDatum " << key << " - dominant FX already present.")
+                    } else {
+                        LOG("Skipped MarketDatum " << key << " - this is already present.");
+                    }
                 } catch (std::exception& e) {
                     WLOG("Failed to parse MarketDatum " << key << ": " << e.what());
                 }
-            } else if (dataType == DataType::Fixing) {
+            }
+            for (; w != chunk.warnings.end(); ++w)
+                WLOG(w->second);
+        } else if (dataType == DataType::Fixing) {
+            for (auto const& f : chunk.fixings) {
                 // process fixings
-                if (date < today || (date == today && !implyTodaysFixings_)
-		    || (fixingCutOffDate_ != Date() && date <= fixingCutOffDate_)) {
-                    if(!fixings_.insert(Fixing(date, key, value)).second) {
-                        WLOG("Skipped Fixing " << key << "@" << QuantLib::io::iso_date(date)
+                if (f.date < today || (f.date == today && !implyTodaysFixings_) ||
+                    (fixingCutOffDate_ != Date() && f.date <= fixingCutOffDate_)) {
+                    if (!fixings_.insert(f).second) {
+                        WLOG("Skipped Fixing " << f.name << "@" << QuantLib::io::iso_date(f.date)
                                                << " - this is already present.");
                     }
                 }
-            } else if (dataType == DataType::Dividend) {
-                Date payDate = date;
-                if (tokens.size() == 4)
-                    payDate = parseDate(tokens[3]);
+            }
+        } else if (dataType == DataType::Dividend) {
+            for (auto const& d : chunk.dividends) {
                 // process dividends
-                if (date <= today) {
-                    if (!dividends_.insert(QuantExt::Dividend(date, key, value, payDate)).second) {
-                        WLOG("Skipped Dividend " << key << "@" << QuantLib::io::iso_date(date)
+                if (d.exDate <= today) {
+                    if (!dividends_.insert(d).second) {
+                        WLOG("Skipped Dividend " << d.name << "@" << QuantLib::io::iso_date(d.exDate)
                                                  << " - this is already present.");
                     }
                 }
-            } else {
-                QL_FAIL("unknown data type");
             }
         }
+        // release the memory of the chunk early
+        chunk = ParsedChunk();
     }
-    file.close();
+
     LOG("CSVLoader completed processing " << filename);
 }
 
@@ -228,26 +366,17 @@ std::set<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::get(const Wildcard&
         }
         return {};
     }
-    auto it = data_.find(asof);
-    if (it == data_.end())
+    auto it = index_.find(asof);
+    if (it == index_.end())
         return {};
-    std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
-    std::set<QuantLib::ext::shared_ptr<MarketDatum>>::iterator it1, it2;
-    if (wildcard.wildcardPos() == 0) {
-        // wildcard at first position => we have to search all of the data
-        it1 = it->second.begin();
-        it2 = it->second.end();
-    } else {
-        // search the range matching the substring of the pattern until the wildcard
-        std::string prefix = wildcard.pattern().substr(0, wildcard.wildcardPos());
-        it1 = it->second.lower_bound(makeDummyMarketDatum(asof, prefix));
-        it2 = it->second.upper_bound(makeDummyMarketDatum(asof, prefix + "\xFF"));
-    }
-    for (auto it = it1; it != it2; ++it) {
-        if (wildcard.isPrefix() || wildcard.matches((*it)->name()))
-            result.insert(*it);
-    }
-    return result;
+    return it->second.get(wildcard);
+}
+
+void CSVLoader::buildIndex() {
+    index_.clear();
+    for (auto const& d : data_)
+        index_.emplace(d.first, MarketDatumIndex(d.second.begin(), d.second.end()));
 }
+
 } // namespace data
 } // namespace ore
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <ored/marketdata/loader.hpp>
+#include <ored/marketdata/marketdatumindex.hpp>
 
 namespace ore {
 namespace data {
@@ -34,6 +35,9 @@ namespace data {
   Data is loaded with the call to the constructor.
   Inspectors can be called to then retrieve quotes and fixings.
 
+  The files are split into chunks at line breaks which are parsed on up to nThreads threads. The parsed data is
+  merged in file order, so that the result and the log output do not depend on the number of threads.
+
   TODO implementation has large overlap with inmemoryloader.?pp, factor this out
 
   \ingroup marketdata
@@ -50,7 +54,11 @@ public:
         //! Enable/disable implying today's fixings
         bool implyTodaysFixings = false,
 	//! Load fixings up to this date
-	Date fixingCutOffDate = Date());
+	Date fixingCutOffDate = Date(),
+        //! Number of threads used to parse the files
+        QuantLib::Size nThreads = 1,
+        //! Size in bytes of the chunks the files are split into for parsing
+        QuantLib::Size chunkSize = 1 << 20);
 
     CSVLoader( //! Quote file name
         const vector<string>& marketFiles,
@@ -59,7 +67,11 @@ public:
         //! Enable/disable implying today's fixings
         bool implyTodaysFixings = false,
 	//! Load fixings up to this date
-	Date fixingCutOffDate = Date());
+	Date fixingCutOffDate = Date(),
+        //! Number of threads used to parse the files
+        QuantLib::Size nThreads = 1,
+        //! Size in bytes of the chunks the files are split into for parsing
+        QuantLib::Size chunkSize = 1 << 20);
 
     CSVLoader( //! Quote file name
         const string& marketFilename,
@@ -70,7 +82,11 @@ public:
         //! Enable/disable implying today's fixings
         bool implyTodaysFixings = false,
 	//! Load fixings up to this date
-	Date fixingCutOffDate = Date());
+	Date fixingCutOffDate = Date(),
+        //! Number of threads used to parse the files
+        QuantLib::Size nThreads = 1,
+        //! Size in bytes of the chunks the files are split into for parsing
+        QuantLib::Size chunkSize = 1 << 20);
 
     CSVLoader( //! Quote file name
         const vector<string>& marketFiles,
@@ -81,7 +97,11 @@ public:
         //! Enable/disable implying today's fixings
         bool implyTodaysFixings = false,
 	//! Load fixings up to this date
-	Date fixingCutOffDate = Date());
+	Date fixingCutOffDate = Date(),
+        //! Number of threads used to parse the files
+        QuantLib::Size nThreads = 1,
+        //! Size in bytes of the chunks the files are split into for parsing
+        QuantLib::Size chunkSize = 1 << 20);
 
     std::vector<QuantLib::ext::shared_ptr<MarketDatum>> loadQuotes(const QuantLib::Date&) const override;
 
@@ -101,11 +121,16 @@ private:
     enum class DataType { Market, Fixing, Dividend };
     void loadFile(const string&, DataType);
 
+    void buildIndex();
+
     bool implyTodaysFixings_;
     std::map<QuantLib::Date, std::set<QuantLib::ext::shared_ptr<MarketDatum>, SharedPtrMarketDatumComparator>> data_;
+    std::map<QuantLib::Date, MarketDatumIndex> index_;
     std::set<Fixing> fixings_;
     std::set<QuantExt::Dividend> dividends_;
     Date fixingCutOffDate_;
+    QuantLib::Size nThreads_ = 1;
+    QuantLib::Size chunkSize_ = 1 << 20;
 };
 } // namespace data
 } // namespace ore
@@ -77,23 +77,17 @@ std::set<QuantLib::ext::shared_ptr<MarketDatum>> InMemoryLoader::get(const Wildc
     auto it = data_.find(asof);
     if (it == data_.end())
         return {};
-    std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
-    std::set<QuantLib::ext::shared_ptr<MarketDatum>>::iterator it1, it2;
-    if (wildcard.wildcardPos() == 0) {
-        // wildcard at first position => we have to search all of the data
-        it1 = it->second.begin();
-        it2 = it->second.end();
-    } else {
-        // search the range matching the substring of the pattern until the wildcard
-        std::string prefix = wildcard.pattern().substr(0, wildcard.wildcardPos());
-        it1 = it->second.lower_bound(makeDummyMarketDatum(asof, prefix));
-        it2 = it->second.upper_bound(makeDummyMarketDatum(asof, prefix + "\xFF"));
-    }
-    for (auto it = it1; it != it2; ++it) {
-        if (wildcard.isPrefix() || wildcard.matches((*it)->name()))
-            result.insert(*it);
+    {
+        boost::shared_lock<boost::shared_mutex> lock(indexMutex_);
+        auto idx = index_.find(asof);
+        if (idx != index_.end() && idx->second.size() == it->second.size())
+            return idx->second.get(wildcard);
     }
-    return result;
+    boost::unique_lock<boost::shared_mutex> lock(indexMutex_);
+    MarketDatumIndex& idx = index_[asof];
+    if (idx.size() != it->second.size())
+        idx = MarketDatumIndex(it->second.begin(), it->second.end());
+    return idx.get(wildcard);
 }
 
 bool InMemoryLoader::hasQuotes(const QuantLib::Date& d) const {
@@ -109,6 +103,10 @@ void InMemoryLoader::add(QuantLib::Date date, const string& name, QuantLib::Real
         WLOG("Failed to parse MarketDatum " << name << ": " << e.what());
     }
     if (md != nullptr) {
+        {
+            boost::unique_lock<boost::shared_mutex> lock(indexMutex_);
+            index_.erase(date);
+        }
         std::pair<bool, string> addFX = {true, ""};
         if (md->instrumentType() == MarketDatum::InstrumentType::FX_SPOT &&
             md->quoteType() == MarketDatum::QuoteType::RATE) {
@@ -144,6 +142,10 @@ void InMemoryLoader::addDividend(const QuantExt::Dividend& dividend) {
 
 void InMemoryLoader::reset() {
     data_.clear();
+    {
+        boost::unique_lock<boost::shared_mutex> lock(indexMutex_);
+        index_.clear();
+    }
     fixings_.clear();
     dividends_.clear();
     actualDate_ = Date();
@@ -19,8 +19,11 @@
 #pragma once
 
 #include <ored/marketdata/loader.hpp>
+#include <ored/marketdata/marketdatumindex.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 
+#include <boost/thread/shared_mutex.hpp>
+
 namespace ore {
 namespace data {
 using std::string;
@@ -54,6 +57,11 @@ protected:
     std::map<QuantLib::Date, std::set<QuantLib::ext::shared_ptr<MarketDatum>, SharedPtrMarketDatumComparator>> data_;
     std::set<Fixing> fixings_;
     std::set<QuantExt::Dividend> dividends_;
+
+private:
+    // name index per date for wildcard lookups, built on first use and rebuilt if data_ has changed
+    mutable std::map<QuantLib::Date, MarketDatumIndex> index_;
+    mutable boost::shared_mutex indexMutex_;
 };
 
 //! Utility function for loading market quotes and fixings from an in memory csv buffer
@@ -0,0 +1,76 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/marketcache.hpp>
+#include <ored/utilities/log.hpp>
+
+namespace ore {
+namespace data {
+
+MarketCache::MarketCache(const QuantLib::Size maxSize) : maxSize_(maxSize) {
+    QL_REQUIRE(maxSize_ > 0, "MarketCache: maxSize must be positive");
+}
+
+QuantLib::ext::shared_ptr<Market> MarketCache::get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto m = markets_.begin(); m != markets_.end(); ++m) {
+        if (m->first == key) {
+            markets_.splice(markets_.begin(), markets_, m);
+            ++hits_;
+            return markets_.front().second;
+        }
+    }
+    ++misses_;
+    return nullptr;
+}
+
+void MarketCache::add(const std::string& key, const QuantLib::ext::shared_ptr<Market>& market) {
+    QL_REQUIRE(market, "MarketCache: market for key '" << key << "' is null");
+    std::lock_guard<std::mutex> lock(mutex_);
+    markets_.remove_if([&key](const std::pair<std::string, QuantLib::ext::shared_ptr<Market>>& m) {
+        return m.first == key;
+    });
+    markets_.emplace_front(key, market);
+    while (markets_.size() > maxSize_) {
+        DLOG("MarketCache: remove market with key '" << markets_.back().first << "'");
+        markets_.pop_back();
+    }
+}
+
+void MarketCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    markets_.clear();
+}
+
+QuantLib::Size MarketCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return markets_.size();
+}
+
+QuantLib::Size MarketCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+QuantLib::Size MarketCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+} // namespace data
+} // namespace ore
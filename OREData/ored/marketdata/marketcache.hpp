@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/marketcache.hpp
+    \brief In-memory cache of built markets
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/marketdata/market.hpp>
+
+#include <list>
+#include <mutex>
+
+namespace ore {
+namespace data {
+
+/*! In-memory cache of built markets
+
+    Keeps markets resident between runs of a long-running application. The markets are identified by a key describing
+    their inputs, see MarketSnapshot::key(), so that a market is only reused if the market data, the todays market
+    parameters and the curve configurations are unchanged. If the cache is full, the least recently used market is
+    removed.
+
+    \ingroup marketdata
+*/
+class MarketCache {
+public:
+    explicit MarketCache(const QuantLib::Size maxSize = 4);
+
+    //! The market for the given key or null if there is none
+    QuantLib::ext::shared_ptr<Market> get(const std::string& key);
+    //! Add a market, replaces an existing market with the same key
+    void add(const std::string& key, const QuantLib::ext::shared_ptr<Market>& market);
+    //! Remove all markets
+    void clear();
+
+    QuantLib::Size size() const;
+    QuantLib::Size maxSize() const { return maxSize_; }
+    QuantLib::Size hits() const;
+    QuantLib::Size misses() const;
+
+private:
+    QuantLib::Size maxSize_;
+    // most recently used first
+    std::list<std::pair<std::string, QuantLib::ext::shared_ptr<Market>>> markets_;
+    QuantLib::Size hits_ = 0, misses_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace data
+} // namespace ore
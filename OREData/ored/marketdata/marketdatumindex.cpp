@@ -0,0 +1,151 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/marketdatumindex.hpp>
+
+#include <algorithm>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+// add q and, while q points to a '*', the position after it (a '*' may match the empty string)
+void addState(const std::string& pattern, std::size_t q, std::vector<std::size_t>& states) {
+    while (true) {
+        if (std::find(states.begin(), states.end(), q) == states.end())
+            states.push_back(q);
+        if (q < pattern.size() && pattern[q] == '*')
+            ++q;
+        else
+            break;
+    }
+}
+
+// the pattern positions reachable from states after consuming the given characters
+std::vector<std::size_t> advance(const std::string& pattern, std::vector<std::size_t> states, const char* begin,
+                                 const char* end) {
+    std::vector<std::size_t> next;
+    for (const char* c = begin; c != end && !states.empty(); ++c) {
+        next.clear();
+        for (auto q : states) {
+            if (q == pattern.size())
+                continue;
+            if (pattern[q] == '*')
+                addState(pattern, q, next);
+            else if (pattern[q] == *c)
+                addState(pattern, q + 1, next);
+        }
+        states.swap(next);
+    }
+    return states;
+}
+
+bool accepts(const std::string& pattern, const std::vector<std::size_t>& states) {
+    return std::find(states.begin(), states.end(), pattern.size()) != states.end();
+}
+
+} // namespace
+
+MarketDatumIndex::MarketDatumIndex() : nodes_(1), size_(0) {}
+
+void MarketDatumIndex::add(const QuantLib::ext::shared_ptr<MarketDatum>& md) {
+    const std::string& name = md->name();
+    std::size_t node = 0, start = 0;
+    while (true) {
+        std::size_t end = name.find('/', start);
+        std::string token = name.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        auto it = nodes_[node].children.find(token);
+        if (it == nodes_[node].children.end()) {
+            nodes_.push_back(Node());
+            it = nodes_[node].children.insert(std::make_pair(token, nodes_.size() - 1)).first;
+        }
+        node = it->second;
+        if (end == std::string::npos)
+            break;
+        start = end + 1;
+    }
+    if (nodes_[node].datum == nullptr)
+        ++size_;
+    nodes_[node].datum = md;
+}
+
+std::set<QuantLib::ext::shared_ptr<MarketDatum>> MarketDatumIndex::get(const Wildcard& wildcard) const {
+    // a prefix wildcard ignores everything after the first '*' (aggressive prefixes)
+    std::string pattern = wildcard.isPrefix() ? wildcard.prefix() + "*" : wildcard.pattern();
+    std::vector<std::size_t> states;
+    addState(pattern, 0, states);
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
+    collect(0, pattern, states, result);
+    return result;
+}
+
+void MarketDatumIndex::collect(std::size_t node, const std::string& pattern, const std::vector<std::size_t>& states,
+                               std::set<QuantLib::ext::shared_ptr<MarketDatum>>& result) const {
+    const Node& n = nodes_[node];
+    if (n.children.empty() || (states.size() == 1 && states.front() == pattern.size()))
+        return;
+
+    // the token separator consumed before the child tokens
+    std::size_t sepSize = node == 0 ? 0 : 1;
+
+    // visits a child, i.e. consumes the separator and the child token and recurses if there is a state left
+    auto visit = [this, &pattern, &result, node](const std::pair<const std::string, std::size_t>& child,
+                                                 std::vector<std::size_t> s) {
+        if (node != 0) {
+            const char sep = '/';
+            s = advance(pattern, s, &sep, &sep + 1);
+        }
+        s = advance(pattern, s, child.first.data(), child.first.data() + child.first.size());
+        if (s.empty())
+            return;
+        if (accepts(pattern, s) && nodes_[child.second].datum)
+            result.insert(nodes_[child.second].datum);
+        collect(child.second, pattern, s, result);
+    };
+
+    if (states.size() == 1 && pattern[states.front()] != '*') {
+        // no wildcard active: the next token is a literal or starts with one, look it up in the children
+        std::size_t q = states.front();
+        if (sepSize == 1 && pattern[q] != '/')
+            return;
+        std::size_t tokenStart = q + sepSize;
+        std::size_t tokenEnd = std::min(pattern.find('/', tokenStart), pattern.find('*', tokenStart));
+        std::string token = pattern.substr(tokenStart, tokenEnd == std::string::npos ? std::string::npos
+                                                                                      : tokenEnd - tokenStart);
+        if (tokenEnd == std::string::npos || pattern[tokenEnd] == '/') {
+            // full literal token
+            auto it = n.children.find(token);
+            if (it != n.children.end())
+                visit(*it, states);
+        } else {
+            // the token continues with a wildcard, restrict to the children starting with the literal part
+            for (auto it = n.children.lower_bound(token);
+                 it != n.children.end() && it->first.compare(0, token.size(), token) == 0; ++it)
+                visit(*it, states);
+        }
+        return;
+    }
+
+    // a wildcard is active, all children might match
+    for (auto const& child : n.children)
+        visit(child, states);
+}
+
+} // namespace data
+} // namespace ore
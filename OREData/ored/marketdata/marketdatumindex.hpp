@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/marketdatumindex.hpp
+    \brief name index for wildcard lookups of market data
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/marketdata/marketdatum.hpp>
+#include <ored/utilities/wildcard.hpp>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Index of market data by name
+/*! The names are stored in a trie over their '/' separated tokens. Wildcard queries descend the trie by exact token
+    lookups as long as the pattern does not contain a wildcard and then match the remaining pattern against the
+    subtree, dropping branches as soon as they can not match any more. This avoids both a scan over all data and a
+    regex match per datum.
+
+    \ingroup marketdata
+*/
+class MarketDatumIndex {
+public:
+    MarketDatumIndex();
+    template <class I> MarketDatumIndex(I begin, I end) : MarketDatumIndex() {
+        for (I it = begin; it != end; ++it)
+            add(*it);
+    }
+
+    //! add a datum, an existing datum with the same name is replaced
+    void add(const QuantLib::ext::shared_ptr<MarketDatum>& md);
+    //! number of data in the index
+    std::size_t size() const { return size_; }
+    //! data with names matching the wildcard
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> get(const Wildcard& wildcard) const;
+
+private:
+    struct Node {
+        std::map<std::string, std::size_t> children;
+        QuantLib::ext::shared_ptr<MarketDatum> datum;
+    };
+    void collect(std::size_t node, const std::string& pattern, const std::vector<std::size_t>& states,
+                 std::set<QuantLib::ext::shared_ptr<MarketDatum>>& result) const;
+    std::vector<Node> nodes_;
+    std::size_t size_;
+};
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,432 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/configuration/conventions.hpp>
+#include <ored/marketdata/fixings.hpp>
+#include <ored/marketdata/marketdatum.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
+#include <ored/utilities/indexparser.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+#include <qle/indexes/dividendmanager.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/termstructures/yield/discountcurve.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using QuantLib::Date;
+using QuantLib::DayCounter;
+using QuantLib::Handle;
+using QuantLib::Real;
+using QuantLib::Size;
+using QuantLib::YieldTermStructure;
+using std::string;
+using std::vector;
+
+namespace ore {
+namespace data {
+
+namespace {
+
+// identifies the binary file format, the last character is the format version
+const char binaryMagic[8] = {'O', 'R', 'E', 'M', 'K', 'T', 'S', '1'};
+
+template <typename T> void writePod(std::ostream& os, const T& t) {
+    os.write(reinterpret_cast<const char*>(&t), sizeof(T));
+}
+
+template <typename T> void readPod(std::istream& is, T& t) {
+    is.read(reinterpret_cast<char*>(&t), sizeof(T));
+    QL_REQUIRE(is, "MarketSnapshot: unexpected end of snapshot file");
+}
+
+template <typename T> void writeVector(std::ostream& os, const vector<T>& v) {
+    writePod(os, static_cast<std::uint64_t>(v.size()));
+    if (!v.empty())
+        os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+template <typename T> void readVector(std::istream& is, vector<T>& v) {
+    std::uint64_t n;
+    readPod(is, n);
+    v.resize(n);
+    if (n > 0) {
+        is.read(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+        QL_REQUIRE(is, "MarketSnapshot: unexpected end of snapshot file");
+    }
+}
+
+void writeString(std::ostream& os, const string& s) {
+    writePod(os, static_cast<std::uint64_t>(s.size()));
+    os.write(s.data(), s.size());
+}
+
+string readString(std::istream& is) {
+    std::uint64_t n;
+    readPod(is, n);
+    string s(n, '\0');
+    if (n > 0) {
+        is.read(&s[0], n);
+        QL_REQUIRE(is, "MarketSnapshot: unexpected end of snapshot file");
+    }
+    return s;
+}
+
+// daily grid up to 30 years, monthly grid up to 100 years
+vector<Date> samplingGrid(const Date& asof) {
+    // a daily grid, so that the restored curves are exact on all dates within the horizon
+    vector<Date> dates;
+    Date end = asof + 100 * QuantLib::Years;
+    dates.reserve(end - asof + 1);
+    for (Date d = asof; d <= end; ++d)
+        dates.push_back(d);
+    return dates;
+}
+
+// a yield term structure sampled on the snapshot grid
+struct SampledCurve {
+    string dayCounter;
+    bool extrapolation = false;
+    vector<std::int32_t> dates;
+    vector<Real> discounts;
+};
+
+SampledCurve sample(const string& spec, const Handle<YieldTermStructure>& curve, const Date& asof,
+                    const vector<Date>& grid) {
+    QL_REQUIRE(!curve.empty(), "MarketSnapshot: curve '" << spec << "' is empty");
+    QL_REQUIRE(curve->referenceDate() == asof, "MarketSnapshot: curve '" << spec << "' has reference date "
+                                                                         << curve->referenceDate()
+                                                                         << ", expected asof date " << asof);
+    SampledCurve c;
+    c.dayCounter = curve->dayCounter().name();
+    QL_REQUIRE(parseDayCounter(c.dayCounter) == curve->dayCounter(),
+               "MarketSnapshot: day counter '" << c.dayCounter << "' of curve '" << spec << "' can not be restored");
+    c.extrapolation = curve->allowsExtrapolation();
+    c.dates.reserve(grid.size());
+    c.discounts.reserve(grid.size());
+    for (auto const& d : grid) {
+        c.dates.push_back(d.serialNumber());
+        c.discounts.push_back(curve->discount(d, true));
+    }
+    return c;
+}
+
+bool isSupported(const MarketObject o) {
+    return o == MarketObject::DiscountCurve || o == MarketObject::YieldCurve || o == MarketObject::IndexCurve ||
+           o == MarketObject::SwapIndexCurve || o == MarketObject::FXSpot;
+}
+
+} // namespace
+
+MarketSnapshot::MarketSnapshot(const string& filename, const string& key, const Date& asof,
+                               const QuantLib::ext::shared_ptr<Loader>& loader, const bool loadFixings,
+                               const bool handlePseudoCurrencies)
+    : MarketImpl(handlePseudoCurrencies) {
+
+    QL_REQUIRE(loader, "MarketSnapshot: Loader is null");
+    asof_ = asof;
+
+    std::ifstream is(filename.c_str(), std::ios::binary);
+    QL_REQUIRE(is.is_open(), "MarketSnapshot: error opening file " << filename);
+    char magic[sizeof(binaryMagic)];
+    is.read(magic, sizeof(magic));
+    QL_REQUIRE(is && std::equal(magic, magic + sizeof(magic), binaryMagic),
+               "MarketSnapshot: file " << filename << " is not a market snapshot or has an unsupported version");
+    string fileKey = readString(is);
+    QL_REQUIRE(fileKey == key, "MarketSnapshot: file " << filename << " has key " << fileKey << ", expected " << key);
+    std::int32_t fileAsof;
+    readPod(is, fileAsof);
+    QL_REQUIRE(fileAsof == asof.serialNumber(),
+               "MarketSnapshot: file " << filename << " has asof " << Date(fileAsof) << ", expected " << asof);
+
+    // fixings, dividends and fx quotes, as in TodaysMarket
+
+    if (loadFixings)
+        applyFixings(loader->loadFixings());
+    QuantExt::applyDividends(loader->loadDividends());
+
+    std::map<string, Handle<QuantLib::Quote>> fxQuotes;
+    if (loader->hasQuotes(asof_)) {
+        for (auto& md : loader->get(Wildcard("FX/RATE/*"), asof_)) {
+            auto q = QuantLib::ext::dynamic_pointer_cast<FXSpotQuote>(md);
+            QL_REQUIRE(q, "Failed to cast " << md->name() << " to FXSpotQuote");
+            fxQuotes[q->unitCcy() + q->ccy()] = q->quote();
+        }
+    }
+    fx_ = QuantLib::ext::make_shared<FXTriangulation>(fxQuotes);
+
+    // curves by spec
+
+    std::map<string, Handle<YieldTermStructure>> curves;
+    std::uint64_t n;
+    readPod(is, n);
+    for (std::uint64_t i = 0; i < n; ++i) {
+        string spec = readString(is);
+        DayCounter dc = parseDayCounter(readString(is));
+        std::uint8_t extrapolation;
+        readPod(is, extrapolation);
+        vector<std::int32_t> serials;
+        vector<Real> discounts;
+        readVector(is, serials);
+        readVector(is, discounts);
+        QL_REQUIRE(serials.size() == discounts.size() && !serials.empty(),
+                   "MarketSnapshot: inconsistent data for curve '" << spec << "' in file " << filename);
+        vector<Date> dates(serials.begin(), serials.end());
+        auto curve = QuantLib::ext::make_shared<QuantLib::DiscountCurve>(dates, discounts, dc);
+        if (extrapolation != 0)
+            curve->enableExtrapolation();
+        curves[spec] = Handle<YieldTermStructure>(curve);
+    }
+
+    auto curve = [&curves, &filename](const string& spec) {
+        auto c = curves.find(spec);
+        QL_REQUIRE(c != curves.end(), "MarketSnapshot: curve '" << spec << "' not found in file " << filename);
+        return c->second;
+    };
+
+    // discount and yield curves
+
+    readPod(is, n);
+    for (std::uint64_t i = 0; i < n; ++i) {
+        string configuration = readString(is);
+        std::uint8_t type;
+        readPod(is, type);
+        string name = readString(is);
+        yieldCurves_[std::make_tuple(configuration, static_cast<YieldCurveType>(type), name)] = curve(readString(is));
+    }
+
+    // ibor indices, swap indices may refer to them, so they are added first
+
+    readPod(is, n);
+    for (std::uint64_t i = 0; i < n; ++i) {
+        string configuration = readString(is);
+        string name = readString(is);
+        iborIndices_[std::make_pair(configuration, name)] =
+            Handle<QuantLib::IborIndex>(parseIborIndex(name, curve(readString(is))));
+    }
+
+    readPod(is, n);
+    for (std::uint64_t i = 0; i < n; ++i) {
+        string configuration = readString(is);
+        string name = readString(is);
+        addSwapIndex(name, readString(is), configuration);
+    }
+
+    LOG("MarketSnapshot: restored " << curves.size() << " curves, " << yieldCurves_.size() << " yield curves, "
+                                    << iborIndices_.size() << " ibor indices and " << swapIndices_.size()
+                                    << " swap indices from file " << filename);
+}
+
+string MarketSnapshot::key(const Date& asof, const QuantLib::ext::shared_ptr<TodaysMarketParameters>& params,
+                           const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs, const Loader& loader,
+                           const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
+                           const IborFallbackConfig& iborFallbackConfig, const bool continueOnError,
+                           const bool lazyBuild) {
+    QL_REQUIRE(params, "MarketSnapshot: TodaysMarketParameters are null");
+    QL_REQUIRE(curveConfigs, "MarketSnapshot: CurveConfigurations are null");
+
+    std::size_t seed = 0;
+    boost::hash_combine(seed, asof.serialNumber());
+    boost::hash_combine(seed, params->toXMLString());
+
+    // curve configurations and conventions used by the market objects
+
+    std::set<string> configurations;
+    for (auto const& c : params->configurations())
+        configurations.insert(c.first);
+    boost::hash_combine(seed, curveConfigs->minimalCurveConfig(params, configurations)->toXMLString());
+
+    std::set<string> conventionIds = curveConfigs->conventions(params, configurations);
+    for (auto const& c : configurations) {
+        for (auto const& m : params->mapping(MarketObject::IndexCurve, c))
+            conventionIds.insert(m.first);
+    }
+    auto conventions = InstrumentConventions::instance().conventions();
+    for (auto const& id : conventionIds) {
+        boost::hash_combine(seed, id);
+        if (conventions->has(id))
+            boost::hash_combine(seed, conventions->get(id)->toXMLString());
+    }
+
+    // market data, the quotes are combined independent of their order in the loader
+
+    std::size_t quotesSeed = 0;
+    if (loader.hasQuotes(asof)) {
+        for (auto const& md : loader.loadQuotes(asof)) {
+            std::size_t h = 0;
+            boost::hash_combine(h, md->name());
+            boost::hash_combine(h, md->quote()->value());
+            quotesSeed += h;
+        }
+    }
+    boost::hash_combine(seed, quotesSeed);
+
+    for (auto const& f : loader.loadFixings()) {
+        boost::hash_combine(seed, f.name);
+        boost::hash_combine(seed, f.date.serialNumber());
+        boost::hash_combine(seed, f.fixing);
+    }
+
+    for (auto const& d : loader.loadDividends()) {
+        boost::hash_combine(seed, d.name);
+        boost::hash_combine(seed, d.exDate.serialNumber());
+        boost::hash_combine(seed, d.payDate.serialNumber());
+        boost::hash_combine(seed, d.rate);
+    }
+
+    // reference data, ibor fallback configuration and build flags
+
+    if (auto r = QuantLib::ext::dynamic_pointer_cast<XMLSerializable>(referenceData))
+        boost::hash_combine(seed, r->toXMLString());
+    else
+        boost::hash_combine(seed, referenceData.get());
+    boost::hash_combine(seed, iborFallbackConfig.toXMLString());
+    boost::hash_combine(seed, continueOnError);
+    boost::hash_combine(seed, lazyBuild);
+
+    std::ostringstream s;
+    s << std::hex << std::setw(2 * sizeof(std::size_t)) << std::setfill('0') << seed;
+    return s.str();
+}
+
+string MarketSnapshot::fileKey(const string& filename) {
+    std::ifstream is(filename.c_str(), std::ios::binary);
+    if (!is.is_open())
+        return string();
+    char magic[sizeof(binaryMagic)];
+    is.read(magic, sizeof(magic));
+    if (!is || !std::equal(magic, magic + sizeof(magic), binaryMagic))
+        return string();
+    try {
+        return readString(is);
+    } catch (const std::exception&) {
+        return string();
+    }
+}
+
+bool MarketSnapshot::supported(const Date& asof, const TodaysMarketParameters& params,
+                               const IborFallbackConfig& iborFallbackConfig) {
+    for (auto const& c : params.configurations()) {
+        for (Size o = 0; o <= static_cast<Size>(MarketObject::YieldVol); ++o) {
+            MarketObject obj = static_cast<MarketObject>(o);
+            if (!params.hasMarketObject(obj) || params.mapping(obj, c.first).empty())
+                continue;
+            if (!isSupported(obj)) {
+                DLOG("MarketSnapshot: market object " << obj << " is not supported");
+                return false;
+            }
+            if (obj == MarketObject::IndexCurve) {
+                for (auto const& m : params.mapping(obj, c.first)) {
+                    if (iborFallbackConfig.isIndexReplaced(m.first, asof)) {
+                        DLOG("MarketSnapshot: ibor fallback index " << m.first << " is not supported");
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void MarketSnapshot::write(const string& filename, const string& key, const Date& asof, const Market& market,
+                           const TodaysMarketParameters& params) {
+
+    // collect the curves by spec, since several market objects and configurations usually share a curve
+
+    vector<Date> grid = samplingGrid(asof);
+    std::map<string, SampledCurve> curves;
+    vector<std::tuple<string, YieldCurveType, string, string>> yieldCurves;
+    vector<std::tuple<string, string, string>> iborIndices, swapIndices;
+
+    for (auto const& c : params.configurations()) {
+        const string& configuration = c.first;
+        for (auto const& [o, type] : {std::make_pair(MarketObject::DiscountCurve, YieldCurveType::Discount),
+                                      std::make_pair(MarketObject::YieldCurve, YieldCurveType::Yield)}) {
+            if (!params.hasMarketObject(o))
+                continue;
+            for (auto const& [name, spec] : params.mapping(o, configuration)) {
+                if (curves.find(spec) == curves.end())
+                    curves[spec] = sample(spec, market.yieldCurve(type, name, configuration), asof, grid);
+                yieldCurves.push_back(std::make_tuple(configuration, type, name, spec));
+            }
+        }
+        if (params.hasMarketObject(MarketObject::IndexCurve)) {
+            for (auto const& [name, spec] : params.mapping(MarketObject::IndexCurve, configuration)) {
+                if (curves.find(spec) == curves.end())
+                    curves[spec] = sample(spec, market.iborIndex(name, configuration)->forwardingTermStructure(),
+                                          asof, grid);
+                iborIndices.push_back(std::make_tuple(configuration, name, spec));
+            }
+        }
+        if (params.hasMarketObject(MarketObject::SwapIndexCurve)) {
+            for (auto const& [name, discountIndex] : params.mapping(MarketObject::SwapIndexCurve, configuration))
+                swapIndices.push_back(std::make_tuple(configuration, name, discountIndex));
+        }
+    }
+
+    // write to a temporary file first, so that a failure does not leave a corrupted snapshot behind
+
+    string tmpFile = filename + ".tmp";
+    {
+        std::ofstream os(tmpFile.c_str(), std::ios::binary);
+        QL_REQUIRE(os.is_open(), "MarketSnapshot: error opening file " << tmpFile);
+        os.write(binaryMagic, sizeof(binaryMagic));
+        writeString(os, key);
+        writePod(os, static_cast<std::int32_t>(asof.serialNumber()));
+        writePod(os, static_cast<std::uint64_t>(curves.size()));
+        for (auto const& [spec, c] : curves) {
+            writeString(os, spec);
+            writeString(os, c.dayCounter);
+            writePod(os, static_cast<std::uint8_t>(c.extrapolation ? 1 : 0));
+            writeVector(os, c.dates);
+            writeVector(os, c.discounts);
+        }
+        writePod(os, static_cast<std::uint64_t>(yieldCurves.size()));
+        for (auto const& [configuration, type, name, spec] : yieldCurves) {
+            writeString(os, configuration);
+            writePod(os, static_cast<std::uint8_t>(type));
+            writeString(os, name);
+            writeString(os, spec);
+        }
+        for (auto const& indices : {iborIndices, swapIndices}) {
+            writePod(os, static_cast<std::uint64_t>(indices.size()));
+            for (auto const& [configuration, name, value] : indices) {
+                writeString(os, configuration);
+                writeString(os, name);
+                writeString(os, value);
+            }
+        }
+        os.close();
+        QL_REQUIRE(os, "MarketSnapshot: error writing file " << tmpFile);
+    }
+    std::remove(filename.c_str());
+    QL_REQUIRE(std::rename(tmpFile.c_str(), filename.c_str()) == 0,
+               "MarketSnapshot: error renaming " << tmpFile << " to " << filename);
+
+    LOG("MarketSnapshot: wrote " << curves.size() << " curves to file " << filename);
+}
+
+} // namespace data
+} // namespace ore
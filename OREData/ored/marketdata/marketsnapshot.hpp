@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/marketsnapshot.hpp
+    \brief Market restored from an on-disk snapshot of a built market
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/configuration/iborfallbackconfig.hpp>
+#include <ored/marketdata/loader.hpp>
+#include <ored/marketdata/marketimpl.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/portfolio/referencedata.hpp>
+
+namespace ore {
+namespace data {
+
+/*! Market restored from an on-disk snapshot of a market built by TodaysMarket
+
+    Intraday reruns of an application on unchanged market data spend a considerable amount of time on the curve
+    bootstrap. A snapshot stores the built term structures in a binary file together with a key, which is a hash
+    of the inputs that determine the market, i.e. the asof date, the market data quotes, fixings and dividends, the
+    todays market parameters, the curve configurations and the conventions used by them, the reference data, the ibor
+    fallback configuration and the TodaysMarket build flags. If a rerun computes the same key, the market can be
+    restored from the file instead of being built from scratch.
+
+    Only markets consisting of discount curves, yield curves, index curves, swap index curves and fx spots are
+    supported, see supported(). Markets with other objects (volatilities, credit, inflation, equity, commodity) or
+    ibor fallback indices have to be built by TodaysMarket. The fx spots, fixings and dividends are taken from the
+    loader as in TodaysMarket.
+
+    Yield term structures are stored as discount factors on a daily grid up to 100 years after the asof date and
+    restored as log-linearly interpolated discount curves. They are therefore exact on all dates up to 100 years,
+    so that date based pricing (cashflow discounting, ibor and swap index forecasts) is unchanged. Queries at times
+    between two dates, e.g. instantaneous forward rates, and beyond 100 years follow the log-linear interpolation
+    and extrapolation instead of the interpolation of the original curve. The restored curves do not depend on the
+    quotes of the loader, i.e. they are not rebuilt if a quote changes.
+
+    The binary format is not portable between platforms with different endianness.
+
+    \ingroup marketdata
+*/
+class MarketSnapshot : public MarketImpl {
+public:
+    /*! Restore the market from the snapshot file, throws if the file can not be read or the key stored in the file
+        does not match the given key */
+    MarketSnapshot(const std::string& filename, const std::string& key, const QuantLib::Date& asof,
+                   const QuantLib::ext::shared_ptr<Loader>& loader, const bool loadFixings = true,
+                   const bool handlePseudoCurrencies = true);
+
+    /*! The key identifying the inputs of the market, the last four arguments are those passed to TodaysMarket.
+        Reference data that is not XML serializable is identified by its address, i.e. it only matches within the
+        same run. */
+    static std::string
+    key(const QuantLib::Date& asof, const QuantLib::ext::shared_ptr<TodaysMarketParameters>& params,
+        const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs, const Loader& loader,
+        const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData = nullptr,
+        const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
+        const bool continueOnError = false, const bool lazyBuild = true);
+
+    //! The key stored in a snapshot file, or an empty string if the file does not exist or is not a snapshot file
+    static std::string fileKey(const std::string& filename);
+
+    //! True if all market objects in the todays market parameters can be restored from a snapshot
+    static bool supported(const QuantLib::Date& asof, const TodaysMarketParameters& params,
+                          const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig());
+
+    //! Write a snapshot of the given market, which was built from the given todays market parameters
+    static void write(const std::string& filename, const std::string& key, const QuantLib::Date& asof,
+                      const Market& market, const TodaysMarketParameters& params);
+};
+
+} // namespace data
+} // namespace ore
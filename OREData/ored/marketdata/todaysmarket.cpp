@@ -52,6 +52,7 @@
 #include <qle/indexes/inflationindexwrapper.hpp>
 #include <qle/termstructures/blackvolsurfacewithatm.hpp>
 #include <qle/termstructures/pricetermstructureadapter.hpp>
+#include <qle/utilities/profiler.hpp>
 
 #include <ql/tuple.hpp>
 
@@ -99,6 +100,8 @@ struct Count {
 
 void TodaysMarket::initialise(const Date& asof) {
 
+    QLE_PROFILE_ZONE("TodaysMarket::initialise");
+
     std::map<std::string, boost::timer::nanosecond_type> timings;
     std::map<std::string, Count> counts;
     boost::timer::cpu_timer timer;
@@ -64,9 +64,12 @@
 #include <ored/marketdata/inmemoryloader.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
+#include <ored/marketdata/marketcache.hpp>
 #include <ored/marketdata/marketdatum.hpp>
+#include <ored/marketdata/marketdatumindex.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/marketdata/marketimpl.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
 #include <ored/marketdata/security.hpp>
 #include <ored/marketdata/strike.hpp>
 #include <ored/marketdata/structuredcurveerror.hpp>
@@ -335,6 +338,7 @@
 #include <ored/portfolio/varianceswap.hpp>
 #include <ored/portfolio/windowbarrieroption.hpp>
 #include <ored/portfolio/worstofbasketswap.hpp>
+#include <ored/report/columnarreport.hpp>
 #include <ored/report/csvreport.hpp>
 #include <ored/report/inmemoryreport.hpp>
 #include <ored/report/report.hpp>
@@ -372,6 +376,7 @@
 #include <ored/scripting/models/modelcg.hpp>
 #include <ored/scripting/models/modelcgimpl.hpp>
 #include <ored/scripting/models/modelimpl.hpp>
+#include <ored/scripting/models/pathcache.hpp>
 #include <ored/scripting/paylog.hpp>
 #include <ored/scripting/randomastgenerator.hpp>
 #include <ored/scripting/safestack.hpp>
@@ -505,6 +505,7 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
     externalComputeDevice_ = engineParameter("ExternalComputeDevice", {}, false, "");
     externalDeviceCompatibilityMode_ = parseBool(engineParameter("ExternalDeviceCompatibilityMode", {}, false, "false"));
     includePastCashflows_ = parseBool(engineParameter("IncludePastCashflows", {resolvedProductTag_}, false, "false"));
+    sharePaths_ = parseBool(engineParameter("SharePaths", {resolvedProductTag_}, false, "false"));
 
     // usage of ad or an external device implies usage of cg
     if (useAd_ || useExternalComputeDevice_)
@@ -1648,7 +1649,8 @@ void ScriptedTradeEngineBuilder::buildGaussianCam(const std::string& id, const I
             camBuilder->model(), modelSize_, modelCcys_, modelCurves_, modelFxSpots_, modelIrIndices_, modelInfIndices_,
             modelIndices_, modelIndicesCurrencies_, simulationDates_, mcParams_,
             camBuilder->model()->discretization() == CrossAssetModel::Discretization::Exact ? 0 : timeStepsPerYear_,
-            iborFallbackConfig, std::vector<Size>(), conditionalExpectationModelStates);
+            iborFallbackConfig, std::vector<Size>(), conditionalExpectationModelStates,
+            sharePaths_ ? pathCache_ : nullptr);
     }
 
     modelBuilders_.insert(std::make_pair(id, camBuilder));
@@ -20,6 +20,7 @@
 
 #include <ored/scripting/models/model.hpp>
 #include <ored/scripting/models/modelcg.hpp>
+#include <ored/scripting/models/pathcache.hpp>
 #include <ored/portfolio/scriptedtrade.hpp>
 #include <ored/scripting/ast.hpp>
 #include <ored/scripting/staticanalyser.hpp>
@@ -114,6 +115,9 @@ protected:
     // cache for parsed asts
     std::map<std::string, ASTNodePtr> astCache_;
 
+    // cache for paths shared between the models built by this builder
+    QuantLib::ext::shared_ptr<PathCache> pathCache_ = QuantLib::ext::make_shared<PathCache>();
+
     // populated by a call to engine()
     ASTNodePtr ast_;
     std::string npvCurrency_;
@@ -164,6 +168,7 @@ protected:
     bool externalDeviceCompatibilityMode_;
     std::string externalComputeDevice_;
     bool includePastCashflows_;
+    bool sharePaths_;
 };
 
 } // namespace data
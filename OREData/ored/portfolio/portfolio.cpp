@@ -27,6 +27,7 @@
 #include <ored/utilities/xmlutils.hpp>
 #include <ql/errors.hpp>
 #include <ql/time/date.hpp>
+#include <qle/utilities/profiler.hpp>
 
 using namespace QuantLib;
 using namespace std;
@@ -122,6 +123,7 @@ void Portfolio::removeMatured(const Date& asof) {
 void Portfolio::build(const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory, const std::string& context,
                       const bool emitStructuredError) {
     LOG("Building Portfolio of size " << trades_.size() << " for context = '" << context << "'");
+    QLE_PROFILE_ZONE("Portfolio::build");
     auto trade = trades_.begin();
     Size initialSize = trades_.size();
     Size failedTrades = 0;
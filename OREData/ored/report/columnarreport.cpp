@@ -0,0 +1,359 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/report/columnarreport.hpp>
+#include <ored/report/csvreport.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+// identifies the binary file format, the last character is the format version
+const char binaryMagic[8] = {'O', 'R', 'E', 'C', 'O', 'L', 'R', '1'};
+
+template <typename T> void writePod(std::ostream& os, const T& t) {
+    os.write(reinterpret_cast<const char*>(&t), sizeof(T));
+}
+
+template <typename T> void readPod(std::istream& is, T& t) {
+    is.read(reinterpret_cast<char*>(&t), sizeof(T));
+    QL_REQUIRE(is, "ColumnarReport: unexpected end of binary file");
+}
+
+template <typename T> void writeVector(std::ostream& os, const vector<T>& v) {
+    writePod(os, static_cast<std::uint64_t>(v.size()));
+    if (!v.empty())
+        os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+template <typename T> void readVector(std::istream& is, vector<T>& v, std::uint64_t expectedSize) {
+    std::uint64_t n;
+    readPod(is, n);
+    QL_REQUIRE(n == expectedSize,
+               "ColumnarReport: binary file has column of size " << n << ", expected " << expectedSize);
+    v.resize(n);
+    if (n > 0) {
+        is.read(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+        QL_REQUIRE(is, "ColumnarReport: unexpected end of binary file");
+    }
+}
+
+void writeString(std::ostream& os, const string& s) {
+    writePod(os, static_cast<std::uint64_t>(s.size()));
+    os.write(s.data(), s.size());
+}
+
+string readString(std::istream& is) {
+    std::uint64_t n;
+    readPod(is, n);
+    string s(n, '\0');
+    if (n > 0) {
+        is.read(&s[0], n);
+        QL_REQUIRE(is, "ColumnarReport: unexpected end of binary file");
+    }
+    return s;
+}
+
+// the Date() serial number is 0, which is not a valid argument for the Date constructor
+Date toDate(std::int32_t serial) { return serial == 0 ? Date() : Date(serial); }
+
+} // namespace
+
+Report& ColumnarReport::addColumn(const string& name, const ReportType& rt, Size precision) {
+    QL_REQUIRE(rows() == 0, "ColumnarReport: can not add column " << name << " after rows were added");
+    Column c;
+    c.header = name;
+    c.type = rt;
+    c.precision = precision;
+    c.columnType = static_cast<ColumnType>(rt.which());
+    columns_.push_back(std::move(c));
+    i_++;
+    return *this;
+}
+
+Report& ColumnarReport::next() {
+    QL_REQUIRE(i_ == columns_.size(), "Cannot go to next line, only " << i_ << " entries filled, report has "
+                                                                      << columns_.size() << " columns");
+    i_ = 0;
+    return *this;
+}
+
+Report& ColumnarReport::add(const ReportType& rt) {
+    QL_REQUIRE(i_ < columns_.size(), "No column to add [" << rt << "] to.");
+    Column& c = columns_[i_];
+    QL_REQUIRE(rt.which() == static_cast<int>(c.columnType), "Cannot add value " << rt << " of type " << rt.which()
+                                                                                 << " to column " << c.header
+                                                                                 << " of type "
+                                                                                 << static_cast<int>(c.columnType));
+    switch (c.columnType) {
+    case ColumnType::Size:
+        c.sizes.push_back(boost::get<Size>(rt));
+        break;
+    case ColumnType::Real:
+        c.reals.push_back(boost::get<Real>(rt));
+        break;
+    case ColumnType::String:
+        addString(c, boost::get<string>(rt));
+        break;
+    case ColumnType::Date:
+        c.dates.push_back(static_cast<std::int32_t>(boost::get<Date>(rt).serialNumber()));
+        break;
+    case ColumnType::Period: {
+        const Period& p = boost::get<Period>(rt);
+        c.periodLengths.push_back(p.length());
+        c.periodUnits.push_back(static_cast<std::int8_t>(p.units()));
+        break;
+    }
+    }
+    i_++;
+    return *this;
+}
+
+void ColumnarReport::addString(Column& c, const string& s) {
+    auto it = c.lookup.find(s);
+    if (it == c.lookup.end()) {
+        QL_REQUIRE(c.dictionary.size() < std::numeric_limits<std::uint32_t>::max(),
+                   "ColumnarReport: too many distinct values in column " << c.header);
+        it = c.lookup.insert(std::make_pair(s, static_cast<std::uint32_t>(c.dictionary.size()))).first;
+        c.dictionary.push_back(s);
+    }
+    c.codes.push_back(it->second);
+}
+
+void ColumnarReport::end() {
+    QL_REQUIRE(i_ == columns_.size() || i_ == 0, "report is finalized with incomplete row, got data for "
+                                                     << i_ << " columns out of " << columns_.size());
+}
+
+Size ColumnarReport::size(const Column& c) const {
+    switch (c.columnType) {
+    case ColumnType::Size:
+        return c.sizes.size();
+    case ColumnType::Real:
+        return c.reals.size();
+    case ColumnType::String:
+        return c.codes.size();
+    case ColumnType::Date:
+        return c.dates.size();
+    case ColumnType::Period:
+        return c.periodLengths.size();
+    }
+    QL_FAIL("ColumnarReport: unknown column type");
+}
+
+Size ColumnarReport::rows() const { return columns_.empty() ? 0 : size(columns_.front()); }
+
+bool ColumnarReport::hasHeader(const string& h) const {
+    return std::find_if(columns_.begin(), columns_.end(), [&h](const Column& c) { return c.header == h; }) !=
+           columns_.end();
+}
+
+const ColumnarReport::Column& ColumnarReport::column(Size i, ColumnType t) const {
+    QL_REQUIRE(i < columns_.size(), "ColumnarReport: column " << i << " out of range, report has " << columns_.size()
+                                                              << " columns");
+    QL_REQUIRE(columns_[i].columnType == t, "ColumnarReport: column " << columns_[i].header << " has type "
+                                                                      << static_cast<int>(columns_[i].columnType)
+                                                                      << ", requested " << static_cast<int>(t));
+    return columns_[i];
+}
+
+Report::ReportType ColumnarReport::value(Size j, Size i) const {
+    QL_REQUIRE(i < columns_.size(), "ColumnarReport: column " << i << " out of range, report has " << columns_.size()
+                                                              << " columns");
+    const Column& c = columns_[i];
+    QL_REQUIRE(j < size(c), "ColumnarReport: row " << j << " out of range for column " << c.header);
+    switch (c.columnType) {
+    case ColumnType::Size:
+        return c.sizes[j];
+    case ColumnType::Real:
+        return c.reals[j];
+    case ColumnType::String:
+        return c.dictionary[c.codes[j]];
+    case ColumnType::Date:
+        return toDate(c.dates[j]);
+    case ColumnType::Period:
+        return Period(c.periodLengths[j], static_cast<QuantLib::TimeUnit>(c.periodUnits[j]));
+    }
+    QL_FAIL("ColumnarReport: unknown column type");
+}
+
+const vector<Size>& ColumnarReport::sizeData(Size i) const { return column(i, ColumnType::Size).sizes; }
+
+const vector<Real>& ColumnarReport::realData(Size i) const { return column(i, ColumnType::Real).reals; }
+
+const string& ColumnarReport::stringData(Size j, Size i) const {
+    const Column& c = column(i, ColumnType::String);
+    return c.dictionary[c.codes.at(j)];
+}
+
+Date ColumnarReport::dateData(Size j, Size i) const { return toDate(column(i, ColumnType::Date).dates.at(j)); }
+
+Period ColumnarReport::periodData(Size j, Size i) const {
+    const Column& c = column(i, ColumnType::Period);
+    return Period(c.periodLengths.at(j), static_cast<QuantLib::TimeUnit>(c.periodUnits.at(j)));
+}
+
+const vector<string>& ColumnarReport::stringDictionary(Size i) const {
+    return column(i, ColumnType::String).dictionary;
+}
+
+const vector<std::uint32_t>& ColumnarReport::stringCodes(Size i) const { return column(i, ColumnType::String).codes; }
+
+void ColumnarReport::toFile(const string& filename, const char sep, const bool commentCharacter, char quoteChar,
+                            const string& nullString, bool lowerHeader) const {
+    CSVFileReport cReport(filename, sep, commentCharacter, quoteChar, nullString, lowerHeader);
+    for (auto const& c : columns_)
+        cReport.addColumn(c.header, c.type, c.precision);
+    Size numRows = rows();
+    for (Size j = 0; j < numRows; ++j) {
+        cReport.next();
+        for (Size i = 0; i < columns_.size(); ++i)
+            cReport.add(value(j, i));
+    }
+    cReport.end();
+}
+
+void ColumnarReport::toBinaryFile(const string& filename) const {
+    std::ofstream os(filename.c_str(), std::ios::binary);
+    QL_REQUIRE(os.is_open(), "ColumnarReport: error opening file " << filename);
+    Size numRows = rows();
+    os.write(binaryMagic, sizeof(binaryMagic));
+    writePod(os, static_cast<std::uint64_t>(columns_.size()));
+    writePod(os, static_cast<std::uint64_t>(numRows));
+    for (auto const& c : columns_) {
+        QL_REQUIRE(size(c) == numRows, "ColumnarReport: column " << c.header << " has " << size(c)
+                                                                 << " rows, expected " << numRows);
+        writeString(os, c.header);
+        writePod(os, static_cast<std::uint8_t>(c.columnType));
+        writePod(os, static_cast<std::uint64_t>(c.precision));
+        // the column's default value as given in addColumn(), needed to reproduce e.g. the precision of csv output
+        switch (c.columnType) {
+        case ColumnType::Size:
+            writePod(os, static_cast<std::uint64_t>(boost::get<Size>(c.type)));
+            writeVector(os, vector<std::uint64_t>(c.sizes.begin(), c.sizes.end()));
+            break;
+        case ColumnType::Real:
+            writePod(os, boost::get<Real>(c.type));
+            writeVector(os, c.reals);
+            break;
+        case ColumnType::String:
+            writeString(os, boost::get<string>(c.type));
+            writePod(os, static_cast<std::uint64_t>(c.dictionary.size()));
+            for (auto const& s : c.dictionary)
+                writeString(os, s);
+            writeVector(os, c.codes);
+            break;
+        case ColumnType::Date:
+            writePod(os, static_cast<std::int32_t>(boost::get<Date>(c.type).serialNumber()));
+            writeVector(os, c.dates);
+            break;
+        case ColumnType::Period:
+            writePod(os, static_cast<std::int32_t>(boost::get<Period>(c.type).length()));
+            writePod(os, static_cast<std::int8_t>(boost::get<Period>(c.type).units()));
+            writeVector(os, c.periodLengths);
+            writeVector(os, c.periodUnits);
+            break;
+        }
+    }
+    QL_REQUIRE(os, "ColumnarReport: error writing file " << filename);
+}
+
+QuantLib::ext::shared_ptr<ColumnarReport> ColumnarReport::fromBinaryFile(const string& filename) {
+    std::ifstream is(filename.c_str(), std::ios::binary);
+    QL_REQUIRE(is.is_open(), "ColumnarReport: error opening file " << filename);
+    char magic[sizeof(binaryMagic)];
+    is.read(magic, sizeof(magic));
+    QL_REQUIRE(is && std::equal(magic, magic + sizeof(magic), binaryMagic),
+               "ColumnarReport: file " << filename << " is not a columnar report file or has an unsupported version");
+    std::uint64_t numColumns, numRows;
+    readPod(is, numColumns);
+    readPod(is, numRows);
+    auto report = QuantLib::ext::make_shared<ColumnarReport>();
+    report->columns_.resize(numColumns);
+    for (auto& c : report->columns_) {
+        c.header = readString(is);
+        std::uint8_t t;
+        std::uint64_t precision;
+        readPod(is, t);
+        readPod(is, precision);
+        QL_REQUIRE(t <= static_cast<std::uint8_t>(ColumnType::Period),
+                   "ColumnarReport: unknown column type " << static_cast<int>(t) << " in file " << filename);
+        c.columnType = static_cast<ColumnType>(t);
+        c.precision = precision;
+        switch (c.columnType) {
+        case ColumnType::Size: {
+            std::uint64_t d;
+            readPod(is, d);
+            c.type = static_cast<Size>(d);
+            vector<std::uint64_t> tmp;
+            readVector(is, tmp, numRows);
+            c.sizes.assign(tmp.begin(), tmp.end());
+            break;
+        }
+        case ColumnType::Real: {
+            Real d;
+            readPod(is, d);
+            c.type = d;
+            readVector(is, c.reals, numRows);
+            break;
+        }
+        case ColumnType::String: {
+            c.type = readString(is);
+            std::uint64_t n;
+            readPod(is, n);
+            c.dictionary.resize(n);
+            for (std::uint64_t k = 0; k < n; ++k) {
+                c.dictionary[k] = readString(is);
+                c.lookup[c.dictionary[k]] = static_cast<std::uint32_t>(k);
+            }
+            readVector(is, c.codes, numRows);
+            for (auto code : c.codes)
+                QL_REQUIRE(code < n, "ColumnarReport: invalid string code " << code << " in column " << c.header);
+            break;
+        }
+        case ColumnType::Date: {
+            std::int32_t d;
+            readPod(is, d);
+            c.type = toDate(d);
+            readVector(is, c.dates, numRows);
+            break;
+        }
+        case ColumnType::Period: {
+            std::int32_t length;
+            std::int8_t units;
+            readPod(is, length);
+            readPod(is, units);
+            c.type = Period(length, static_cast<QuantLib::TimeUnit>(units));
+            readVector(is, c.periodLengths, numRows);
+            readVector(is, c.periodUnits, numRows);
+            break;
+        }
+        }
+    }
+    return report;
+}
+
+} // namespace data
+} // namespace ore
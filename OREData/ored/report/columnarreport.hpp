@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/report/columnarreport.hpp
+    \brief In memory report with typed column storage
+    \ingroup report
+*/
+
+#pragma once
+
+#include <ored/report/report.hpp>
+#include <ql/shared_ptr.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace data {
+using std::string;
+using std::vector;
+
+/*! ColumnarReport stores the report data in memory, column by column in typed containers
+
+    Real and Size columns are stored as contiguous vectors, strings are dictionary encoded (each distinct value is
+    stored once and the rows hold 32 bit codes into the dictionary), dates are stored as serial numbers and periods
+    as length and unit. Compared to the InMemoryReport, which stores a variant per cell, this reduces the memory
+    footprint substantially for large reports with repeated string values such as trade ids or netting set ids.
+
+    The report can be written to and read from a compact binary file, which is much faster than going through
+    a csv representation. The binary format is not portable between platforms with different endianness. The
+    analytics reports listed in the \c binaryReports setup parameter are written in this format, see
+    AnalyticsManager::toFile().
+
+    \ingroup report
+*/
+class ColumnarReport : public Report {
+public:
+    ColumnarReport() : i_(0) {}
+
+    Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override;
+    Report& next() override;
+    Report& add(const ReportType& rt) override;
+    void end() override;
+
+    Size columns() const { return columns_.size(); }
+    Size rows() const;
+    const string& header(Size i) const { return columns_.at(i).header; }
+    bool hasHeader(const string& h) const;
+    ReportType columnType(Size i) const { return columns_.at(i).type; }
+    Size columnPrecision(Size i) const { return columns_.at(i).precision; }
+
+    //! Returns the value in row j and column i
+    ReportType value(Size j, Size i) const;
+
+    //! Typed access, a type mismatch throws
+    //@{
+    const vector<Size>& sizeData(Size i) const;
+    const vector<Real>& realData(Size i) const;
+    const string& stringData(Size j, Size i) const;
+    Date dateData(Size j, Size i) const;
+    Period periodData(Size j, Size i) const;
+    //! the distinct values of a string column
+    const vector<string>& stringDictionary(Size i) const;
+    //! the codes into the dictionary of a string column, by row
+    const vector<std::uint32_t>& stringCodes(Size i) const;
+    //@}
+
+    //! write the report to a csv file
+    void toFile(const string& filename, const char sep = ',', const bool commentCharacter = true, char quoteChar = '\0',
+                const string& nullString = "#N/A", bool lowerHeader = false) const;
+    //! write the report to a binary file
+    void toBinaryFile(const string& filename) const;
+    //! read a report from a binary file written by toBinaryFile()
+    static QuantLib::ext::shared_ptr<ColumnarReport> fromBinaryFile(const string& filename);
+
+private:
+    // column types, in the order of the ReportType variant
+    enum class ColumnType : std::uint8_t { Size = 0, Real = 1, String = 2, Date = 3, Period = 4 };
+    struct Column {
+        string header;
+        ReportType type;
+        Size precision = 0;
+        ColumnType columnType = ColumnType::Size;
+        vector<Size> sizes;
+        vector<Real> reals;
+        vector<std::uint32_t> codes;
+        vector<string> dictionary;
+        std::unordered_map<string, std::uint32_t> lookup;
+        vector<std::int32_t> dates;
+        vector<std::int32_t> periodLengths;
+        vector<std::int8_t> periodUnits;
+    };
+    const Column& column(Size i, ColumnType t) const;
+    Size size(const Column& c) const;
+    void addString(Column& c, const string& s);
+
+    vector<Column> columns_;
+    Size i_;
+};
+
+} // namespace data
+} // namespace ore
@@ -116,8 +116,11 @@ const vector<Report::ReportType>& InMemoryReport::data(Size i) const {
 
 void InMemoryReport::toFile(const string& filename, const char sep, const bool commentCharacter, char quoteChar,
                             const string& nullString, bool lowerHeader) {
-
     CSVFileReport cReport(filename, sep, commentCharacter, quoteChar, nullString, lowerHeader);
+    writeTo(cReport);
+}
+
+void InMemoryReport::writeTo(Report& cReport) const {
 
     for (Size i = 0; i < headers_.size(); i++) {
         cReport.addColumn(headers_[i], columnTypes_[i], columnPrecision_[i]);
@@ -59,6 +59,8 @@ public:
     const vector<ReportType>& data(Size i) const;
     void toFile(const string& filename, const char sep = ',', const bool commentCharacter = true, char quoteChar = '\0',
                 const string& nullString = "#N/A", bool lowerHeader = false);
+    //! Adds the columns and rows, including buffered ones, to the given report and ends it
+    void writeTo(Report& report) const;
     void jumpToColumn(Size i) { i_ = i; }
 
 private:
@@ -17,6 +17,7 @@
 */
 
 #include <ored/scripting/engines/scriptedinstrumentamccalculator.hpp>
+#include <ored/scripting/astprinter.hpp>
 #include <ored/scripting/engines/scriptedinstrumentpricingenginecg.hpp>
 #include <ored/scripting/utilities.hpp>
 
@@ -30,12 +31,17 @@
 #include <qle/instruments/cashflowresults.hpp>
 #include <qle/math/computeenvironment.hpp>
 #include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_io.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
 
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 namespace ore {
 namespace data {
 
@@ -100,6 +106,35 @@ ScriptedInstrumentPricingEngineCG::ScriptedInstrumentPricingEngineCG(
     }
 }
 
+std::string ScriptedInstrumentPricingEngineCG::graphKey() const {
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<double>::max_digits10) << std::boolalpha
+       << randomvariable_output_size(model_->size());
+    os << "npv: " << npv_ << '\n';
+    for (auto const& [name, variable] : additionalResults_)
+        os << "result: " << name << " " << variable << '\n';
+    os << "script:\n" << script_ << '\n';
+    if (ast_)
+        os << "ast:\n" << to_string(ast_, false);
+    if (context_) {
+        os << "context:\n" << *context_;
+        for (auto const& c : context_->constants)
+            os << "constant: " << c << '\n';
+        for (auto const& c : context_->ignoreAssignments)
+            os << "ignoreAssignment: " << c << '\n';
+    }
+    os << "mcParams: " << mcParams_.seed << " " << mcParams_.trainingSeed << " " << mcParams_.trainingSamples << " "
+       << mcParams_.sequenceType << " " << mcParams_.trainingSequenceType << " "
+       << mcParams_.externalDeviceCompatibilityMode << " " << mcParams_.regressionOrder << " "
+       << static_cast<int>(mcParams_.polynomType) << " " << static_cast<int>(mcParams_.sobolOrdering) << " "
+       << static_cast<int>(mcParams_.sobolDirectionIntegers) << " " << mcParams_.regressionVarianceCutoff << '\n';
+    os << "interactive: " << interactive_ << '\n';
+    os << "generateAdditionalResults: " << generateAdditionalResults_ << '\n';
+    os << "includePastCashflows: " << includePastCashflows_ << '\n';
+    os << "useCachedSensis: " << useCachedSensis_ << '\n';
+    return os.str();
+}
+
 void ScriptedInstrumentPricingEngineCG::buildComputationGraph() const {
 
     if (cgVersion_ != model_->cgVersion()) {
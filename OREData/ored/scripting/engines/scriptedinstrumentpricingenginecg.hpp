@@ -55,6 +55,10 @@ public:
 
     void buildComputationGraph() const;
 
+    /*! Describes the inputs the computation graph is built from (script, ast, initial context and engine parameters),
+        to be used as part of a key for cached computation graphs */
+    std::string graphKey() const;
+
 private:
     void calculate() const override;
 
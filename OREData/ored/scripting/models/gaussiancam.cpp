@@ -38,6 +38,9 @@
 #include <ql/math/comparison.hpp>
 #include <ql/quotes/simplequote.hpp>
 
+#include <sstream>
+#include <typeinfo>
+
 namespace ore {
 namespace data {
 
@@ -54,11 +57,12 @@ GaussianCam::GaussianCam(const Handle<CrossAssetModel>& cam, const Size paths,
                          const std::set<Date>& simulationDates, const McParams& mcParams, const Size timeStepsPerYear,
                          const IborFallbackConfig& iborFallbackConfig,
                          const std::vector<Size>& projectedStateProcessIndices,
-                         const std::vector<std::string>& conditionalExpectationModelStates)
+                         const std::vector<std::string>& conditionalExpectationModelStates,
+                         const QuantLib::ext::shared_ptr<PathCache>& pathCache)
     : ModelImpl(curves.front()->dayCounter(), paths, currencies, irIndices, infIndices, indices, indexCurrencies,
                 simulationDates, iborFallbackConfig),
       cam_(cam), curves_(curves), fxSpots_(fxSpots), mcParams_(mcParams), timeStepsPerYear_(timeStepsPerYear),
-      projectedStateProcessIndices_(projectedStateProcessIndices) {
+      projectedStateProcessIndices_(projectedStateProcessIndices), pathCache_(pathCache) {
 
     // check inputs
 
@@ -88,6 +92,22 @@ GaussianCam::GaussianCam(const Handle<CrossAssetModel>& cam, const Size paths,
         std::find(conditionalExpectationModelStates.begin(), conditionalExpectationModelStates.end(), "Asset") !=
             conditionalExpectationModelStates.end();
 
+    // register simulation dates with the path cache, models with the same key share their paths
+
+    if (pathCache_) {
+        std::ostringstream key;
+        key << "GaussianCam/" << static_cast<int>(cam_->discretization()) << "/" << static_cast<int>(cam_->measure())
+            << "/" << paths << "/" << timeStepsPerYear_ << "/" << static_cast<int>(mcParams_.sequenceType) << "/"
+            << mcParams_.seed << "/" << static_cast<int>(mcParams_.trainingSequenceType) << "/"
+            << mcParams_.trainingSeed << "/"
+            << (mcParams_.trainingSamples == Null<Size>() ? 0 : mcParams_.trainingSamples) << "/"
+            << static_cast<int>(mcParams_.sobolOrdering) << "/" << static_cast<int>(mcParams_.sobolDirectionIntegers);
+        for (auto const& p : cam_->parametrizations())
+            key << "/" << typeid(*p).name() << ":" << p->currency().code() << ":" << p->name();
+        pathCacheKey_ = key.str();
+        pathCache_->registerDates(pathCacheKey_, simulationDates);
+    }
+
 } // GaussianCam ctor
 
 Size GaussianCam::size() const {
@@ -306,11 +326,32 @@ void GaussianCam::populatePathValues(const Size nSamples, std::map<Date, std::ve
         // build a temporary repository of the state prcess values, since we want to access them not path by path
         // below - for efficiency reasons the loop over the paths should be the innermost loop there!
 
-        std::vector<std::vector<std::vector<Real>>> pathValues(
-            effectiveSimulationDates_.size() - 1,
-            std::vector<std::vector<Real>>(process->size(), std::vector<Real>(nSamples)));
+        std::vector<std::vector<std::vector<Real>>> pathValues;
+
+        // the state process values per effective simulation date (excluding the reference date)
+
+        std::vector<const std::vector<std::vector<Real>>*> pathValuesAt(effectiveSimulationDates_.size() - 1);
+        QuantLib::ext::shared_ptr<const PathCache::PathValues> sharedPaths;
+
+        if (pathCache_ && injectedPathTimes_ == nullptr) {
+
+            // paths simulated on the union of the simulation dates of all models sharing the cache
+
+            std::vector<Size> position;
+            sharedPaths = sharedPathValues(nSamples, isTraining, position);
+            for (Size j = 0; j < pathValuesAt.size(); ++j)
+                pathValuesAt[j] = &(*sharedPaths)[position[j]];
+
+        } else {
+            pathValues.resize(effectiveSimulationDates_.size() - 1,
+                              std::vector<std::vector<Real>>(process->size(), std::vector<Real>(nSamples)));
+            for (Size j = 0; j < pathValuesAt.size(); ++j)
+                pathValuesAt[j] = &pathValues[j];
+        }
 
-        if (injectedPathTimes_ == nullptr) {
+        if (sharedPaths) {
+            // nothing to do, the paths were retrieved from the cache above
+        } else if (injectedPathTimes_ == nullptr) {
 
             // the usual path generator
 
@@ -374,7 +415,7 @@ void GaussianCam::populatePathValues(const Size nSamples, std::map<Date, std::ve
         for (Size k = 0; k < indices_.size(); ++k) {
             for (Size j = 1; j < effectiveSimulationDates_.size(); ++j) {
                 for (Size i = 0; i < nSamples; ++i) {
-                    rvs[k][j - 1]->data()[i] = std::exp(pathValues[j - 1][indexPositionInProcess_[k]][i]);
+                    rvs[k][j - 1]->data()[i] = std::exp((*pathValuesAt[j - 1])[indexPositionInProcess_[k]][i]);
                 }
             }
         }
@@ -393,7 +434,7 @@ void GaussianCam::populatePathValues(const Size nSamples, std::map<Date, std::ve
         for (Size k = 0; k < currencies_.size(); ++k) {
             for (Size j = 1; j < effectiveSimulationDates_.size(); ++j) {
                 for (Size i = 0; i < nSamples; ++i) {
-                    rvs2[k][j - 1]->data()[i] = pathValues[j - 1][currencyPositionInProcess_[k]][i];
+                    rvs2[k][j - 1]->data()[i] = (*pathValuesAt[j - 1])[currencyPositionInProcess_[k]][i];
                 }
             }
         }
@@ -416,14 +457,100 @@ void GaussianCam::populatePathValues(const Size nSamples, std::map<Date, std::ve
         for (Size k = 0; k < infIndices_.size(); ++k) {
             for (Size j = 1; j < effectiveSimulationDates_.size(); ++j) {
                 for (Size i = 0; i < nSamples; ++i) {
-                    rvs3a[k][j - 1]->data()[i] = pathValues[j - 1][infIndexPositionInProcess_[k]][i];
-                    rvs3b[k][j - 1]->data()[i] = pathValues[j - 1][infIndexPositionInProcess_[k] + 1][i];
+                    rvs3a[k][j - 1]->data()[i] = (*pathValuesAt[j - 1])[infIndexPositionInProcess_[k]][i];
+                    rvs3b[k][j - 1]->data()[i] = (*pathValuesAt[j - 1])[infIndexPositionInProcess_[k] + 1][i];
                 }
             }
         }
     }
 }
 
+QuantLib::ext::shared_ptr<const PathCache::PathValues>
+GaussianCam::sharedPathValues(const Size nSamples, const bool isTraining, std::vector<Size>& position) const {
+
+    auto process = cam_->stateProcess();
+
+    // time grid on the union of the simulation dates of all models registered with the cache
+
+    std::set<Date> dates;
+    dates.insert(referenceDate());
+    for (auto const& d : pathCache_->dates(pathCacheKey_)) {
+        if (d >= referenceDate())
+            dates.insert(d);
+    }
+
+    std::vector<Real> times;
+    for (auto const& d : dates)
+        times.push_back(timeFromReference(d));
+
+    Size steps = std::max(std::lround(timeStepsPerYear_ * times.back() + 0.5), 1l);
+    TimeGrid grid(times.begin(), times.end(), steps);
+    std::vector<Size> positionInGrid(times.size());
+    for (Size i = 0; i < positionInGrid.size(); ++i)
+        positionInGrid[i] = grid.index(times[i]);
+
+    position.clear();
+    for (auto d = std::next(effectiveSimulationDates_.begin(), 1); d != effectiveSimulationDates_.end(); ++d) {
+        auto p = dates.find(*d);
+        QL_REQUIRE(p != dates.end(), "GaussianCam::sharedPathValues(): simulation date "
+                                         << *d << " not registered with path cache, this is unexpected");
+        position.push_back(std::distance(dates.begin(), p) - 1);
+    }
+
+    /* the fingerprint of everything that determines the paths: the time grid, the number of samples and the state
+       process, which is described by its initial values, the model parameters and correlations and, where
+       available, its discretisation coefficients on the time grid */
+
+    std::vector<Real> fingerprint(grid.begin(), grid.end());
+    fingerprint.push_back(static_cast<Real>(referenceDate().serialNumber()));
+    fingerprint.push_back(static_cast<Real>(nSamples));
+    Array x0 = process->initialValues();
+    fingerprint.insert(fingerprint.end(), x0.begin(), x0.end());
+    fingerprint.insert(fingerprint.end(), cam_->correlation().begin(), cam_->correlation().end());
+    for (auto const& p : cam_->parametrizations()) {
+        for (Size i = 0; i < p->numberOfParameters(); ++i) {
+            Array t = p->parameterTimes(i), v = p->parameterValues(i);
+            fingerprint.insert(fingerprint.end(), t.begin(), t.end());
+            fingerprint.insert(fingerprint.end(), v.begin(), v.end());
+        }
+    }
+    auto camProcess = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process);
+    QuantLib::ext::shared_ptr<const CrossAssetStateProcess::Cache> cache;
+    if (camProcess) {
+        cache = camProcess->warmUpCache(grid);
+        for (auto const& m : cache->m)
+            fingerprint.insert(fingerprint.end(), m.begin(), m.end());
+        for (auto const& d : cache->d)
+            fingerprint.insert(fingerprint.end(), d.begin(), d.end());
+        for (auto const& v : cache->v)
+            fingerprint.insert(fingerprint.end(), v.begin(), v.end());
+    }
+
+    return pathCache_->paths(pathCacheKey_ + (isTraining ? "/Training" : ""), fingerprint, [&]() {
+        if (camProcess) {
+            if (cache->t0.empty())
+                camProcess->resetCache(grid.size() - 1);
+            else
+                camProcess->setCache(cache);
+        }
+        auto pathGen = makeMultiPathGenerator(isTraining ? mcParams_.trainingSequenceType : mcParams_.sequenceType,
+                                              process, grid, isTraining ? mcParams_.trainingSeed : mcParams_.seed,
+                                              mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers);
+        PathCache::PathValues result(times.size() - 1,
+                                     std::vector<std::vector<Real>>(process->size(), std::vector<Real>(nSamples)));
+        for (Size i = 0; i < nSamples; ++i) {
+            MultiPath path = pathGen->next().value;
+            for (Size j = 0; j < times.size() - 1; ++j) {
+                for (Size k = 0; k < process->size(); ++k) {
+                    result[j][k][i] = path[k][positionInGrid[j + 1]];
+                }
+            }
+        }
+        return result;
+    });
+}
+
+
 RandomVariable GaussianCam::getIndexValue(const Size indexNo, const Date& d, const Date& fwd) const {
     auto res = underlyingPaths_.at(d).at(indexNo);
     if (comIndexInCam_[indexNo] != Null<Size>()) {
@@ -25,6 +25,7 @@
 
 #include <ored/scripting/models/amcmodel.hpp>
 #include <ored/scripting/models/modelimpl.hpp>
+#include <ored/scripting/models/pathcache.hpp>
 
 #include <ored/model/crossassetmodelbuilder.hpp>
 
@@ -44,6 +45,7 @@ public:
        - regressionOrder is the regression order used to compute conditional expectations in npv()
        - timeStepsPerYear time steps used for discretisation (overwritten by 1 if exact discretisation is used
        - disc: choose exact or Euler discretisation of state process
+       - pathCache: if given, the paths are shared with other models using the same cache and configuration
      */
     GaussianCam(const Handle<CrossAssetModel>& cam, const Size paths, const std::vector<std::string>& currencies,
                 const std::vector<Handle<YieldTermStructure>>& curves, const std::vector<Handle<Quote>>& fxSpots,
@@ -53,7 +55,8 @@ public:
                 const std::set<Date>& simulationDates, const McParams& mcParams, const Size timeStepsPerYear = 1,
                 const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
                 const std::vector<Size>& projectedStateProcessIndices = {},
-                const std::vector<std::string>& conditionalExpectationModelStates = {});
+                const std::vector<std::string>& conditionalExpectationModelStates = {},
+                const QuantLib::ext::shared_ptr<PathCache>& pathCache = nullptr);
 
     // Model interface implementation
     Type type() const override { return Type::MC; }
@@ -100,6 +103,10 @@ private:
                             std::map<Date, std::vector<RandomVariable>>& irStates,
                             std::map<Date, std::vector<std::pair<RandomVariable, RandomVariable>>>& infStates,
                             const std::vector<Real>& times, const bool isTraining) const;
+    /* path values from the path cache, position[j] is the index in the returned values for the effective simulation
+       date j + 1 (the reference date is not contained in the values) */
+    QuantLib::ext::shared_ptr<const PathCache::PathValues>
+    sharedPathValues(const Size nSamples, const bool isTraining, std::vector<Size>& position) const;
     // input parameters
     const Handle<CrossAssetModel> cam_;
     const std::vector<Handle<YieldTermStructure>> curves_;
@@ -108,6 +115,8 @@ private:
     const Size timeStepsPerYear_;
     const std::vector<Size> projectedStateProcessIndices_; // if data is injected via the AMCModel interface
     const Real regressionVarianceCutoff_ = Null<Real>();
+    const QuantLib::ext::shared_ptr<PathCache> pathCache_;
+    std::string pathCacheKey_; // identifies models that can share paths
 
     // computed values
     mutable Date referenceDate_;                      // the model reference date
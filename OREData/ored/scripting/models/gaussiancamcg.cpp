@@ -7,6 +7,7 @@
 #include <ored/scripting/models/hwcg.hpp>
 #include <ored/scripting/models/lgmcg.hpp>
 #include <ored/utilities/indexparser.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <ql/math/comparison.hpp>
@@ -17,6 +18,8 @@
 #include <qle/cashflows/overnightindexedcoupon.hpp>
 #include <qle/math/randomvariablelsmbasissystem.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 namespace ore {
 namespace data {
 
@@ -366,6 +369,74 @@ std::size_t GaussianCamCG::getFxSpot(const Size idx) const {
     return addModelParameter(id, [c] { return c->value(); });
 }
 
+std::function<double(void)> GaussianCamCG::modelParameterFunctor(const std::string& id) const {
+    calculate();
+    auto cam(cam_);
+    try {
+
+        // __fxspot_<idx>
+
+        if (boost::starts_with(id, "__fxspot_")) {
+            auto c = fxSpots_.at(std::stoul(id.substr(9)));
+            return [c] { return c->value(); };
+        }
+
+        // __irFix_<index name>_<fixing date>_<obs date>, a parameter for historical fixings only
+
+        if (boost::starts_with(id, "__irFix_") && id.size() > 30) {
+            std::string name = id.substr(8, id.size() - 30);
+            Date fixingDate = parseDate(id.substr(id.size() - 21, 10));
+            if (fixingDate > Settings::instance().evaluationDate())
+                return {};
+            for (auto const& i : irIndices_) {
+                if (auto index = i.second; index->name() == name)
+                    return [index, fixingDate] { return index->fixing(fixingDate); };
+            }
+            return {};
+        }
+
+        // __lgm_<ccy>_H_<date>, __lgm_<ccy>_zeta_<date>, __dsc_<ccy>_<date>_<curve id> from LgmCG
+
+        for (Size i = 0; i < currencies_.size(); ++i) {
+            Size cpidx = currencyPositionInCam_[i];
+            std::function<QuantLib::ext::shared_ptr<IrLgm1fParametrization>()> p = [cam, cpidx] {
+                return cam->irlgm1f(cpidx);
+            };
+            std::string lgm = "__lgm_" + currencies_[i] + "_", dsc = "__dsc_" + currencies_[i] + "_";
+            if (boost::starts_with(id, lgm + "H_")) {
+                Real t = p()->termStructure()->timeFromReference(parseDate(id.substr(lgm.size() + 2)));
+                return [p, t] { return p()->H(t); };
+            }
+            if (boost::starts_with(id, lgm + "zeta_")) {
+                Real t = p()->termStructure()->timeFromReference(parseDate(id.substr(lgm.size() + 5)));
+                return [p, t] { return p()->zeta(t); };
+            }
+            if (boost::starts_with(id, dsc) && id.size() > dsc.size() + 11) {
+                Real t = p()->termStructure()->timeFromReference(parseDate(id.substr(dsc.size(), 10)));
+                std::string curveId = id.substr(dsc.size() + 11);
+                Handle<YieldTermStructure> discountCurve;
+                if (curveId != "default") {
+                    auto index = std::find_if(irIndices_.begin(), irIndices_.end(), [&curveId](const auto& i) {
+                        return curveId == "fwd_" + i.second->name();
+                    });
+                    auto ibor = index == irIndices_.end()
+                                    ? nullptr
+                                    : QuantLib::ext::dynamic_pointer_cast<IborIndex>(index->second);
+                    if (!ibor)
+                        return {};
+                    discountCurve = ibor->forwardingTermStructure();
+                }
+                return [p, discountCurve, t] {
+                    return (discountCurve.empty() ? p()->termStructure() : discountCurve)->discount(t);
+                };
+            }
+        }
+    } catch (const std::exception&) {
+        // not an id of this model
+    }
+    return {};
+}
+
 Real GaussianCamCG::getDirectFxSpotT0(const std::string& forCcy, const std::string& domCcy) const {
     auto c1 = std::find(currencies_.begin(), currencies_.end(), forCcy);
     auto c2 = std::find(currencies_.begin(), currencies_.end(), domCcy);
@@ -50,6 +50,9 @@ public:
     Real getDirectFxSpotT0(const std::string& forCcy, const std::string& domCcy) const override;
     Real getDirectDiscountT0(const Date& paydate, const std::string& currency) const override;
 
+    // model parameters created by getIrIndexValue(), getDiscount(), getNumeraire() and getFxSpot()
+    std::function<double(void)> modelParameterFunctor(const std::string& id) const override;
+
 protected:
     // ModelCGImpl interface implementation
     virtual std::size_t getFutureBarrierProb(const std::string& index, const Date& obsdate1, const Date& obsdate2,
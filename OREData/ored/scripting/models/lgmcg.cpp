@@ -40,7 +40,7 @@ std::size_t LgmCG::numeraire(const Date& d, const std::size_t x, const Handle<Yi
         // Date ds = getSloppyDate(d, sloppySimDates_, effSimDates_);
         Real t = p()->termStructure()->timeFromReference(d);
         // Real ts = p()->termStructure()->timeFromReference(ds);
-        std::string id_P0t = "__dsc_" + ore::data::to_string(d) + "_" + discountCurveId;
+        std::string id_P0t = "__dsc_" + qualifier_ + "_" + ore::data::to_string(d) + "_" + discountCurveId;
         std::string id_H = "__lgm_" + qualifier_ + "_H_" + ore::data::to_string(d);
         std::string id_zeta = "__lgm_" + qualifier_ + "_zeta_" + ore::data::to_string(d);
         std::size_t H = addModelParameter(g_, modelParameters_, id_H, [p, t] { return p()->H(t); });
@@ -85,7 +85,7 @@ std::size_t LgmCG::reducedDiscountBond(const Date& d, Date e, const std::size_t
         Real T = p()->termStructure()->timeFromReference(e);
         // Real ts = p()->termStructure()->timeFromReference(ds);
         // Real Ts = p()->termStructure()->timeFromReference(es);
-        std::string id_P0T = "__dsc_" + ore::data::to_string(e) + "_" + discountCurveId;
+        std::string id_P0T = "__dsc_" + qualifier_ + "_" + ore::data::to_string(e) + "_" + discountCurveId;
         std::string id_H = "__lgm_" + qualifier_ + "_H_" + ore::data::to_string(e);
         std::string id_zeta = "__lgm_" + qualifier_ + "_zeta_" + ore::data::to_string(d);
         std::size_t H = addModelParameter(g_, modelParameters_, id_H, [p, T] { return p()->H(T); });
@@ -131,6 +131,9 @@ public:
     virtual const std::vector<std::vector<std::size_t>>& randomVariates() const = 0; // dim / steps
     virtual std::vector<std::pair<std::size_t, double>> modelParameters() const = 0;
     virtual std::vector<std::pair<std::size_t, std::function<double(void)>>>& modelParameterFunctors() const = 0;
+    /* functor for a model parameter with the given id, as created while building a trade graph, or an empty functor
+       if the model does not know the id, this allows to relink a stored trade graph to the model */
+    virtual std::function<double(void)> modelParameterFunctor(const std::string& id) const { return {}; }
 
     // get fx spot as of today directly, i.e. bypassing the cg
     virtual Real getDirectFxSpotT0(const std::string& forCcy, const std::string& domCcy) const = 0;
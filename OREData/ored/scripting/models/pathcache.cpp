@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/scripting/models/pathcache.hpp>
+#include <ored/utilities/log.hpp>
+
+namespace ore {
+namespace data {
+
+void PathCache::registerDates(const std::string& key, const std::set<QuantLib::Date>& dates) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dates_[key].insert(dates.begin(), dates.end());
+}
+
+std::set<QuantLib::Date> PathCache::dates(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto d = dates_.find(key);
+    return d == dates_.end() ? std::set<QuantLib::Date>() : d->second;
+}
+
+QuantLib::ext::shared_ptr<const PathCache::PathValues>
+PathCache::paths(const std::string& key, const std::vector<QuantLib::Real>& fingerprint,
+                 const std::function<PathValues()>& simulate) {
+    QuantLib::ext::shared_ptr<std::mutex> entryMutex;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entryMutex = entries_[key].mutex;
+    }
+    // only one thread simulates the paths for a key, other threads requesting the same key wait for the result
+    std::lock_guard<std::mutex> entryLock(*entryMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& e = entries_[key];
+        if (e.paths && e.fingerprint == fingerprint) {
+            ++hits_;
+            return e.paths;
+        }
+    }
+    DLOG("PathCache: simulate paths for key '" << key << "'");
+    auto p = QuantLib::ext::make_shared<const PathValues>(simulate());
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& e = entries_[key];
+    e.fingerprint = fingerprint;
+    e.paths = p;
+    ++misses_;
+    return p;
+}
+
+QuantLib::Size PathCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+QuantLib::Size PathCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void PathCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dates_.clear();
+    entries_.clear();
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/scripting/models/pathcache.hpp
+    \brief cache for simulated paths shared between models
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ql/shared_ptr.hpp>
+#include <ql/time/date.hpp>
+#include <ql/types.hpp>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+/*! Cache for simulated paths, which allows several models with the same configuration to share one simulation
+
+    Models are grouped by a key that identifies their configuration (model structure, number of paths, random
+    sequence settings, etc.). Each model registers its simulation dates on construction, so that the first model
+    that is calculated can simulate paths on the union of the dates of all models in its group. The other models
+    then read the values on their own simulation dates from that superset.
+
+    Since the model inputs (market data, calibrated parameters) can change after the paths were simulated, the
+    cached paths are stored together with a fingerprint of the data that determines them. A request with a different
+    fingerprint triggers a new simulation which replaces the cached paths.
+*/
+class PathCache {
+public:
+    //! path values, indexed by simulation time, state variable and sample
+    typedef std::vector<std::vector<std::vector<QuantLib::Real>>> PathValues;
+
+    //! register the simulation dates of a model with the given key
+    void registerDates(const std::string& key, const std::set<QuantLib::Date>& dates);
+
+    //! the union of all simulation dates registered for the key
+    std::set<QuantLib::Date> dates(const std::string& key) const;
+
+    /*! the paths for the key, if no paths with the given fingerprint are cached, they are generated with the given
+        simulation function and cached */
+    QuantLib::ext::shared_ptr<const PathValues> paths(const std::string& key,
+                                                      const std::vector<QuantLib::Real>& fingerprint,
+                                                      const std::function<PathValues()>& simulate);
+
+    //! remove all registered dates and cached paths
+    void clear();
+
+    //! statistics on the cache usage
+    QuantLib::Size hits() const;
+    QuantLib::Size misses() const;
+
+private:
+    struct Entry {
+        std::vector<QuantLib::Real> fingerprint;
+        QuantLib::ext::shared_ptr<const PathValues> paths;
+        QuantLib::ext::shared_ptr<std::mutex> mutex = QuantLib::ext::make_shared<std::mutex>();
+    };
+    mutable std::mutex mutex_;
+    std::map<std::string, std::set<QuantLib::Date>> dates_;
+    std::map<std::string, Entry> entries_;
+    QuantLib::Size hits_ = 0, misses_ = 0;
+};
+
+} // namespace data
+} // namespace ore
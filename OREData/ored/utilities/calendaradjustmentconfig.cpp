@@ -107,7 +107,8 @@ void CalendarAdjustmentConfig::fromXML(XMLNode* node) {
             parseCalendar(baseCalendar);
             continue;
         }
-        Calendar cal = parseCalendar(calname);
+        // adjust the underlying calendar, not the cached business days
+        Calendar cal = CalendarParser::instance().parseCalendar(calname, false);
 
         vector<string> holidayDates = XMLUtils::getChildrenValues(calnode, "AdditionalHolidays", "Date");
         for (auto holiday : holidayDates) {
@@ -163,6 +164,8 @@ void CalendarAdjustmentConfig::fromXML(XMLNode* node) {
         addBaseCalendar(calname, baseCalendar);
     }
 
+    // cached business days are rebuilt from the adjusted calendars on next use
+    CalendarParser::instance().clearBusinessDayCache();
 }
 
 XMLNode* CalendarAdjustmentConfig::toXML(XMLDocument& doc) const {
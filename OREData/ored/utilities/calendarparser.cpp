@@ -26,6 +26,7 @@
 #include <qle/calendars/amendedcalendar.hpp>
 #include <qle/calendars/austria.hpp>
 #include <qle/calendars/belgium.hpp>
+#include <qle/calendars/bitmapcalendar.hpp>
 #include <qle/calendars/cme.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/cyprus.hpp>
@@ -57,7 +58,31 @@ using namespace QuantExt;
 
 CalendarParser::CalendarParser() { reset(); }
 
-QuantLib::Calendar CalendarParser::parseCalendar(const std::string& name) const {
+QuantLib::Calendar CalendarParser::parseCalendar(const std::string& name, const bool useCache) const {
+    if (!useCache)
+        return parseBaseCalendar(name);
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cacheMutex_);
+        if (cacheStart_ == Date())
+            return parseBaseCalendar(name);
+        auto it = cachedCalendars_.find(name);
+        if (it != cachedCalendars_.end())
+            return it->second;
+    }
+    QuantLib::Calendar base = parseBaseCalendar(name);
+    boost::unique_lock<boost::shared_mutex> lock(cacheMutex_);
+    // the cache might have been disabled or the calendar added by another thread in the meantime
+    if (cacheStart_ == Date())
+        return base;
+    auto it = cachedCalendars_.find(name);
+    if (it != cachedCalendars_.end())
+        return it->second;
+    QuantLib::Calendar cal = QuantExt::BitmapCalendar(base, cacheStart_, cacheEnd_);
+    cachedCalendars_[name] = cal;
+    return cal;
+}
+
+QuantLib::Calendar CalendarParser::parseBaseCalendar(const std::string& name) const {
     boost::shared_lock<boost::shared_mutex> lock(mutex_);
     auto it = calendars_.find(name);
     if (it != calendars_.end())
@@ -80,7 +105,7 @@ QuantLib::Calendar CalendarParser::parseCalendar(const std::string& name) const
         for (Size i = 0; i < calendarNames.size(); i++) {
             boost::trim(calendarNames[i]);
             try {
-                calendars.push_back(parseCalendar(calendarNames[i]));
+                calendars.push_back(parseBaseCalendar(calendarNames[i]));
             } catch (std::exception& e) {
                 QL_FAIL("Cannot convert \"" << name << "\" to Calendar [exception:" << e.what() << "]");
             } catch (...) {
@@ -92,7 +117,8 @@ QuantLib::Calendar CalendarParser::parseCalendar(const std::string& name) const
 }
 
 QuantLib::Calendar CalendarParser::addCalendar(const std::string baseName, std::string& newName) {
-    auto cal = parseCalendar(baseName);
+    auto cal = parseBaseCalendar(baseName);
+    clearBusinessDayCache();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     auto it = calendars_.find(newName);
     if (it == calendars_.end()) {
@@ -106,6 +132,7 @@ QuantLib::Calendar CalendarParser::addCalendar(const std::string baseName, std::
 
 void CalendarParser::reset() {
     resetAddedAndRemovedHolidays();
+    disableBusinessDayCache();
 
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
 
@@ -438,11 +465,38 @@ void CalendarParser::reset() {
 }
 
 void CalendarParser::resetAddedAndRemovedHolidays() {
+    clearBusinessDayCache();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     for (auto& m : calendars_) {
         m.second.resetAddedAndRemovedHolidays();
     }
 }
 
+void CalendarParser::enableBusinessDayCache(const Date& start, const Date& end) {
+    QL_REQUIRE(start != Date() && start <= end, "CalendarParser: invalid business day cache range [" << start << ", "
+                                                                                                   << end << "]");
+    boost::unique_lock<boost::shared_mutex> lock(cacheMutex_);
+    if (start != cacheStart_ || end != cacheEnd_)
+        cachedCalendars_.clear();
+    cacheStart_ = start;
+    cacheEnd_ = end;
+}
+
+void CalendarParser::disableBusinessDayCache() {
+    boost::unique_lock<boost::shared_mutex> lock(cacheMutex_);
+    cachedCalendars_.clear();
+    cacheStart_ = cacheEnd_ = Date();
+}
+
+bool CalendarParser::businessDayCacheEnabled() const {
+    boost::shared_lock<boost::shared_mutex> lock(cacheMutex_);
+    return cacheStart_ != Date();
+}
+
+void CalendarParser::clearBusinessDayCache() {
+    boost::unique_lock<boost::shared_mutex> lock(cacheMutex_);
+    cachedCalendars_.clear();
+}
+
 } // namespace data
 } // namespace ore
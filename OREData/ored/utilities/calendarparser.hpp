@@ -35,14 +35,32 @@ namespace data {
 class CalendarParser : public QuantLib::Singleton<CalendarParser, std::integral_constant<bool, true>> {
 public:
     CalendarParser();
-    QuantLib::Calendar parseCalendar(const std::string& name) const;
+    /*! If the business day cache is enabled and useCache is true, a QuantExt::BitmapCalendar wrapping the calendar
+        is returned. Holidays must be added to or removed from the calendar returned for useCache = false. */
+    QuantLib::Calendar parseCalendar(const std::string& name, const bool useCache = true) const;
     QuantLib::Calendar addCalendar(const std::string baseName, std::string& newName);
     void reset();
     void resetAddedAndRemovedHolidays();
 
+    /*! Enable the business day cache, i.e. parseCalendar() returns calendars with precomputed business days in the
+        given range. The calendars are built on first use and must be rebuilt with clearBusinessDayCache() when
+        holidays are added to or removed from the underlying calendars. */
+    void enableBusinessDayCache(const QuantLib::Date& start = QuantLib::Date(1, QuantLib::January, 1950),
+                                const QuantLib::Date& end = QuantLib::Date(31, QuantLib::December, 2150));
+    void disableBusinessDayCache();
+    bool businessDayCacheEnabled() const;
+    //! Remove the cached calendars, they are rebuilt on the next use
+    void clearBusinessDayCache();
+
 private:
+    QuantLib::Calendar parseBaseCalendar(const std::string& name) const;
+
     mutable boost::shared_mutex mutex_;
     std::map<std::string, QuantLib::Calendar> calendars_;
+
+    mutable boost::shared_mutex cacheMutex_;
+    QuantLib::Date cacheStart_, cacheEnd_;
+    mutable std::map<std::string, QuantLib::Calendar> cachedCalendars_;
 };
 
 } // namespace data
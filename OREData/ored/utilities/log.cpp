@@ -31,6 +31,8 @@
 #include <boost/log/support/date_time.hpp>
 #include <boost/log/sources/severity_feature.hpp>
 #include <boost/phoenix/bind/bind_function.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -268,6 +270,62 @@ void EventLogger::setFormatter(
         fileSink_->set_formatter(formatter);
 }
 
+// -- Asynchronous logging
+
+/* Single producer single consumer ring buffer. The owning thread appends messages, the thread draining the buffers
+   (writer or flushing thread, serialised by the drain mutex) removes them. */
+class LogBuffer {
+public:
+    struct Entry {
+        unsigned mask = 0;
+        const char* filename = nullptr;
+        int lineNo = 0;
+        ptime time;
+        string msg;
+    };
+    explicit LogBuffer(Size capacity) : entries_(capacity) {}
+    Size capacity() const { return entries_.size(); }
+    Size size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+    // producer side, e is moved from only if the push succeeds
+    bool push(Entry& e) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == entries_.size())
+            return false;
+        entries_[tail % entries_.size()] = std::move(e);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    // consumer side
+    void pop(vector<Entry>& out) {
+        std::size_t head = head_.load(std::memory_order_relaxed), tail = tail_.load(std::memory_order_acquire);
+        for (; head != tail; ++head)
+            out.push_back(std::move(entries_[head % entries_.size()]));
+        head_.store(head, std::memory_order_release);
+    }
+    // set by the producer while it appends a message
+    std::atomic<bool> busy{false};
+    // set when the owning thread exits, no more messages are appended then
+    std::atomic<bool> closed{false};
+    // set when asynchronous logging is switched off, the owning thread has to use a new buffer
+    std::atomic<bool> detached{false};
+
+private:
+    vector<Entry> entries_;
+    std::atomic<std::size_t> head_{0}, tail_{0};
+};
+
+namespace {
+struct LogBufferHolder {
+    ~LogBufferHolder() {
+        if (buffer)
+            buffer->closed.store(true);
+    }
+    QuantLib::ext::shared_ptr<LogBuffer> buffer;
+};
+thread_local LogBufferHolder threadLogBuffer;
+thread_local bool isLogWriterThread = false;
+} // namespace
+
 // The Log itself
 Log::Log() : loggers_(), enabled_(false), mask_(255), ls_() {
 
@@ -275,6 +333,147 @@ Log::Log() : loggers_(), enabled_(false), mask_(255), ls_() {
     ls_.setf(ios::showpoint);
 }
 
+Log::~Log() {
+    try {
+        setAsync(false);
+    } catch (...) {
+    }
+}
+
+void Log::setAsync(const bool async, const Size bufferSize) {
+    QL_REQUIRE(bufferSize > 0, "Log::setAsync(): buffer size must be positive");
+    std::lock_guard<std::mutex> asyncLock(asyncMutex_);
+
+    if (writer_.joinable()) {
+        // new messages go the synchronous way, wait until messages that are being appended are complete
+        async_.store(false);
+        vector<QuantLib::ext::shared_ptr<LogBuffer>> buffers;
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            buffers = buffers_;
+        }
+        for (auto const& b : buffers) {
+            while (b->busy.load())
+                std::this_thread::yield();
+        }
+        {
+            std::lock_guard<std::mutex> lock(writerMutex_);
+            stopWriter_ = true;
+        }
+        writerCondition_.notify_one();
+        writer_.join();
+        drain();
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        for (auto const& b : buffers_)
+            b->detached.store(true);
+        buffers_.clear();
+    }
+
+    if (async) {
+        bufferSize_ = bufferSize;
+        stopWriter_ = false;
+        writer_ = std::thread([this]() { writerLoop(); });
+        async_.store(true);
+    }
+}
+
+bool Log::enqueue(unsigned m, const char* filename, int lineNo, const string& msg) {
+    if (isLogWriterThread)
+        return false;
+    while (true) {
+        if (!threadLogBuffer.buffer || threadLogBuffer.buffer->detached.load()) {
+            auto b = QuantLib::ext::make_shared<LogBuffer>(bufferSize_);
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            buffers_.push_back(b);
+            threadLogBuffer.buffer = b;
+        }
+        LogBuffer& b = *threadLogBuffer.buffer;
+        b.busy.store(true);
+        if (!async_.load()) {
+            b.busy.store(false);
+            return false;
+        }
+        if (b.detached.load()) {
+            // asynchronous logging was switched off and on again since we got the buffer
+            b.busy.store(false);
+            continue;
+        }
+        LogBuffer::Entry e{m, filename, lineNo, microsec_clock::local_time(), msg};
+        while (!b.push(e)) {
+            if (m > ORE_WARNING) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            writerCondition_.notify_one();
+            std::this_thread::yield();
+        }
+        if (2 * b.size() >= b.capacity())
+            writerCondition_.notify_one();
+        b.busy.store(false);
+        return true;
+    }
+}
+
+void Log::drain() {
+    std::lock_guard<std::mutex> drainLock(drainMutex_);
+    vector<QuantLib::ext::shared_ptr<LogBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        // remove the buffers of threads that have exited once they are empty
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                      [](const QuantLib::ext::shared_ptr<LogBuffer>& b) {
+                                          return b->closed.load() && b->size() == 0;
+                                      }),
+                       buffers_.end());
+        buffers = buffers_;
+    }
+    vector<LogBuffer::Entry> entries;
+    for (auto const& b : buffers)
+        b->pop(entries);
+    Size dropped = dropped_.load();
+    if (entries.empty() && dropped == reportedDropped_)
+        return;
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const LogBuffer::Entry& a, const LogBuffer::Entry& b) { return a.time < b.time; });
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    for (auto const& e : entries) {
+        header(e.mask, e.filename, e.lineNo, e.time);
+        ls_ << e.msg;
+        log(e.mask);
+    }
+    if (dropped > reportedDropped_) {
+        header(ORE_WARNING, __FILE__, __LINE__, microsec_clock::local_time());
+        ls_ << (dropped - reportedDropped_) << " log messages dropped, because the log buffer of a thread was full";
+        log(ORE_WARNING);
+        reportedDropped_ = dropped;
+    }
+}
+
+void Log::writerLoop() {
+    isLogWriterThread = true;
+    std::unique_lock<std::mutex> lock(writerMutex_);
+    while (!stopWriter_) {
+        writerCondition_.wait_for(lock, std::chrono::milliseconds(10));
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+void Log::flush() {
+    if (async_.load())
+        drain();
+}
+
+void Log::log(unsigned m, const char* filename, int lineNo, const string& msg) {
+    if (async_.load() && enqueue(m, filename, lineNo, msg))
+        return;
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    header(m, filename, lineNo);
+    ls_ << msg;
+    log(m);
+}
+
 void Log::registerLogger(const QuantLib::ext::shared_ptr<Logger>& logger) {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     QL_REQUIRE(loggers_.find(logger->name()) == loggers_.end(),
@@ -318,6 +517,7 @@ QuantLib::ext::shared_ptr<IndependentLogger>& Log::independentLogger(const strin
 }
 
 void Log::removeLogger(const string& name) {
+    flush();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     map<string, QuantLib::ext::shared_ptr<Logger>>::iterator it = loggers_.find(name);
     if (it != loggers_.end()) {
@@ -339,6 +539,7 @@ void Log::removeIndependentLogger(const string& name) {
 }
 
 void Log::removeAllLoggers() {
+    flush();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     loggers_.clear();
     logging::core::get()->remove_all_sinks();
@@ -372,14 +573,19 @@ string Log::source(const char* filename, int lineNo) const {
 void Log::addExcludeFilter(const string& key, const std::function<bool(const std::string&)> func) {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     excludeFilters_[key] = func;
+    hasExcludeFilters_.store(true);
 }
 
 void Log::removeExcludeFilter(const string& key) {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     excludeFilters_.erase(key);
+    hasExcludeFilters_.store(!excludeFilters_.empty());
 }
 
 bool Log::checkExcludeFilters(const std::string& msg) {
+    // avoid the lock in the usual case that there are no filters
+    if (!hasExcludeFilters_.load(std::memory_order_relaxed))
+        return false;
     boost::shared_lock<boost::shared_mutex> lock(mutex_);
     for (const auto& f : excludeFilters_) {
         if (f.second(msg))
@@ -389,6 +595,10 @@ bool Log::checkExcludeFilters(const std::string& msg) {
 }
 
 void Log::header(unsigned m, const char* filename, int lineNo) {
+    header(m, filename, lineNo, microsec_clock::local_time());
+}
+
+void Log::header(unsigned m, const char* filename, int lineNo, const ptime& time) {
     // 1. Reset stringstream
     ls_.str(string());
     ls_.clear();
@@ -425,7 +635,7 @@ void Log::header(unsigned m, const char* filename, int lineNo) {
     // Timestamp
     // Use boost::posix_time microsecond clock to get better precision (when available).
     // format is "2014-Apr-04 11:10:16.179347"
-    ls_ << '[' << to_simple_string(microsec_clock::local_time()) << ']';
+    ls_ << '[' << to_simple_string(time) << ']';
 
     // Filename & line no
     // format is " (file:line)"
@@ -480,10 +690,7 @@ LoggerStream::~LoggerStream() {
     while (getline(ss_, text)) {
         // we expand the MLOG macro here so we can overwrite __FILE__ and __LINE__
         if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(mask_)) {
-            boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());
-            ore::data::Log::instance().header(mask_, filename_, lineNo_);
-            ore::data::Log::instance().logStream() << text;
-            ore::data::Log::instance().log(mask_);
+            ore::data::Log::instance().log(mask_, filename_, lineNo_, text);
         }
     }
 }
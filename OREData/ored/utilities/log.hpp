@@ -33,12 +33,18 @@
 #define ORE_DATA 64    // 01000000  127
 #define ORE_MEMORY 128 // 10000000  255
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <time.h>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/log/attributes/mutable_constant.hpp>
 #include <boost/log/utility/manipulators/add_value.hpp>
 #include <boost/log/attributes.hpp>
@@ -352,6 +358,9 @@ private:
     QuantLib::ext::shared_ptr<file_sink> fileSink_;
 };
 
+//! Buffer of log messages of one thread, implementation detail of asynchronous logging
+class LogBuffer;
+
 //! Global static Log class
 /*!
   The Global Log class gets registered with individual loggers and receives application log messages.
@@ -384,6 +393,15 @@ private:
           std::cout << bl.next() << std::endl;
       std::cout << "End Log Messages." << std::endl;
   </pre>
+
+  Asynchronous logging can be switched on with setAsync(). In this mode a log call does not acquire the Log mutex.
+  The message is time stamped and appended to a buffer owned by the calling thread, a background writer thread
+  collects the messages from all buffers, orders them by time stamp and dispatches them to the loggers. Each thread
+  buffer holds a fixed number of messages, so that the memory used is bounded. If the buffer of a thread is full,
+  messages of level warning or more severe wait until the writer has made room, less severe messages are dropped.
+  The number of dropped messages is reported by a warning in the log and by droppedMessages(). Messages are not
+  delivered immediately, flush() writes out all messages logged so far, it is called when loggers are removed,
+  when the log is switched off and when asynchronous logging is switched off.
   \ingroup utilities
  */
 class Log : public QuantLib::Singleton<Log, std::integral_constant<bool, true>> {
@@ -441,23 +459,17 @@ public:
     std::ostream& logStream() { return ls_; }
     //! macro utility function - do not use directly, not thread safe
     void log(unsigned m);
+    //! macro utility function - do not use directly, thread safe
+    void log(unsigned m, const char* filename, int lineNo, const std::string& msg);
 
     //! mutex to acquire locks
     boost::shared_mutex& mutex() { return mutex_; }
 
+    // the level checks do not lock, they are done for every log call
     // Avoid a large number of warnings in VS by adding 0 !=
-    bool filter(unsigned mask) {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return 0 != (mask & mask_);
-    }
-    unsigned mask() {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return mask_;
-    }
-    void setMask(unsigned mask) {
-        boost::unique_lock<boost::shared_mutex> lock(mutex());
-        mask_ = mask;
-    }
+    bool filter(unsigned mask) { return 0 != (mask & mask_.load(std::memory_order_relaxed)); }
+    unsigned mask() { return mask_.load(std::memory_order_relaxed); }
+    void setMask(unsigned mask) { mask_.store(mask, std::memory_order_relaxed); }
     const boost::filesystem::path& rootPath() {
         boost::shared_lock<boost::shared_mutex> lock(mutex());
         return rootPath_;
@@ -475,17 +487,11 @@ public:
         maxLen_ = n;
     }
 
-    bool enabled() {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return enabled_;
-    }
-    void switchOn() {
-        boost::unique_lock<boost::shared_mutex> lock(mutex());
-        enabled_ = true;
-    }
+    bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    void switchOn() { enabled_.store(true, std::memory_order_relaxed); }
     void switchOff() {
-        boost::unique_lock<boost::shared_mutex> lock(mutex());
-        enabled_ = false;
+        enabled_.store(false, std::memory_order_relaxed);
+        flush();
     }
 
     bool writeSuppressedMessagesHint() {
@@ -496,16 +502,36 @@ public:
     //! if a PID is set for the logger, messages are tagged with [1234] if pid = 1234
     void setPid(const int pid) { pid_ = pid; }
 
+    //! \name Asynchronous logging
+    //@{
+    /*! Switch asynchronous logging on or off, bufferSize is the number of messages each thread can buffer. Switching
+        off writes out all buffered messages and stops the writer thread. */
+    void setAsync(const bool async, const QuantLib::Size bufferSize = 4096);
+    bool async() const { return async_.load(); }
+    //! Write out all messages that were logged so far, does nothing in synchronous mode
+    void flush();
+    //! Number of messages dropped because a thread buffer was full
+    QuantLib::Size droppedMessages() const { return dropped_.load(); }
+    //@}
+
+    ~Log();
+
 private:
     Log();
 
     // not thread safe
     std::string source(const char* filename, int lineNo) const;
+    void header(unsigned m, const char* filename, int lineNo, const boost::posix_time::ptime& time);
+
+    // asynchronous logging
+    bool enqueue(unsigned m, const char* filename, int lineNo, const std::string& msg);
+    void drain();
+    void writerLoop();
 
     std::map<std::string, QuantLib::ext::shared_ptr<Logger>> loggers_;
     std::map<std::string, QuantLib::ext::shared_ptr<IndependentLogger>> independentLoggers_;
-    bool enabled_;
-    unsigned mask_;
+    std::atomic<bool> enabled_;
+    std::atomic<unsigned> mask_;
     boost::filesystem::path rootPath_;
     std::ostringstream ls_;
 
@@ -521,6 +547,17 @@ private:
     mutable boost::shared_mutex mutex_;
 
     std::map<std::string, std::function<bool(const std::string&)>> excludeFilters_;
+    std::atomic<bool> hasExcludeFilters_{false};
+
+    std::atomic<bool> async_{false};
+    QuantLib::Size bufferSize_ = 4096;
+    std::atomic<QuantLib::Size> dropped_{0};
+    QuantLib::Size reportedDropped_ = 0;
+    std::vector<QuantLib::ext::shared_ptr<LogBuffer>> buffers_;
+    std::mutex buffersMutex_, drainMutex_, asyncMutex_, writerMutex_;
+    std::condition_variable writerCondition_;
+    bool stopWriter_ = false;
+    std::thread writer_;
 };
 
 /*!
@@ -532,10 +569,7 @@ private:
             std::ostringstream __ore_mlog_tmp_stringstream__;                                                          \
             __ore_mlog_tmp_stringstream__ << text;                                                                     \
             if (!ore::data::Log::instance().checkExcludeFilters(__ore_mlog_tmp_stringstream__.str())) {                \
-                boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());                      \
-                ore::data::Log::instance().header(mask, __FILE__, __LINE__);                                           \
-                ore::data::Log::instance().logStream() << __ore_mlog_tmp_stringstream__.str();                         \
-                ore::data::Log::instance().log(mask);                                                                  \
+                ore::data::Log::instance().log(mask, __FILE__, __LINE__, __ore_mlog_tmp_stringstream__.str());         \
             }                                                                                                          \
         }                                                                                                              \
     }
@@ -561,11 +595,9 @@ private:
 #define MEM_LOG_USING_LEVEL(LEVEL)                                                                                      \
     {                                                                                                                   \
         if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(LEVEL)) {                         \
-            boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());                           \
-            ore::data::Log::instance().header(LEVEL, __FILE__, __LINE__);                                               \
-            ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getPeakMemoryUsageBytes()) << "|";  \
-            ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getMemoryUsageBytes());             \
-            ore::data::Log::instance().log(LEVEL);                                                                      \
+            ore::data::Log::instance().log(LEVEL, __FILE__, __LINE__,                                                   \
+                                           std::to_string(ore::data::os::getPeakMemoryUsageBytes()) + "|" +             \
+                                               std::to_string(ore::data::os::getMemoryUsageBytes()));                   \
         }                                                                                                               \
     }
 
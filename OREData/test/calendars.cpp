@@ -20,6 +20,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
 // clang-format on
+#include <ored/utilities/calendarparser.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/time/calendars/all.hpp>
@@ -156,6 +157,34 @@ BOOST_DATA_TEST_CASE(testCalendarNameParsing, bdata::make(calendarData), calenda
     BOOST_TEST_MESSAGE("Parsed " << calendarDatum.calendarName << " and got " << calendar.name());
 }
 
+BOOST_AUTO_TEST_CASE(testBusinessDayCache) {
+
+    BOOST_TEST_MESSAGE("Testing business day cache in calendar parser...");
+
+    ore::data::CalendarParser& parser = ore::data::CalendarParser::instance();
+    Calendar expected = JointCalendar(UnitedStates(UnitedStates::Settlement), TARGET());
+    parser.enableBusinessDayCache(Date(1, January, 2020), Date(31, December, 2030));
+    BOOST_CHECK(parser.businessDayCacheEnabled());
+
+    Calendar cal = ore::data::parseCalendar("NYB,TGT");
+    BOOST_CHECK_EQUAL(cal, expected);
+    for (Date d(1, December, 2019); d <= Date(31, January, 2031); ++d)
+        BOOST_CHECK_EQUAL(cal.isBusinessDay(d), expected.isBusinessDay(d));
+
+    // adjustments of the underlying calendar are seen after the cache is cleared
+    Date h(14, March, 2024);
+    BOOST_REQUIRE(ore::data::parseCalendar("TARGET").isBusinessDay(h));
+    parser.parseCalendar("TARGET", false).addHoliday(h);
+    parser.clearBusinessDayCache();
+    BOOST_CHECK(!ore::data::parseCalendar("TARGET").isBusinessDay(h));
+    BOOST_CHECK(!ore::data::parseCalendar("NYB,TGT").isBusinessDay(h));
+
+    // reset removes the adjustments and disables the cache
+    parser.reset();
+    BOOST_CHECK(!parser.businessDayCacheEnabled());
+    BOOST_CHECK(ore::data::parseCalendar("TARGET").isBusinessDay(h));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/report/columnarreport.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace ore::data;
+using namespace QuantLib;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+template <class R> void fillReport(R& report) {
+    report.addColumn("TradeId", string())
+        .addColumn("Index", Size())
+        .addColumn("Date", Date())
+        .addColumn("Tenor", Period())
+        .addColumn("Value", Real(), 4);
+    vector<string> ids = {"Trade_1", "Trade_2", "Trade_3"};
+    for (Size i = 0; i < 30; ++i) {
+        report.next()
+            .add(ids[i % ids.size()])
+            .add(i)
+            .add(i == 0 ? Date() : Date(1, January, 2024) + i)
+            .add(Period(i, Months))
+            .add(i == 1 ? Null<Real>() : 1.5 * i);
+    }
+    report.end();
+}
+
+string readFile(const string& filename) {
+    std::ifstream is(filename.c_str());
+    std::stringstream s;
+    s << is.rdbuf();
+    return s.str();
+}
+
+void checkEqual(const ColumnarReport& r1, const ColumnarReport& r2) {
+    BOOST_REQUIRE_EQUAL(r1.columns(), r2.columns());
+    BOOST_REQUIRE_EQUAL(r1.rows(), r2.rows());
+    for (Size i = 0; i < r1.columns(); ++i) {
+        BOOST_CHECK_EQUAL(r1.header(i), r2.header(i));
+        BOOST_CHECK_EQUAL(r1.columnPrecision(i), r2.columnPrecision(i));
+        BOOST_CHECK(r1.columnType(i) == r2.columnType(i));
+        for (Size j = 0; j < r1.rows(); ++j)
+            BOOST_CHECK(r1.value(j, i) == r2.value(j, i));
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ColumnarReportTests)
+
+BOOST_AUTO_TEST_CASE(testTypedAccess) {
+
+    BOOST_TEST_MESSAGE("Testing typed access to columnar report data...");
+
+    ColumnarReport report;
+    fillReport(report);
+
+    BOOST_CHECK_EQUAL(report.columns(), 5);
+    BOOST_CHECK_EQUAL(report.rows(), 30);
+    BOOST_CHECK(report.hasHeader("Tenor"));
+    BOOST_CHECK(!report.hasHeader("NPV"));
+
+    // strings are dictionary encoded
+    BOOST_CHECK_EQUAL(report.stringDictionary(0).size(), 3);
+    BOOST_CHECK_EQUAL(report.stringCodes(0).size(), 30);
+    BOOST_CHECK_EQUAL(report.stringData(4, 0), "Trade_2");
+
+    BOOST_CHECK_EQUAL(report.sizeData(1)[7], 7);
+    BOOST_CHECK_EQUAL(report.dateData(0, 2), Date());
+    BOOST_CHECK_EQUAL(report.dateData(3, 2), Date(4, January, 2024));
+    BOOST_CHECK_EQUAL(report.periodData(5, 3), 5 * Months);
+    BOOST_CHECK_EQUAL(report.realData(4)[2], 3.0);
+    BOOST_CHECK_EQUAL(report.realData(4)[1], Null<Real>());
+    BOOST_CHECK(boost::get<string>(report.value(2, 0)) == "Trade_3");
+
+    // type mismatches and incomplete rows are rejected
+    BOOST_CHECK_THROW(report.realData(0), QuantLib::Error);
+    BOOST_CHECK_THROW(report.next().add(string("Trade_4")).add(string("x")), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testFileOutput) {
+
+    BOOST_TEST_MESSAGE("Testing columnar report csv and binary file output...");
+
+    ColumnarReport report;
+    fillReport(report);
+
+    // the csv output is identical to the one of an InMemoryReport
+    InMemoryReport imReport;
+    fillReport(imReport);
+    string csv1 = TEST_OUTPUT_FILE("columnarreport.csv");
+    string csv2 = TEST_OUTPUT_FILE("inmemoryreport.csv");
+    report.toFile(csv1);
+    imReport.toFile(csv2);
+    BOOST_CHECK_EQUAL(readFile(csv1), readFile(csv2));
+
+    // binary round trip
+    string bin = TEST_OUTPUT_FILE("columnarreport.bin");
+    report.toBinaryFile(bin);
+    auto restored = ColumnarReport::fromBinaryFile(bin);
+    checkEqual(report, *restored);
+
+    // the restored report can be extended
+    restored->next().add(string("Trade_1")).add(Size(30)).add(Date()).add(Period()).add(1.0);
+    BOOST_CHECK_EQUAL(restored->rows(), 31);
+    BOOST_CHECK_EQUAL(restored->stringDictionary(0).size(), 3);
+
+    BOOST_CHECK_THROW(ColumnarReport::fromBinaryFile(csv1), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testFromInMemoryReport) {
+
+    BOOST_TEST_MESSAGE("Testing conversion of a buffered in memory report to a columnar report...");
+
+    // a small buffer size, so that most rows are spilled to temporary files
+    InMemoryReport imReport(7);
+    fillReport(imReport);
+    ColumnarReport report;
+    imReport.writeTo(report);
+
+    ColumnarReport expected;
+    fillReport(expected);
+    checkEqual(report, expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,236 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/utilities/log.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using namespace ore::data;
+using namespace QuantLib;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+// a file with the given content in the temp directory, removed on destruction
+class TempFile {
+public:
+    TempFile(const string& content)
+        : name_((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string()) {
+        ofstream file(name_, std::ios::out | std::ios::binary);
+        file << content;
+    }
+    ~TempFile() { boost::filesystem::remove(name_); }
+    const string& name() const { return name_; }
+
+private:
+    string name_;
+};
+
+// installs a buffer logger and restores the previous log state on destruction
+class BufferLogFixture {
+public:
+    BufferLogFixture() : enabled_(Log::instance().enabled()), mask_(Log::instance().mask()) {
+        logger_ = QuantLib::ext::make_shared<BufferLogger>(ORE_MEMORY);
+        Log::instance().registerLogger(logger_);
+        Log::instance().setMask(255);
+        Log::instance().switchOn();
+    }
+    ~BufferLogFixture() {
+        Log::instance().removeLogger(BufferLogger::name);
+        Log::instance().setMask(mask_);
+        if (!enabled_)
+            Log::instance().switchOff();
+    }
+    // the messages without the time stamp
+    vector<string> messages() {
+        vector<string> result;
+        while (logger_->hasNext()) {
+            string m = logger_->next();
+            result.push_back(m.substr(m.find(']') + 1));
+        }
+        return result;
+    }
+
+private:
+    bool enabled_;
+    unsigned mask_;
+    QuantLib::ext::shared_ptr<BufferLogger> logger_;
+};
+
+const Date asof(5, February, 2016);
+
+string iso(const Date& d) {
+    ostringstream os;
+    os << io::iso_date(d);
+    return os.str();
+}
+
+string marketData() {
+    vector<string> ccys = {"USD", "GBP", "CHF", "JPY", "SEK", "NOK", "AUD", "CAD"};
+    ostringstream os;
+    os << "# market data\n\n";
+    for (Size d = 0; d < 20; ++d) {
+        string date = iso(asof - d);
+        for (Size i = 0; i < ccys.size(); ++i) {
+            // vary separators, white space and line endings
+            if (i % 3 == 0)
+                os << date << ",FX/RATE/EUR/" << ccys[i] << "," << 1.0 + 0.01 * d + 0.1 * i << "\n";
+            else if (i % 3 == 1)
+                os << "  " << date << " \t FX/RATE/EUR/" << ccys[i] << " ; " << 1.0 + 0.01 * d + 0.1 * i << "\r\n";
+            else
+                os << date << " FX/RATE/EUR/" << ccys[i] << " " << 1.0 + 0.01 * d + 0.1 * i << "  \n";
+        }
+        os << "# end of " << date << "\n";
+    }
+    // no line break at the end of the file
+    os << iso(asof) << " FX/RATE/EUR/NZD 1.6";
+    return os.str();
+}
+
+string fixingData() {
+    ostringstream os;
+    for (Size d = 1; d < 50; ++d)
+        os << iso(asof - d) << " EUR-EURIBOR-6M " << 0.01 + 0.0001 * d << "\n";
+    return os.str();
+}
+
+void checkSameData(const CSVLoader& loader, const CSVLoader& reference) {
+    for (Size d = 0; d < 20; ++d) {
+        auto data = loader.loadQuotes(asof - d);
+        auto refData = reference.loadQuotes(asof - d);
+        BOOST_REQUIRE_EQUAL(data.size(), refData.size());
+        for (Size i = 0; i < data.size(); ++i) {
+            BOOST_CHECK_EQUAL(data[i]->name(), refData[i]->name());
+            BOOST_CHECK_EQUAL(data[i]->quote()->value(), refData[i]->quote()->value());
+        }
+    }
+    auto fixings = loader.loadFixings();
+    auto refFixings = reference.loadFixings();
+    BOOST_REQUIRE_EQUAL(fixings.size(), refFixings.size());
+    for (auto f = fixings.begin(), r = refFixings.begin(); f != fixings.end(); ++f, ++r) {
+        BOOST_CHECK_EQUAL(f->name, r->name);
+        BOOST_CHECK_EQUAL(f->date, r->date);
+        BOOST_CHECK_EQUAL(f->fixing, r->fixing);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CSVLoaderTests)
+
+BOOST_AUTO_TEST_CASE(testChunkBoundaries) {
+
+    BOOST_TEST_MESSAGE("Testing CSVLoader with lines split across chunk boundaries...");
+
+    Settings::instance().evaluationDate() = asof;
+    TempFile market(marketData()), fixings(fixingData());
+
+    CSVLoader reference(market.name(), fixings.name(), false, Date(), 1);
+    BOOST_REQUIRE_EQUAL(reference.loadQuotes(asof).size(), 9);
+    BOOST_REQUIRE_EQUAL(reference.loadFixings().size(), 49);
+    BOOST_CHECK_CLOSE(reference.get("FX/RATE/EUR/NZD", asof)->quote()->value(), 1.6, 1.0E-12);
+    BOOST_CHECK_CLOSE(reference.get("FX/RATE/EUR/GBP", asof - 3)->quote()->value(), 1.13, 1.0E-12);
+
+    // the nominal chunk ends fall into the middle of lines for these chunk sizes
+    for (Size chunkSize : {1, 7, 64, 1000}) {
+        for (Size nThreads : {1, 3, 8}) {
+            CSVLoader loader(market.name(), fixings.name(), false, Date(), nThreads, chunkSize);
+            checkSameData(loader, reference);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testFxDominanceAcrossChunks) {
+
+    BOOST_TEST_MESSAGE("Testing CSVLoader FX dominance and duplicates in different chunks...");
+
+    Settings::instance().evaluationDate() = asof;
+    string date = iso(asof);
+    string filler;
+    for (Size i = 0; i < 20; ++i)
+        filler += date + " FX/RATE/EUR/CHF 1.08\n";
+    TempFile market(date + " FX/RATE/USD/EUR 0.9\n" + filler + date + " FX/RATE/EUR/USD 1.1\n" + filler + date +
+                    " FX/RATE/USD/EUR 0.95\n" + filler + date + " FX/RATE/EUR/USD 1.2\n" + filler + date +
+                    " FX/RATE/GBP/JPY 150.0\n" + filler + date + " FX/RATE/JPY/GBP 0.0066\n");
+    TempFile fixings("");
+
+    for (Size nThreads : {1, 4}) {
+        CSVLoader loader(market.name(), fixings.name(), false, Date(), nThreads, 32);
+        // the dominant quote replaces the non-dominant one, later duplicates are skipped
+        BOOST_CHECK(!loader.has("FX/RATE/USD/EUR", asof));
+        BOOST_REQUIRE(loader.has("FX/RATE/EUR/USD", asof));
+        BOOST_CHECK_CLOSE(loader.get("FX/RATE/EUR/USD", asof)->quote()->value(), 1.1, 1.0E-12);
+        // the non-dominant quote is skipped if the dominant one is present
+        BOOST_CHECK(!loader.has("FX/RATE/JPY/GBP", asof));
+        BOOST_CHECK_CLOSE(loader.get("FX/RATE/GBP/JPY", asof)->quote()->value(), 150.0, 1.0E-12);
+        BOOST_CHECK_CLOSE(loader.get("FX/RATE/EUR/CHF", asof)->quote()->value(), 1.08, 1.0E-12);
+        BOOST_CHECK_EQUAL(loader.loadQuotes(asof).size(), 3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testWarningOrder) {
+
+    BOOST_TEST_MESSAGE("Testing CSVLoader log output does not depend on the number of threads...");
+
+    Settings::instance().evaluationDate() = asof;
+    ostringstream market, fixings;
+    string date = iso(asof);
+    for (Size i = 0; i < 30; ++i) {
+        market << date << " FX/RATE/EUR/USD " << 1.1 + 0.01 * i << "\n";
+        market << date << " INVALID/QUOTE/" << i << " 1.0\n";
+        market << date << " FX/RATE/EUR/GBP " << 0.8 + 0.01 * i << "\n";
+        fixings << iso(asof - (i % 7 + 1)) << " EUR-EURIBOR-6M " << 0.01 * i << "\n";
+    }
+    TempFile marketFile(market.str()), fixingsFile(fixings.str());
+
+    auto logMessages = [&marketFile, &fixingsFile](Size nThreads, Size chunkSize) {
+        BufferLogFixture logFixture;
+        CSVLoader loader(marketFile.name(), fixingsFile.name(), false, Date(), nThreads, chunkSize);
+        return logFixture.messages();
+    };
+
+    vector<string> serial = logMessages(1, 1 << 20);
+    Size warnings = 0;
+    for (auto const& m : serial)
+        if (m.find("Failed to parse MarketDatum INVALID/QUOTE") != string::npos ||
+            m.find("Skipped Fixing EUR-EURIBOR-6M") != string::npos)
+            ++warnings;
+    BOOST_CHECK_EQUAL(warnings, 30 + 23);
+
+    for (Size nThreads : {2, 4}) {
+        for (Size chunkSize : {16, 100}) {
+            vector<string> threaded = logMessages(nThreads, chunkSize);
+            BOOST_REQUIRE_EQUAL(threaded.size(), serial.size());
+            for (Size i = 0; i < serial.size(); ++i)
+                BOOST_CHECK_EQUAL(threaded[i], serial[i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -30,6 +30,7 @@
 #include <ored/scripting/scriptparser.hpp>
 #include <ored/scripting/astprinter.hpp>
 #include <ored/scripting/models/dummymodel.hpp>
+#include <ored/scripting/models/pathcache.hpp>
 
 #include <oret/toplevelfixture.hpp>
 
@@ -312,6 +313,118 @@ BOOST_AUTO_TEST_CASE(testRepricingCalibrationInstruments) {
     }
 }
 
+
+BOOST_AUTO_TEST_CASE(testSharedPaths) {
+
+    BOOST_TEST_MESSAGE("test sharing of paths between Gaussian CAM instances...");
+
+    constexpr Size paths = 1000;
+
+    Date asof(7, July, 2019);
+    Settings::instance().evaluationDate() = asof;
+    auto testMarket = QuantLib::ext::make_shared<OredTestMarket>(asof);
+
+    // build an uncalibrated IR-FX CAM
+
+    std::vector<QuantLib::ext::shared_ptr<IrModelData>> irConfigs;
+    for (auto const& ccy : {"EUR", "USD"}) {
+        auto config = QuantLib::ext::make_shared<IrLgmData>();
+        config->qualifier() = ccy;
+        config->reversionType() = LgmData::ReversionType::HullWhite;
+        config->volatilityType() = LgmData::VolatilityType::Hagan;
+        config->calibrationType() = CalibrationType::None;
+        config->calibrateH() = false;
+        config->hParamType() = ParamType::Constant;
+        config->hValues() = {0.01};
+        config->calibrateA() = false;
+        config->aParamType() = ParamType::Constant;
+        config->aValues() = {0.0050};
+        config->scaling() = 1.0;
+        config->shiftHorizon() = 0.0;
+        irConfigs.push_back(config);
+    }
+
+    auto configFX = QuantLib::ext::make_shared<FxBsData>();
+    configFX->foreignCcy() = "USD";
+    configFX->domesticCcy() = "EUR";
+    configFX->calibrationType() = CalibrationType::None;
+    configFX->calibrateSigma() = false;
+    configFX->sigmaParamType() = ParamType::Constant;
+    configFX->sigmaValues() = {0.10};
+    std::vector<QuantLib::ext::shared_ptr<FxBsData>> fxConfigs = {configFX};
+
+    CorrelationMatrixBuilder cmb;
+    cmb.addCorrelation("IR:EUR", "IR:USD", Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.6)));
+    cmb.addCorrelation("IR:EUR", "FX:EURUSD", Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.2)));
+    cmb.addCorrelation("IR:USD", "FX:EURUSD", Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.3)));
+
+    auto camBuilder = QuantLib::ext::make_shared<CrossAssetModelBuilder>(
+        testMarket, QuantLib::ext::make_shared<CrossAssetModelData>(irConfigs, fxConfigs,
+                                                                    std::vector<QuantLib::ext::shared_ptr<EqBsData>>(),
+                                                                    cmb.correlations()));
+
+    std::vector<std::string> modelCcys = {"EUR", "USD"};
+    std::vector<Handle<YieldTermStructure>> modelCurves = {testMarket->discountCurve("EUR"),
+                                                           testMarket->discountCurve("USD")};
+    std::vector<Handle<Quote>> modelFxSpots = {testMarket->fxRate("USDEUR")};
+    std::vector<std::string> indices = {"FX-GENERIC-USD-EUR"};
+    std::vector<std::string> indexCurrencies = {"USD"};
+
+    Date d1 = asof + 1 * Years, d2 = asof + 2 * Years, d3 = asof + 3 * Years;
+
+    auto makeModel = [&](const std::set<Date>& simulationDates, const QuantLib::ext::shared_ptr<PathCache>& cache) {
+        return QuantLib::ext::make_shared<GaussianCam>(
+            camBuilder->model(), paths, modelCcys, modelCurves, modelFxSpots,
+            std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<InterestRateIndex>>>(),
+            std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<ZeroInflationIndex>>>(), indices,
+            indexCurrencies, simulationDates, Model::McParams(), 1, IborFallbackConfig::defaultConfig(),
+            std::vector<Size>(), std::vector<std::string>(), cache);
+    };
+
+    auto price = [&](const QuantLib::ext::shared_ptr<Model>& model, const Date& expiry) {
+        auto context = QuantLib::ext::make_shared<Context>();
+        context->scalars["Option"] = RandomVariable(paths, 0.0);
+        context->scalars["Underlying"] = IndexVec{paths, "FX-GENERIC-USD-EUR"};
+        context->scalars["PayCcy"] = CurrencyVec{paths, "EUR"};
+        context->scalars["Expiry"] = EventVec{paths, expiry};
+        std::string script = "Option = PAY( max( Underlying(Expiry) - 0.9, 0), Expiry, Expiry, PayCcy );";
+        ScriptEngine engine(ScriptParser(script).ast(), context, model);
+        engine.run();
+        return expectation(QuantLib::ext::get<RandomVariable>(context->scalars["Option"])).at(0);
+    };
+
+    // two models with different simulation dates sharing their paths
+
+    auto cache = QuantLib::ext::make_shared<PathCache>();
+    auto model1 = makeModel({d1, d3}, cache);
+    auto model2 = makeModel({d2, d3}, cache);
+
+    // a standalone model simulating on the union of the dates generates the same paths as the shared models
+
+    auto reference = makeModel({d1, d2, d3}, nullptr);
+
+    Real p1 = price(model1, d3), p2 = price(model2, d3), pRef = price(reference, d3);
+    BOOST_TEST_MESSAGE("shared paths: model1 = " << p1 << ", model2 = " << p2 << ", reference = " << pRef);
+    BOOST_CHECK_CLOSE(p1, pRef, 1E-10);
+    BOOST_CHECK_CLOSE(p2, pRef, 1E-10);
+    BOOST_CHECK_CLOSE(price(model1, d1), price(reference, d1), 1E-10);
+    BOOST_CHECK_CLOSE(price(model2, d2), price(reference, d2), 1E-10);
+
+    // the paths were simulated once and reused for the second model
+
+    BOOST_CHECK_EQUAL(cache->misses(), 1);
+    BOOST_CHECK_EQUAL(cache->hits(), 1);
+
+    // a change in the market data triggers a new simulation
+
+    auto fxSpot = QuantLib::ext::dynamic_pointer_cast<SimpleQuote>(*testMarket->fxRate("EURUSD"));
+    BOOST_REQUIRE(fxSpot);
+    fxSpot->setValue(fxSpot->value() * 1.01);
+    price(model1, d3);
+    BOOST_CHECK_EQUAL(cache->misses(), 2);
+    BOOST_CHECK_EQUAL(cache->hits(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
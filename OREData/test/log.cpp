@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/utilities/log.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <thread>
+
+using namespace ore::data;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+// installs a buffer logger and restores the previous log state on destruction
+class BufferLogFixture {
+public:
+    BufferLogFixture(unsigned mask) : enabled_(Log::instance().enabled()), mask_(Log::instance().mask()) {
+        logger_ = QuantLib::ext::make_shared<BufferLogger>(ORE_MEMORY);
+        Log::instance().registerLogger(logger_);
+        Log::instance().setMask(mask);
+        Log::instance().switchOn();
+    }
+    ~BufferLogFixture() {
+        Log::instance().setAsync(false);
+        Log::instance().removeLogger(BufferLogger::name);
+        Log::instance().setMask(mask_);
+        if (!enabled_)
+            Log::instance().switchOff();
+    }
+    vector<string> messages() {
+        vector<string> result;
+        while (logger_->hasNext())
+            result.push_back(logger_->next());
+        return result;
+    }
+
+private:
+    bool enabled_;
+    unsigned mask_;
+    QuantLib::ext::shared_ptr<BufferLogger> logger_;
+};
+
+void logFromThreads(Size nThreads, Size nMessages, bool warnings) {
+    vector<std::thread> threads;
+    for (Size t = 0; t < nThreads; ++t) {
+        threads.emplace_back([t, nMessages, warnings]() {
+            for (Size i = 0; i < nMessages; ++i) {
+                if (warnings) {
+                    WLOG("thread " << t << " message " << i);
+                } else {
+                    DLOG("thread " << t << " message " << i);
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LogTests)
+
+BOOST_AUTO_TEST_CASE(testAsyncLogging) {
+
+    BOOST_TEST_MESSAGE("Testing asynchronous logging...");
+
+    BufferLogFixture fixture(255);
+    Log::instance().setAsync(true, 16);
+    BOOST_CHECK(Log::instance().async());
+
+    // warnings are never dropped, even if the thread buffers are small
+    logFromThreads(4, 200, true);
+    Log::instance().flush();
+    vector<string> messages = fixture.messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), 800);
+
+    // the messages of each thread arrive in order
+    vector<Size> next(4, 0);
+    for (auto const& m : messages) {
+        for (Size t = 0; t < 4; ++t) {
+            string expected = "thread " + std::to_string(t) + " message " + std::to_string(next[t]);
+            if (m.size() >= expected.size() && m.compare(m.size() - expected.size(), expected.size(), expected) == 0)
+                ++next[t];
+        }
+    }
+    for (Size t = 0; t < 4; ++t)
+        BOOST_CHECK_EQUAL(next[t], 200);
+    BOOST_CHECK_EQUAL(Log::instance().droppedMessages(), 0);
+
+    // less severe messages are dropped if the buffers are full, the number of dropped messages is reported
+    logFromThreads(4, 200, false);
+    Log::instance().flush();
+    Size delivered = 0, dropReports = 0;
+    for (auto const& m : fixture.messages()) {
+        if (m.find("log messages dropped") != string::npos)
+            ++dropReports;
+        else
+            ++delivered;
+    }
+    Size dropped = Log::instance().droppedMessages();
+    BOOST_CHECK_EQUAL(delivered + dropped, 800);
+    BOOST_CHECK_EQUAL(dropReports > 0, dropped > 0);
+
+    // switching off asynchronous logging writes out all messages
+    LOG("last asynchronous message");
+    Log::instance().setAsync(false);
+    BOOST_CHECK(!Log::instance().async());
+    LOG("synchronous message");
+    messages = fixture.messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), 2);
+    BOOST_CHECK(messages[0].find("last asynchronous message") != string::npos);
+    BOOST_CHECK(messages[1].find("synchronous message") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(testLevelFilter) {
+
+    BOOST_TEST_MESSAGE("Testing log level filter in asynchronous mode...");
+
+    BufferLogFixture fixture(ORE_ALERT | ORE_CRITICAL | ORE_ERROR | ORE_WARNING);
+    Log::instance().setAsync(true);
+    WLOG("warning");
+    DLOG("debug");
+    Log::instance().flush();
+    vector<string> messages = fixture.messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), 1);
+    BOOST_CHECK(messages[0].find("WARNING") == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/marketdata/marketcache.hpp>
+#include <ored/marketdata/marketimpl.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace ore::data;
+
+using ore::test::TopLevelFixture;
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MarketCacheTests)
+
+BOOST_AUTO_TEST_CASE(testMarketCache) {
+
+    BOOST_TEST_MESSAGE("Testing market cache...");
+
+    MarketCache cache(2);
+    auto m1 = QuantLib::ext::make_shared<MarketImpl>(false);
+    auto m2 = QuantLib::ext::make_shared<MarketImpl>(false);
+    auto m3 = QuantLib::ext::make_shared<MarketImpl>(false);
+
+    BOOST_CHECK(!cache.get("key1"));
+    cache.add("key1", m1);
+    cache.add("key2", m2);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(cache.get("key1") == m1);
+    BOOST_CHECK(cache.get("key2") == m2);
+
+    // key1 is the least recently used market and is removed
+    cache.add("key3", m3);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(!cache.get("key1"));
+    BOOST_CHECK(cache.get("key2") == m2);
+    BOOST_CHECK(cache.get("key3") == m3);
+
+    // a market with an existing key is replaced
+    cache.add("key2", m1);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(cache.get("key2") == m1);
+
+    BOOST_CHECK_EQUAL(cache.hits(), 5);
+    BOOST_CHECK_EQUAL(cache.misses(), 2);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK_THROW(cache.add("key1", nullptr), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/marketdata/inmemoryloader.hpp>
+#include <ored/marketdata/marketdatumindex.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace ore::data;
+using namespace QuantLib;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+void fillLoader(InMemoryLoader& loader, const Date& asof) {
+    vector<string> pairs = {"EUR/USD", "EUR/GBP", "GBP/USD", "USD/JPY"};
+    vector<string> tenors = {"1M", "2M", "1Y", "10Y"};
+    vector<string> strikes = {"ATM", "25RR", "25BF", "10RR", "10BF"};
+    Real value = 1.0;
+    for (auto const& p : pairs) {
+        loader.add(asof, "FX/RATE/" + p, value);
+        for (auto const& t : tenors)
+            for (auto const& k : strikes)
+                loader.add(asof, "FX_OPTION/RATE_LNVOL/" + p + "/" + t + "/" + k, value += 0.01);
+    }
+}
+
+void checkAgainstScan(const InMemoryLoader& loader, const Date& asof, const Wildcard& w) {
+    auto indexed = loader.get(w, asof);
+    // the base class implementation scans all quotes
+    auto scanned = loader.Loader::get(w, asof);
+    BOOST_CHECK_MESSAGE(indexed == scanned, "indexed lookup for '" << w.pattern() << "' returns " << indexed.size()
+                                                                   << " quotes, scan returns " << scanned.size());
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MarketDatumIndexTests)
+
+BOOST_AUTO_TEST_CASE(testWildcardLookup) {
+
+    BOOST_TEST_MESSAGE("Testing indexed wildcard lookup of market data...");
+
+    Date asof(5, February, 2016);
+    InMemoryLoader loader;
+    fillLoader(loader, asof);
+
+    vector<string> patterns = {"FX_OPTION/RATE_LNVOL/EUR/USD/*",
+                               "FX_OPTION/RATE_LNVOL/EUR/*",
+                               "FX_OPTION/RATE_LNVOL/*/USD/*",
+                               "FX_OPTION/RATE_LNVOL/EUR/USD/*/ATM",
+                               "FX_OPTION/RATE_LNVOL/*/1*/25*",
+                               "*/ATM",
+                               "*USD*",
+                               "FX*",
+                               "FX/RATE/*",
+                               "FX_OPTION/RATE_LNVOL/EUR/USD/1Y/ATM",
+                               "FX_OPTION/RATE_LNVOL/CHF/*",
+                               "*"};
+    for (auto const& p : patterns) {
+        checkAgainstScan(loader, asof, Wildcard(p));
+        checkAgainstScan(loader, asof, Wildcard(p, false));
+        checkAgainstScan(loader, asof, Wildcard(p, true, true));
+    }
+
+    BOOST_CHECK_EQUAL(loader.get(Wildcard("FX_OPTION/RATE_LNVOL/EUR/USD/*"), asof).size(), 20);
+    BOOST_CHECK_EQUAL(loader.get(Wildcard("FX_OPTION/RATE_LNVOL/*/1Y/ATM"), asof).size(), 4);
+    BOOST_CHECK(loader.get(Wildcard("FX_OPTION/RATE_LNVOL/*"), asof + 1).empty());
+
+    // the index is updated when quotes are added after a lookup
+    loader.add(asof, "FX_OPTION/RATE_LNVOL/EUR/CHF/1Y/ATM", 0.1);
+    BOOST_CHECK_EQUAL(loader.get(Wildcard("FX_OPTION/RATE_LNVOL/*/1Y/ATM"), asof).size(), 5);
+    checkAgainstScan(loader, asof, Wildcard("FX_OPTION/RATE_LNVOL/EUR/*"));
+}
+
+BOOST_AUTO_TEST_CASE(testIndexReplacesDuplicateNames) {
+
+    BOOST_TEST_MESSAGE("Testing market datum index with duplicate names...");
+
+    Date asof(5, February, 2016);
+    auto md1 = parseMarketDatum(asof, "FX/RATE/EUR/USD", 1.1);
+    auto md2 = parseMarketDatum(asof, "FX/RATE/EUR/USD", 1.2);
+    MarketDatumIndex index;
+    index.add(md1);
+    index.add(md2);
+    BOOST_CHECK_EQUAL(index.size(), 1);
+    auto result = index.get(Wildcard("FX/RATE/*"));
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK(*result.begin() == md2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
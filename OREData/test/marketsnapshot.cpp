@@ -0,0 +1,236 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/marketdata/inmemoryloader.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
+#include <ored/portfolio/referencedata.hpp>
+#include <ored/utilities/indexparser.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/cashflows/cashflows.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/instruments/makevanillaswap.hpp>
+#include <ql/pricingengines/swap/discountingswapengine.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/termstructures/yield/zerocurve.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
+
+using namespace ore::data;
+using namespace QuantLib;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+
+// a market as TodaysMarket would build it for the parameters below
+class SnapshotTestMarket : public MarketImpl {
+public:
+    SnapshotTestMarket(const Date& asof) : MarketImpl(false) {
+        asof_ = asof;
+        vector<Date> dates = {asof, asof + 1 * Years, asof + 5 * Years, asof + 10 * Years, asof + 30 * Years};
+        vector<Rate> rates = {0.030, 0.030, 0.025, 0.027, 0.020};
+        auto eur = QuantLib::ext::make_shared<ZeroCurve>(dates, rates, Actual365Fixed());
+        eur->enableExtrapolation();
+        auto eur6m = QuantLib::ext::make_shared<FlatForward>(asof, 0.032, Actual365Fixed());
+        auto usd = QuantLib::ext::make_shared<FlatForward>(asof, 0.045, Actual365Fixed());
+        yieldCurves_[make_tuple(Market::defaultConfiguration, YieldCurveType::Discount, "EUR")] =
+            Handle<YieldTermStructure>(eur);
+        yieldCurves_[make_tuple(Market::defaultConfiguration, YieldCurveType::Discount, "USD")] =
+            Handle<YieldTermStructure>(usd);
+        yieldCurves_[make_tuple(Market::defaultConfiguration, YieldCurveType::Yield, "BondCurve")] =
+            Handle<YieldTermStructure>(eur);
+        iborIndices_[make_pair(Market::defaultConfiguration, "EUR-EURIBOR-6M")] =
+            Handle<IborIndex>(parseIborIndex("EUR-EURIBOR-6M", Handle<YieldTermStructure>(eur6m)));
+        fx_ = QuantLib::ext::make_shared<FXTriangulation>(std::map<string, Handle<Quote>>{
+            {"EURUSD", Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(1.08))}});
+    }
+};
+
+QuantLib::ext::shared_ptr<TodaysMarketParameters> snapshotTestParameters() {
+    auto params = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    params->addConfiguration(Market::defaultConfiguration, MarketConfiguration());
+    params->addMarketObject(MarketObject::DiscountCurve, Market::defaultConfiguration,
+                            {{"EUR", "Yield/EUR/EUR-DISC"}, {"USD", "Yield/USD/USD-DISC"}});
+    params->addMarketObject(MarketObject::YieldCurve, Market::defaultConfiguration,
+                            {{"BondCurve", "Yield/EUR/EUR-DISC"}});
+    params->addMarketObject(MarketObject::IndexCurve, Market::defaultConfiguration,
+                            {{"EUR-EURIBOR-6M", "Yield/EUR/EUR-6M"}});
+    params->addMarketObject(MarketObject::FXSpot, Market::defaultConfiguration, {{"EURUSD", "FX/EUR/USD"}});
+    return params;
+}
+
+QuantLib::ext::shared_ptr<InMemoryLoader> snapshotTestLoader(const Date& asof) {
+    auto loader = QuantLib::ext::make_shared<InMemoryLoader>();
+    loader->add(asof, "FX/RATE/EUR/USD", 1.08);
+    loader->add(asof, "MM/RATE/EUR/2D/6M", 0.032);
+    loader->addFixing(Date(31, January, 2024), "EUR-EURIBOR-6M", 0.039);
+    return loader;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MarketSnapshotTests)
+
+BOOST_AUTO_TEST_CASE(testRoundTrip) {
+
+    BOOST_TEST_MESSAGE("Testing market snapshot round trip...");
+
+    Date asof(5, February, 2024);
+    Settings::instance().evaluationDate() = asof;
+
+    auto params = snapshotTestParameters();
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    auto loader = snapshotTestLoader(asof);
+    SnapshotTestMarket market(asof);
+
+    BOOST_REQUIRE(MarketSnapshot::supported(asof, *params));
+    string key = MarketSnapshot::key(asof, params, curveConfigs, *loader);
+    string file = TEST_OUTPUT_FILE("marketsnapshot.bin");
+    MarketSnapshot::write(file, key, asof, market, *params);
+    BOOST_CHECK_EQUAL(MarketSnapshot::fileKey(file), key);
+
+    MarketSnapshot snapshot(file, key, asof, loader);
+
+    // exact on the daily grid, extrapolated beyond 100 years
+    for (Size i = 0; i < 1900; ++i) {
+        Date d = asof + i * 20;
+        Real tol = d <= asof + 100 * Years ? 1E-12 : 1E-4;
+        for (auto const& ccy : {"EUR", "USD"}) {
+            BOOST_CHECK_CLOSE(snapshot.discountCurve(ccy)->discount(d), market.discountCurve(ccy)->discount(d), tol);
+        }
+        BOOST_CHECK_CLOSE(snapshot.yieldCurve("BondCurve")->discount(d), market.yieldCurve("BondCurve")->discount(d),
+                          tol);
+    }
+
+    auto index = snapshot.iborIndex("EUR-EURIBOR-6M");
+    Date fixingDate = index->fixingCalendar().adjust(asof + 1 * Years);
+    BOOST_CHECK_CLOSE(index->fixing(fixingDate), market.iborIndex("EUR-EURIBOR-6M")->fixing(fixingDate), 1E-12);
+    BOOST_CHECK_CLOSE(index->fixing(Date(31, January, 2024)), 0.039, 1E-12);
+
+    BOOST_CHECK_CLOSE(snapshot.fxSpot("EURUSD")->value(), 1.08, 1E-12);
+}
+
+BOOST_AUTO_TEST_CASE(testRepricing) {
+
+    BOOST_TEST_MESSAGE("Testing repricing on a market snapshot against the original market...");
+
+    Date asof(5, February, 2024);
+    Settings::instance().evaluationDate() = asof;
+
+    auto params = snapshotTestParameters();
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    auto loader = snapshotTestLoader(asof);
+    SnapshotTestMarket market(asof);
+
+    string key = MarketSnapshot::key(asof, params, curveConfigs, *loader);
+    string file = TEST_OUTPUT_FILE("marketsnapshot.bin");
+    MarketSnapshot::write(file, key, asof, market, *params);
+    MarketSnapshot snapshot(file, key, asof, loader);
+
+    // forward starting and long dated swaps, forecasting on the index curve and discounting on the EUR curve
+    auto swapNpv = [](const Market& m, const Period& forwardStart, const Period& tenor) {
+        auto index = *m.iborIndex("EUR-EURIBOR-6M");
+        VanillaSwap swap = MakeVanillaSwap(tenor, index, 0.03, forwardStart).withNominal(1.0E8);
+        swap.setPricingEngine(QuantLib::ext::make_shared<DiscountingSwapEngine>(m.discountCurve("EUR")));
+        return swap.NPV();
+    };
+
+    // fixed cashflows on the yield and the USD discount curve
+    auto legNpv = [&asof](const Handle<YieldTermStructure>& curve, const Period& tenor) {
+        Schedule schedule = MakeSchedule().from(asof).to(asof + tenor).withFrequency(Semiannual).withCalendar(TARGET());
+        Leg leg = FixedRateLeg(schedule).withNotionals(1.0E8).withCouponRates(0.04, Actual360());
+        return CashFlows::npv(leg, **curve, false, asof);
+    };
+
+    for (auto const& [forwardStart, tenor] : vector<pair<Period, Period>>{
+             {0 * Days, 5 * Years}, {0 * Days, 30 * Years}, {10 * Years, 40 * Years}, {1 * Years, 80 * Years}}) {
+        BOOST_CHECK_CLOSE(swapNpv(snapshot, forwardStart, tenor), swapNpv(market, forwardStart, tenor), 1E-10);
+        BOOST_CHECK_CLOSE(legNpv(snapshot.yieldCurve("BondCurve"), forwardStart + tenor),
+                          legNpv(market.yieldCurve("BondCurve"), forwardStart + tenor), 1E-10);
+        Real usdSnapshot = legNpv(snapshot.discountCurve("USD"), forwardStart + tenor);
+        Real usdMarket = legNpv(market.discountCurve("USD"), forwardStart + tenor);
+        BOOST_CHECK_CLOSE(usdSnapshot * snapshot.fxSpot("USDEUR")->value(),
+                          usdMarket * market.fxSpot("USDEUR")->value(), 1E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testKey) {
+
+    BOOST_TEST_MESSAGE("Testing market snapshot key...");
+
+    Date asof(5, February, 2024);
+    Settings::instance().evaluationDate() = asof;
+
+    auto params = snapshotTestParameters();
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    auto loader = snapshotTestLoader(asof);
+    string key = MarketSnapshot::key(asof, params, curveConfigs, *loader);
+    BOOST_CHECK_EQUAL(MarketSnapshot::key(asof, params, curveConfigs, *snapshotTestLoader(asof)), key);
+
+    // changed market data
+    auto loader2 = snapshotTestLoader(asof);
+    loader2->add(asof, "MM/RATE/EUR/2D/1Y", 0.033);
+    BOOST_CHECK_NE(MarketSnapshot::key(asof, params, curveConfigs, *loader2), key);
+
+    // changed todays market parameters
+    auto params2 = snapshotTestParameters();
+    params2->addMarketObject(MarketObject::DiscountCurve, Market::defaultConfiguration,
+                             {{"GBP", "Yield/GBP/GBP-DISC"}});
+    BOOST_CHECK_NE(MarketSnapshot::key(asof, params2, curveConfigs, *loader), key);
+
+    // changed reference data
+    auto refData = QuantLib::ext::make_shared<BasicReferenceDataManager>();
+    string refDataKey = MarketSnapshot::key(asof, params, curveConfigs, *loader, refData);
+    BOOST_CHECK_NE(refDataKey, key);
+    refData->add(QuantLib::ext::make_shared<CreditIndexReferenceDatum>("CDX_NA_IG"));
+    BOOST_CHECK_NE(MarketSnapshot::key(asof, params, curveConfigs, *loader, refData), refDataKey);
+
+    // changed ibor fallback config, error handling and lazy build flags
+    IborFallbackConfig noFallbacks(false, false, false, {});
+    BOOST_CHECK_NE(MarketSnapshot::key(asof, params, curveConfigs, *loader, nullptr, noFallbacks), key);
+    BOOST_CHECK_NE(MarketSnapshot::key(asof, params, curveConfigs, *loader, nullptr,
+                                       IborFallbackConfig::defaultConfig(), true),
+                   key);
+    BOOST_CHECK_NE(MarketSnapshot::key(asof, params, curveConfigs, *loader, nullptr,
+                                       IborFallbackConfig::defaultConfig(), false, false),
+                   key);
+
+    // a snapshot is not restored for a different key
+    string file = TEST_OUTPUT_FILE("marketsnapshot.bin");
+    SnapshotTestMarket market(asof);
+    MarketSnapshot::write(file, key, asof, market, *params);
+    BOOST_CHECK_THROW(MarketSnapshot(file, key + "0", asof, loader), QuantLib::Error);
+    BOOST_CHECK_EQUAL(MarketSnapshot::fileKey(TEST_OUTPUT_FILE("nonexistingsnapshot.bin")), "");
+
+    // markets with objects other than yield curves and fx spots are not supported
+    params2->addMarketObject(MarketObject::SwaptionVol, Market::defaultConfiguration,
+                             {{"EUR", "SwaptionVolatility/EUR/EUR_SW_N"}});
+    BOOST_CHECK(!MarketSnapshot::supported(asof, *params2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
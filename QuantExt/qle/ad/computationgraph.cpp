@@ -25,6 +25,9 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#include <algorithm>
+#include <tuple>
+
 namespace QuantExt {
 
 std::size_t ComputationGraph::nan = std::numeric_limits<std::size_t>::max();
@@ -180,6 +183,270 @@ const std::set<std::size_t>& ComputationGraph::redBlockDependencies() const { re
 
 std::size_t ComputationGraph::redBlockId(const std::size_t node) const { return redBlockId_[node]; }
 
+namespace {
+// evaluates an op on constant arguments using the constant folding of the cg_ methods
+std::size_t foldConstants(ComputationGraph& g, const std::size_t opId, const std::vector<std::size_t>& args) {
+    switch (opId) {
+    case RandomVariableOpCode::Add: {
+        double sum = 0.0;
+        for (auto const& a : args)
+            sum += g.constantValue(a);
+        return cg_const(g, sum);
+    }
+    case RandomVariableOpCode::Subtract:
+        return cg_subtract(g, args[0], args[1]);
+    case RandomVariableOpCode::Negative:
+        return cg_negative(g, args[0]);
+    case RandomVariableOpCode::Mult:
+        return cg_mult(g, args[0], args[1]);
+    case RandomVariableOpCode::Div:
+        return cg_div(g, args[0], args[1]);
+    case RandomVariableOpCode::IndicatorEq:
+        return cg_indicatorEq(g, args[0], args[1]);
+    case RandomVariableOpCode::IndicatorGt:
+        return cg_indicatorGt(g, args[0], args[1]);
+    case RandomVariableOpCode::IndicatorGeq:
+        return cg_indicatorGeq(g, args[0], args[1]);
+    case RandomVariableOpCode::Min:
+        return cg_min(g, args[0], args[1]);
+    case RandomVariableOpCode::Max:
+        return cg_max(g, args[0], args[1]);
+    case RandomVariableOpCode::Abs:
+        return cg_abs(g, args[0]);
+    case RandomVariableOpCode::Exp:
+        return cg_exp(g, args[0]);
+    case RandomVariableOpCode::Sqrt:
+        return cg_sqrt(g, args[0]);
+    case RandomVariableOpCode::Log:
+        return cg_log(g, args[0]);
+    case RandomVariableOpCode::Pow:
+        return cg_pow(g, args[0], args[1]);
+    case RandomVariableOpCode::NormalCdf:
+        return cg_normalCdf(g, args[0]);
+    case RandomVariableOpCode::NormalPdf:
+        return cg_normalPdf(g, args[0]);
+    default:
+        return ComputationGraph::nan;
+    }
+}
+
+bool isCommutative(const std::size_t opId) {
+    return opId == RandomVariableOpCode::Add || opId == RandomVariableOpCode::Mult ||
+           opId == RandomVariableOpCode::Min || opId == RandomVariableOpCode::Max ||
+           opId == RandomVariableOpCode::IndicatorEq;
+}
+} // namespace
+
+std::size_t ComputationGraph::simplifiedNode(const std::size_t opId, const std::vector<std::size_t>& args) {
+    auto isConstantValue = [this](const std::size_t n, const double v) {
+        return isConstant_[n] && QuantLib::close_enough(constantValue_[n], v);
+    };
+
+    if (std::all_of(args.begin(), args.end(), [this](std::size_t n) { return isConstant_[n]; })) {
+        if (std::size_t c = foldConstants(*this, opId, args); c != nan)
+            return c;
+    }
+
+    switch (opId) {
+    case RandomVariableOpCode::Add: {
+        std::vector<std::size_t> nonZero;
+        for (auto const& a : args) {
+            if (!isConstantValue(a, 0.0))
+                nonZero.push_back(a);
+        }
+        if (nonZero.empty())
+            return constant(0.0);
+        if (nonZero.size() == 1)
+            return nonZero.front();
+        return nan;
+    }
+    case RandomVariableOpCode::Subtract:
+        if (args[0] == args[1])
+            return constant(0.0);
+        if (isConstantValue(args[1], 0.0))
+            return args[0];
+        return nan;
+    case RandomVariableOpCode::Negative:
+        // -(-x) = x
+        if (opId_[args[0]] == RandomVariableOpCode::Negative)
+            return predecessors_[args[0]][0];
+        return nan;
+    case RandomVariableOpCode::Mult:
+        if (isConstantValue(args[0], 0.0) || isConstantValue(args[1], 0.0))
+            return constant(0.0);
+        if (isConstantValue(args[0], 1.0))
+            return args[1];
+        if (isConstantValue(args[1], 1.0))
+            return args[0];
+        return nan;
+    case RandomVariableOpCode::Div:
+        if (args[0] == args[1])
+            return constant(1.0);
+        if (isConstantValue(args[1], 1.0))
+            return args[0];
+        if (isConstantValue(args[0], 0.0))
+            return constant(0.0);
+        return nan;
+    case RandomVariableOpCode::ConditionalExpectation:
+        // same as in cg_conditionalExpectation()
+        if (isConstant_[args[0]])
+            return args[0];
+        return nan;
+    case RandomVariableOpCode::Min:
+    case RandomVariableOpCode::Max:
+        if (args[0] == args[1])
+            return args[0];
+        return nan;
+    case RandomVariableOpCode::Log:
+        // log(exp(x)) = x
+        if (opId_[args[0]] == RandomVariableOpCode::Exp)
+            return predecessors_[args[0]][0];
+        return nan;
+    default:
+        return nan;
+    }
+}
+
+ComputationGraph::OptimisationResult ComputationGraph::optimise(const std::vector<std::size_t>& outputNodes,
+                                                                const bool cse, const bool simplify) {
+
+    QL_REQUIRE(currentRedBlockId_ == 0, "ComputationGraph::optimise(): can not optimise inside an active red block.");
+
+    OptimisationResult result;
+
+    // we only loop over the original nodes, constants added during the simplification are leaves
+
+    std::size_t originalSize = size();
+    std::vector<std::size_t> replacement(originalSize);
+    std::vector<bool> eliminated(originalSize, false);
+
+    // key = (red block id, op id, args), value = node holding the result
+
+    std::map<std::tuple<std::size_t, std::size_t, std::vector<std::size_t>>, std::size_t> opNodes;
+
+    for (std::size_t node = 0; node < originalSize; ++node) {
+
+        replacement[node] = node;
+
+        if (predecessors_[node].empty())
+            continue;
+
+        ++result.opNodesBefore;
+
+        // rewrite the args to the replacing nodes, these are smaller than node or constants added above
+
+        for (auto& p : predecessors_[node])
+            p = replacement[p];
+
+        if (simplify) {
+            if (std::size_t s = simplifiedNode(opId_[node], predecessors_[node]); s != nan) {
+                replacement[node] = s;
+                eliminated[node] = true;
+                ++result.simplified;
+                continue;
+            }
+        }
+
+        if (cse) {
+            std::vector<std::size_t> key = predecessors_[node];
+            if (isCommutative(opId_[node]))
+                std::sort(key.begin(), key.end());
+            // look for a node in the same red block first, then for a node outside any red block
+            auto n = opNodes.find(std::make_tuple(redBlockId_[node], opId_[node], key));
+            if (n == opNodes.end() && redBlockId_[node] != 0)
+                n = opNodes.find(std::make_tuple(0, opId_[node], key));
+            if (n != opNodes.end()) {
+                replacement[node] = n->second;
+                eliminated[node] = true;
+                ++result.merged;
+                continue;
+            }
+            opNodes[std::make_tuple(redBlockId_[node], opId_[node], key)] = node;
+        }
+    }
+
+    // mark the nodes required to compute the outputs, unless no outputs are given
+
+    std::vector<bool> required(size(), outputNodes.empty());
+    for (auto const& n : outputNodes) {
+        QL_REQUIRE(n < originalSize, "ComputationGraph::optimise(): output node " << n << " out of range, graph has "
+                                                                                  << originalSize << " nodes.");
+        required[replacement[n]] = true;
+    }
+
+    for (std::size_t node = originalSize; node > 0; --node) {
+        if (!required[node - 1] || eliminated[node - 1])
+            continue;
+        for (auto const& p : predecessors_[node - 1])
+            required[p] = true;
+    }
+
+    for (std::size_t node = 0; node < originalSize; ++node) {
+        if (predecessors_[node].empty())
+            continue;
+        if (!eliminated[node] && !required[node]) {
+            eliminated[node] = true;
+            replacement[node] = nan;
+            ++result.pruned;
+        }
+        if (eliminated[node]) {
+            predecessors_[node].clear();
+            opId_[node] = 0;
+        }
+    }
+
+    // a node might have been replaced by a node that was pruned afterwards
+
+    for (std::size_t node = 0; node < originalSize; ++node) {
+        if (replacement[node] != nan && replacement[node] < originalSize && replacement[node] != node &&
+            eliminated[replacement[node]])
+            replacement[node] = nan;
+    }
+
+    for (std::size_t node = originalSize; node < size(); ++node)
+        replacement.push_back(node);
+
+    // update variables and labels
+
+    for (auto v = variables_.begin(); v != variables_.end();) {
+        if (v->second < originalSize && replacement[v->second] == nan) {
+            v = variables_.erase(v);
+        } else {
+            v->second = replacement[v->second];
+            ++v;
+        }
+    }
+
+    for (std::size_t node = 0; node < originalSize; ++node) {
+        if (replacement[node] == node)
+            continue;
+        auto l = labels_.find(node);
+        if (l == labels_.end())
+            continue;
+        if (replacement[node] != nan)
+            labels_[replacement[node]].insert(l->second.begin(), l->second.end());
+        labels_.erase(node);
+    }
+
+    // recompute the max node requiring an arg and the red block dependencies
+
+    std::fill(maxNodeRequiringArg_.begin(), maxNodeRequiringArg_.end(), 0);
+    redBlockDependencies_.clear();
+    for (std::size_t node = 0; node < size(); ++node) {
+        if (predecessors_[node].empty())
+            continue;
+        ++result.opNodesAfter;
+        for (auto const& p : predecessors_[node]) {
+            maxNodeRequiringArg_[p] = std::max(maxNodeRequiringArg_[p], node);
+            if (redBlockId_[node] != 0 && redBlockId_[p] != redBlockId_[node])
+                redBlockDependencies_.insert(p);
+        }
+    }
+
+    result.replacement = std::move(replacement);
+    return result;
+}
+
 bool ComputationGraph::isConstant(const std::size_t node) const { return isConstant_[node]; }
 
 double ComputationGraph::constantValue(const std::size_t node) const { return constantValue_[node]; }
@@ -37,6 +37,17 @@ public:
     enum class VarDoesntExist { Nan, Create, Throw };
     static std::size_t nan;
 
+    /*! result of optimise(), the node counts refer to op nodes, i.e. nodes that are evaluated in a forward run,
+        replacement maps a node to the node holding its value after the optimisation (nan if the node was pruned) */
+    struct OptimisationResult {
+        std::size_t opNodesBefore = 0;
+        std::size_t opNodesAfter = 0;
+        std::size_t merged = 0;
+        std::size_t simplified = 0;
+        std::size_t pruned = 0;
+        std::vector<std::size_t> replacement;
+    };
+
     void clear();
 
     std::size_t size() const;
@@ -66,7 +77,21 @@ public:
     const std::vector<std::pair<std::size_t, std::size_t>>& redBlockRanges() const;
     const std::set<std::size_t>& redBlockDependencies() const;
 
+    /*! Common subexpression elimination (op nodes with the same op and arguments), algebraic simplification (constant
+        folding and identities like x - x = 0, x * 1 = x) and removal of op nodes not required to compute the given
+        output nodes. If no output nodes are given, no nodes are pruned.
+
+        Node indices are kept stable: eliminated nodes become leaves without op and are skipped in forward and backward
+        runs, new constants may be appended. Leaf nodes (constants, variables, random variates, model parameters) are
+        never eliminated. Variables and labels are moved to the replacing node, or removed if the node was pruned.
+        Red block dependencies are updated, a node is only replaced by a node of the same red block or outside any
+        red block. Must not be called inside an active red block. */
+    OptimisationResult optimise(const std::vector<std::size_t>& outputNodes = {}, const bool cse = true,
+                                const bool simplify = true);
+
 private:
+    std::size_t simplifiedNode(const std::size_t opId, const std::vector<std::size_t>& args);
+
     std::vector<std::vector<std::size_t>> predecessors_;
     std::vector<std::size_t> opId_;
     std::vector<bool> isConstant_;
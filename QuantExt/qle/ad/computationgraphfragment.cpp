@@ -0,0 +1,338 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/ad/computationgraphfragment.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/algorithm/string/join.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+namespace QuantExt {
+
+namespace {
+
+// identifies the binary format, the last character is the format version
+const char binaryMagic[8] = {'O', 'R', 'E', 'C', 'G', 'F', 'R', '2'};
+
+template <typename T> void writePod(std::ostream& os, const T& t) {
+    os.write(reinterpret_cast<const char*>(&t), sizeof(T));
+}
+
+template <typename T> void readPod(std::istream& is, T& t) {
+    is.read(reinterpret_cast<char*>(&t), sizeof(T));
+    QL_REQUIRE(is, "ComputationGraphFragment: unexpected end of input");
+}
+
+void writeString(std::ostream& os, const std::string& s) {
+    writePod(os, static_cast<std::uint64_t>(s.size()));
+    os.write(s.data(), s.size());
+}
+
+std::string readString(std::istream& is) {
+    std::uint64_t n;
+    readPod(is, n);
+    std::string s(n, '\0');
+    if (n > 0) {
+        is.read(&s[0], n);
+        QL_REQUIRE(is, "ComputationGraphFragment: unexpected end of input");
+    }
+    return s;
+}
+
+void writeStrings(std::ostream& os, const std::vector<std::string>& s) {
+    writePod(os, static_cast<std::uint64_t>(s.size()));
+    for (auto const& t : s)
+        writeString(os, t);
+}
+
+std::vector<std::string> readStrings(std::istream& is) {
+    std::uint64_t n;
+    readPod(is, n);
+    std::vector<std::string> s;
+    for (std::size_t i = 0; i < n; ++i)
+        s.push_back(readString(is));
+    return s;
+}
+
+} // namespace
+
+ComputationGraphFragment::ComputationGraphFragment(const ComputationGraph& g, const std::size_t begin,
+                                                   const std::size_t end, const std::vector<std::size_t>& outputs,
+                                                   const std::size_t modelSize, const std::string& variablePrefix) {
+    QL_REQUIRE(begin <= end && end <= g.size(), "ComputationGraphFragment: invalid range [" << begin << ", " << end
+                                                                                          << ") for graph of size "
+                                                                                          << g.size());
+    QL_REQUIRE(modelSize <= begin,
+               "ComputationGraphFragment: model size (" << modelSize << ") must not exceed begin (" << begin << ")");
+
+    // names of the nodes that can not be referenced as model nodes
+
+    std::map<std::size_t, std::vector<std::string>> names;
+    for (auto const& [name, node] : g.variables()) {
+        if (node >= modelSize && node < end && name.compare(0, variablePrefix.size(), variablePrefix) == 0)
+            names[node].push_back(name);
+    }
+
+    valid_ = true;
+    nodes_.resize(end - begin);
+    for (std::size_t n = begin; n < end && valid_; ++n) {
+        Node& node = nodes_[n - begin];
+        if (auto v = names.find(n); v != names.end())
+            node.names = v->second;
+        if (g.predecessors(n).empty()) {
+            if (g.isConstant(n)) {
+                node.ref.type = Type::Constant;
+                node.ref.value = g.constantValue(n);
+            } else if (!node.names.empty()) {
+                node.ref.type = Type::Variable;
+                node.ref.names = node.names;
+            } else {
+                valid_ = false;
+            }
+        } else {
+            node.opId = g.opId(n);
+            for (auto const& p : g.predecessors(n))
+                node.predecessors.push_back(ref(g, p, begin, end, modelSize, names));
+        }
+    }
+
+    for (auto const& o : outputs) {
+        QL_REQUIRE(o < end, "ComputationGraphFragment: output node " << o << " is not below end (" << end << ")");
+        outputs_.push_back(ref(g, o, begin, end, modelSize, names));
+    }
+
+    if (!valid_) {
+        nodes_.clear();
+        outputs_.clear();
+    }
+}
+
+ComputationGraphFragment::Ref
+ComputationGraphFragment::ref(const ComputationGraph& g, const std::size_t node, const std::size_t begin,
+                              const std::size_t end, const std::size_t modelSize,
+                              const std::map<std::size_t, std::vector<std::string>>& names) {
+    Ref r;
+    if (g.isConstant(node)) {
+        r.type = Type::Constant;
+        r.value = g.constantValue(node);
+    } else if (node >= begin && node < end) {
+        r.type = Type::Local;
+        r.node = node - begin;
+    } else if (node < modelSize) {
+        r.type = Type::Model;
+        r.node = node;
+    } else if (auto v = names.find(node); v != names.end()) {
+        r.type = Type::Variable;
+        r.names = v->second;
+    } else {
+        // a node added outside the range after the model nodes, e.g. by another trade
+        valid_ = false;
+    }
+    return r;
+}
+
+bool ComputationGraphFragment::canInsert(const ComputationGraph& g,
+                                         const std::function<bool(const std::string&)>& isParameter) const {
+    if (!valid_)
+        return false;
+    auto check = [&g, &isParameter](const Ref& r) {
+        if (r.type == Type::Model)
+            return r.node < g.size();
+        if (r.type == Type::Variable) {
+            return std::any_of(r.names.begin(), r.names.end(), [&g, &isParameter](const std::string& name) {
+                return g.variables().find(name) != g.variables().end() || (isParameter && isParameter(name));
+            });
+        }
+        return true;
+    };
+    for (auto const& n : nodes_) {
+        if (!check(n.ref))
+            return false;
+        for (auto const& p : n.predecessors) {
+            if (!check(p))
+                return false;
+        }
+    }
+    for (auto const& o : outputs_) {
+        if (!check(o))
+            return false;
+    }
+    return true;
+}
+
+std::size_t
+ComputationGraphFragment::resolve(ComputationGraph& g, const Ref& r, const std::vector<std::size_t>& local,
+                                  const std::function<std::size_t(const std::string&)>& createParameter) const {
+    switch (r.type) {
+    case Type::Local:
+        return local.at(r.node);
+    case Type::Model:
+        return r.node;
+    case Type::Constant:
+        return g.constant(r.value);
+    case Type::Variable: {
+        for (auto const& name : r.names) {
+            if (std::size_t n = g.variable(name, ComputationGraph::VarDoesntExist::Nan); n != ComputationGraph::nan)
+                return n;
+        }
+        for (auto const& name : r.names) {
+            if (std::size_t n = createParameter ? createParameter(name) : ComputationGraph::nan;
+                n != ComputationGraph::nan)
+                return n;
+        }
+        QL_FAIL("ComputationGraphFragment: none of the variables "
+                << boost::algorithm::join(r.names, ", ") << " exists or can be created as a parameter");
+    }
+    default:
+        QL_FAIL("ComputationGraphFragment: internal error, reference type " << static_cast<int>(r.type)
+                                                                           << " not covered.");
+    }
+}
+
+std::vector<std::size_t>
+ComputationGraphFragment::insert(ComputationGraph& g,
+                                 const std::function<std::size_t(const std::string&)>& createParameter) const {
+    QL_REQUIRE(valid_, "ComputationGraphFragment::insert(): fragment is not valid");
+    std::vector<std::size_t> local(nodes_.size());
+    for (std::size_t n = 0; n < nodes_.size(); ++n) {
+        if (nodes_[n].predecessors.empty()) {
+            local[n] = resolve(g, nodes_[n].ref, local, createParameter);
+        } else {
+            std::vector<std::size_t> predecessors;
+            for (auto const& p : nodes_[n].predecessors)
+                predecessors.push_back(resolve(g, p, local, createParameter));
+            local[n] = g.insert(predecessors, nodes_[n].opId);
+        }
+        // make the node available to later ranges under its names, as building the range would have done
+        for (auto const& name : nodes_[n].names)
+            g.setVariable(name, local[n]);
+    }
+    std::vector<std::size_t> result;
+    for (auto const& o : outputs_)
+        result.push_back(resolve(g, o, local, createParameter));
+    return result;
+}
+
+void ComputationGraphFragment::write(std::ostream& os) const {
+    QL_REQUIRE(valid_, "ComputationGraphFragment::write(): fragment is not valid");
+    auto writeR = [&os](const Ref& r) {
+        writePod(os, static_cast<std::uint8_t>(r.type));
+        if (r.type == Type::Local || r.type == Type::Model)
+            writePod(os, static_cast<std::uint64_t>(r.node));
+        else if (r.type == Type::Constant)
+            writePod(os, r.value);
+        else
+            writeStrings(os, r.names);
+    };
+    os.write(binaryMagic, sizeof(binaryMagic));
+    writePod(os, static_cast<std::uint64_t>(nodes_.size()));
+    for (auto const& n : nodes_) {
+        writePod(os, static_cast<std::uint64_t>(n.opId));
+        writePod(os, static_cast<std::uint64_t>(n.predecessors.size()));
+        if (n.predecessors.empty())
+            writeR(n.ref);
+        for (auto const& p : n.predecessors)
+            writeR(p);
+        writeStrings(os, n.names);
+    }
+    writePod(os, static_cast<std::uint64_t>(outputs_.size()));
+    for (auto const& o : outputs_)
+        writeR(o);
+    QL_REQUIRE(os, "ComputationGraphFragment::write(): error writing to stream");
+}
+
+void ComputationGraphFragment::read(std::istream& is) {
+    auto readR = [&is]() {
+        Ref r;
+        std::uint8_t type;
+        readPod(is, type);
+        QL_REQUIRE(type <= static_cast<std::uint8_t>(Type::Variable),
+                   "ComputationGraphFragment::read(): invalid reference type " << static_cast<int>(type));
+        r.type = static_cast<Type>(type);
+        if (r.type == Type::Local || r.type == Type::Model) {
+            std::uint64_t node;
+            readPod(is, node);
+            r.node = node;
+        } else if (r.type == Type::Constant) {
+            readPod(is, r.value);
+        } else {
+            r.names = readStrings(is);
+        }
+        return r;
+    };
+
+    valid_ = false;
+    nodes_.clear();
+    outputs_.clear();
+
+    char magic[sizeof(binaryMagic)];
+    is.read(magic, sizeof(magic));
+    QL_REQUIRE(is && std::equal(magic, magic + sizeof(magic), binaryMagic),
+               "ComputationGraphFragment::read(): input is not a computation graph fragment of the supported version");
+
+    std::uint64_t size, opId, nPredecessors;
+    readPod(is, size);
+    nodes_.resize(size);
+    for (std::size_t n = 0; n < size; ++n) {
+        readPod(is, opId);
+        readPod(is, nPredecessors);
+        nodes_[n].opId = opId;
+        if (nPredecessors == 0)
+            nodes_[n].ref = readR();
+        for (std::size_t p = 0; p < nPredecessors; ++p) {
+            nodes_[n].predecessors.push_back(readR());
+            QL_REQUIRE(nodes_[n].predecessors.back().type != Type::Local || nodes_[n].predecessors.back().node < n,
+                       "ComputationGraphFragment::read(): node " << n << " refers to a later node");
+        }
+        nodes_[n].names = readStrings(is);
+    }
+    readPod(is, size);
+    for (std::size_t o = 0; o < size; ++o) {
+        outputs_.push_back(readR());
+        QL_REQUIRE(outputs_.back().type != Type::Local || outputs_.back().node < nodes_.size(),
+                   "ComputationGraphFragment::read(): output refers to node outside fragment");
+    }
+    valid_ = true;
+}
+
+std::size_t computationGraphHash(const ComputationGraph& g, const std::size_t end) {
+    QL_REQUIRE(end <= g.size(), "computationGraphHash(): end (" << end << ") exceeds graph size (" << g.size() << ")");
+    std::size_t seed = 0;
+    boost::hash_combine(seed, end);
+    for (std::size_t n = 0; n < end; ++n) {
+        boost::hash_combine(seed, g.opId(n));
+        boost::hash_combine(seed, g.predecessors(n));
+        boost::hash_combine(seed, g.isConstant(n));
+        if (g.isConstant(n))
+            boost::hash_combine(seed, g.constantValue(n));
+    }
+    for (auto const& [name, node] : g.variables()) {
+        if (node < end) {
+            boost::hash_combine(seed, name);
+            boost::hash_combine(seed, node);
+        }
+    }
+    return seed;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/ad/computationgraphfragment.hpp
+    \brief relocatable range of computation graph nodes with binary serialisation
+*/
+
+#pragma once
+
+#include <qle/ad/computationgraph.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+
+namespace QuantExt {
+
+//! Relocatable range of nodes of a computation graph
+/*! A fragment holds the nodes [begin, end) of a graph, e.g. the nodes added for one trade, and a list of output
+    nodes. References to nodes outside the range are stored symbolically, so that the fragment can be appended to
+    another graph with the same leading nodes:
+
+    - constants by their value
+    - nodes below the model size (the nodes present before the range was built) by their index
+    - other nodes that are bound to a variable (e.g. model parameters or named model quantities added by another
+      range) by the variable names
+
+    Leaves within the range must be constants or bound to a variable, e.g. model parameters added while the range was
+    built. On insertion they are linked to an existing variable of the same name or created by a parameter factory.
+    The variable names bound to nodes within the range are registered in the target graph again, so that later ranges
+    can refer to them.
+
+    Only variables whose name starts with variablePrefix are taken into account, other names (e.g. trade local
+    variables that are overwritten by each range) are ignored. If the range contains other leaves than constants and
+    named variables, or refers to other nodes outside the range, the fragment is not valid. */
+class ComputationGraphFragment {
+public:
+    ComputationGraphFragment() = default;
+    ComputationGraphFragment(const ComputationGraph& g, const std::size_t begin, const std::size_t end,
+                             const std::vector<std::size_t>& outputs, const std::size_t modelSize,
+                             const std::string& variablePrefix = std::string());
+
+    bool valid() const { return valid_; }
+    std::size_t size() const { return nodes_.size(); }
+
+    /*! true if all variables the fragment refers to exist in g or are parameters that isParameter() accepts, and all
+        model nodes are within g */
+    bool canInsert(const ComputationGraph& g,
+                   const std::function<bool(const std::string&)>& isParameter = nullptr) const;
+    /*! appends the nodes to g and returns the nodes of g holding the outputs, missing parameters are added to g by
+        createParameter(), which returns the new variable node */
+    std::vector<std::size_t>
+    insert(ComputationGraph& g, const std::function<std::size_t(const std::string&)>& createParameter = nullptr) const;
+
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
+
+private:
+    enum class Type : std::uint8_t { Local, Model, Constant, Variable };
+    struct Ref {
+        Type type = Type::Local;
+        std::size_t node = 0;
+        double value = 0.0;
+        std::vector<std::string> names;
+    };
+    /* a node is either an op node (opId > 0), or a constant / variable leaf described by ref, the names of an op
+       node are the variables bound to it */
+    struct Node {
+        std::size_t opId = 0;
+        std::vector<Ref> predecessors;
+        Ref ref;
+        std::vector<std::string> names;
+    };
+
+    Ref ref(const ComputationGraph& g, const std::size_t node, const std::size_t begin, const std::size_t end,
+            const std::size_t modelSize, const std::map<std::size_t, std::vector<std::string>>& names);
+    std::size_t resolve(ComputationGraph& g, const Ref& r, const std::vector<std::size_t>& local,
+                        const std::function<std::size_t(const std::string&)>& createParameter) const;
+
+    bool valid_ = false;
+    std::vector<Node> nodes_;
+    std::vector<Ref> outputs_;
+};
+
+//! hash of the structure (ops, predecessors, constants, variables) of the nodes [0, end) of a graph
+std::size_t computationGraphHash(const ComputationGraph& g, const std::size_t end);
+
+} // namespace QuantExt
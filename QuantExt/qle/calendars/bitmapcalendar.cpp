@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ql/errors.hpp>
+#include <qle/calendars/bitmapcalendar.hpp>
+
+#include <algorithm>
+#include <bitset>
+
+using namespace QuantLib;
+
+namespace QuantExt {
+
+namespace {
+constexpr Date::serial_type blockSize = 64;
+inline Date::serial_type popCount(std::uint64_t x) { return static_cast<Date::serial_type>(std::bitset<64>(x).count()); }
+} // namespace
+
+BitmapCalendar::Impl::Impl(const Calendar& calendar, const Date& start, const Date& end)
+    : baseCalendar_(calendar), start_(start), end_(end) {
+    QL_REQUIRE(!calendar.empty(), "BitmapCalendar: no base calendar given");
+    QL_REQUIRE(start <= end, "BitmapCalendar: start date (" << start << ") must not be after end date (" << end << ")");
+    Date::serial_type days = end - start + 1;
+    Size blocks = static_cast<Size>((days + blockSize - 1) / blockSize);
+    bits_.resize(blocks, 0);
+    counts_.resize(blocks + 1, 0);
+    for (Date::serial_type i = 0; i < days; ++i) {
+        if (baseCalendar_.isBusinessDay(start + i))
+            bits_[i / blockSize] |= std::uint64_t(1) << (i % blockSize);
+    }
+    for (Size b = 0; b < blocks; ++b)
+        counts_[b + 1] = counts_[b] + popCount(bits_[b]);
+}
+
+std::string BitmapCalendar::Impl::name() const { return baseCalendar_.name(); }
+
+bool BitmapCalendar::Impl::isWeekend(Weekday w) const { return baseCalendar_.isWeekend(w); }
+
+bool BitmapCalendar::Impl::isBusinessDay(const Date& date) const {
+    if (!inRange(date))
+        return baseCalendar_.isBusinessDay(date);
+    Date::serial_type i = date - start_;
+    return (bits_[i / blockSize] >> (i % blockSize)) & 1;
+}
+
+Date::serial_type BitmapCalendar::Impl::count(const Date& d) const {
+    Date::serial_type i = d - start_;
+    Date::serial_type b = i / blockSize, r = i % blockSize;
+    if (r == 0)
+        return counts_[b];
+    return counts_[b] + popCount(bits_[b] & ((std::uint64_t(1) << r) - 1));
+}
+
+Date BitmapCalendar::Impl::select(Date::serial_type n) const {
+    // the block b with counts_[b] <= n < counts_[b + 1]
+    Size b = static_cast<Size>(std::upper_bound(counts_.begin(), counts_.end(), n) - counts_.begin()) - 1;
+    Date::serial_type remaining = n - counts_[b];
+    std::uint64_t word = bits_[b];
+    for (Date::serial_type r = 0; r < blockSize; ++r) {
+        if ((word >> r) & 1) {
+            if (remaining == 0)
+                return start_ + static_cast<Date::serial_type>(b) * blockSize + r;
+            --remaining;
+        }
+    }
+    QL_FAIL("BitmapCalendar: internal error, business day #" << n << " not found");
+}
+
+BitmapCalendar::BitmapCalendar(const Calendar& calendar, const Date& start, const Date& end) {
+    bitmapImpl_ = QuantLib::ext::make_shared<BitmapCalendar::Impl>(calendar, start, end);
+    impl_ = bitmapImpl_;
+}
+
+Date::serial_type BitmapCalendar::businessDaysBetween(const Date& from, const Date& to, bool includeFirst,
+                                                      bool includeLast) const {
+    if (amended() || !bitmapImpl_->inRange(from) || !bitmapImpl_->inRange(to))
+        return Calendar::businessDaysBetween(from, to, includeFirst, includeLast);
+    if (from == to)
+        return includeFirst && includeLast && isBusinessDay(from) ? 1 : 0;
+    // business days in [min(from, to), max(from, to)], then remove the end points as in Calendar
+    Date lo = std::min(from, to), hi = std::max(from, to);
+    Date::serial_type wd = bitmapImpl_->count(hi + 1) - bitmapImpl_->count(lo);
+    if (isBusinessDay(from) && !includeFirst)
+        wd--;
+    if (isBusinessDay(to) && !includeLast)
+        wd--;
+    return from > to ? -wd : wd;
+}
+
+Date BitmapCalendar::advance(const Date& d, Integer n, TimeUnit unit, BusinessDayConvention convention,
+                             bool endOfMonth) const {
+    if (unit != Days || n == 0 || amended() || !bitmapImpl_->inRange(d))
+        return Calendar::advance(d, n, unit, convention, endOfMonth);
+    // the n-th business day after d resp. the |n|-th business day before d
+    Date::serial_type k = n > 0 ? bitmapImpl_->count(d + 1) + n - 1 : bitmapImpl_->count(d) + n;
+    if (k < 0 || k >= bitmapImpl_->total())
+        return Calendar::advance(d, n, unit, convention, endOfMonth);
+    return bitmapImpl_->select(k);
+}
+
+Date BitmapCalendar::advance(const Date& d, const Period& period, BusinessDayConvention convention,
+                             bool endOfMonth) const {
+    return advance(d, period.length(), period.units(), convention, endOfMonth);
+}
+
+} // namespace QuantExt
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file bitmapcalendar.hpp
+    \brief Calendar with precomputed business days
+*/
+
+#ifndef quantext_bitmap_calendar_h
+#define quantext_bitmap_calendar_h
+
+#include <ql/time/calendar.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace QuantExt {
+
+//! Calendar with precomputed business days
+/*! The business days of the base calendar in the range [start, end] are stored in a bitmap together with the
+    cumulative number of business days per block of 64 days. Within this range isBusinessDay() is a bit lookup,
+    and businessDaysBetween() and advance() by a number of days do not iterate over the single days. Outside the
+    range the base calendar is used.
+
+    The bitmap reflects the holidays of the base calendar at construction, i.e. holidays added to or removed from
+    the base calendar afterwards are not seen. Holidays added to or removed from this calendar are taken into
+    account as for any other calendar.
+
+    \ingroup calendars
+*/
+class BitmapCalendar : public QuantLib::Calendar {
+private:
+    class Impl : public Calendar::Impl {
+    public:
+        Impl(const QuantLib::Calendar& calendar, const QuantLib::Date& start, const QuantLib::Date& end);
+        std::string name() const override;
+        bool isWeekend(QuantLib::Weekday) const override;
+        bool isBusinessDay(const QuantLib::Date&) const override;
+
+        //! true if the date is in the cached range
+        bool inRange(const QuantLib::Date& d) const { return d >= start_ && d <= end_; }
+        //! number of business days in [start, d), d in [start, end + 1]
+        QuantLib::Date::serial_type count(const QuantLib::Date& d) const;
+        //! the business day with the given count, i.e. the n-th business day in [start, end] (0-based)
+        QuantLib::Date select(QuantLib::Date::serial_type n) const;
+        //! total number of business days in [start, end]
+        QuantLib::Date::serial_type total() const { return counts_.back(); }
+
+        QuantLib::Calendar baseCalendar_;
+        QuantLib::Date start_, end_;
+        std::vector<std::uint64_t> bits_;
+        std::vector<QuantLib::Date::serial_type> counts_;
+    };
+
+public:
+    BitmapCalendar(const QuantLib::Calendar& calendar, const QuantLib::Date& start, const QuantLib::Date& end);
+
+    //! \name Calendar interface
+    //@{
+    /*! Same as Calendar::businessDaysBetween(), without iterating over the days if both dates are in the cached
+        range */
+    QuantLib::Date::serial_type businessDaysBetween(const QuantLib::Date& from, const QuantLib::Date& to,
+                                                    bool includeFirst = true, bool includeLast = false) const;
+    /*! Same as Calendar::advance(), without iterating over the days if the unit is Days and the result is in the
+        cached range */
+    QuantLib::Date advance(const QuantLib::Date& d, QuantLib::Integer n, QuantLib::TimeUnit unit,
+                           QuantLib::BusinessDayConvention convention = QuantLib::Following,
+                           bool endOfMonth = false) const;
+    QuantLib::Date advance(const QuantLib::Date& d, const QuantLib::Period& period,
+                           QuantLib::BusinessDayConvention convention = QuantLib::Following,
+                           bool endOfMonth = false) const;
+    //@}
+
+    //! \name Inspectors
+    //@{
+    const QuantLib::Calendar& baseCalendar() const { return bitmapImpl_->baseCalendar_; }
+    const QuantLib::Date& startDate() const { return bitmapImpl_->start_; }
+    const QuantLib::Date& endDate() const { return bitmapImpl_->end_; }
+    //@}
+
+private:
+    //! true if holidays were added to or removed from this calendar
+    bool amended() const { return !addedHolidays().empty() || !removedHolidays().empty(); }
+    QuantLib::ext::shared_ptr<Impl> bitmapImpl_;
+};
+
+} // namespace QuantExt
+
+#endif
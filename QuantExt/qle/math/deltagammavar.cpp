@@ -23,6 +23,7 @@
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 
 namespace QuantExt {
@@ -42,6 +43,79 @@ void check(const Matrix& omega, const Array& delta, const Matrix& gamma) {
                "gamma (" << gamma.rows() << "x" << gamma.columns() << ") must have same dimensions as omega ("
                          << omega.rows() << "x" << omega.columns() << ")");
 }
+
+std::vector<Size> blockSeeds(const Size seed, const Size nBlocks) {
+    MersenneTwisterUniformRng mt(seed);
+    std::vector<Size> seeds(nBlocks);
+    for (auto& s : seeds) {
+        // a zero seed would trigger a random seed in the block generator, so we avoid it
+        s = mt.nextInt32();
+        if (s == 0)
+            s = 1;
+    }
+    return seeds;
+}
+
+void deltaGammaPl(const std::vector<Real>& z, const Size m, const Array& d, const Matrix& b, const bool hasGamma,
+                  std::vector<Real>& pl, std::vector<Real>& work) {
+    const Size n = d.size();
+    pl.resize(m);
+
+    for (Size i = 0; i < m; ++i) {
+        const Real* zi = &z[i * n];
+        Real tmp = 0.0;
+        for (Size k = 0; k < n; ++k)
+            tmp += zi[k] * d[k];
+        pl[i] = tmp;
+    }
+
+    if (!hasGamma)
+        return;
+
+    // work = z * b, looping over tiles of rows of b so that a tile is reused for all paths in the block
+
+    constexpr Size tileSize = 64;
+    work.assign(m * n, 0.0);
+    for (Size kk = 0; kk < n; kk += tileSize) {
+        Size kEnd = std::min(kk + tileSize, n);
+        for (Size i = 0; i < m; ++i) {
+            const Real* zi = &z[i * n];
+            Real* wi = &work[i * n];
+            for (Size k = kk; k < kEnd; ++k) {
+                Real zik = zi[k];
+                if (zik == 0.0)
+                    continue;
+                const Real* bk = b.row_begin(k);
+                for (Size j = 0; j < n; ++j)
+                    wi[j] += zik * bk[j];
+            }
+        }
+    }
+
+    for (Size i = 0; i < m; ++i) {
+        const Real* zi = &z[i * n];
+        const Real* wi = &work[i * n];
+        Real tmp = 0.0;
+        for (Size k = 0; k < n; ++k)
+            tmp += zi[k] * wi[k];
+        pl[i] += 0.5 * tmp;
+    }
+}
+
+void truncateRightTail(std::vector<Real>& v, const Size n) {
+    if (v.size() <= n)
+        return;
+    std::nth_element(v.begin(), v.begin() + n, v.end(), std::greater<Real>());
+    v.resize(n);
+}
+
+Real rightTailQuantile(const std::vector<Real>& tail, const Size paths, const Real p) {
+    Size n = static_cast<Size>(std::ceil(static_cast<double>(paths) * (1.0 - p)));
+    n = std::max<Size>(n, 1);
+    QL_REQUIRE(n <= tail.size(), "rightTailQuantile: tail size (" << tail.size() << ") too small for p = " << p
+                                                                  << " and " << paths << " paths");
+    return tail[n - 1];
+}
 } // namespace detail
 
 namespace {
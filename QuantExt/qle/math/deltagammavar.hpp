@@ -42,6 +42,12 @@
 #include <boost/accumulators/statistics/tail_quantile.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -75,6 +81,25 @@ std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const
 				  const std::vector<Real>& p, const Size paths, const Size seed,
 				  const CovarianceSalvage& sal = NoCovarianceSalvage());
 
+//! function that computes a delta-gamma VaR using Monte Carlo, multi-threaded (multiple quantiles)
+/*! Same as deltaGammaVarMc(), but the paths are processed in blocks of blockSize paths on nThreads worker threads.
+    Each block draws from its own rng stream, the seeds of which are generated from a master generator initialised
+    with the given seed. The result therefore only depends on the seed and the block size, but not on the number of
+    threads. Within a block the PL is computed as  z'L'delta + 1/2 z'(L'Gamma L)z for all paths at once, i.e. the
+    factor transform L is folded into delta and gamma up front and the quadratic form is evaluated via a blocked
+    matrix-matrix product. Notice that for a given seed the results are not identical to those of deltaGammaVarMc(),
+    since the random number sequences differ. */
+template <class RNG>
+std::vector<Real> deltaGammaVarMcMt(const Matrix& omega, const Array& delta, const Matrix& gamma,
+                                    const std::vector<Real>& p, const Size paths, const Size seed, const Size nThreads,
+                                    const CovarianceSalvage& sal = NoCovarianceSalvage(), const Size blockSize = 1024);
+
+//! function that computes a delta-gamma VaR using Monte Carlo, multi-threaded (single quantile)
+template <class RNG>
+Real deltaGammaVarMcMt(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p, const Size paths,
+                       const Size seed, const Size nThreads, const CovarianceSalvage& sal = NoCovarianceSalvage(),
+                       const Size blockSize = 1024);
+
 namespace detail {
 void check(const Real p);
 void check(const Matrix& omega, const Array& delta);
@@ -87,6 +112,17 @@ template <typename A> Real absMax(const A& a) {
     }
     return tmp;
 }
+/* returns the seeds for nBlocks rng streams, generated from a master generator */
+std::vector<Size> blockSeeds(const Size seed, const Size nBlocks);
+/* computes the delta-gamma pl = z'd + 1/2 z'Bz for m paths z given as rows of a m x n row-major array, the work array
+   is used to hold zB and resized as necessary, B is ignored if hasGamma is false */
+void deltaGammaPl(const std::vector<Real>& z, const Size m, const Array& d, const Matrix& b, const bool hasGamma,
+                  std::vector<Real>& pl, std::vector<Real>& work);
+/* keeps the largest n values in v (in no particular order) */
+void truncateRightTail(std::vector<Real>& v, const Size n);
+/* right tail quantile estimate consistent with boost::accumulators::tail_quantile<right>, the tail must contain the
+   largest values of the sample sorted in descending order */
+Real rightTailQuantile(const std::vector<Real>& tail, const Size paths, const Real p);
 } // namespace detail
 
 // implementation
@@ -142,6 +178,101 @@ Real deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamm
     return deltaGammaVarMc<RNG>(omega, delta, gamma, pv, paths, seed, sal).front();
 }
 
+template <class RNG>
+std::vector<Real> deltaGammaVarMcMt(const Matrix& omega, const Array& delta, const Matrix& gamma,
+                                    const std::vector<Real>& p, const Size paths, const Size seed, const Size nThreads,
+                                    const CovarianceSalvage& sal, const Size blockSize) {
+    BOOST_FOREACH (Real q, p) { detail::check(q); }
+    detail::check(omega, delta, gamma);
+    QL_REQUIRE(nThreads > 0, "deltaGammaVarMcMt: nThreads must be positive");
+    QL_REQUIRE(blockSize > 0, "deltaGammaVarMcMt: blockSize must be positive");
+
+    Real num = std::max(detail::absMax(delta), detail::absMax(gamma));
+    if (QuantLib::close_enough(num, 0.0) || paths == 0) {
+        std::vector<Real> res(p.size(), 0.0);
+        return res;
+    }
+
+    Matrix L = sal.salvage(omega).second;
+    if (L.rows() == 0) {
+        L = CholeskyDecomposition(omega, true);
+    }
+
+    // fold the factor transform into delta and gamma, so that pl = z'd + 1/2 z'Bz with z iid standard normal
+
+    Matrix Lt = transpose(L);
+    Array d = Lt * delta;
+    bool hasGamma = !QuantLib::close_enough(detail::absMax(gamma), 0.0);
+    Matrix B = hasGamma ? Matrix(Lt * gamma * L) : Matrix();
+
+    Real pmin = QL_MAX_REAL;
+    BOOST_FOREACH (Real q, p) { pmin = std::min(pmin, q); }
+    Size cache = Size(std::floor(static_cast<double>(paths) * (1.0 - pmin) + 0.5)) + 2;
+
+    Size nBlocks = (paths - 1) / blockSize + 1;
+    std::vector<Size> seeds = detail::blockSeeds(seed, nBlocks);
+    Size effThreads = std::min(nThreads, nBlocks);
+
+    std::vector<std::vector<Real>> tails(effThreads);
+    std::vector<std::exception_ptr> errors(effThreads);
+    std::atomic<Size> nextBlock(0);
+
+    auto worker = [&](const Size thread) {
+        try {
+            std::vector<Real> z, pl, work;
+            std::vector<Real>& tail = tails[thread];
+            for (Size b = nextBlock++; b < nBlocks; b = nextBlock++) {
+                Size m = std::min(blockSize, paths - b * blockSize);
+                typename RNG::rsg_type rng = RNG::make_sequence_generator(d.size(), seeds[b]);
+                z.resize(m * d.size());
+                for (Size i = 0; i < m; ++i) {
+                    const std::vector<Real>& seq = rng.nextSequence().value;
+                    std::copy(seq.begin(), seq.end(), z.begin() + i * d.size());
+                }
+                detail::deltaGammaPl(z, m, d, B, hasGamma, pl, work);
+                tail.insert(tail.end(), pl.begin(), pl.end());
+                if (tail.size() > 2 * cache)
+                    detail::truncateRightTail(tail, cache);
+            }
+        } catch (...) {
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (Size t = 1; t < effThreads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers)
+        w.join();
+
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+
+    // merge the thread tails, the result only depends on the set of pl values, not on their order
+
+    std::vector<Real> tail;
+    for (auto const& t : tails)
+        tail.insert(tail.end(), t.begin(), t.end());
+    detail::truncateRightTail(tail, cache);
+    std::sort(tail.begin(), tail.end(), std::greater<Real>());
+
+    std::vector<Real> res;
+    BOOST_FOREACH (Real q, p) { res.push_back(detail::rightTailQuantile(tail, paths, q)); }
+
+    return res;
+}
+
+template <class RNG>
+Real deltaGammaVarMcMt(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p, const Size paths,
+                       const Size seed, const Size nThreads, const CovarianceSalvage& sal, const Size blockSize) {
+
+    std::vector<Real> pv(1, p);
+    return deltaGammaVarMcMt<RNG>(omega, delta, gamma, pv, paths, seed, nThreads, sal, blockSize).front();
+}
+
 /* delta-gamma VaR using Cornish-Fisher extrapolation (or normal delta-gamma VaR) */
 Real deltaGammaVarCornishFisher(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p,
                                 const CovarianceSalvage& sal = NoCovarianceSalvage());
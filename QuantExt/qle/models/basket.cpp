@@ -295,6 +295,47 @@ Real Basket::expectedTrancheLoss(const Date& d, Real recoveryRate) const {
     return cumulatedLoss() + lossModel_->expectedTrancheLoss(d, recoveryRate);
 }
 
+std::vector<Real> Basket::expectedTrancheLoss(const std::vector<Date>& dates, Real recoveryRate) const {
+    calculate();
+    std::vector<Real> result = lossModel_->expectedTrancheLoss(dates, recoveryRate);
+    QL_REQUIRE(result.size() == dates.size(), "Basket::expectedTrancheLoss(): loss model returned "
+                                                  << result.size() << " values, expected " << dates.size());
+    Real loss = cumulatedLoss();
+    for (auto& r : result)
+        r += loss;
+    return result;
+}
+
+std::vector<std::vector<Real>>
+Basket::expectedTrancheLosses(const std::vector<Date>& dates, const std::vector<std::pair<Real, Real>>& trancheRatios,
+                              Real recoveryRate) const {
+    calculate();
+    // remaining amounts at the evaluation date, as in remainingAttachmentAmount() for the basket tranche
+    Real loss = settledLoss();
+    std::vector<std::pair<Real, Real>> trancheAmounts;
+    for (auto const& [attachRatio, detachRatio] : trancheRatios) {
+        QL_REQUIRE(attachRatio >= 0.0 && attachRatio <= detachRatio && detachRatio <= 1.0,
+                   "Basket::expectedTrancheLosses(): invalid tranche [" << attachRatio << ", " << detachRatio << "]");
+        Real attach = 0.0, detach = 0.0;
+        for (auto const& n : notionals_) {
+            attach += n * attachRatio;
+            detach += n * detachRatio;
+        }
+        trancheAmounts.emplace_back(std::min(detach, attach + std::max(0.0, loss - attach)), detach);
+    }
+    std::vector<std::vector<Real>> result = lossModel_->expectedTrancheLosses(dates, trancheAmounts, recoveryRate);
+    QL_REQUIRE(result.size() == trancheRatios.size(), "Basket::expectedTrancheLosses(): loss model returned "
+                                                          << result.size() << " tranches, expected "
+                                                          << trancheRatios.size());
+    for (auto& r : result) {
+        QL_REQUIRE(r.size() == dates.size(), "Basket::expectedTrancheLosses(): loss model returned "
+                                                 << r.size() << " values, expected " << dates.size());
+        for (auto& v : r)
+            v += loss;
+    }
+    return result;
+}
+
 std::vector<Real> Basket::splitVaRLevel(const Date& date, Real loss) const {
     calculate();
     return lossModel_->splitVaRLevel(date, loss);
@@ -228,6 +228,15 @@ public:
     */
     //@{
     Real expectedTrancheLoss(const Date& d, Real recoveryRate = Null<Real>()) const;
+    //! Expected tranche loss at each of the given dates, computed by the loss model in one call
+    std::vector<Real> expectedTrancheLoss(const std::vector<Date>& dates, Real recoveryRate = Null<Real>()) const;
+    /*! Expected tranche losses of several tranches on this basket at each of the given dates, computed by the
+        loss model in one pass. The tranches are given by their attachment and detachment ratios, the result is
+        indexed by tranche and date.
+    */
+    std::vector<std::vector<Real>> expectedTrancheLosses(const std::vector<Date>& dates,
+                                                         const std::vector<std::pair<Real, Real>>& trancheRatios,
+                                                         Real recoveryRate = Null<Real>()) const;
     /*! The lossFraction is the fraction of losses expressed in
         inception (no losses) tranche units (e.g. 'attach level'=0%,
         'detach level'=100%)
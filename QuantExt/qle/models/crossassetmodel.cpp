@@ -27,6 +27,8 @@
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 #include <ql/processes/eulerdiscretization.hpp>
 
+#include <algorithm>
+
 using namespace QuantExt::CrossAssetAnalytics;
 using std::map;
 using std::vector;
@@ -164,6 +166,7 @@ Size CrossAssetModel::crName(const std::string& name) const {
 void CrossAssetModel::update() {
     cache_crlgm1fS_.clear();
     cache_infdkI_.clear();
+    integralCache_.reset();
     for (Size i = 0; i < p_.size(); ++i) {
         p_[i]->update();
     }
@@ -865,21 +868,27 @@ void CrossAssetModel::calibrateCrLgm1fReversionsIterative(
     update();
 }
 
-std::pair<Real, Real> CrossAssetModel::infdkV(const Size i, const Time t, const Time T) {
+std::pair<Real, Real> CrossAssetModel::infdkV(const Size i, const Time t, const Time T) const {
     Size ccy = ccyIndex(infdk(i)->currency());
     cache_key k = {i, ccy, t, T};
-    boost::unordered_map<cache_key, std::pair<Real, Real>>::const_iterator it = cache_infdkI_.find(k);
-    Real V0, V_tilde;
-
-    if (it == cache_infdkI_.end()) {
-        V0 = infV(i, ccy, 0, t);
-        V_tilde = infV(i, ccy, t, T) - infV(i, ccy, 0, T) + infV(i, ccy, 0, t);
-        cache_infdkI_.insert(std::make_pair(k, std::make_pair(V0, V_tilde)));
-    } else {
+    if (integralCache_) {
+        // read-only lookup in the precomputed table
+        auto it = integralCache_->infdkV.find(k);
+        return it != integralCache_->infdkV.end() ? it->second : infdkVImpl(i, ccy, t, T);
+    }
+    auto it = cache_infdkI_.find(k);
+    if (it != cache_infdkI_.end()) {
         // take V0 and V_tilde from cache
-        V0 = it->second.first;
-        V_tilde = it->second.second;
+        return it->second;
     }
+    std::pair<Real, Real> V = infdkVImpl(i, ccy, t, T);
+    cache_infdkI_.insert(std::make_pair(k, V));
+    return V;
+}
+
+std::pair<Real, Real> CrossAssetModel::infdkVImpl(const Size i, const Size ccy, const Time t, const Time T) const {
+    Real V0 = infV(i, ccy, 0, t);
+    Real V_tilde = infV(i, ccy, t, T) - infV(i, ccy, 0, T) + infV(i, ccy, 0, t);
     return std::make_pair(V0, V_tilde);
 }
 
@@ -932,38 +941,12 @@ std::pair<Real, Real> CrossAssetModel::crlgm1fS(const Size i, const Size ccy, co
     QL_REQUIRE(t < T || close_enough(t, T), "crlgm1fS: t (" << t << ") <= T (" << T << ") required");
     QL_REQUIRE(modelType(CrossAssetModel::AssetType::CR, i) == CrossAssetModel::ModelType::LGM1F,
                "model at " << i << " is not CR-LGM1F");
-    cache_key k = {i, ccy, t, T};
-    boost::unordered_map<cache_key, std::pair<Real, Real>>::const_iterator it = cache_crlgm1fS_.find(k);
-    Real V0, V_tilde;
+    std::pair<Real, Real> Vs = crlgm1fV(i, ccy, t, T);
+    Real V0 = Vs.first;
+    Real V_tilde = Vs.second;
     Real Hlt = Hl(i).eval(*this, t);
     Real HlT = Hl(i).eval(*this, T);
 
-    if (it == cache_crlgm1fS_.end()) {
-        // compute V0 and V_tilde
-        if (ccy == 0) {
-            // domestic credit
-            Real Hzt = Hz(0).eval(*this, t);
-            Real HzT = Hz(0).eval(*this, T);
-            Real zetal0 = zetal(i).eval(*this, t);
-            Real zetal1 = integral(*this, P(Hl(i), al(i), al(i)), 0.0, t);
-            Real zetal2 = integral(*this, P(Hl(i), Hl(i), al(i), al(i)), 0.0, t);
-            Real zetanl0 = integral(*this, P(rzl(0, i), az(0), al(i)), 0.0, t);
-            Real zetanl1 = integral(*this, P(rzl(0, i), Hl(i), az(0), al(i)), 0.0, t);
-            // opposite signs for last two terms in the book
-            V0 = 0.5 * Hlt * Hlt * zetal0 - Hlt * zetal1 + 0.5 * zetal2 + Hzt * Hlt * zetanl0 - Hzt * zetanl1;
-            V_tilde = -0.5 * (HlT * HlT - Hlt * Hlt) * zetal0 + (HlT - Hlt) * zetal1 -
-                      (HzT * HlT - Hzt * Hlt) * zetanl0 + (HzT - Hzt) * zetanl1;
-        } else {
-            // foreign credit
-            V0 = crV(i, ccy, 0, t);
-            V_tilde = crV(i, ccy, t, T) - crV(i, ccy, 0, T) + crV(i, ccy, 0, t);
-        }
-        cache_crlgm1fS_.insert(std::make_pair(k, std::make_pair(V0, V_tilde)));
-    } else {
-        // take V0 and V_tilde from cache
-        V0 = it->second.first;
-        V_tilde = it->second.second;
-    }
     // compute final results depending on z and y
     // opposite sign for V0 in the book
     Real St = crlgm1f(i)->termStructure()->survivalProbability(t) * std::exp(-Hlt * z + y - V0);
@@ -972,6 +955,85 @@ std::pair<Real, Real> CrossAssetModel::crlgm1fS(const Size i, const Size ccy, co
     return std::make_pair(St, Stilde_t_T);
 }
 
+std::pair<Real, Real> CrossAssetModel::crlgm1fV(const Size i, const Size ccy, const Time t, const Time T) const {
+    cache_key k = {i, ccy, t, T};
+    if (integralCache_) {
+        // read-only lookup in the precomputed table
+        auto it = integralCache_->crlgm1fV.find(k);
+        return it != integralCache_->crlgm1fV.end() ? it->second : crlgm1fVImpl(i, ccy, t, T);
+    }
+    auto it = cache_crlgm1fS_.find(k);
+    if (it != cache_crlgm1fS_.end()) {
+        // take V0 and V_tilde from cache
+        return it->second;
+    }
+    std::pair<Real, Real> V = crlgm1fVImpl(i, ccy, t, T);
+    cache_crlgm1fS_.insert(std::make_pair(k, V));
+    return V;
+}
+
+std::pair<Real, Real> CrossAssetModel::crlgm1fVImpl(const Size i, const Size ccy, const Time t, const Time T) const {
+    Real V0, V_tilde;
+    // compute V0 and V_tilde
+    if (ccy == 0) {
+        // domestic credit
+        Real Hlt = Hl(i).eval(*this, t);
+        Real HlT = Hl(i).eval(*this, T);
+        Real Hzt = Hz(0).eval(*this, t);
+        Real HzT = Hz(0).eval(*this, T);
+        Real zetal0 = zetal(i).eval(*this, t);
+        Real zetal1 = integral(*this, P(Hl(i), al(i), al(i)), 0.0, t);
+        Real zetal2 = integral(*this, P(Hl(i), Hl(i), al(i), al(i)), 0.0, t);
+        Real zetanl0 = integral(*this, P(rzl(0, i), az(0), al(i)), 0.0, t);
+        Real zetanl1 = integral(*this, P(rzl(0, i), Hl(i), az(0), al(i)), 0.0, t);
+        // opposite signs for last two terms in the book
+        V0 = 0.5 * Hlt * Hlt * zetal0 - Hlt * zetal1 + 0.5 * zetal2 + Hzt * Hlt * zetanl0 - Hzt * zetanl1;
+        V_tilde = -0.5 * (HlT * HlT - Hlt * Hlt) * zetal0 + (HlT - Hlt) * zetal1 - (HzT * HlT - Hzt * Hlt) * zetanl0 +
+                  (HzT - Hzt) * zetanl1;
+    } else {
+        // foreign credit
+        V0 = crV(i, ccy, 0, t);
+        V_tilde = crV(i, ccy, t, T) - crV(i, ccy, 0, T) + crV(i, ccy, 0, t);
+    }
+    return std::make_pair(V0, V_tilde);
+}
+
+QuantLib::ext::shared_ptr<const CrossAssetModel::IntegralCache>
+CrossAssetModel::warmUpCaches(const std::vector<Time>& times) const {
+    std::vector<Time> t(times);
+    t.push_back(0.0);
+    std::sort(t.begin(), t.end());
+    // remove exact duplicates only, the lookups are by exact times
+    t.erase(std::unique(t.begin(), t.end()), t.end());
+    auto cache = QuantLib::ext::make_shared<IntegralCache>();
+    for (Size i = 0; i < components(CrossAssetModel::AssetType::INF); ++i) {
+        if (modelType(CrossAssetModel::AssetType::INF, i) != CrossAssetModel::ModelType::DK)
+            continue;
+        Size ccy = ccyIndex(infdk(i)->currency());
+        for (Size j = 0; j < t.size(); ++j)
+            for (Size k = j; k < t.size(); ++k)
+                cache->infdkV[cache_key{i, ccy, t[j], t[k]}] = infdkVImpl(i, ccy, t[j], t[k]);
+    }
+    for (Size i = 0; i < components(CrossAssetModel::AssetType::CR); ++i) {
+        if (modelType(CrossAssetModel::AssetType::CR, i) != CrossAssetModel::ModelType::LGM1F)
+            continue;
+        Size ccy = ccyIndex(crlgm1f(i)->currency());
+        for (Size j = 0; j < t.size(); ++j)
+            for (Size k = j; k < t.size(); ++k)
+                cache->crlgm1fV[cache_key{i, ccy, t[j], t[k]}] = crlgm1fVImpl(i, ccy, t[j], t[k]);
+    }
+    setIntegralCache(cache);
+    return cache;
+}
+
+void CrossAssetModel::setIntegralCache(const QuantLib::ext::shared_ptr<const IntegralCache>& cache) const {
+    integralCache_ = cache;
+}
+
+const QuantLib::ext::shared_ptr<const CrossAssetModel::IntegralCache>& CrossAssetModel::integralCache() const {
+    return integralCache_;
+}
+
 std::pair<Real, Real> CrossAssetModel::crcirppS(const Size i, const Time t, const Time T, const Real y,
                                                 const Real s) const {
     QL_REQUIRE(modelType(CrossAssetModel::AssetType::CR, i) == CrossAssetModel::ModelType::CIRPP,
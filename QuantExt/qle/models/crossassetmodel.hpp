@@ -273,7 +273,7 @@ public:
     const QuantLib::ext::shared_ptr<Integrator> integrator() const;
 
     /*! return (V(t), V^tilde(t,T)) in the notation of the book */
-    std::pair<Real, Real> infdkV(const Size i, const Time t, const Time T);
+    std::pair<Real, Real> infdkV(const Size i, const Time t, const Time T) const;
 
     /*! return (I(t), I^tilde(t,T)) in the notation of the book, note that
         I(0) is normalized to 1 here, i.e. you have to multiply the result
@@ -288,6 +288,44 @@ public:
     std::pair<Real, Real> crlgm1fS(const Size i, const Size ccy, const Time t, const Time T, const Real z,
                                    const Real y) const;
 
+    /*! returns (V0(t), V^tilde(t,T)) entering crlgm1fS() */
+    std::pair<Real, Real> crlgm1fV(const Size i, const Size ccy, const Time t, const Time T) const;
+
+    // key and hasher for the caches of infdkV(), crlgm1fV()
+    struct cache_key {
+        Size i, ccy;
+        double t, T;
+        bool operator==(const cache_key& o) const { return (i == o.i) && (ccy == o.ccy) && (t == o.t) && (T == o.T); }
+    };
+
+    struct cache_hasher {
+        std::size_t operator()(cache_key const& x) const {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, x.i);
+            boost::hash_combine(seed, x.ccy);
+            boost::hash_combine(seed, x.t);
+            boost::hash_combine(seed, x.T);
+            return seed;
+        }
+    };
+
+    //! immutable table of the results of infdkV() and crlgm1fV() on a fixed set of times, see warmUpCaches()
+    struct IntegralCache {
+        boost::unordered_map<cache_key, std::pair<Real, Real>, cache_hasher> infdkV, crlgm1fV;
+    };
+
+    /*! Builds the table of infdkV() and crlgm1fV() for all inflation DK and credit LGM components (the latter in
+        their own currency) and all pairs t <= T from the given times, e.g. a simulation grid, and installs it
+        via setIntegralCache(). */
+    QuantLib::ext::shared_ptr<const IntegralCache> warmUpCaches(const std::vector<Time>& times) const;
+
+    /*! While a table is installed, infdkV() and crlgm1fV() look up their results in it without taking any lock and
+        compute pairs (t, T) not in the table without caching them, so that the model can be shared read-only
+        between threads. Without a table the results are cached lazily, which is not thread safe. The table is
+        removed by update(). */
+    void setIntegralCache(const QuantLib::ext::shared_ptr<const IntegralCache>& cache) const;
+    const QuantLib::ext::shared_ptr<const IntegralCache>& integralCache() const;
+
     /*! returns (S(t), S^tilde(t,T)) in the notation of the book */
     std::pair<Real, Real> crcirppS(const Size i, const Time t, const Time T, const Real y, const Real s) const;
 
@@ -455,26 +493,12 @@ protected:
     /* helper function for infdkI, crlgm1fS */
     Real infV(const Size idx, const Size ccy, const Time t, const Time T) const;
     Real crV(const Size idx, const Size ccy, const Time t, const Time T) const;
+    std::pair<Real, Real> infdkVImpl(const Size i, const Size ccy, const Time t, const Time T) const;
+    std::pair<Real, Real> crlgm1fVImpl(const Size i, const Size ccy, const Time t, const Time T) const;
 
     // cache for infdkI, crlgm1fS method
-    struct cache_key {
-        Size i, ccy;
-        double t, T;
-        bool operator==(const cache_key& o) const { return (i == o.i) && (ccy == o.ccy) && (t == o.t) && (T == o.T); }
-    };
-
-    struct cache_hasher {
-        std::size_t operator()(cache_key const& x) const {
-            std::size_t seed = 0;
-            boost::hash_combine(seed, x.i);
-            boost::hash_combine(seed, x.ccy);
-            boost::hash_combine(seed, x.t);
-            boost::hash_combine(seed, x.T);
-            return seed;
-        }
-    };
-
     mutable boost::unordered_map<cache_key, std::pair<Real, Real>, cache_hasher> cache_crlgm1fS_, cache_infdkI_;
+    mutable QuantLib::ext::shared_ptr<const IntegralCache> integralCache_;
 
     /* members */
 
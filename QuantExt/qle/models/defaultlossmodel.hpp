@@ -71,6 +71,25 @@ protected:
     virtual Real expectedTrancheLoss(const Date& d, Real recoveryRate = Null<Real>()) const {
         QL_FAIL("expectedTrancheLoss Not implemented for this model.");
     }
+    /*! Expected tranche loss of the basket tranche at each of the given dates. The default implementation calls
+        expectedTrancheLoss(Date) date by date, models should override it if the dates can share calculations. */
+    virtual std::vector<Real> expectedTrancheLoss(const std::vector<Date>& dates,
+                                                  Real recoveryRate = Null<Real>()) const {
+        std::vector<Real> result;
+        result.reserve(dates.size());
+        for (auto const& d : dates)
+            result.push_back(expectedTrancheLoss(d, recoveryRate));
+        return result;
+    }
+    /*! Expected tranche losses of several tranches on the (remaining) basket at each of the given dates in one
+        pass. The tranches are given by their remaining attachment and detachment amounts, the result is indexed
+        by tranche and date.
+    */
+    virtual std::vector<std::vector<Real>>
+    expectedTrancheLosses(const std::vector<Date>& dates, const std::vector<std::pair<Real, Real>>& trancheAmounts,
+                          Real recoveryRate = Null<Real>()) const {
+        QL_FAIL("expectedTrancheLosses Not implemented for this model.");
+    }
     /*! Probability of the tranche losing the same or more than the
         fractional amount given.
 
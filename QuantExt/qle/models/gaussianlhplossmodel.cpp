@@ -77,19 +77,62 @@ Real GaussianLHPLossModel::expectedTrancheLossImpl(Real remainingNot, // << at t
     if (remainingNot == 0.)
         return 0.;
 
+    if (prob > 0)
+        return expectedTrancheLossInvProb(remainingNot, InverseCumulativeNormal::standard_value(prob), averageRR,
+                                          attachLimit, detachLimit);
+    else
+        return 0.0;
+}
+
+Real GaussianLHPLossModel::expectedTrancheLossInvProb(Real remainingNot, Real ip, Real averageRR, Real attachLimit,
+                                                      Real detachLimit) const {
     const Real one = 1.0 - 1.0e-12; // FIXME DUE TO THE INV CUMUL AT 1
     const Real k1 = std::min(one, attachLimit / (1.0 - averageRR)) + QL_EPSILON;
     const Real k2 = std::min(one, detachLimit / (1.0 - averageRR)) + QL_EPSILON;
 
-    if (prob > 0) {
-        const Real ip = InverseCumulativeNormal::standard_value(prob);
-        const Real invFlightK1 = (ip - sqrt1minuscorrel_ * InverseCumulativeNormal::standard_value(k1)) / beta_;
-        const Real invFlightK2 = (ip - sqrt1minuscorrel_ * InverseCumulativeNormal::standard_value(k2)) / beta_;
+    const Real invFlightK1 = (ip - sqrt1minuscorrel_ * InverseCumulativeNormal::standard_value(k1)) / beta_;
+    const Real invFlightK2 = (ip - sqrt1minuscorrel_ * InverseCumulativeNormal::standard_value(k2)) / beta_;
 
-        return remainingNot * (detachLimit * phi_(invFlightK2) - attachLimit * phi_(invFlightK1) +
-                               (1. - averageRR) * (biphi_(ip, -invFlightK2) - biphi_(ip, -invFlightK1)));
-    } else
-        return 0.0;
+    return remainingNot * (detachLimit * phi_(invFlightK2) - attachLimit * phi_(invFlightK1) +
+                           (1. - averageRR) * (biphi_(ip, -invFlightK2) - biphi_(ip, -invFlightK1)));
+}
+
+std::vector<std::vector<Real>>
+GaussianLHPLossModel::expectedTrancheLosses(const std::vector<Date>& dates,
+                                            const std::vector<std::pair<Real, Real>>& trancheAmounts,
+                                            Real recoveryRate) const {
+    std::vector<std::vector<Real>> result(trancheAmounts.size(), std::vector<Real>(dates.size(), 0.0));
+    for (Size j = 0; j < dates.size(); ++j) {
+        const Real remainingNot = basket_->remainingNotional(dates[j]);
+        if (remainingNot == 0.)
+            continue;
+
+        // same as averageProb() and averageRecovery(), but reading the basket probabilities only once
+        const std::vector<Probability> probs = basket_->remainingProbabilities(dates[j]);
+        const std::vector<Real> notionals = basket_->remainingNotionals(dates[j]);
+        const Real expectedDefaultNotional = std::inner_product(probs.begin(), probs.end(), notionals.begin(), 0.);
+        const Probability prob = expectedDefaultNotional / remainingNot;
+        if (prob <= 0.)
+            continue;
+        Real averageRR = recoveryRate;
+        if (averageRR == Null<Real>()) {
+            averageRR = 0.0;
+            if (expectedDefaultNotional != 0.) {
+                for (Size k = 0; k < notionals.size(); ++k)
+                    averageRR += rrQuotes_[k]->value() * (notionals[k] * probs[k]);
+                averageRR /= expectedDefaultNotional;
+            }
+        }
+
+        const Real ip = InverseCumulativeNormal::standard_value(prob);
+        for (Size i = 0; i < trancheAmounts.size(); ++i) {
+            const Real attach = trancheAmounts[i].first / remainingNot;
+            const Real detach = trancheAmounts[i].second / remainingNot;
+            if (attach < detach)
+                result[i][j] = expectedTrancheLossInvProb(remainingNot, ip, averageRR, attach, detach);
+        }
+    }
+    return result;
 }
 
 Real GaussianLHPLossModel::probOverLoss(const Date& d, Real remainingLossFraction) const {
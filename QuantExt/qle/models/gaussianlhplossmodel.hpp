@@ -88,6 +88,9 @@ private:
                                  Real prob,         // << at the given date 'd'
                                  Real averageRR,    // << at the given date 'd'
                                  Real attachLimit, Real detachLimit) const;
+    //! as above, with the inverse cumulative normal of the default probability given
+    Real expectedTrancheLossInvProb(Real remainingNot, Real ip, Real averageRR, Real attachLimit,
+                                    Real detachLimit) const;
 
 public:
     // RL: additional flag
@@ -109,6 +112,19 @@ public:
         return expectedTrancheLossImpl(remainingfullNot, prob, averageRR, attach, detach);
     }
 
+    std::vector<Real> expectedTrancheLoss(const std::vector<Date>& dates,
+                                          Real recoveryRate = Null<Real>()) const override {
+        return expectedTrancheLosses(
+            dates, {{basket_->remainingAttachmentAmount(), basket_->remainingDetachmentAmount()}}, recoveryRate)[0];
+    }
+
+    /*! The remaining notional, average default probability and average recovery are computed once per date and
+        shared by all tranches.
+    */
+    std::vector<std::vector<Real>> expectedTrancheLosses(const std::vector<Date>& dates,
+                                                         const std::vector<std::pair<Real, Real>>& trancheAmounts,
+                                                         Real recoveryRate = Null<Real>()) const override;
+
     /*! The passed remainingLossFraction is in live tranche units,
         not portfolio as a fraction of the remaining(live) tranche
         (i.e. a_remaining=0% and det_remaining=100%)
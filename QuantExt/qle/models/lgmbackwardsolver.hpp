@@ -46,6 +46,18 @@ public:
     virtual RandomVariable rollback(const RandomVariable& v, const Real t1, const Real t0,
                                     Size steps = Null<Size>()) const = 0;
 
+    /* roll back several deflated NPV arrays from t1 to t0 in one go, solvers can override this to share the work
+       that only depends on t1, t0 and the grid between the arrays, the default implementation rolls back each
+       array separately */
+    virtual std::vector<RandomVariable> rollback(const std::vector<RandomVariable>& v, const Real t1, const Real t0,
+                                                 Size steps = Null<Size>()) const {
+        std::vector<RandomVariable> result;
+        result.reserve(v.size());
+        for (auto const& w : v)
+            result.push_back(rollback(w, t1, t0, steps));
+        return result;
+    }
+
     /* the underlying model */
     virtual const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model() const = 0;
 };
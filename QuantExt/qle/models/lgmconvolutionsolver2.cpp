@@ -20,6 +20,8 @@
 
 #include <ql/math/distributions/normaldistribution.hpp>
 
+#include <algorithm>
+
 namespace QuantExt {
 
 LgmConvolutionSolver2::LgmConvolutionSolver2(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
@@ -68,49 +70,100 @@ RandomVariable LgmConvolutionSolver2::stateGrid(const Real t) const {
     return x;
 }
 
-RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Real t1, const Real t0, Size) const {
-    if (QuantLib::close_enough(t0, t1) || v.deterministic())
-        return v;
-    QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+LgmConvolutionSolver2::Stencil LgmConvolutionSolver2::buildStencil(const Real t1, const Real t0) const {
+    Stencil s;
     Real sigma = std::sqrt(model_->parametrization()->zeta(t1));
     Real dx = sigma / static_cast<Real>(nx_);
+    Size ny = 2 * my_ + 1;
     if (QuantLib::close_enough(t0, 0.0)) {
         // rollback from t1 to t0 = 0
-        Real value = 0.0;
+        s.rows = 1;
+        s.kk.resize(ny);
+        s.alpha.resize(ny);
+        s.beta.resize(ny);
         for (int i = 0; i <= 2 * my_; i++) {
             // Map y index to x index, not integer in general
             Real kp = y_[i] * sigma / dx + mx_;
             // Adjacent integer x index <= k
             int kk = int(floor(kp));
-            // Get value at kp by linear interpolation on
-            // kk <= kp <= kk + 1 with flat extrapolation
-            value +=
-                w_[i] *
-                (kk < 0 ? v[0] : (kk + 1 > 2 * mx_ ? v[2 * mx_] : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk]));
+            s.kk[i] = kk;
+            s.alpha[i] = kp - kk;
+            s.beta[i] = 1.0 + kk - kp;
         }
-        return RandomVariable(2 * mx_ + 1, value);
     } else {
-        RandomVariable value(2 * mx_ + 1, 0.0);
-        value.expand();
         // rollback from t1 to t0 > 0
+        s.rows = 2 * mx_ + 1;
+        s.kk.resize(s.rows * ny);
+        s.alpha.resize(s.rows * ny);
+        s.beta.resize(s.rows * ny);
         Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
         Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
         for (int k = 0; k <= 2 * mx_; k++) {
             for (int i = 0; i <= 2 * my_; i++) {
-                // Map y index to x index, not integer in generalTo
+                // Map y index to x index, not integer in general
                 Real kp = (dx2 * (k - mx_) + y_[i] * std) / dx + mx_;
                 // Adjacent integer x index <= k
                 int kk = int(floor(kp));
-                // Get value at kp by linear interpolation on
-                // kk <= kp <= kk + 1 with flat extrapolation
-                value.set(k, value[k] + w_[i] * (kk < 0 ? v[0]
-                                                        : (kk + 1 > 2 * mx_
-                                                               ? v[2 * mx_]
-                                                               : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk])));
+                Size idx = k * ny + i;
+                s.kk[idx] = kk;
+                s.alpha[idx] = kp - kk;
+                s.beta[idx] = 1.0 + kk - kp;
             }
         }
-        return value;
     }
+    return s;
+}
+
+void LgmConvolutionSolver2::applyStencil(const Stencil& s, const RandomVariable& v, RandomVariable& result) const {
+    Size ny = 2 * my_ + 1;
+    int mx2 = 2 * mx_;
+    for (Size k = 0; k < s.rows; ++k) {
+        Real value = 0.0;
+        for (Size i = 0; i < ny; ++i) {
+            Size idx = k * ny + i;
+            int kk = s.kk[idx];
+            // Get value at kp by linear interpolation on
+            // kk <= kp <= kk + 1 with flat extrapolation
+            value += w_[i] * (kk < 0 ? v[0]
+                                     : (kk + 1 > mx2 ? v[mx2] : s.alpha[idx] * v[kk + 1] + s.beta[idx] * v[kk]));
+        }
+        if (s.rows == 1)
+            result = RandomVariable(2 * mx_ + 1, value);
+        else
+            result.set(k, value);
+    }
+}
+
+RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Real t1, const Real t0, Size) const {
+    if (QuantLib::close_enough(t0, t1) || v.deterministic())
+        return v;
+    QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+    RandomVariable value(2 * mx_ + 1, 0.0);
+    value.expand();
+    applyStencil(buildStencil(t1, t0), v, value);
+    return value;
+}
+
+std::vector<RandomVariable> LgmConvolutionSolver2::rollback(const std::vector<RandomVariable>& v, const Real t1,
+                                                            const Real t0, Size) const {
+    if (QuantLib::close_enough(t0, t1) ||
+        std::all_of(v.begin(), v.end(), [](const RandomVariable& r) { return r.deterministic(); }))
+        return v;
+    QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+    Stencil s = buildStencil(t1, t0);
+    std::vector<RandomVariable> result;
+    result.reserve(v.size());
+    for (auto const& r : v) {
+        if (r.deterministic()) {
+            result.push_back(r);
+        } else {
+            RandomVariable value(2 * mx_ + 1, 0.0);
+            value.expand();
+            applyStencil(s, r, value);
+            result.push_back(std::move(value));
+        }
+    }
+    return result;
 }
 
 } // namespace QuantExt
@@ -43,9 +43,26 @@ public:
     // steps are always ignored, since we can take large steps
     RandomVariable rollback(const RandomVariable& v, const Real t1, const Real t0,
                             Size steps = Null<Size>()) const override;
+    /* the interpolation stencil of the convolution step is computed once and applied to all arrays, so rolling back
+       several arrays costs little more than rolling back a single one */
+    std::vector<RandomVariable> rollback(const std::vector<RandomVariable>& v, const Real t1, const Real t0,
+                                         Size steps = Null<Size>()) const override;
     const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model() const override { return model_; }
 
 private:
+    /* Interpolation stencil for the rollback from t1 to t0: for each target grid point (a single one if t0 = 0) and
+       each convolution weight w_i the adjacent lower source grid index kk and the interpolation weights
+       alpha = kp - kk, beta = 1 + kk - kp for the source grid points kk + 1 and kk. */
+    struct Stencil {
+        Size rows = 0;
+        std::vector<int> kk;
+        std::vector<Real> alpha, beta;
+    };
+    /* the stencil is built per rollback call and not kept as a member, so that the solver can be shared between
+       engines and threads */
+    Stencil buildStencil(const Real t1, const Real t0) const;
+    void applyStencil(const Stencil& s, const RandomVariable& v, RandomVariable& result) const;
+
     QuantLib::ext::shared_ptr<LinearGaussMarkovModel> model_;
     int mx_, my_, nx_;
     Real h_;
@@ -38,6 +38,7 @@ public:
     LgmFdSolver(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real maxTime = 50.0,
                 const QuantLib::FdmSchemeDesc scheme = QuantLib::FdmSchemeDesc::Douglas(),
                 const Size stateGridPoints = 64, const Size timeStepsPerYear = 24, const Real mesherEpsilon = 1E-4);
+    using LgmBackwardSolver::rollback;
     Size gridSize() const override;
     RandomVariable stateGrid(const Real t) const override;
     // if steps are not given, the time steps per year specified in the constructor
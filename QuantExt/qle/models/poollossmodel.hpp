@@ -24,14 +24,21 @@
 #include <qle/models/extendedconstantlosslatentmodel.hpp>
 #include <qle/models/defaultlossmodel.hpp>
 #include <qle/models/hullwhitebucketing.hpp>
+#include <atomic>
+#include <exception>
 #include <functional>
 #include <iostream>
+#include <thread>
 
 // clang-format off
 namespace QuantExt {
 
 /*! Default loss distribution convolution for finite homogeneous or non-homogeneous pool
 
+    The batched expected tranche losses compute one loss distribution per date, shared by all tranches, and
+    distribute the dates over nThreads threads. The default probabilities are read from the basket before the
+    threads are started.
+
     \todo Extend to the multifactor case for a generic LM
 */
 template <class CopulaPolicy>
@@ -46,10 +53,19 @@ public:
         QuantLib::Real min = -5.0,
         QuantLib::Size nSteps = 50,
         bool useQuadrature = false,
-        bool useStochasticRecovery = false);
+        bool useStochasticRecovery = false,
+        QuantLib::Size nThreads = 1);
 
     QuantLib::Real expectedTrancheLoss(const QuantLib::Date& d, Real recoveryRate = Null<Real>()) const override;
 
+    std::vector<QuantLib::Real> expectedTrancheLoss(const std::vector<QuantLib::Date>& dates,
+                                                    Real recoveryRate = Null<Real>()) const override;
+
+    std::vector<std::vector<QuantLib::Real>>
+    expectedTrancheLosses(const std::vector<QuantLib::Date>& dates,
+                          const std::vector<std::pair<QuantLib::Real, QuantLib::Real>>& trancheAmounts,
+                          Real recoveryRate = Null<Real>()) const override;
+
     QuantLib::Real percentile(const QuantLib::Date& d, QuantLib::Real percentile) const override;
 
     QuantLib::Real expectedShortfall(const QuantLib::Date& d, QuantLib::Probability percentile) const override;
@@ -67,6 +83,7 @@ private:
     QuantLib::Size nSteps_;
     bool useQuadrature_;
     bool useStochasticRecovery_;
+    QuantLib::Size nThreads_;
 
     QuantLib::Real delta_;
     mutable QuantLib::Real attach_;
@@ -78,9 +95,7 @@ private:
 
     // deterministic LGD vector by entity
     mutable std::vector<QuantLib::Real> lgd_;
-    // marginal probabilities, by entity and recovery rate, second dimension size 1 when deterministic
-    mutable std::vector<std::vector<QuantLib::Real>> q_;
-    // Copula model thresholds, with same dimension as q_
+    // Copula model thresholds, by entity and recovery rate, second dimension size 1 when deterministic
     mutable std::vector<std::vector<QuantLib::Real>> c_;
     // LGD by entity and (stochastic) recovery rate dimension 
     mutable std::vector<std::vector<QuantLib::Real>> lgdVV_;
@@ -88,12 +103,23 @@ private:
     mutable std::vector<std::vector<QuantLib::Real>> cprVV_;
     
     QuantLib::Distribution lossDistrib(const QuantLib::Date& d, Real recoveryRate = Null<Real>()) const;
-    // update lgdVV_
+    /* Loss distribution on [0, maximum] for the given marginal default probabilities of the remaining entities,
+       requires updateLGDs(). Only c and cprVV are written to, so that it can be called from several threads. */
+    QuantLib::Distribution lossDistrib(const std::vector<QuantLib::Real>& prob, QuantLib::Real maximum,
+                                       Real recoveryRate, std::vector<std::vector<QuantLib::Real>>& c,
+                                       std::vector<std::vector<QuantLib::Real>>& cprVV) const;
+    // expected loss of the tranche [attachAmount, detachAmount] under the given loss distribution
+    QuantLib::Real trancheLoss(QuantLib::Distribution& dist, QuantLib::Real attachAmount,
+                               QuantLib::Real detachAmount) const;
+    // update lgd_ and lgdVV_
     void updateLGDs(Real recoveryRate = Null<Real>()) const;
-    // update q_and c_
-    void updateThresholds(QuantLib::Date d, Real recoveryRate = Null<Real>()) const;
-    // update cprVV_
-    std::vector<Real> updateCPRs(std::vector<QuantLib::Real> factor, Real recoveryRate = Null<Real>()) const;
+    // update the thresholds c
+    void updateThresholds(const std::vector<QuantLib::Real>& prob, Real recoveryRate,
+                          std::vector<std::vector<QuantLib::Real>>& c) const;
+    // update the conditional probabilities cprVV
+    std::vector<Real> updateCPRs(std::vector<QuantLib::Real> factor, Real recoveryRate,
+                                 const std::vector<std::vector<QuantLib::Real>>& c,
+                                 std::vector<std::vector<QuantLib::Real>>& cprVV) const;
 
     void resetModel() override;
 
@@ -144,7 +170,8 @@ PoolLossModel<CopulaPolicy>::PoolLossModel(
     QuantLib::Real min,
     QuantLib::Size nSteps,
     bool useQuadrature,
-    bool useStochasticRecovery)
+    bool useStochasticRecovery,
+    QuantLib::Size nThreads)
     : homogeneous_(homogeneous),
       copula_(copula),
       nBuckets_(nBuckets),
@@ -153,6 +180,7 @@ PoolLossModel<CopulaPolicy>::PoolLossModel(
       nSteps_(nSteps),
       useQuadrature_(useQuadrature),
       useStochasticRecovery_(useStochasticRecovery),
+      nThreads_(nThreads),
       delta_((max - min) / nSteps),
       attach_(0.0),
       detach_(0.0),
@@ -161,27 +189,103 @@ PoolLossModel<CopulaPolicy>::PoolLossModel(
       detachAmount_(0.0) {
 
     QL_REQUIRE(copula->numFactors() == 1, "Multifactor PoolLossModel not yet implemented.");
+    QL_REQUIRE(nThreads > 0, "PoolLossModel: nThreads must be positive");
 }
 
 template <class CopulaPolicy>
 QuantLib::Real PoolLossModel<CopulaPolicy>::expectedTrancheLoss(const QuantLib::Date& d, Real recoveryRate) const {
-
     QuantLib::Distribution dist = lossDistrib(d, recoveryRate);
+    return trancheLoss(dist, attachAmount_, detachAmount_);
+}
+
+template <class CopulaPolicy>
+std::vector<QuantLib::Real> PoolLossModel<CopulaPolicy>::expectedTrancheLoss(const std::vector<QuantLib::Date>& dates,
+                                                                             Real recoveryRate) const {
+    // the distributions are built on [0, detachAmount_] as in the single date case
+    return expectedTrancheLosses(dates, {{attachAmount_, detachAmount_}}, recoveryRate)[0];
+}
+
+template <class CopulaPolicy>
+std::vector<std::vector<QuantLib::Real>> PoolLossModel<CopulaPolicy>::expectedTrancheLosses(
+    const std::vector<QuantLib::Date>& dates,
+    const std::vector<std::pair<QuantLib::Real, QuantLib::Real>>& trancheAmounts, Real recoveryRate) const {
+
+    std::vector<std::vector<QuantLib::Real>> result(trancheAmounts.size(),
+                                                    std::vector<QuantLib::Real>(dates.size(), 0.0));
+    if (trancheAmounts.empty() || dates.empty())
+        return result;
+
+    // one distribution per date covering all tranches
+    QuantLib::Real maximum = 0.0;
+    for (auto const& t : trancheAmounts)
+        maximum = std::max(maximum, t.second);
+
+    // the basket (and its default curves) is only used here, not on the worker threads
+    updateLGDs(recoveryRate);
+    std::vector<std::vector<QuantLib::Real>> prob(dates.size());
+    for (QuantLib::Size j = 0; j < dates.size(); ++j)
+        prob[j] = basket_->remainingProbabilities(dates[j]);
+
+    auto compute = [this, &prob, &trancheAmounts, &result, maximum, recoveryRate](
+                       QuantLib::Size j, std::vector<std::vector<QuantLib::Real>>& c,
+                       std::vector<std::vector<QuantLib::Real>>& cprVV) {
+        QuantLib::Distribution dist = lossDistrib(prob[j], maximum, recoveryRate, c, cprVV);
+        for (QuantLib::Size i = 0; i < trancheAmounts.size(); ++i)
+            result[i][j] = trancheLoss(dist, trancheAmounts[i].first, trancheAmounts[i].second);
+    };
+
+    QuantLib::Size nThreads = std::min(nThreads_, dates.size());
+    if (nThreads == 1) {
+        for (QuantLib::Size j = 0; j < dates.size(); ++j)
+            compute(j, c_, cprVV_);
+        return result;
+    }
+
+    std::atomic<QuantLib::Size> nextDate(0);
+    std::vector<std::exception_ptr> errors(nThreads);
+    auto worker = [&compute, &nextDate, &errors, &dates](const QuantLib::Size thread) {
+        std::vector<std::vector<QuantLib::Real>> c, cprVV;
+        try {
+            for (QuantLib::Size j = nextDate++; j < dates.size(); j = nextDate++)
+                compute(j, c, cprVV);
+        } catch (...) {
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (QuantLib::Size t = 1; t < nThreads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers)
+        w.join();
+
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+
+    return result;
+}
+
+template <class CopulaPolicy>
+QuantLib::Real PoolLossModel<CopulaPolicy>::trancheLoss(QuantLib::Distribution& dist, QuantLib::Real attachAmount,
+                                                        QuantLib::Real detachAmount) const {
 
     // RL: dist.trancheExpectedValue() using x = dist.average(i)
-    // FIXME: some remaining inaccuracy in dist.cumulativeDensity(detachAmount_)
+    // FIXME: some remaining inaccuracy in dist.cumulativeDensity(detachAmount)
     QuantLib::Real expectedLoss = 0;
     dist.normalize();
     for (QuantLib::Size i = 0; i < dist.size(); i++) {
         // Real x = dist.x(i) + dist.dx(i)/2; // in QL distribution.cpp
         QuantLib::Real x = dist.average(i);
-        if (x < attachAmount_)
+        if (x < attachAmount)
             continue;
-        if (x > detachAmount_)
+        if (x > detachAmount)
             break;
-        expectedLoss += (x - attachAmount_) * dist.dx(i) * dist.density(i);
+        expectedLoss += (x - attachAmount) * dist.dx(i) * dist.density(i);
     }
-    expectedLoss += (detachAmount_ - attachAmount_) * (1.0 - dist.cumulativeDensity(detachAmount_));
+    expectedLoss += (detachAmount - attachAmount) * (1.0 - dist.cumulativeDensity(detachAmount));
 
     return expectedLoss;
 }
@@ -293,14 +397,14 @@ void PoolLossModel<CopulaPolicy>::updateLGDs(Real recoveryRate) const {
 }
 
 template <class CopulaPolicy>
-void PoolLossModel<CopulaPolicy>::updateThresholds(QuantLib::Date d, Real recoveryRate) const {
-    // Initialize probability of default function Q and thresholds C according to spec
-
-    // Marginal probabilities of default for each remaining entity in basket
-    std::vector<QuantLib::Real> prob = basket_->remainingProbabilities(d);
+void PoolLossModel<CopulaPolicy>::updateThresholds(const std::vector<QuantLib::Real>& prob, Real recoveryRate,
+                                                   std::vector<std::vector<QuantLib::Real>>& c) const {
+    // Initialize probability of default function Q and thresholds C according to spec, given the marginal
+    // probabilities of default for each remaining entity in basket
 
-    q_.resize(notionals_.size());
-    c_.resize(notionals_.size());
+    // marginal probabilities, by entity and recovery rate, same dimension as c
+    std::vector<std::vector<QuantLib::Real>> q(notionals_.size());
+    c.resize(notionals_.size());
 
     if (useStochasticRecovery_ && recoveryRate == Null<Real>()) {
         Real tiny = 1.0e-10;
@@ -308,24 +412,24 @@ void PoolLossModel<CopulaPolicy>::updateThresholds(QuantLib::Date d, Real recove
             QL_REQUIRE(copula_->recoveryProbabilities().size() == notionals_.size(),
                        "number of rec rate probability vectors does not match number of notionals"); 
             std::vector<Real> rrProbs = copula_->recoveryProbabilities()[i];
-            q_[i] = std::vector<Real>(rrProbs.size() + 1, prob[i]);
-            c_[i] = std::vector<Real>(rrProbs.size() + 1, copula_->inverseCumulativeY(q_[i][0], i));
+            q[i] = std::vector<Real>(rrProbs.size() + 1, prob[i]);
+            c[i] = std::vector<Real>(rrProbs.size() + 1, copula_->inverseCumulativeY(q[i][0], i));
             Real sum = 0.0;
             for (Size j = 0; j < rrProbs.size(); ++j) {
                 sum += rrProbs[j];
-                q_[i][j+1] = q_[i][0] * (1.0 - sum);
-                if (QuantLib::close_enough(q_[i][j+1], 0.0))
-                    c_[i][j+1] = QL_MIN_REAL;
+                q[i][j+1] = q[i][0] * (1.0 - sum);
+                if (QuantLib::close_enough(q[i][j+1], 0.0))
+                    c[i][j+1] = QL_MIN_REAL;
                 else
-                    c_[i][j+1] = copula_->inverseCumulativeY(q_[i][j+1], i); 
+                    c[i][j+1] = copula_->inverseCumulativeY(q[i][j+1], i); 
             }
-            QL_REQUIRE(fabs(q_[i].back()) < tiny, "expected zero qij, but found " << q_[i].back() << " for i=" << i); 
+            QL_REQUIRE(fabs(q[i].back()) < tiny, "expected zero qij, but found " << q[i].back() << " for i=" << i); 
         }
     }
     else {
         for (QuantLib::Size i = 0; i < prob.size(); i++) {
-            q_[i] = std::vector<Real>(1, prob[i]);
-            c_[i] = std::vector<Real>(1, copula_->inverseCumulativeY(prob[i], i));
+            q[i] = std::vector<Real>(1, prob[i]);
+            c[i] = std::vector<Real>(1, copula_->inverseCumulativeY(prob[i], i));
         }
     }
 }
@@ -354,36 +458,38 @@ std::vector<std::vector<Real>> PoolLossModel<CopulaPolicy>::marginalProbabilitie
 }
 
 template <class CopulaPolicy>
-std::vector<Real> PoolLossModel<CopulaPolicy>::updateCPRs(std::vector<QuantLib::Real> factor, Real recoveryRate) const {
-    cprVV_.clear();
+std::vector<Real> PoolLossModel<CopulaPolicy>::updateCPRs(std::vector<QuantLib::Real> factor, Real recoveryRate,
+                                                          const std::vector<std::vector<QuantLib::Real>>& c,
+                                                          std::vector<std::vector<QuantLib::Real>>& cprVV) const {
+    cprVV.clear();
 
     Real tiny = 1.0e-10;
     if (useStochasticRecovery_ && recoveryRate == Null<Real>()) {
-        cprVV_.resize(notionals_.size(), std::vector<Real>());
-        for (Size i = 0; i < c_.size(); ++i) {
-            cprVV_[i].resize(c_[i].size() - 1, 0.0);
-            Real pd = copula_->conditionalDefaultProbabilityInvP(c_[i][0], i, factor);
+        cprVV.resize(notionals_.size(), std::vector<Real>());
+        for (Size i = 0; i < c.size(); ++i) {
+            cprVV[i].resize(c[i].size() - 1, 0.0);
+            Real pd = copula_->conditionalDefaultProbabilityInvP(c[i][0], i, factor);
             Real sum = 0.0;
-            for (Size j = 1; j < c_[i].size(); ++j) {
+            for (Size j = 1; j < c[i].size(); ++j) {
                 // probability of recovery j conditional on default of i
-                cprVV_[i][j-1] = copula_->conditionalDefaultProbabilityInvP(c_[i][j-1], i, factor)
-                    - copula_->conditionalDefaultProbabilityInvP(c_[i][j], i, factor);
-                sum += cprVV_[i][j-1];
+                cprVV[i][j-1] = copula_->conditionalDefaultProbabilityInvP(c[i][j-1], i, factor)
+                    - copula_->conditionalDefaultProbabilityInvP(c[i][j], i, factor);
+                sum += cprVV[i][j-1];
             }
             QL_REQUIRE(fabs(sum - pd) < tiny, "probability check failed for factor0 " << factor[0]);
         }
     }
     else {
-        cprVV_.resize(notionals_.size(), std::vector<Real>(1, 0));
-        for (Size i = 0; i < c_.size(); ++i) {
-            cprVV_[i][0] = copula_->conditionalDefaultProbabilityInvP(c_[i][0], i, factor);
+        cprVV.resize(notionals_.size(), std::vector<Real>(1, 0));
+        for (Size i = 0; i < c.size(); ++i) {
+            cprVV[i][0] = copula_->conditionalDefaultProbabilityInvP(c[i][0], i, factor);
         }
     }
     
     // Vector of default probabilities conditional on the common market factor M: P(\tau_i < t | M = m).
     std::vector<Real> probs;
-    for (Size i = 0; i < c_.size(); i++)
-        probs.push_back(copula_->conditionalDefaultProbabilityInvP(c_[i][0], i, factor));
+    for (Size i = 0; i < c.size(); i++)
+        probs.push_back(copula_->conditionalDefaultProbabilityInvP(c[i][0], i, factor));
 
     return probs;
 }
@@ -403,16 +509,25 @@ void PoolLossModel<CopulaPolicy>::resetModel() {
 template <class CopulaPolicy>
 QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::Date& d, Real recoveryRate) const {
 
+    // Update the LGD vector, could be moved to resetModel() if we can disregard the zeroRecovery flag
+    updateLGDs(recoveryRate);
+
+    // Marginal probabilities for each remaining entity in basket, P(\tau_i < t).
+    return lossDistrib(basket_->remainingProbabilities(d), detachAmount_, recoveryRate, c_, cprVV_);
+}
+
+template <class CopulaPolicy>
+QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const std::vector<QuantLib::Real>& prob,
+                                                                QuantLib::Real maximum, Real recoveryRate,
+                                                                std::vector<std::vector<QuantLib::Real>>& c,
+                                                                std::vector<std::vector<QuantLib::Real>>& cprVV) const {
+
     bool check = false;
     
-    Real maximum = detachAmount_; 
     Real minimum = 0.0;
     
-    // Update the LGD vector, could be moved to resetModel() if we can disregard the zeroRecovery flag
-    updateLGDs(recoveryRate);
-
-    // Update probabilities qij and thresholds cij, needs to stay here because date dependent
-    updateThresholds(d, recoveryRate);
+    // Update thresholds cij, needs to stay here because date dependent
+    updateThresholds(prob, recoveryRate, c);
 
     // Init bucketing class
     HullWhiteBucketing hwb(minimum, maximum, nBuckets_);
@@ -437,8 +552,6 @@ QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::
         // FIXME: Ensure quadrature works with stochastic recovery
 
         QuantLib::GaussHermiteIntegration Integrator(nSteps_);
-        // Marginal probabilities for each remaining entity in basket, P(\tau_i < t).
-        std::vector<QuantLib::Real> prob = basket_->remainingProbabilities(d);
         LossModelConditionalDist<CopulaPolicy> lmcd(copula_, bucketing, prob, lgd_);
 
         for (QuantLib::Size j = 0; j < nBuckets_; j++) {
@@ -458,7 +571,7 @@ QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::
 
         for (QuantLib::Size k = 0; k < nSteps_; k++) {
             
-            std::vector<Real> cpr = updateCPRs(factor, recoveryRate);
+            std::vector<Real> cpr = updateCPRs(factor, recoveryRate, c, cprVV);
 
             // Loss distribution up to date d conditional on common factor M = m.
             Distribution conditionalDist;
@@ -469,7 +582,7 @@ QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::
                 // recovery, homogeneous pool), but this can cause small regression errors (using bucketing
                 // instead of homogeneoius pool algorithm) and calculation time increase (QuantLib::LossDist's
                 // bucketing is faster).
-                hwb.computeMultiState(cprVV_.begin(), cprVV_.end(), lgdVV_.begin());                
+                hwb.computeMultiState(cprVV.begin(), cprVV.end(), lgdVV_.begin());                
             }
             else if (homogeneous_) {
                 // Original QuantLib::LossDist (homogeneous), works with deterministic recovery only.
@@ -528,8 +641,8 @@ QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::
         // This checks the consistency between the Distribution object and the "raw" p and A vectors
         // by way of expectedTrancheLoss calculations.
         // Can be deactivated because of its performance impact.
-        Real etl1 = expectedTrancheLoss1(d, dist);
-        Real etl2 = expectedTrancheLoss2(d, p, A);
+        Real etl1 = expectedTrancheLoss1(Date(), dist);
+        Real etl2 = expectedTrancheLoss2(Date(), p, A);
         Real tiny = 1e-3;
         QL_REQUIRE(fabs((etl1 - etl2)/etl2) < tiny, "expected tranche loss failed, " << etl1 << " vs " << etl2);
     }
@@ -30,20 +30,25 @@
 namespace QuantExt {
 
 void sanitiseTransitionMatrix(Matrix& m) {
-    for (Size i = 0; i < m.rows(); ++i) {
-        Real sum = 0.0;
-        for (Size j = 0; j < m.columns(); ++j) {
-            m[i][j] = std::max(std::min(m[i][j], 1.0), 0.0);
-            if (i != j)
-                sum += m[i][j];
-        }
-        if (sum <= 1.0) {
-            m(i, i) = 1.0 - sum;
-        } else {
-            sum += m[i][i];
-            for (Size j = 0; j < m.columns(); ++j) {
-                m[i][j] = m[i][j] / sum;
-            }
+    for (Size i = 0; i < m.rows(); ++i)
+        sanitiseTransitionMatrixRow(m.row_begin(i), m.row_end(i), i);
+}
+
+void sanitiseTransitionMatrixRow(Real* begin, Real* end, const Size i) {
+    Size n = end - begin;
+    QL_REQUIRE(i < n, "sanitiseTransitionMatrixRow(): state " << i << " out of range, row has " << n << " entries");
+    Real sum = 0.0;
+    for (Size j = 0; j < n; ++j) {
+        begin[j] = std::max(std::min(begin[j], 1.0), 0.0);
+        if (i != j)
+            sum += begin[j];
+    }
+    if (sum <= 1.0) {
+        begin[i] = 1.0 - sum;
+    } else {
+        sum += begin[i];
+        for (Size j = 0; j < n; ++j) {
+            begin[j] = begin[j] / sum;
         }
     }
 }
@@ -32,6 +32,10 @@ using namespace QuantLib;
   the row elements by the row sum */
 void sanitiseTransitionMatrix(Matrix& m);
 
+/*! sanitise the transition probabilities [begin, end) from state i, i.e. row i of a transition matrix, as in
+  sanitiseTransitionMatrix() */
+void sanitiseTransitionMatrixRow(Real* begin, Real* end, const Size i);
+
 //! check if the matrix is a transition matrix, i.e. row sums are 1 and entries are non-negative
 void checkTransitionMatrix(const Matrix& t);
 
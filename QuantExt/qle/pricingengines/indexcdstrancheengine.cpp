@@ -87,18 +87,32 @@ void IndexCdsTrancheEngine::calculate() const {
     results_.protectionValue = 0.0;
     Real inceptionTrancheNotional = arguments_.basket->trancheNotional();
 
+    // Expected losses on the tranche up to the end of all remaining coupon periods, in one call to the loss model.
+    vector<QuantLib::ext::shared_ptr<Coupon>> coupons(arguments_.normalizedLeg.size());
+    vector<Date> endDates;
+    for (Size i = 0; i < arguments_.normalizedLeg.size(); i++) {
+        if (arguments_.normalizedLeg[i]->hasOccurred(today))
+            continue;
+        coupons[i] = QuantLib::ext::dynamic_pointer_cast<Coupon>(arguments_.normalizedLeg[i]);
+        QL_REQUIRE(coupons[i], "IndexCdsTrancheEngine expects leg to have Coupon cashflow type.");
+        endDates.push_back(coupons[i]->accrualEndDate());
+    }
+    vector<Real> endDateEtls;
+    if (!endDates.empty())
+        endDateEtls = basket->expectedTrancheLoss(endDates, arguments_.recoveryRate);
+    Size nextEtl = 0;
+
     // Value the premium and protection leg.
     for (Size i = 0; i < arguments_.normalizedLeg.size(); i++) {
 
         // Zero expected loss on coupon end dates that have already occured.
         // FD TODO: check again when testing tranches with existing losses.
-        if (arguments_.normalizedLeg[i]->hasOccurred(today)) {
+        if (!coupons[i]) {
             etls.push_back(0.0);
             continue;
         }
 
-        QuantLib::ext::shared_ptr<Coupon> coupon = QuantLib::ext::dynamic_pointer_cast<Coupon>(arguments_.normalizedLeg[i]);
-        QL_REQUIRE(coupon, "IndexCdsTrancheEngine expects leg to have Coupon cashflow type.");
+        const QuantLib::ext::shared_ptr<Coupon>& coupon = coupons[i];
 
         // Relevant dates with assumption that future defaults occur at midpoint of (remaining) coupon period.
         Date paymentDate = coupon->date();
@@ -107,7 +121,7 @@ void IndexCdsTrancheEngine::calculate() const {
         Date defaultDate = startDate + (endDate - startDate) / 2;
 
         // Expected loss on the tranche up to the end of the current period.
-        Real etl = basket->expectedTrancheLoss(endDate, arguments_.recoveryRate);
+        Real etl = endDateEtls[nextEtl++];
 
         // Update protection leg value
         results_.protectionValue += discountCurve_->discount(defaultDate) * (etl - etls.back());
@@ -27,6 +27,7 @@
 #include <qle/math/randomvariablelsmbasissystem.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
 #include <qle/processes/irlgm1fstateprocess.hpp>
+#include <qle/utilities/profiler.hpp>
 
 #include <ql/cashflows/averagebmacoupon.hpp>
 #include <ql/cashflows/capflooredcoupon.hpp>
@@ -685,6 +686,8 @@ RandomVariable McMultiLegBaseEngine::cashflowPathValue(const CashflowInfo& cf,
 
 void McMultiLegBaseEngine::calculate() const {
 
+    QLE_PROFILE_ZONE("McMultiLegBaseEngine::calculate");
+
     McEngineStats::instance().other_timer.resume();
 
     // check data set by derived engines
@@ -802,9 +805,19 @@ void McMultiLegBaseEngine::calculate() const {
         auto tmp = QuantLib::ext::make_shared<IrLgm1fStateProcess>(model_->irlgm1f(0));
         tmp->resetCache(timeGrid.size() - 1);
         process = tmp;
-    } else if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
-        // enable cache
-        tmp->resetCache(timeGrid.size() - 1);
+    } else if (auto shared = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
+        // the model might be shared with other threads (see AMCValuationEngine), so we simulate with a process of our
+        // own, that looks up the coefficients in the read-only cache of the model's process if it covers our time
+        // grid, or uses a cache of its own otherwise
+        auto tmp = QuantLib::ext::make_shared<CrossAssetStateProcess>(model_.currentLink());
+        bool useSharedCache = shared->cache() != nullptr;
+        for (Size i = 0; i < timeGrid.size() - 1 && useSharedCache; ++i)
+            useSharedCache = shared->cache()->index(timeGrid[i], timeGrid.dt(i)) != Null<Size>();
+        if (useSharedCache)
+            tmp->setCache(shared->cache());
+        else
+            tmp->resetCache(timeGrid.size() - 1);
+        process = tmp;
     }
 
     auto pathGenerator = makeMultiPathGenerator(calibrationPathGenerator_, process, timeGrid, calibrationSeed_,
@@ -81,24 +81,40 @@ void MidPointCDOEngine::calculate() const {
     //         QuantLib::ext::dynamic_pointer_cast<Coupon>(
     //             arguments_.normalizedLeg[0])->accrualStartDate());
     results_.expectedTrancheLoss.push_back(recovery_e1);
+
+    // expected tranche losses at the end of all remaining periods, one call to the loss model per recovery flag
+    std::vector<QuantLib::ext::shared_ptr<Coupon>> coupons(arguments_.normalizedLeg.size());
+    std::vector<Date> endDates;
+    for (Size i = 0; i < arguments_.normalizedLeg.size(); i++) {
+        if (arguments_.normalizedLeg[i]->hasOccurred(today))
+            continue;
+        coupons[i] = QuantLib::ext::dynamic_pointer_cast<Coupon>(arguments_.normalizedLeg[i]);
+        QL_REQUIRE(coupons[i], "MidPointCDOEngine expects leg to have Coupon cashflow type.");
+        endDates.push_back(coupons[i]->accrualEndDate());
+    }
+    std::vector<Real> zeroRecoveryEtls, recoveryEtls;
+    if (!endDates.empty()) {
+        zeroRecoveryEtls = arguments_.basket->expectedTrancheLoss(endDates, true); // zero recoveries for the coupon leg
+        recoveryEtls = arguments_.basket->expectedTrancheLoss(endDates, false); // non-zero recovery for the default leg
+    }
+    Size nextEtl = 0;
+
     //'e1'  should contain the existing loses.....? use remaining amounts?
     for (Size i = 0; i < arguments_.normalizedLeg.size(); i++) {
-        if (arguments_.normalizedLeg[i]->hasOccurred(today)) {
+        if (!coupons[i]) {
             results_.expectedTrancheLoss.push_back(0.);
             continue;
         }
-        QuantLib::ext::shared_ptr<Coupon> coupon = QuantLib::ext::dynamic_pointer_cast<Coupon>(arguments_.normalizedLeg[i]);
+        const QuantLib::ext::shared_ptr<Coupon>& coupon = coupons[i];
         Date paymentDate = coupon->date();
         Date startDate = std::max(coupon->accrualStartDate(), discountCurve_->referenceDate());
         Date endDate = coupon->accrualEndDate();
         // we assume the loss within the period took place on this date:
         Date defaultDate = startDate + (endDate - startDate) / 2;
 
-        Real zeroRecovery_e2 =
-            arguments_.basket->expectedTrancheLoss(endDate, true); // zero recoveries for the coupon leg
-
-        Real recovery_e2 =
-            arguments_.basket->expectedTrancheLoss(endDate, false); // non-zero recovery for the default leg
+        Real zeroRecovery_e2 = zeroRecoveryEtls[nextEtl];
+        Real recovery_e2 = recoveryEtls[nextEtl];
+        ++nextEtl;
 
         results_.expectedTrancheLoss.push_back(recovery_e2);
         results_.premiumValue += ((inceptionTrancheNotional - zeroRecovery_e2) / inceptionTrancheNotional) *
@@ -336,56 +336,31 @@ bool NumericLgmMultiLegOptionEngineBase::instrumentIsHandled(
     return isHandled;
 }
 
-void NumericLgmMultiLegOptionEngineBase::calculate() const {
-
-    std::vector<std::string> messages;
-    QL_REQUIRE(
-        instrumentIsHandled(legs_, payer_, currency_, exercise_, settlementType_, settlementMethod_, messages),
-        "NumericLgmMultiLegOptionEngineBase::calculate(): instrument is not handled: " << boost::join(messages, ", "));
-
-    // handle empty exercise
-
-    if (exercise_ == nullptr) {
-        npv_ = 0.0;
-        for (Size i = 0; i < legs_.size(); ++i) {
-            for (Size j = 0; j < legs_[i].size(); ++j) {
-                npv_ += legs_[i][j]->amount() * discountCurve_->discount(legs_[i][j]->date());
-            }
-        }
-        underlyingNpv_ = npv_;
-        return;
-    }
+NumericLgmMultiLegOptionEngineBase::BackwardRun NumericLgmMultiLegOptionEngineBase::initBackwardRun() const {
 
-    // we have a non-empty exercise
+    BackwardRun run;
+    run.rebatedExercise = QuantLib::ext::dynamic_pointer_cast<QuantExt::RebatedExercise>(exercise_);
+    run.exerciseType = exercise_->type();
 
-    auto rebatedExercise = QuantLib::ext::dynamic_pointer_cast<QuantExt::RebatedExercise>(exercise_);
     auto const& ts = solver_->model()->parametrization()->termStructure();
     Date refDate = ts->referenceDate();
 
     /* Build the cashflow info */
 
-    enum class CashflowStatus { Open, Cached, Done };
-
-    std::vector<CashflowInfo> cashflows;
-    std::vector<CashflowStatus> cashflowStatus;
-
     for (Size i = 0; i < legs_.size(); ++i) {
         for (Size j = 0; j < legs_[i].size(); ++j) {
-            cashflows.push_back(buildCashflowInfo(i, j));
-            cashflowStatus.push_back(CashflowStatus::Open);
+            run.cashflows.push_back(buildCashflowInfo(i, j));
+            run.cashflowStatus.push_back(BackwardRun::CashflowStatus::Open);
         }
     }
 
     /* Build the time grid containing the option times */
 
-    std::set<Real> optionTimes;
-    std::map<Real, Date> optionDates;
-
     if (exercise_->type() == Exercise::Bermudan || exercise_->type() == Exercise::European) {
         for (auto const& d : exercise_->dates()) {
             if (d > refDate) {
-                optionTimes.insert(ts->timeFromReference(d));
-                optionDates[ts->timeFromReference(d)] = d;
+                run.optionTimes.insert(ts->timeFromReference(d));
+                run.optionDates[ts->timeFromReference(d)] = d;
             }
         }
     } else if (exercise_->type() == Exercise::American) {
@@ -396,9 +371,9 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
         Real t2 = std::max(t1, ts->timeFromReference(exercise_->dates().back()));
         Size steps =
             std::max<Size>(1, static_cast<Size>((t2 - t1) * static_cast<Real>(americanExerciseTimeStepsPerYear_)));
-        optionTimes.insert(t1);
+        run.optionTimes.insert(t1);
         for (Size i = 0; i <= steps; ++i) {
-            optionTimes.insert(t1 + static_cast<Real>(i) * (t2 - t1) / static_cast<Real>(steps));
+            run.optionTimes.insert(t1 + static_cast<Real>(i) * (t2 - t1) / static_cast<Real>(steps));
         }
     } else {
         QL_FAIL("NumericLgmMultiLegOptionEngineBase::calculate(): internal error: exercise type "
@@ -409,114 +384,176 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
 
     std::set<Real> requiredCfSimTimes;
 
-    for (auto const& c : cashflows) {
+    for (auto const& c : run.cashflows) {
         if (Real t = c.requiredSimulationTime(); t != Null<Real>())
             requiredCfSimTimes.insert(t);
     }
 
     /* Join the two grids to get the time grid which we use for the backward run */
 
-    std::set<Real> timeGrid{0.0};
-    timeGrid.insert(optionTimes.begin(), optionTimes.end());
-    timeGrid.insert(requiredCfSimTimes.begin(), requiredCfSimTimes.end());
+    run.timeGrid.insert(0.0);
+    run.timeGrid.insert(run.optionTimes.begin(), run.optionTimes.end());
+    run.timeGrid.insert(requiredCfSimTimes.begin(), requiredCfSimTimes.end());
 
-    /* Step backwards through the grid and compute the option npv */
-
-    LgmVectorised lgm(solver_->model()->parametrization());
+    run.underlyingNpv = RandomVariable(solver_->gridSize(), 0.0);
+    run.optionNpv = RandomVariable(solver_->gridSize(), 0.0);
+    run.provisionalNpv = RandomVariable(solver_->gridSize(), 0.0);
+    run.cache.resize(run.cashflows.size());
 
-    RandomVariable underlyingNpv(solver_->gridSize(), 0.0);
-    RandomVariable optionNpv(solver_->gridSize(), 0.0);
-    RandomVariable provisionalNpv(solver_->gridSize(), 0.0);
+    return run;
+}
 
-    std::vector<RandomVariable> cache(cashflows.size());
+void NumericLgmMultiLegOptionEngineBase::updateBackwardRun(BackwardRun& run, const LgmVectorised& lgm,
+                                                           const Real t_from, const RandomVariable& state) const {
 
-    for (auto it = timeGrid.rbegin(); it != timeGrid.rend(); ++it) {
+    using CashflowStatus = BackwardRun::CashflowStatus;
 
-        Real t_from = *it;
-        Real t_to = (it != std::next(timeGrid.rend(), -1)) ? *std::next(it, 1) : t_from;
+    // update cashflows on current time
 
-        RandomVariable state = solver_->stateGrid(t_from);
+    run.provisionalNpv = RandomVariable(solver_->gridSize(), 0.0);
 
-        // update cashflows on current time
-
-        provisionalNpv = RandomVariable(solver_->gridSize(), 0.0);
-
-        for (Size i = 0; i < cashflows.size(); ++i) {
-            if (cashflowStatus[i] == CashflowStatus::Done)
-                continue;
-            if (cashflows[i].isPartOfUnderlying(t_from)) {
-                RandomVariable cpnRatio(solver_->gridSize(), cashflows[i].couponRatio(t_from));
-                bool isBrokenCoupon = !QuantLib::close_enough(cpnRatio.at(0), 1.0);
-                if (cashflowStatus[i] == CashflowStatus::Cached) {
-                    if (isBrokenCoupon) {
-                        provisionalNpv += cache[i] * cpnRatio;
-                    } else {
-                        underlyingNpv += cache[i];
-                        cache[i].clear();
-                        cashflowStatus[i] = CashflowStatus::Done;
-                    }
-                } else if (cashflows[i].canBeEstimated(t_from)) {
-                    if (isBrokenCoupon) {
-                        cache[i] = cashflows[i].pv(lgm, t_from, state, discountCurve_);
-                        cashflowStatus[i] = CashflowStatus::Cached;
-                        provisionalNpv += cache[i] * cpnRatio;
-                    } else {
-                        underlyingNpv += cashflows[i].pv(lgm, t_from, state, discountCurve_);
-                        cashflowStatus[i] = CashflowStatus::Done;
-                    }
+    for (Size i = 0; i < run.cashflows.size(); ++i) {
+        auto const& cf = run.cashflows[i];
+        auto& status = run.cashflowStatus[i];
+        if (status == CashflowStatus::Done)
+            continue;
+        if (cf.isPartOfUnderlying(t_from)) {
+            RandomVariable cpnRatio(solver_->gridSize(), cf.couponRatio(t_from));
+            bool isBrokenCoupon = !QuantLib::close_enough(cpnRatio.at(0), 1.0);
+            if (status == CashflowStatus::Cached) {
+                if (isBrokenCoupon) {
+                    run.provisionalNpv += run.cache[i] * cpnRatio;
                 } else {
-                    provisionalNpv += cashflows[i].pv(lgm, t_from, state, discountCurve_) * cpnRatio;
+                    run.underlyingNpv += run.cache[i];
+                    run.cache[i].clear();
+                    status = CashflowStatus::Done;
                 }
-            } else if (cashflows[i].mustBeEstimated(t_from) && cashflowStatus[i] == CashflowStatus::Open) {
-                cache[i] = cashflows[i].pv(lgm, t_from, state, discountCurve_);
-                cashflowStatus[i] = CashflowStatus::Cached;
+            } else if (cf.canBeEstimated(t_from)) {
+                if (isBrokenCoupon) {
+                    run.cache[i] = cf.pv(lgm, t_from, state, discountCurve_);
+                    status = CashflowStatus::Cached;
+                    run.provisionalNpv += run.cache[i] * cpnRatio;
+                } else {
+                    run.underlyingNpv += cf.pv(lgm, t_from, state, discountCurve_);
+                    status = CashflowStatus::Done;
+                }
+            } else {
+                run.provisionalNpv += cf.pv(lgm, t_from, state, discountCurve_) * cpnRatio;
             }
+        } else if (cf.mustBeEstimated(t_from) && status == CashflowStatus::Open) {
+            run.cache[i] = cf.pv(lgm, t_from, state, discountCurve_);
+            status = CashflowStatus::Cached;
         }
+    }
+
+    // process optionality
+
+    if (run.optionTimes.find(t_from) != run.optionTimes.end()) {
+        auto rebateNpv =
+            getRebatePv(lgm, t_from, state, discountCurve_, run.rebatedExercise,
+                        run.exerciseType == Exercise::American ? Null<Date>() : run.optionDates.at(t_from));
+        run.optionNpv = max(run.optionNpv, run.underlyingNpv + run.provisionalNpv + rebateNpv);
+    }
+}
+
+void NumericLgmMultiLegOptionEngineBase::rollbackBackwardRuns(std::vector<BackwardRun>& runs) const {
+
+    /* Step backwards through the union of the time grids, each run is updated on the times of its own grid only */
+
+    std::set<Real> timeGrid;
+    for (auto const& r : runs)
+        timeGrid.insert(r.timeGrid.begin(), r.timeGrid.end());
+
+    LgmVectorised lgm(solver_->model()->parametrization());
+
+    for (auto it = timeGrid.rbegin(); it != timeGrid.rend(); ++it) {
 
-        // process optionality
+        Real t_from = *it;
+        Real t_to = (it != std::next(timeGrid.rend(), -1)) ? *std::next(it, 1) : t_from;
 
-        if (optionTimes.find(t_from) != optionTimes.end()) {
-            auto rebateNpv =
-                getRebatePv(lgm, t_from, state, discountCurve_, rebatedExercise,
-                            exercise_->type() == Exercise::American ? Null<Date>() : optionDates.at(t_from));
-            optionNpv = max(optionNpv, underlyingNpv + provisionalNpv + rebateNpv);
+        RandomVariable state = solver_->stateGrid(t_from);
+
+        for (auto& r : runs) {
+            if (r.timeGrid.find(t_from) != r.timeGrid.end())
+                updateBackwardRun(r, lgm, t_from, state);
         }
 
         // roll back
 
         if (t_from != t_to) {
-            underlyingNpv = solver_->rollback(underlyingNpv, t_from, t_to);
-            optionNpv = solver_->rollback(optionNpv, t_from, t_to);
-            for (auto& c : cache) {
-                if (!c.initialised())
-                    continue;
-                c = solver_->rollback(c, t_from, t_to);
+            /* collect the arrays of all runs and roll them back in one batch, so that the solver can share the work
+               across them; provisionalNpv is rebuilt on each time of a run's grid including t = 0, so it is not
+               rolled back */
+            std::vector<RandomVariable*> arrays;
+            for (auto& r : runs) {
+                arrays.push_back(&r.underlyingNpv);
+                arrays.push_back(&r.optionNpv);
+                for (auto& c : r.cache) {
+                    if (c.initialised())
+                        arrays.push_back(&c);
+                }
             }
-            // need to roll back provisionalNpv only for the last step t_1 -> t_0 = 0
-            if (it == std::next(timeGrid.rend(), -1))
-                provisionalNpv = solver_->rollback(provisionalNpv, t_from, t_to);
+            std::vector<RandomVariable> batch;
+            batch.reserve(arrays.size());
+            for (auto a : arrays)
+                batch.push_back(std::move(*a));
+            batch = solver_->rollback(batch, t_from, t_to);
+            for (Size b = 0; b < arrays.size(); ++b)
+                *arrays[b] = std::move(batch[b]);
         }
     }
+}
 
-    /* Set the results */
+void NumericLgmMultiLegOptionEngineBase::setResults(const BackwardRun& run) const {
 
-    npv_ = optionNpv.at(0);
-    underlyingNpv_ = underlyingNpv.at(0);
-    for (auto const& c : cache) {
+    npv_ = run.optionNpv.at(0);
+    underlyingNpv_ = run.underlyingNpv.at(0);
+    for (auto const& c : run.cache) {
         if (c.initialised())
             underlyingNpv_ += c.at(0);
     }
-    underlyingNpv_ += provisionalNpv.at(0);
+    underlyingNpv_ += run.provisionalNpv.at(0);
 
     additionalResults_ = getAdditionalResultsMap(solver_->model()->getCalibrationInfo());
 
-    if (rebatedExercise) {
-        for (Size i = 0; i < rebatedExercise->dates().size(); ++i) {
+    if (run.rebatedExercise) {
+        for (Size i = 0; i < run.rebatedExercise->dates().size(); ++i) {
             std::ostringstream d;
-            d << QuantLib::io::iso_date(rebatedExercise->dates()[i]);
-            additionalResults_["exerciseFee_" + d.str()] = -rebatedExercise->rebate(i);
+            d << QuantLib::io::iso_date(run.rebatedExercise->dates()[i]);
+            additionalResults_["exerciseFee_" + d.str()] = -run.rebatedExercise->rebate(i);
+        }
+    }
+}
+
+void NumericLgmMultiLegOptionEngineBase::setUnderlyingResults() const {
+    npv_ = 0.0;
+    for (Size i = 0; i < legs_.size(); ++i) {
+        for (Size j = 0; j < legs_[i].size(); ++j) {
+            npv_ += legs_[i][j]->amount() * discountCurve_->discount(legs_[i][j]->date());
         }
     }
+    underlyingNpv_ = npv_;
+}
+
+void NumericLgmMultiLegOptionEngineBase::calculate() const {
+
+    std::vector<std::string> messages;
+    QL_REQUIRE(
+        instrumentIsHandled(legs_, payer_, currency_, exercise_, settlementType_, settlementMethod_, messages),
+        "NumericLgmMultiLegOptionEngineBase::calculate(): instrument is not handled: " << boost::join(messages, ", "));
+
+    // handle empty exercise
+
+    if (exercise_ == nullptr) {
+        setUnderlyingResults();
+        return;
+    }
+
+    // we have a non-empty exercise
+
+    std::vector<BackwardRun> runs(1, initBackwardRun());
+    rollbackBackwardRuns(runs);
+    setResults(runs.front());
 
 } // NumericLgmMultiLegOptionEngineBase::calculate()
 
@@ -639,4 +676,54 @@ void NumericLgmNonstandardSwaptionEngine::calculate() const {
     results_.additionalResults["underlyingNpv"] = underlyingNpv_;
 } // NumericLgmSwaptionEngine::calculate
 
+NumericLgmMultiLegOptionBatchPricer::NumericLgmMultiLegOptionBatchPricer(
+    const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny, const Real sx,
+    const Size nx, const Handle<YieldTermStructure>& discountCurve, const Size americanExerciseTimeStepsPerYear)
+    : NumericLgmMultiLegOptionEngineBase(QuantLib::ext::make_shared<LgmConvolutionSolver2>(model, sy, ny, sx, nx),
+                                         discountCurve, americanExerciseTimeStepsPerYear) {}
+
+std::vector<NumericLgmMultiLegOptionBatchPricer::Result> NumericLgmMultiLegOptionBatchPricer::price(
+    const std::vector<QuantLib::ext::shared_ptr<MultiLegOption>>& options) const {
+
+    std::vector<Result> results(options.size());
+    std::vector<BackwardRun> runs;
+    std::vector<Size> runIndex;
+
+    for (Size i = 0; i < options.size(); ++i) {
+        QL_REQUIRE(options[i], "NumericLgmMultiLegOptionBatchPricer::price(): option #" << i << " is null");
+        legs_ = options[i]->legs();
+        payer_ = options[i]->payer();
+        currency_ = options[i]->currency();
+        exercise_ = options[i]->exercise();
+        settlementType_ = options[i]->settlementType();
+        settlementMethod_ = options[i]->settlementMethod();
+        std::vector<std::string> messages;
+        QL_REQUIRE(instrumentIsHandled(legs_, payer_, currency_, exercise_, settlementType_, settlementMethod_,
+                                       messages),
+                   "NumericLgmMultiLegOptionBatchPricer::price(): option #" << i << " is not handled: "
+                                                                             << boost::join(messages, ", "));
+        if (exercise_ == nullptr) {
+            setUnderlyingResults();
+            results[i].npv = npv_;
+            results[i].underlyingNpv = underlyingNpv_;
+        } else {
+            runs.push_back(initBackwardRun());
+            runIndex.push_back(i);
+        }
+    }
+
+    rollbackBackwardRuns(runs);
+
+    for (Size r = 0; r < runs.size(); ++r) {
+        setResults(runs[r]);
+        Result& res = results[runIndex[r]];
+        res.npv = npv_;
+        res.underlyingNpv = underlyingNpv_;
+        res.additionalResults = additionalResults_;
+        res.additionalResults["underlyingNpv"] = underlyingNpv_;
+    }
+
+    return results;
+}
+
 } // namespace QuantExt
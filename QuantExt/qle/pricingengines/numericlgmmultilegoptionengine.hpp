@@ -19,6 +19,7 @@
 #pragma once
 
 #include <qle/instruments/multilegoption.hpp>
+#include <qle/instruments/rebatedexercise.hpp>
 #include <qle/models/lgmbackwardsolver.hpp>
 #include <qle/models/lgmvectorised.hpp>
 
@@ -61,8 +62,35 @@ protected:
             calculator_; // always a valid function
     };
 
+    /* state of the backward run for one option with non-empty exercise */
+    struct BackwardRun {
+        enum class CashflowStatus { Open, Cached, Done };
+        QuantLib::ext::shared_ptr<RebatedExercise> rebatedExercise;
+        Exercise::Type exerciseType;
+        std::vector<CashflowInfo> cashflows;
+        std::vector<CashflowStatus> cashflowStatus;
+        std::set<Real> optionTimes;
+        std::map<Real, Date> optionDates;
+        std::set<Real> timeGrid;
+        RandomVariable underlyingNpv, optionNpv, provisionalNpv;
+        std::vector<RandomVariable> cache;
+    };
+
     CashflowInfo buildCashflowInfo(const Size i, const Size j) const;
 
+    // sets up the backward run for the option given by the inputs legs_, payer_, ...
+    BackwardRun initBackwardRun() const;
+    // updates the cashflows and the exercise decision of a run on a time of its time grid
+    void updateBackwardRun(BackwardRun& run, const LgmVectorised& lgm, const Real t,
+                           const RandomVariable& state) const;
+    /* steps backwards through the union of the time grids of the runs, between the time grid points the arrays of all
+       runs are handed to the solver in one batch */
+    void rollbackBackwardRuns(std::vector<BackwardRun>& runs) const;
+    // sets npv_, underlyingNpv_ and additionalResults_ from a completed run
+    void setResults(const BackwardRun& run) const;
+    // sets npv_, underlyingNpv_ and additionalResults_ for an option with empty exercise, i.e. the underlying itself
+    void setUnderlyingResults() const;
+
     void calculate() const;
 
     // inputs set in ctor
@@ -140,4 +168,27 @@ public:
     void calculate() const override;
 };
 
+//! Prices a book of multi leg options in one backward run
+/*! The options are priced with the same LGM model, discount curve and convolution solver. Instead of one backward
+    run per option, the options are rolled back together on the union of their time grids, so that the convolution
+    stencil is set up once per step for the whole book.
+
+    An option is also rolled back over the grid times of the other options in the book. Its npv therefore differs
+    from the one computed by NumericLgmMultiLegOptionEngine by the discretisation error of the solver. */
+class NumericLgmMultiLegOptionBatchPricer : public NumericLgmMultiLegOptionEngineBase {
+public:
+    struct Result {
+        Real npv, underlyingNpv;
+        std::map<std::string, boost::any> additionalResults;
+    };
+
+    NumericLgmMultiLegOptionBatchPricer(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
+                                        const Size ny, const Real sx, const Size nx,
+                                        const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+                                        const Size americanExerciseTimeStepsPerYear = 24);
+
+    //! returns the results in the order of the given options
+    std::vector<Result> price(const std::vector<QuantLib::ext::shared_ptr<MultiLegOption>>& options) const;
+};
+
 } // namespace QuantExt
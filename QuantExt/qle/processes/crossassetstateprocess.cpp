@@ -24,6 +24,7 @@
 
 #include <boost/make_shared.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 namespace QuantExt {
@@ -80,6 +81,7 @@ Size CrossAssetStateProcess::size() const { return model_->dimension(); }
 Size CrossAssetStateProcess::factors() const { return model_->brownians() + model_->auxBrownians(); }
 
 void CrossAssetStateProcess::resetCache(const Size timeSteps) const {
+    sharedCache_.reset();
     cacheNotReady_m_ = cacheNotReady_d_ = true;
     timeStepsToCache_m_ = timeStepsToCache_d_ = timeSteps;
     timeStepCache_m_ = timeStepCache_d_ = 0;
@@ -90,6 +92,43 @@ void CrossAssetStateProcess::resetCache(const Size timeSteps) const {
     updateSqrtCorrelation();
 }
 
+QuantLib::ext::shared_ptr<const CrossAssetStateProcess::Cache>
+CrossAssetStateProcess::warmUpCache(const TimeGrid& grid) const {
+    auto cache = QuantLib::ext::make_shared<Cache>();
+    // the drift and diffusion coefficients are only cached for lgm based models
+    if (model_->modelType(CrossAssetModel::AssetType::IR, 0) != CrossAssetModel::ModelType::LGM1F)
+        return cache;
+    for (Size i = 0; i + 1 < grid.size(); ++i) {
+        cache->t0.push_back(grid[i]);
+        cache->dt.push_back(grid.dt(i));
+    }
+    if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_)) {
+        cache->exact = true;
+        tmp->fillCache(*this, *cache);
+    } else {
+        for (Size i = 0; i < cache->t0.size(); ++i) {
+            cache->m.push_back(driftImpl1(cache->t0[i]));
+            cache->d.push_back(diffusionOnCorrelatedBrowniansImpl(cache->t0[i], Array()));
+        }
+    }
+    return cache;
+}
+
+void CrossAssetStateProcess::setCache(const QuantLib::ext::shared_ptr<const Cache>& cache) const {
+    resetCache(0);
+    sharedCache_ = cache;
+    if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_))
+        tmp->setCache(cache);
+}
+
+const QuantLib::ext::shared_ptr<const CrossAssetStateProcess::Cache>& CrossAssetStateProcess::cache() const {
+    return sharedCache_;
+}
+
+const CrossAssetStateProcess::Cache* CrossAssetStateProcess::eulerCache() const {
+    return sharedCache_ && !sharedCache_->exact ? sharedCache_.get() : nullptr;
+}
+
 void CrossAssetStateProcess::updateSqrtCorrelation() const {
     if (model_->discretization() != CrossAssetModel::Discretization::Euler)
         return;
@@ -128,146 +167,158 @@ Array CrossAssetStateProcess::initialValues() const {
     return res;
 }
 
-Array CrossAssetStateProcess::drift(Time t, const Array& x) const {
+Array CrossAssetStateProcess::driftImpl1(Time t) const {
     Array res(model_->dimension(), 0.0);
     Size n = model_->components(CrossAssetModel::AssetType::IR);
     Size n_eq = model_->components(CrossAssetModel::AssetType::EQ);
     Real H0 = model_->irlgm1f(0)->H(t);
-    Real Hprime0 = model_->irlgm1f(0)->Hprime(t);
     Real alpha0 = model_->irlgm1f(0)->alpha(t);
-    Real zeta0 = model_->irlgm1f(0)->zeta(t);
-    if (cacheNotReady_m_) {
-        /* z0 has drift 0 in the LGM measure but non-zero drift in the bank account measure, so start loop at i = 0 */
-        for (Size i = 0; i < n; ++i) {
-            Real Hi = model_->irlgm1f(i)->H(t);
-            Real alphai = model_->irlgm1f(i)->alpha(t);
-            if (i == 0 && model_->measure() == IrModel::Measure::BA) {
-                // ADD z0 drift in the BA measure
-                res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 0)] = -Hi * alphai * alphai;
-                // the auxiliary state variable is drift-free
-                res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 1)] = 0.0;
-            }
-            if (i > 0) {
-                Real sigmai = model_->fxbs(i - 1)->sigma(t);
-                // ir-ir
-                Real rhozz0i =
-                    model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::IR, i);
-                // ir-fx
-                Real rhozx0i =
-                    model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::FX, i - 1);
-                Real rhozxii =
-                    model_->correlation(CrossAssetModel::AssetType::IR, i, CrossAssetModel::AssetType::FX, i - 1);
-                // ir drifts
-                res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 0)] =
-                    -Hi * alphai * alphai + H0 * alpha0 * alphai * rhozz0i - sigmai * alphai * rhozxii;
-                // log spot fx drifts (z0, zi independent parts)
-                res[model_->pIdx(CrossAssetModel::AssetType::FX, i - 1, 0)] =
-                    H0 * alpha0 * sigmai * rhozx0i +
-                    model_->irlgm1f(0)->termStructure()->forwardRate(t, t, Continuous) -
-                    model_->irlgm1f(i)->termStructure()->forwardRate(t, t, Continuous) - 0.5 * sigmai * sigmai;
-                if (model_->measure() == IrModel::Measure::BA) {
-                    // REMOVE the LGM measure drift contributions above
-                    res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 0)] -= H0 * alpha0 * alphai * rhozz0i;
-                    res[model_->pIdx(CrossAssetModel::AssetType::FX, i - 1, 0)] -= H0 * alpha0 * sigmai * rhozx0i;
-                }
+    /* z0 has drift 0 in the LGM measure but non-zero drift in the bank account measure, so start loop at i = 0 */
+    for (Size i = 0; i < n; ++i) {
+        Real Hi = model_->irlgm1f(i)->H(t);
+        Real alphai = model_->irlgm1f(i)->alpha(t);
+        if (i == 0 && model_->measure() == IrModel::Measure::BA) {
+            // ADD z0 drift in the BA measure
+            res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 0)] = -Hi * alphai * alphai;
+            // the auxiliary state variable is drift-free
+            res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 1)] = 0.0;
+        }
+        if (i > 0) {
+            Real sigmai = model_->fxbs(i - 1)->sigma(t);
+            // ir-ir
+            Real rhozz0i =
+                model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::IR, i);
+            // ir-fx
+            Real rhozx0i =
+                model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::FX, i - 1);
+            Real rhozxii =
+                model_->correlation(CrossAssetModel::AssetType::IR, i, CrossAssetModel::AssetType::FX, i - 1);
+            // ir drifts
+            res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 0)] =
+                -Hi * alphai * alphai + H0 * alpha0 * alphai * rhozz0i - sigmai * alphai * rhozxii;
+            // log spot fx drifts (z0, zi independent parts)
+            res[model_->pIdx(CrossAssetModel::AssetType::FX, i - 1, 0)] =
+                H0 * alpha0 * sigmai * rhozx0i +
+                model_->irlgm1f(0)->termStructure()->forwardRate(t, t, Continuous) -
+                model_->irlgm1f(i)->termStructure()->forwardRate(t, t, Continuous) - 0.5 * sigmai * sigmai;
+            if (model_->measure() == IrModel::Measure::BA) {
+                // REMOVE the LGM measure drift contributions above
+                res[model_->pIdx(CrossAssetModel::AssetType::IR, i, 0)] -= H0 * alpha0 * alphai * rhozz0i;
+                res[model_->pIdx(CrossAssetModel::AssetType::FX, i - 1, 0)] -= H0 * alpha0 * sigmai * rhozx0i;
             }
         }
-        /* log equity spot drifts (the cache-able parts) */
-        for (Size k = 0; k < n_eq; ++k) {
-            Size i = model_->ccyIndex(model_->eqbs(k)->currency());
-            // ir params (for equity currency)
-            Real eps_ccy = (i == 0) ? 0.0 : 1.0;
-            // Real Hi = model_->irlgm1f(i)->H(t);
-            // Real alphai = model_->irlgm1f(i)->alpha(t);
-            // eq vol
-            Real sigmask = model_->eqbs(k)->sigma(t);
-            // fx vol (eq ccy / base ccy)
-            Real sigmaxi = (i == 0) ? 0.0 : model_->fxbs(i - 1)->sigma(t);
-            // ir-eq corr
-            // Real rhozsik = model_->correlation(EQ, k, CrossAssetModel::AssetType::IR, i); // eq cur
-            Real rhozs0k =
-                model_->correlation(CrossAssetModel::AssetType::EQ, k, CrossAssetModel::AssetType::IR, 0); // base cur
-            // fx-eq corr
-            Real rhoxsik =
-                (i == 0) ? 0.0 : // no fx process for base-ccy
-                    model_->correlation(CrossAssetModel::AssetType::FX, i - 1, CrossAssetModel::AssetType::EQ, k);
-            // ir instantaneous forward rate (from curve used for eq forward projection)
-            Real fr_i = model_->eqbs(k)->equityIrCurveToday()->forwardRate(t, t, Continuous);
-            // div yield instantaneous forward rate
-            Real fq_k = model_->eqbs(k)->equityDivYieldCurveToday()->forwardRate(t, t, Continuous);
-            res[model_->pIdx(CrossAssetModel::AssetType::EQ, k, 0)] = fr_i - fq_k + (rhozs0k * H0 * alpha0 * sigmask) -
-                                                                      (eps_ccy * rhoxsik * sigmaxi * sigmask) -
-                                                                      (0.5 * sigmask * sigmask);
-        }
-
-        // State independent pieces of JY inflation model, if there is a CAM JY component.
-        for (Size j = 0; j < model_->components(CrossAssetModel::AssetType::INF); ++j) {
-
-            if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::JY) {
-
-                auto p = model_->infjy(j);
-                Size i_j = model_->ccyIndex(p->currency());
-
-                // JY inflation parameter values.
-                Real H_y_j = p->realRate()->H(t);
-                Real Hp_y_j = p->realRate()->Hprime(t);
-                Real zeta_y_j = p->realRate()->zeta(t);
-                Real alpha_y_j = p->realRate()->alpha(t);
-                Real sigma_c_j = p->index()->sigma(t);
-
-                // Inflation nominal currency parameter values
-                Real H_i_j = model_->irlgm1f(i_j)->H(t);
-                Real Hp_i_j = model_->irlgm1f(i_j)->Hprime(t);
-                Real zeta_i_j = model_->irlgm1f(i_j)->zeta(t);
-
-                // Correlations
-                Real rho_zy_0j =
-                    model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::INF, j, 0, 0);
-                Real rho_yc_ij =
-                    model_->correlation(CrossAssetModel::AssetType::INF, j, CrossAssetModel::AssetType::INF, j, 0, 1);
-                Real rho_zc_0j =
-                    model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::INF, j, 0, 1);
-
-                // JY real rate drift. It is state independent
-                auto rrDrift = -alpha_y_j * alpha_y_j * H_y_j + rho_zy_0j * alpha0 * alpha_y_j * H_y_j -
-                               rho_yc_ij * alpha_y_j * sigma_c_j;
-
-                if (i_j > 0) {
-                    Real sigma_x_i_j = model_->fxbs(i_j - 1)->sigma(t);
-                    Real rho_yx_j_i_j = model_->correlation(CrossAssetModel::AssetType::INF, j,
-                                                            CrossAssetModel::AssetType::FX, i_j - 1, 0, 0);
-                    rrDrift -= rho_yx_j_i_j * alpha_y_j * sigma_x_i_j;
-                }
-
-                res[model_->pIdx(CrossAssetModel::AssetType::INF, j, 0)] = rrDrift;
-
-                // JY log inflation index drift (state independent piece).
-                auto indexDrift = rho_zc_0j * alpha0 * sigma_c_j * H0 - 0.5 * sigma_c_j * sigma_c_j +
-                                  zeta_i_j * Hp_i_j * H_i_j - zeta_y_j * Hp_y_j * H_y_j;
-
-                // Add on the f_n(0, t) - f_r(0, t) piece using the initial zero inflation term structure.
-                // Use the same dt below that is used in yield forward rate calculations.
-                auto ts = p->realRate()->termStructure();
-                Time dt = 0.0001;
-                Time t1 = std::max(t - dt / 2.0, 0.0);
-                Time t2 = t1 + dt;
-                auto z_t = ts->zeroRate(t);
-                auto z_t1 = ts->zeroRate(t1);
-                auto z_t2 = ts->zeroRate(t2);
-                indexDrift += std::log(1 + z_t) + (t / (1 + z_t)) * ((z_t2 - z_t1) / dt);
-
-                if (i_j > 0) {
-                    Real sigma_x_i_j = model_->fxbs(i_j - 1)->sigma(t);
-                    Real rho_cx_j_i_j = model_->correlation(CrossAssetModel::AssetType::INF, j,
-                                                            CrossAssetModel::AssetType::FX, i_j - 1, 1, 0);
-                    indexDrift -= rho_cx_j_i_j * sigma_c_j * sigma_x_i_j;
-                }
-
-                res[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)] = indexDrift;
+    }
+    /* log equity spot drifts (the cache-able parts) */
+    for (Size k = 0; k < n_eq; ++k) {
+        Size i = model_->ccyIndex(model_->eqbs(k)->currency());
+        // ir params (for equity currency)
+        Real eps_ccy = (i == 0) ? 0.0 : 1.0;
+        // Real Hi = model_->irlgm1f(i)->H(t);
+        // Real alphai = model_->irlgm1f(i)->alpha(t);
+        // eq vol
+        Real sigmask = model_->eqbs(k)->sigma(t);
+        // fx vol (eq ccy / base ccy)
+        Real sigmaxi = (i == 0) ? 0.0 : model_->fxbs(i - 1)->sigma(t);
+        // ir-eq corr
+        // Real rhozsik = model_->correlation(EQ, k, CrossAssetModel::AssetType::IR, i); // eq cur
+        Real rhozs0k =
+            model_->correlation(CrossAssetModel::AssetType::EQ, k, CrossAssetModel::AssetType::IR, 0); // base cur
+        // fx-eq corr
+        Real rhoxsik =
+            (i == 0) ? 0.0 : // no fx process for base-ccy
+                model_->correlation(CrossAssetModel::AssetType::FX, i - 1, CrossAssetModel::AssetType::EQ, k);
+        // ir instantaneous forward rate (from curve used for eq forward projection)
+        Real fr_i = model_->eqbs(k)->equityIrCurveToday()->forwardRate(t, t, Continuous);
+        // div yield instantaneous forward rate
+        Real fq_k = model_->eqbs(k)->equityDivYieldCurveToday()->forwardRate(t, t, Continuous);
+        res[model_->pIdx(CrossAssetModel::AssetType::EQ, k, 0)] = fr_i - fq_k + (rhozs0k * H0 * alpha0 * sigmask) -
+                                                                  (eps_ccy * rhoxsik * sigmaxi * sigmask) -
+                                                                  (0.5 * sigmask * sigmask);
+    }
+
+    // State independent pieces of JY inflation model, if there is a CAM JY component.
+    for (Size j = 0; j < model_->components(CrossAssetModel::AssetType::INF); ++j) {
+
+        if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::JY) {
+
+            auto p = model_->infjy(j);
+            Size i_j = model_->ccyIndex(p->currency());
+
+            // JY inflation parameter values.
+            Real H_y_j = p->realRate()->H(t);
+            Real Hp_y_j = p->realRate()->Hprime(t);
+            Real zeta_y_j = p->realRate()->zeta(t);
+            Real alpha_y_j = p->realRate()->alpha(t);
+            Real sigma_c_j = p->index()->sigma(t);
+
+            // Inflation nominal currency parameter values
+            Real H_i_j = model_->irlgm1f(i_j)->H(t);
+            Real Hp_i_j = model_->irlgm1f(i_j)->Hprime(t);
+            Real zeta_i_j = model_->irlgm1f(i_j)->zeta(t);
+
+            // Correlations
+            Real rho_zy_0j =
+                model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::INF, j, 0, 0);
+            Real rho_yc_ij =
+                model_->correlation(CrossAssetModel::AssetType::INF, j, CrossAssetModel::AssetType::INF, j, 0, 1);
+            Real rho_zc_0j =
+                model_->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::INF, j, 0, 1);
+
+            // JY real rate drift. It is state independent
+            auto rrDrift = -alpha_y_j * alpha_y_j * H_y_j + rho_zy_0j * alpha0 * alpha_y_j * H_y_j -
+                           rho_yc_ij * alpha_y_j * sigma_c_j;
+
+            if (i_j > 0) {
+                Real sigma_x_i_j = model_->fxbs(i_j - 1)->sigma(t);
+                Real rho_yx_j_i_j = model_->correlation(CrossAssetModel::AssetType::INF, j,
+                                                        CrossAssetModel::AssetType::FX, i_j - 1, 0, 0);
+                rrDrift -= rho_yx_j_i_j * alpha_y_j * sigma_x_i_j;
+            }
+
+            res[model_->pIdx(CrossAssetModel::AssetType::INF, j, 0)] = rrDrift;
+
+            // JY log inflation index drift (state independent piece).
+            auto indexDrift = rho_zc_0j * alpha0 * sigma_c_j * H0 - 0.5 * sigma_c_j * sigma_c_j +
+                              zeta_i_j * Hp_i_j * H_i_j - zeta_y_j * Hp_y_j * H_y_j;
+
+            // Add on the f_n(0, t) - f_r(0, t) piece using the initial zero inflation term structure.
+            // Use the same dt below that is used in yield forward rate calculations.
+            auto ts = p->realRate()->termStructure();
+            Time dt = 0.0001;
+            Time t1 = std::max(t - dt / 2.0, 0.0);
+            Time t2 = t1 + dt;
+            auto z_t = ts->zeroRate(t);
+            auto z_t1 = ts->zeroRate(t1);
+            auto z_t2 = ts->zeroRate(t2);
+            indexDrift += std::log(1 + z_t) + (t / (1 + z_t)) * ((z_t2 - z_t1) / dt);
+
+            if (i_j > 0) {
+                Real sigma_x_i_j = model_->fxbs(i_j - 1)->sigma(t);
+                Real rho_cx_j_i_j = model_->correlation(CrossAssetModel::AssetType::INF, j,
+                                                        CrossAssetModel::AssetType::FX, i_j - 1, 1, 0);
+                indexDrift -= rho_cx_j_i_j * sigma_c_j * sigma_x_i_j;
             }
+
+            res[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)] = indexDrift;
         }
+    }
+    return res;
+}
 
-        if (timeStepsToCache_m_ > 0) {
+Array CrossAssetStateProcess::drift(Time t, const Array& x) const {
+    Array res;
+    Size n = model_->components(CrossAssetModel::AssetType::IR);
+    Size n_eq = model_->components(CrossAssetModel::AssetType::EQ);
+    Real H0 = model_->irlgm1f(0)->H(t);
+    Real Hprime0 = model_->irlgm1f(0)->Hprime(t);
+    Real zeta0 = model_->irlgm1f(0)->zeta(t);
+    const Cache* cache = eulerCache();
+    Size cacheIndex = cache ? cache->index(t) : Null<Size>();
+    if (cacheIndex != Null<Size>()) {
+        res = cache->m[cacheIndex];
+    } else if (sharedCache_ || cacheNotReady_m_) {
+        res = driftImpl1(t);
+        if (!sharedCache_ && timeStepsToCache_m_ > 0) {
             cache_m_.push_back(res);
             if (cache_m_.size() == timeStepsToCache_m_)
                 cacheNotReady_m_ = false;
@@ -342,6 +393,11 @@ Matrix CrossAssetStateProcess::diffusion(Time t, const Array& x) const {
 }
 
 Matrix CrossAssetStateProcess::diffusionOnCorrelatedBrownians(Time t, const Array& x) const {
+    if (sharedCache_) {
+        const Cache* cache = eulerCache();
+        Size cacheIndex = cache ? cache->index(t) : Null<Size>();
+        return cacheIndex != Null<Size>() ? cache->d[cacheIndex] : diffusionOnCorrelatedBrowniansImpl(t, x);
+    }
     if (cacheNotReady_d_) {
         Matrix tmp = diffusionOnCorrelatedBrowniansImpl(t, x);
         if (timeStepsToCache_d_ > 0) {
@@ -585,7 +641,12 @@ CrossAssetStateProcess::ExactDiscretization::ExactDiscretization(QuantLib::ext::
 Array CrossAssetStateProcess::ExactDiscretization::drift(const StochasticProcess& p, Time t0, const Array& x0,
                                                          Time dt) const {
     Array res;
-    if (cacheNotReady_m_) {
+    Size cacheIndex = sharedCache_ ? sharedCache_->index(t0, dt) : Null<Size>();
+    if (cacheIndex != Null<Size>()) {
+        res = sharedCache_->m[cacheIndex];
+    } else if (sharedCache_) {
+        res = driftImpl1(p, t0, x0, dt);
+    } else if (cacheNotReady_m_) {
         res = driftImpl1(p, t0, x0, dt);
         if (timeStepsToCache_m_ > 0) {
             cache_m_.push_back(res);
@@ -606,6 +667,11 @@ Array CrossAssetStateProcess::ExactDiscretization::drift(const StochasticProcess
 
 Matrix CrossAssetStateProcess::ExactDiscretization::diffusion(const StochasticProcess& p, Time t0, const Array& x0,
                                                               Time dt) const {
+    if (sharedCache_) {
+        Size cacheIndex = sharedCache_->index(t0, dt);
+        return cacheIndex != Null<Size>() ? sharedCache_->d[cacheIndex]
+                                          : pseudoSqrt(covariance(p, t0, x0, dt), salvaging_);
+    }
     if (cacheNotReady_d_) {
         Matrix res = pseudoSqrt(covariance(p, t0, x0, dt), salvaging_);
         // note that covariance actually does not depend on x0
@@ -625,6 +691,10 @@ Matrix CrossAssetStateProcess::ExactDiscretization::diffusion(const StochasticPr
 
 Matrix CrossAssetStateProcess::ExactDiscretization::covariance(const StochasticProcess& p, Time t0, const Array& x0,
                                                                Time dt) const {
+    if (sharedCache_) {
+        Size cacheIndex = sharedCache_->index(t0, dt);
+        return cacheIndex != Null<Size>() ? sharedCache_->v[cacheIndex] : covarianceImpl(p, t0, x0, dt);
+    }
     if (cacheNotReady_v_) {
         Matrix res = covarianceImpl(p, t0, x0, dt);
         if (timeStepsToCache_v_ > 0) {
@@ -980,6 +1050,7 @@ Matrix CrossAssetStateProcess::ExactDiscretization::covarianceImpl(const Stochas
 }
 
 void CrossAssetStateProcess::ExactDiscretization::resetCache(const Size timeSteps) const {
+    sharedCache_.reset();
     cacheNotReady_m_ = cacheNotReady_d_ = cacheNotReady_v_ = true;
     timeStepsToCache_m_ = timeStepsToCache_d_ = timeStepsToCache_v_ = timeSteps;
     timeStepCache_m_ = timeStepCache_d_ = timeStepCache_v_ = 0;
@@ -988,4 +1059,30 @@ void CrossAssetStateProcess::ExactDiscretization::resetCache(const Size timeStep
     cache_d_.clear();
 }
 
+void CrossAssetStateProcess::ExactDiscretization::setCache(const QuantLib::ext::shared_ptr<const Cache>& cache) const {
+    resetCache(0);
+    if (cache && cache->exact)
+        sharedCache_ = cache;
+}
+
+void CrossAssetStateProcess::ExactDiscretization::fillCache(const StochasticProcess& p, Cache& cache) const {
+    Array x0 = p.initialValues();
+    for (Size i = 0; i < cache.t0.size(); ++i) {
+        // the cached quantities do not depend on x0
+        cache.m.push_back(driftImpl1(p, cache.t0[i], x0, cache.dt[i]));
+        cache.v.push_back(covarianceImpl(p, cache.t0[i], x0, cache.dt[i]));
+        cache.d.push_back(pseudoSqrt(cache.v.back(), salvaging_));
+    }
+}
+
+Size CrossAssetStateProcess::Cache::index(Time t, Time stepSize) const {
+    auto it = std::lower_bound(t0.begin(), t0.end(), t, [](Time a, Time b) { return a < b && !close_enough(a, b); });
+    if (it == t0.end() || !close_enough(*it, t))
+        return Null<Size>();
+    Size i = std::distance(t0.begin(), it);
+    if (stepSize != Null<Real>() && !close_enough(dt[i], stepSize))
+        return Null<Size>();
+    return i;
+}
+
 } // namespace QuantExt
@@ -27,6 +27,7 @@
 
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 #include <ql/stochasticprocess.hpp>
+#include <ql/timegrid.hpp>
 
 #include <boost/unordered_map.hpp>
 
@@ -54,10 +55,36 @@ public:
     // enables and resets the cache, once enabled the simulated times must stay the stame
     void resetCache(const Size timeSteps) const;
 
+    /*! State independent drift and diffusion coefficients per time step on a fixed time grid. The cache is
+        immutable once built and can be shared read-only between processes of the same model, e.g. one per
+        valuation thread. */
+    struct Cache {
+        //! index of the step starting at t (and of length stepSize, if given), or null if the step is not cached
+        Size index(Time t, Time stepSize = Null<Real>()) const;
+        // true if the coefficients refer to the exact discretization, false for Euler
+        bool exact = false;
+        std::vector<Time> t0, dt;
+        // state independent part of the drift and the diffusion (Euler) resp. its pseudo square root (Exact)
+        std::vector<Array> m;
+        std::vector<Matrix> d;
+        // covariance (Exact only)
+        std::vector<Matrix> v;
+    };
+
+    /*! builds the cache for the steps of the given time grid without changing the state of the process */
+    QuantLib::ext::shared_ptr<const Cache> warmUpCache(const TimeGrid& grid) const;
+    /*! looks up coefficients in the given cache from now on, steps not in the cache are computed on the fly, this
+        replaces the cache enabled by resetCache(), which in turn removes the given cache again */
+    void setCache(const QuantLib::ext::shared_ptr<const Cache>& cache) const;
+    const QuantLib::ext::shared_ptr<const Cache>& cache() const;
+
 protected:
+    virtual Array driftImpl1(Time t) const;
     virtual Matrix diffusionOnCorrelatedBrownians(Time t, const Array& x) const;
     virtual Matrix diffusionOnCorrelatedBrowniansImpl(Time t, const Array& x) const;
     void updateSqrtCorrelation() const;
+    // the shared cache if it holds coefficients of the Euler discretization, otherwise null
+    const Cache* eulerCache() const;
 
     QuantLib::ext::shared_ptr<const CrossAssetModel> model_;
 
@@ -74,6 +101,8 @@ protected:
         virtual Matrix diffusion(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         virtual Matrix covariance(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         void resetCache(const Size timeSteps) const;
+        void setCache(const QuantLib::ext::shared_ptr<const Cache>& cache) const;
+        void fillCache(const StochasticProcess& p, Cache& cache) const;
 
     protected:
         virtual Array driftImpl1(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
@@ -94,6 +123,7 @@ protected:
         mutable Size timeStepCache_v_ = 0;
         mutable std::vector<Array> cache_m_;
         mutable std::vector<Matrix> cache_v_, cache_d_;
+        mutable QuantLib::ext::shared_ptr<const Cache> sharedCache_;
     }; // ExactDiscretization
 
     mutable bool cacheNotReady_m_ = true;
@@ -104,6 +134,7 @@ protected:
     mutable Size timeStepCache_d_ = 0;
     mutable std::vector<Array> cache_m_;
     mutable std::vector<Matrix> cache_d_;
+    mutable QuantLib::ext::shared_ptr<const Cache> sharedCache_;
 }; // CrossAssetStateProcess
 
 } // namespace QuantExt
@@ -7,6 +7,7 @@
 
 #include <qle/ad/backwardderivatives.hpp>
 #include <qle/ad/computationgraph.hpp>
+#include <qle/ad/computationgraphfragment.hpp>
 #include <qle/ad/external_randomvariable_ops.hpp>
 #include <qle/ad/forwardderivatives.hpp>
 #include <qle/ad/forwardevaluation.hpp>
@@ -14,6 +15,7 @@
 #include <qle/calendars/amendedcalendar.hpp>
 #include <qle/calendars/austria.hpp>
 #include <qle/calendars/belgium.hpp>
+#include <qle/calendars/bitmapcalendar.hpp>
 #include <qle/calendars/cme.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/cyprus.hpp>
@@ -585,6 +587,7 @@
 #include <qle/utilities/commodity.hpp>
 #include <qle/utilities/inflation.hpp>
 #include <qle/utilities/interpolation.hpp>
+#include <qle/utilities/profiler.hpp>
 #include <qle/utilities/savedobservablesettings.hpp>
 #include <qle/utilities/time.hpp>
 #include <qle/version.hpp>
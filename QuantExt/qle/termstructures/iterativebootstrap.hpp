@@ -23,12 +23,19 @@
 #ifndef quantext_iterative_bootstrap_hpp
 #define quantext_iterative_bootstrap_hpp
 
+#include <ql/math/comparison.hpp>
 #include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/math/matrix.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 #include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
 #include <ql/termstructures/bootstraperror.hpp>
 #include <ql/termstructures/bootstraphelper.hpp>
 #include <ql/utilities/dataformatters.hpp>
+#include <ql/utilities/tracing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
 
 namespace QuantExt {
 
@@ -73,6 +80,20 @@ QuantLib::Real dontThrowFallback(const QuantLib::BootstrapError<Curve>& error, Q
       \c accuracy specified in the \c Curve which is useful in some situations e.g. cubic spline and optionlet
       stripping. If the \c globalAccuracy is set less than the \c accuracy in the \c Curve, the \c accuracy in the
       \c Curve is used instead.
+    - addition of a \c globalSolver parameter. If set to \c true, recalculations of a curve that was bootstrapped
+      successfully before solve for all pillars simultaneously using a damped Newton iteration, starting from the
+      previous curve. The jacobian of the helper quote errors w.r.t. the pillar values is computed by finite
+      differences once and then kept up to date by Broyden updates, so that subsequent solves for nearby market
+      data (e.g. in sensitivity scenarios) typically only require a few repricings of each helper. The Newton
+      iteration has converged when all helper quote errors are within the accuracy. If this is not reached, the
+      usual pillar by pillar bootstrap is run. The reason for the fallback is traced and available from
+      \c globalSolveFailure().
+    - addition of an \c incremental parameter. If set to \c true, the helper quote errors are stored after each
+      successful bootstrap. On recalculation, the bootstrap restarts from the first pillar whose helper quote error
+      changed, keeping the curve values at the earlier pillars. This detects changed quotes as well as changes in
+      other curves the helpers depend on (e.g. an exogenous discount curve). The incremental restart is only used if
+      the interpolation is local and each helper's pillar is its latest relevant date, so that a helper does not
+      depend on the curve beyond its pillar.
 */
 template <class Curve> class IterativeBootstrap {
     typedef typename Curve::traits_type Traits;
@@ -91,17 +112,37 @@ public:
         \param minFactor      Factor for min value retry on each iteration if there is a failure.
         \param dontThrowSteps If \p dontThrow is \c true, this gives the number of steps to use when searching
                               for a fallback curve pillar value that gives the minimum bootstrap helper error.
+        \param globalSolver   If set to \c true, recalculations use a global Newton solver, see above.
+        \param incremental    If set to \c true, recalculations restart from the first changed pillar, see above.
     */
     IterativeBootstrap(QuantLib::Real accuracy = QuantLib::Null<QuantLib::Real>(),
                        QuantLib::Real globalAccuracy = QuantLib::Null<QuantLib::Real>(), bool dontThrow = false,
                        QuantLib::Size maxAttempts = 1, QuantLib::Real maxFactor = 2.0, QuantLib::Real minFactor = 2.0,
-                       QuantLib::Size dontThrowSteps = 10);
+                       QuantLib::Size dontThrowSteps = 10, bool globalSolver = false, bool incremental = false);
 
     void setup(Curve* ts);
     void calculate() const;
 
+    //! number of calculations that were solved by the global solver
+    QuantLib::Size globalSolves() const { return globalSolves_; }
+    //! why the last global solve fell back to the pillar by pillar bootstrap, empty if it converged
+    const std::string& globalSolveFailure() const { return globalSolveFailure_; }
+    //! the bootstrap of the given curve
+    static const IterativeBootstrap& bootstrap(const Curve& ts) { return ts.bootstrap_; }
+
 private:
     void initialize() const;
+    // the pillar by pillar bootstrap, the curve values before firstPillar are kept
+    void iterativeSolve(QuantLib::Size firstPillar = 1) const;
+    // the first pillar whose helper quote error changed since the last bootstrap, or 1 if this can not be determined
+    QuantLib::Size firstChangedPillar() const;
+    /* the global Newton solver, returns false if the helper quote errors could not be brought within the accuracy,
+       the curve data is unchanged in this case */
+    bool globalSolve() const;
+    // sets the curve data for the alive pillars and returns the helper quote errors
+    QuantLib::Array globalErrors(const QuantLib::Array& x) const;
+    // finite difference jacobian of the helper quote errors
+    QuantLib::Matrix globalJacobian(const QuantLib::Array& x, const QuantLib::Array& errors) const;
     Curve* ts_;
     QuantLib::Size n_;
     QuantLib::Brent firstSolver_;
@@ -117,15 +158,25 @@ private:
     QuantLib::Real maxFactor_;
     QuantLib::Real minFactor_;
     QuantLib::Size dontThrowSteps_;
+    bool globalSolver_;
+    // inverse jacobian used by the global solver, empty if not yet computed
+    mutable QuantLib::Matrix inverseJacobian_;
+    mutable QuantLib::Size globalSolves_ = 0;
+    mutable std::string globalSolveFailure_;
+    bool incremental_;
+    // helper quote errors after the last bootstrap, empty if not available
+    mutable std::vector<QuantLib::Real> quoteErrors_;
 };
 
 template <class Curve>
 IterativeBootstrap<Curve>::IterativeBootstrap(QuantLib::Real accuracy, QuantLib::Real globalAccuracy, bool dontThrow,
                                               QuantLib::Size maxAttempts, QuantLib::Real maxFactor,
-                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps)
+                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps,
+                                              bool globalSolver, bool incremental)
     : ts_(0), n_(0), initialized_(false), validCurve_(false), loopRequired_(Interpolator::global),
       firstAliveHelper_(0), alive_(0), accuracy_(accuracy), globalAccuracy_(globalAccuracy), dontThrow_(dontThrow),
-      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps) {}
+      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps),
+      globalSolver_(globalSolver), incremental_(incremental) {}
 
 template <class Curve> void IterativeBootstrap<Curve>::setup(Curve* ts) {
     ts_ = ts;
@@ -201,6 +252,9 @@ template <class Curve> void IterativeBootstrap<Curve>::initialize() const {
         ts_->data_ = std::vector<QuantLib::Real>(alive_ + 1, Traits::initialValue(ts_));
         previousData_.resize(alive_ + 1);
     }
+    // the pillars might have changed
+    if (inverseJacobian_.rows() != alive_)
+        inverseJacobian_ = QuantLib::Matrix();
     initialized_ = true;
 }
 
@@ -211,8 +265,11 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
     // with evaluation date change.
     // anyway it makes little sense to use date relative helpers with a
     // non-moving curve if the evaluation date changes
-    if (!initialized_ || ts_->moving_)
+    bool initialized = false;
+    if (!initialized_ || ts_->moving_) {
         initialize();
+        initialized = true;
+    }
 
     // setup helpers
     for (QuantLib::Size j = firstAliveHelper_; j < n_; ++j) {
@@ -229,6 +286,42 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
         helper->setTermStructure(const_cast<Curve*>(ts_));
     }
 
+    // the pillar to start the bootstrap from, if the pillars were not (re-)initialized
+    QuantLib::Size firstPillar = incremental_ && validCurve_ && !initialized ? firstChangedPillar() : 1;
+    quoteErrors_.clear();
+
+    if (firstPillar > alive_) {
+        // nothing has changed since the last bootstrap
+    } else if (!(globalSolver_ && validCurve_ && globalSolve())) {
+        // try the global solver if we have a valid curve as a starting point, otherwise bootstrap
+        iterativeSolve(firstPillar);
+    }
+
+    if (incremental_ && validCurve_) {
+        quoteErrors_.resize(alive_ + 1);
+        for (QuantLib::Size i = 1; i <= alive_; ++i)
+            quoteErrors_[i] = errors_[i]->helper()->quoteError();
+    }
+}
+
+template <class Curve> QuantLib::Size IterativeBootstrap<Curve>::firstChangedPillar() const {
+    // for a global interpolation or helpers depending on the curve beyond their pillar, a change at a later pillar
+    // affects earlier helpers too
+    if (loopRequired_ || quoteErrors_.size() != alive_ + 1)
+        return 1;
+    try {
+        for (QuantLib::Size i = 1; i <= alive_; ++i) {
+            if (!QuantLib::close_enough(errors_[i]->helper()->quoteError(), quoteErrors_[i]))
+                return i;
+        }
+    } catch (...) {
+        return 1;
+    }
+    return alive_ + 1;
+}
+
+template <class Curve> void IterativeBootstrap<Curve>::iterativeSolve(QuantLib::Size firstPillar) const {
+
     const std::vector<QuantLib::Time>& times = ts_->times_;
     const std::vector<QuantLib::Real>& data = ts_->data_;
     QuantLib::Real accuracy = accuracy_ != QuantLib::Null<QuantLib::Real>() ? accuracy_ : ts_->accuracy_;
@@ -238,6 +331,8 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
 
     // there might be a valid curve state to use as guess
     bool validData = validCurve_;
+    if (!validData)
+        firstPillar = 1;
 
     for (QuantLib::Size iteration = 0;; ++iteration) {
         previousData_ = ts_->data_;
@@ -246,7 +341,7 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
         std::vector<QuantLib::Real> maxValues(alive_, QuantLib::Null<QuantLib::Real>());
         std::vector<QuantLib::Size> attempts(alive_, 1);
 
-        for (QuantLib::Size i = 1; i <= alive_; ++i) {
+        for (QuantLib::Size i = firstPillar; i <= alive_; ++i) {
 
             // bracket root and calculate guess
             if (minValues[i - 1] == QuantLib::Null<QuantLib::Real>()) {
@@ -363,6 +458,141 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
     validCurve_ = true;
 }
 
+template <class Curve> QuantLib::Array IterativeBootstrap<Curve>::globalErrors(const QuantLib::Array& x) const {
+    for (QuantLib::Size i = 1; i <= alive_; ++i)
+        Traits::updateGuess(ts_->data_, x[i - 1], i);
+    ts_->interpolation_.update();
+    QuantLib::Array errors(alive_);
+    for (QuantLib::Size i = 1; i <= alive_; ++i) {
+        errors[i - 1] = errors_[i]->helper()->quoteError();
+        QL_REQUIRE(std::isfinite(errors[i - 1]), "non-finite quote error for " << QuantLib::io::ordinal(i)
+                                                                               << " alive instrument");
+    }
+    return errors;
+}
+
+template <class Curve>
+QuantLib::Matrix IterativeBootstrap<Curve>::globalJacobian(const QuantLib::Array& x,
+                                                           const QuantLib::Array& errors) const {
+    QuantLib::Matrix jacobian(alive_, alive_, 0.0);
+    QuantLib::Array xb(x);
+    for (QuantLib::Size k = 0; k < alive_; ++k) {
+        QuantLib::Real h = 1.0E-6 * std::max(1.0, std::fabs(x[k]));
+        xb[k] = x[k] + h;
+        for (QuantLib::Size i = 1; i <= alive_; ++i)
+            Traits::updateGuess(ts_->data_, xb[i - 1], i);
+        ts_->interpolation_.update();
+        for (QuantLib::Size j = 0; j < alive_; ++j) {
+            // for a local interpolation, a pillar does not affect helpers that end before the previous pillar
+            if (!Interpolator::global && errors_[j + 1]->helper()->latestRelevantDate() <= ts_->dates_[k])
+                continue;
+            jacobian[j][k] = (errors_[j + 1]->helper()->quoteError() - errors[j]) / h;
+        }
+        xb[k] = x[k];
+    }
+    return jacobian;
+}
+
+template <class Curve> bool IterativeBootstrap<Curve>::globalSolve() const {
+
+    QuantLib::Real accuracy = accuracy_ != QuantLib::Null<QuantLib::Real>() ? accuracy_ : ts_->accuracy_;
+    QuantLib::Size maxIterations = Traits::maxIterations();
+
+    // the solver has converged when all helpers are repriced within the accuracy
+    auto converged = [accuracy](const QuantLib::Array& errors) {
+        for (auto e : errors)
+            if (std::fabs(e) > accuracy)
+                return false;
+        return true;
+    };
+
+    std::vector<QuantLib::Real> initialData = ts_->data_;
+    QuantLib::Array x(alive_);
+    for (QuantLib::Size i = 1; i <= alive_; ++i)
+        x[i - 1] = ts_->data_[i];
+
+    globalSolveFailure_.clear();
+
+    try {
+        QuantLib::Array errors = globalErrors(x);
+        if (converged(errors)) {
+            ++globalSolves_;
+            validCurve_ = true;
+            return true;
+        }
+        bool jacobianIsFresh = false;
+        if (inverseJacobian_.rows() != alive_) {
+            inverseJacobian_ = QuantLib::inverse(globalJacobian(x, errors));
+            jacobianIsFresh = true;
+        }
+
+        for (QuantLib::Size iteration = 0; iteration < maxIterations; ++iteration) {
+
+            QuantLib::Array step = -(inverseJacobian_ * errors);
+            QuantLib::Real errorNorm = QuantLib::Norm2(errors);
+
+            // damped step: halve the step until the errors decrease
+            QuantLib::Real lambda = 1.0;
+            QuantLib::Array xNew, errorsNew;
+            bool improved = false;
+            for (QuantLib::Size attempt = 0; attempt < 8 && !improved; ++attempt, lambda *= 0.5) {
+                xNew = x + lambda * step;
+                try {
+                    errorsNew = globalErrors(xNew);
+                    improved = QuantLib::Norm2(errorsNew) < errorNorm;
+                } catch (const std::exception&) {
+                    // the step leaves the admissible region of the curve, try a smaller one
+                }
+            }
+
+            if (!improved) {
+                // the jacobian might be outdated, recompute it once, otherwise give up
+                if (jacobianIsFresh) {
+                    globalSolveFailure_ = "damped Newton step does not reduce the helper quote errors";
+                    break;
+                }
+                errors = globalErrors(x);
+                inverseJacobian_ = QuantLib::inverse(globalJacobian(x, errors));
+                jacobianIsFresh = true;
+                continue;
+            }
+
+            // Broyden update of the inverse jacobian
+            QuantLib::Array dx = xNew - x, de = errorsNew - errors;
+            QuantLib::Array hde = inverseJacobian_ * de;
+            QuantLib::Real denominator = QuantLib::DotProduct(dx, hde);
+            if (std::fabs(denominator) > QL_EPSILON) {
+                QuantLib::Array dxh = QuantLib::transpose(inverseJacobian_) * dx;
+                QuantLib::Array u = (dx - hde) / denominator;
+                inverseJacobian_ += QuantLib::outerProduct(u.begin(), u.end(), dxh.begin(), dxh.end());
+            }
+            jacobianIsFresh = false;
+
+            x = xNew;
+            errors = errorsNew;
+
+            if (converged(errors)) {
+                ++globalSolves_;
+                validCurve_ = true;
+                return true;
+            }
+        }
+        if (globalSolveFailure_.empty())
+            globalSolveFailure_ = "no convergence within " + std::to_string(maxIterations) + " iterations";
+    } catch (const std::exception& e) {
+        globalSolveFailure_ = e.what();
+    }
+
+    QL_TRACE("IterativeBootstrap: global solver failed (" << globalSolveFailure_
+                                                           << "), falling back to pillar by pillar bootstrap");
+
+    // no convergence, restore the initial curve and discard the jacobian
+    ts_->data_ = initialData;
+    ts_->interpolation_.update();
+    inverseJacobian_ = QuantLib::Matrix();
+    return false;
+}
+
 } // namespace QuantExt
 
 #endif
@@ -0,0 +1,283 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/utilities/profiler.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <ostream>
+
+using namespace QuantLib;
+
+namespace QuantExt {
+
+namespace {
+
+void writeJsonString(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                out << ' ';
+            else
+                out << c;
+        }
+    }
+    out << '"';
+}
+
+void addSummary(Profiler::Summary& r, const Profiler::Summary& s) {
+    r.calls += s.calls;
+    r.total += s.total;
+    r.self += s.self;
+    r.max = std::max(r.max, s.max);
+}
+
+} // namespace
+
+thread_local Profiler::ThreadBufferHandle Profiler::threadBuffer_;
+
+Profiler::ThreadBufferHandle::~ThreadBufferHandle() {
+    if (buffer != nullptr)
+        Profiler::instance().release(buffer);
+}
+
+Profiler::Profiler()
+    : enabled_(false), maxEventsPerThread_(1000000), generation_(0), epoch_(Clock::now().time_since_epoch().count()) {}
+
+void Profiler::enable() {
+    clear();
+    enabled_.store(true);
+}
+
+void Profiler::disable() { enabled_.store(false); }
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+    epoch_.store(Clock::now().time_since_epoch().count());
+    retiredEvents_.clear();
+    retiredSummary_.clear();
+    retiredDropped_ = 0;
+    for (auto& b : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(b->mutex);
+        b->events.clear();
+        b->summary.clear();
+        b->dropped = 0;
+    }
+}
+
+void Profiler::setMaxEventsPerThread(Size n) { maxEventsPerThread_.store(n); }
+
+Profiler::ThreadBuffer* Profiler::buffer() {
+    if (threadBuffer_.buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (freeBuffers_.empty()) {
+            buffers_.push_back(std::make_unique<ThreadBuffer>(buffers_.size() + 1));
+            threadBuffer_.buffer = buffers_.back().get();
+        } else {
+            threadBuffer_.buffer = freeBuffers_.back();
+            freeBuffers_.pop_back();
+        }
+    }
+    return threadBuffer_.buffer;
+}
+
+void Profiler::release(ThreadBuffer* b) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> bufferLock(b->mutex);
+    retiredEvents_.insert(retiredEvents_.end(), std::make_move_iterator(b->events.begin()),
+                          std::make_move_iterator(b->events.end()));
+    for (auto const& s : b->summary)
+        addSummary(retiredSummary_[s.first], s.second);
+    retiredDropped_ += b->dropped;
+    b->frames.clear();
+    b->events.clear();
+    b->summary.clear();
+    b->dropped = 0;
+    freeBuffers_.push_back(b);
+}
+
+void Profiler::open(std::string name, std::string category) {
+    ThreadBuffer* b = buffer();
+    std::string path = b->frames.empty() ? name : b->frames.back().path + "/" + name;
+    b->frames.push_back({std::move(name), std::move(category), std::move(path), Clock::now(), 0.0});
+}
+
+void Profiler::close(bool record) {
+    Clock::time_point end = Clock::now();
+    ThreadBuffer* b = buffer();
+    // called from the zone destructor, so we do not throw
+    if (b->frames.empty())
+        return;
+    Frame f = std::move(b->frames.back());
+    b->frames.pop_back();
+    double duration = std::chrono::duration<double>(end - f.start).count();
+    if (!b->frames.empty())
+        b->frames.back().childTime += duration;
+    if (!record)
+        return;
+    Clock::time_point epoch{Clock::duration(epoch_.load())};
+    double start = std::chrono::duration<double, std::micro>(f.start - epoch).count();
+    std::lock_guard<std::mutex> lock(b->mutex);
+    Summary& s = b->summary[f.path];
+    ++s.calls;
+    s.total += duration;
+    s.self += duration - f.childTime;
+    s.max = std::max(s.max, duration);
+    if (b->events.size() < maxEventsPerThread_.load(std::memory_order_relaxed))
+        b->events.push_back({std::move(f.name), std::move(f.category), start, duration * 1.0E6, b->id,
+                             b->frames.size()});
+    else
+        ++b->dropped;
+}
+
+std::vector<Profiler::Event> Profiler::events() const {
+    std::vector<Event> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = retiredEvents_;
+        for (auto const& b : buffers_) {
+            std::lock_guard<std::mutex> bufferLock(b->mutex);
+            result.insert(result.end(), b->events.begin(), b->events.end());
+        }
+    }
+    // events are recorded on close and buffers are reused by later threads, order them by thread and start time
+    std::stable_sort(result.begin(), result.end(), [](const Event& x, const Event& y) {
+        return x.thread < y.thread || (x.thread == y.thread && x.start < y.start);
+    });
+    return result;
+}
+
+std::map<std::string, Profiler::Summary> Profiler::summary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, Summary> result(retiredSummary_);
+    for (auto const& b : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(b->mutex);
+        for (auto const& s : b->summary)
+            addSummary(result[s.first], s.second);
+    }
+    return result;
+}
+
+Size Profiler::droppedEvents() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Size dropped = retiredDropped_;
+    for (auto const& b : buffers_) {
+        std::lock_guard<std::mutex> bufferLock(b->mutex);
+        dropped += b->dropped;
+    }
+    return dropped;
+}
+
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    std::vector<Event> ev = events();
+    Size nThreads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        nThreads = buffers_.size();
+    }
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (Size t = 1; t <= nThreads; ++t) {
+        out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+            << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+        first = false;
+    }
+    for (auto const& e : ev) {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        writeJsonString(out, e.name);
+        out << ",\"cat\":";
+        writeJsonString(out, e.category);
+        out << ",\"ph\":\"X\",\"ts\":" << e.start << ",\"dur\":" << e.duration << ",\"pid\":1,\"tid\":" << e.thread
+            << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+}
+
+void Profiler::writeChromeTrace(const std::string& fileName) const {
+    std::ofstream out(fileName);
+    QL_REQUIRE(out.is_open(), "Profiler: could not open trace file '" << fileName << "'");
+    writeChromeTrace(out);
+}
+
+void Profiler::writeSummary(std::ostream& out) const {
+    std::map<std::string, Summary> s = summary();
+    Size width = 4;
+    for (auto const& r : s)
+        width = std::max(width, r.first.size());
+    out << std::left << std::setw(width + 2) << "Zone" << std::right << std::setw(10) << "Calls" << std::setw(14)
+        << "Total(s)" << std::setw(14) << "Self(s)" << std::setw(14) << "Mean(s)" << std::setw(14) << "Max(s)"
+        << std::endl;
+    out << std::fixed << std::setprecision(6);
+    for (auto const& r : s) {
+        out << std::left << std::setw(width + 2) << r.first << std::right << std::setw(10) << r.second.calls
+            << std::setw(14) << r.second.total << std::setw(14) << r.second.self << std::setw(14)
+            << r.second.total / static_cast<double>(r.second.calls) << std::setw(14) << r.second.max << std::endl;
+    }
+    Size dropped = droppedEvents();
+    if (dropped > 0)
+        out << dropped << " events not written to the trace (maximum number of events per thread exceeded)"
+            << std::endl;
+}
+
+void Profiler::writeSummary(const std::string& fileName) const {
+    std::ofstream out(fileName);
+    QL_REQUIRE(out.is_open(), "Profiler: could not open summary file '" << fileName << "'");
+    writeSummary(out);
+}
+
+ProfileZone::ProfileZone(const char* name, const char* category) : active_(Profiler::instance().enabled()) {
+    if (active_) {
+        generation_ = Profiler::instance().generation_.load();
+        Profiler::instance().open(name, category);
+    }
+}
+
+ProfileZone::ProfileZone(const std::string& name, const char* category) : active_(Profiler::instance().enabled()) {
+    if (active_) {
+        generation_ = Profiler::instance().generation_.load();
+        Profiler::instance().open(name, category);
+    }
+}
+
+ProfileZone::~ProfileZone() {
+    if (active_)
+        Profiler::instance().close(generation_ == Profiler::instance().generation_.load());
+}
+
+} // namespace QuantExt
@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/utilities/profiler.hpp
+    \brief hierarchical profiler with chrome trace export
+*/
+
+#pragma once
+
+#include <ql/patterns/singleton.hpp>
+#include <ql/types.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace QuantExt {
+
+/*! Hierarchical wall clock profiler
+
+    Code is instrumented with scoped zones, see ProfileZone and the QLE_PROFILE_ZONE macro. Zones opened on the same
+    thread while another zone is open are nested into the latter. Each thread records into its own buffer, so that
+    recording does not contend between threads. When the profiler is disabled, a zone only checks an atomic flag on
+    construction. When a thread exits, the zones recorded in its buffer are moved to the profiler and the buffer is
+    reused by the next thread that records zones, so that the number of buffers is bounded by the maximum number of
+    threads recording at the same time.
+
+    The recorded zones can be written as a chrome trace (JSON trace event format, to be loaded into chrome://tracing
+    or https://ui.perfetto.dev) and as a summary report aggregating the calls, total and self times per zone path,
+    where the path is the sequence of the names of the enclosing zones. */
+class Profiler : public QuantLib::Singleton<Profiler, std::integral_constant<bool, true>> {
+    friend class QuantLib::Singleton<Profiler, std::integral_constant<bool, true>>;
+    friend class ProfileZone;
+
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    //! A closed zone, times are in microseconds since the profiler was enabled resp. cleared
+    struct Event {
+        std::string name, category;
+        double start, duration;
+        QuantLib::Size thread, depth;
+    };
+
+    //! Aggregated statistics of a zone path, times are in seconds
+    struct Summary {
+        QuantLib::Size calls = 0;
+        double total = 0.0, self = 0.0, max = 0.0;
+    };
+
+    //! Start recording, this clears previously recorded zones
+    void enable();
+    //! Stop recording, zones that are open are still recorded when they close
+    void disable();
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    //! Remove all recorded zones
+    void clear();
+
+    /*! Maximum number of events kept per thread for the trace, further events only contribute to the summary. The
+        default is 1,000,000. */
+    void setMaxEventsPerThread(QuantLib::Size n);
+
+    //! All recorded events, ordered by thread and start time, the zones of exited threads are included
+    std::vector<Event> events() const;
+    //! The aggregated statistics keyed by zone path, the path elements are separated by '/'
+    std::map<std::string, Summary> summary() const;
+    //! Number of events not kept for the trace because of the maximum number of events per thread
+    QuantLib::Size droppedEvents() const;
+
+    //! Write the events in the chrome trace event format
+    void writeChromeTrace(std::ostream& out) const;
+    void writeChromeTrace(const std::string& fileName) const;
+    //! Write the summary as a table, sorted by path
+    void writeSummary(std::ostream& out) const;
+    void writeSummary(const std::string& fileName) const;
+
+private:
+    Profiler();
+
+    struct Frame {
+        std::string name, category, path;
+        Clock::time_point start;
+        double childTime;
+    };
+
+    struct ThreadBuffer {
+        explicit ThreadBuffer(QuantLib::Size id) : id(id) {}
+        QuantLib::Size id;
+        // guards events, summary and dropped against concurrent reads, the frames are only used by the owner thread
+        mutable std::mutex mutex;
+        std::vector<Frame> frames;
+        std::vector<Event> events;
+        std::map<std::string, Summary> summary;
+        QuantLib::Size dropped = 0;
+    };
+
+    // releases the buffer of the current thread on thread exit
+    struct ThreadBufferHandle {
+        ThreadBuffer* buffer = nullptr;
+        ~ThreadBufferHandle();
+    };
+    static thread_local ThreadBufferHandle threadBuffer_;
+
+    ThreadBuffer* buffer();
+    // moves the recorded zones of the buffer to the retired zones and makes the buffer available for reuse
+    void release(ThreadBuffer* b);
+    void open(std::string name, std::string category);
+    void close(bool record);
+
+    std::atomic<bool> enabled_;
+    std::atomic<QuantLib::Size> maxEventsPerThread_;
+    // incremented on clear(), zones opened before a clear are not recorded
+    std::atomic<QuantLib::Size> generation_;
+    std::atomic<Clock::rep> epoch_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    // buffers released by exited threads
+    std::vector<ThreadBuffer*> freeBuffers_;
+    // zones recorded by exited threads
+    std::vector<Event> retiredEvents_;
+    std::map<std::string, Summary> retiredSummary_;
+    QuantLib::Size retiredDropped_ = 0;
+};
+
+//! Scoped zone, recorded from construction to destruction if the profiler is enabled at construction
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name, const char* category = "ore");
+    explicit ProfileZone(const std::string& name, const char* category = "ore");
+    ~ProfileZone();
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    bool active_;
+    QuantLib::Size generation_;
+};
+
+} // namespace QuantExt
+
+#define QLE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define QLE_PROFILE_CONCAT(a, b) QLE_PROFILE_CONCAT_IMPL(a, b)
+
+//! Open a profile zone with the given name and category "ore" until the end of the enclosing scope
+#define QLE_PROFILE_ZONE(name) QuantExt::ProfileZone QLE_PROFILE_CONCAT(qle_profile_zone_, __LINE__)(name)
+
+//! Open a profile zone with the given name and category until the end of the enclosing scope
+#define QLE_PROFILE_ZONE_CAT(name, category)                                                                           \
+    QuantExt::ProfileZone QLE_PROFILE_CONCAT(qle_profile_zone_, __LINE__)(name, category)
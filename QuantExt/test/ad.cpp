@@ -19,6 +19,7 @@
 #include "toplevelfixture.hpp"
 
 #include <qle/ad/backwardderivatives.hpp>
+#include <qle/ad/computationgraphfragment.hpp>
 #include <qle/ad/forwardderivatives.hpp>
 #include <qle/ad/forwardevaluation.hpp>
 #include <qle/ad/ssaform.hpp>
@@ -30,8 +31,18 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <sstream>
+
 using namespace QuantExt;
 
+namespace {
+// a model part with a state x and exp(x)
+std::size_t buildModel(ComputationGraph& g) {
+    auto x = cg_var(g, "x", ComputationGraph::VarDoesntExist::Create);
+    return cg_exp(g, x);
+}
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(AdTest)
@@ -190,6 +201,205 @@ BOOST_AUTO_TEST_CASE(testIndicatorDerivative) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testOptimise) {
+    BOOST_TEST_MESSAGE("Testing computation graph optimisation...");
+
+    constexpr Real tol = 1E-14;
+
+    // z = (exp(x) + y) * x + ((exp(x) + y) - (y + exp(x))), w = log(y + exp(x)) is not required
+    ComputationGraph g;
+    g.enableLabels();
+    auto x = cg_var(g, "x", ComputationGraph::VarDoesntExist::Create);
+    auto y = cg_var(g, "y", ComputationGraph::VarDoesntExist::Create);
+    auto e1 = cg_exp(g, x, "e1");
+    auto s1 = cg_add(g, e1, y);
+    g.startRedBlock();
+    auto e2 = cg_exp(g, x, "e2");
+    auto s2 = cg_add(g, y, e2);
+    auto d = cg_subtract(g, s1, s2);
+    g.endRedBlock();
+    auto z = cg_add(g, cg_mult(g, s1, x), d, "z");
+    auto w = cg_log(g, s2);
+    g.setVariable("w", w);
+
+    ComputationGraph g0 = g;
+    auto result = g.optimise({z});
+
+    BOOST_TEST_MESSAGE("SSA Form:\n" + ssaForm(g, getRandomVariableOpLabels()));
+
+    BOOST_CHECK_EQUAL(result.opNodesBefore, 8);
+    BOOST_CHECK_EQUAL(result.opNodesAfter, 3);
+    BOOST_CHECK_EQUAL(result.merged, 2);
+    BOOST_CHECK_EQUAL(result.simplified, 2);
+    BOOST_CHECK_EQUAL(result.pruned, 1);
+
+    // e2, s2 in the red block are replaced by e1, s1 outside the red block
+    BOOST_CHECK_EQUAL(result.replacement[e2], e1);
+    BOOST_CHECK_EQUAL(result.replacement[s2], s1);
+    BOOST_CHECK(g.isConstant(result.replacement[d]));
+    BOOST_CHECK_EQUAL(result.replacement[w], ComputationGraph::nan);
+    BOOST_CHECK(g.variables().find("w") == g.variables().end());
+    BOOST_CHECK(g.labels().at(e1) == std::set<std::string>({"e1", "e2"}));
+    BOOST_CHECK(g.redBlockDependencies().empty());
+
+    // the optimised graph yields the same value and derivatives for z
+
+    std::vector<RandomVariable> values0(g0.size(), RandomVariable(1, 0.0)), values(g.size(), RandomVariable(1, 0.0));
+    for (auto const& [n, v] : g.constants())
+        values[v] = RandomVariable(1, n);
+    for (auto const& [n, v] : g0.constants())
+        values0[v] = RandomVariable(1, n);
+    values0[x] = values[x] = RandomVariable(1, 0.5);
+    values0[y] = values[y] = RandomVariable(1, 3.0);
+
+    forwardEvaluation(g0, values0, getRandomVariableOps(1), {}, true);
+    forwardEvaluation(g, values, getRandomVariableOps(1), {}, true);
+    std::size_t zOpt = result.replacement[z];
+    BOOST_CHECK_CLOSE(values[zOpt][0], values0[z][0], tol);
+    BOOST_CHECK_CLOSE(values[zOpt][0], (std::exp(0.5) + 3.0) * 0.5, tol);
+
+    std::vector<RandomVariable> derivatives0(g0.size(), RandomVariable(1, 0.0)),
+        derivatives(g.size(), RandomVariable(1, 0.0));
+    derivatives0[z] = derivatives[zOpt] = RandomVariable(1, 1.0);
+    // the red block is reconstructed during the backward run
+    backwardDerivatives(g0, values0, derivatives0, getRandomVariableGradients(1), {}, {}, getRandomVariableOps(1),
+                        getRandomVariableOpNodeRequirements());
+    backwardDerivatives(g, values, derivatives, getRandomVariableGradients(1), {}, {}, getRandomVariableOps(1),
+                        getRandomVariableOpNodeRequirements());
+    BOOST_CHECK_CLOSE(derivatives[x][0], derivatives0[x][0], tol);
+    BOOST_CHECK_CLOSE(derivatives[y][0], derivatives0[y][0], tol);
+
+    // without outputs nothing is pruned
+    BOOST_CHECK_EQUAL(g0.optimise().pruned, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testGraphFragment) {
+    BOOST_TEST_MESSAGE("Testing computation graph fragment serialisation and relinking...");
+
+    ComputationGraph g;
+    auto s = buildModel(g);
+    std::size_t modelSize = g.size();
+
+    // the first block adds a model parameter p, the second one uses it and refers to a constant of the first block
+    std::size_t begin1 = g.size();
+    auto p = cg_var(g, "p", ComputationGraph::VarDoesntExist::Create);
+    auto t1 = cg_mult(g, cg_add(g, s, p), cg_const(g, 2.0));
+    ComputationGraphFragment f1(g, begin1, g.size(), {t1}, modelSize);
+    std::size_t begin2 = g.size();
+    auto t2 = cg_div(g, p, cg_add(g, s, cg_const(g, 2.0)));
+    ComputationGraphFragment f2(g, begin2, g.size(), {t2}, modelSize);
+    // the third block refers to an op node of the first block
+    std::size_t begin3 = g.size();
+    auto t3 = cg_exp(g, t1);
+    ComputationGraphFragment f3(g, begin3, g.size(), {t3}, modelSize);
+
+    BOOST_CHECK(f1.valid());
+    BOOST_CHECK(f2.valid());
+    BOOST_CHECK(!f3.valid());
+    BOOST_CHECK(!f3.canInsert(g));
+    BOOST_CHECK_THROW(f3.write(std::cout), QuantLib::Error);
+
+    std::stringstream stream;
+    f1.write(stream);
+    f2.write(stream);
+    ComputationGraphFragment r1, r2;
+    r1.read(stream);
+    r2.read(stream);
+    BOOST_CHECK_EQUAL(r1.size(), f1.size());
+    BOOST_CHECK_EQUAL(r2.size(), f2.size());
+
+    // relink into a new graph with the same model part
+    ComputationGraph h;
+    buildModel(h);
+    BOOST_CHECK_EQUAL(computationGraphHash(h, h.size()), computationGraphHash(g, modelSize));
+
+    // the model parameter p must be present before the fragments can be inserted
+    BOOST_CHECK(!r1.canInsert(h));
+    BOOST_CHECK(!r2.canInsert(h));
+    cg_var(h, "p", ComputationGraph::VarDoesntExist::Create);
+    BOOST_REQUIRE(r1.canInsert(h));
+    BOOST_REQUIRE(r2.canInsert(h));
+    auto o1 = r1.insert(h);
+    auto o2 = r2.insert(h);
+    BOOST_REQUIRE_EQUAL(o1.size(), 1);
+    BOOST_REQUIRE_EQUAL(o2.size(), 1);
+
+    // both graphs give the same results
+    for (auto const& [graph, outputs] : std::vector<std::pair<ComputationGraph*, std::vector<std::size_t>>>{
+             {&g, {t1, t2}}, {&h, {o1[0], o2[0]}}}) {
+        std::vector<RandomVariable> values(graph->size(), RandomVariable(1, 0.0));
+        for (auto const& [c, n] : graph->constants())
+            values[n] = RandomVariable(1, c);
+        values[graph->variable("x")] = RandomVariable(1, 0.1);
+        values[graph->variable("p")] = RandomVariable(1, 3.0);
+        forwardEvaluation(*graph, values, getRandomVariableOps(1));
+        BOOST_CHECK_CLOSE(values[outputs[0]][0], (std::exp(0.1) + 3.0) * 2.0, 1E-12);
+        BOOST_CHECK_CLOSE(values[outputs[1]][0], 3.0 / (std::exp(0.1) + 2.0), 1E-12);
+    }
+
+    // a changed model part changes the hash
+    cg_sqrt(h, h.variable("x"));
+    BOOST_CHECK(computationGraphHash(h, h.size()) != computationGraphHash(g, modelSize));
+}
+
+BOOST_AUTO_TEST_CASE(testGraphFragmentParametersAndNamedNodes) {
+    BOOST_TEST_MESSAGE("Testing computation graph fragment parameter creation and named nodes...");
+
+    ComputationGraph g;
+    auto s = buildModel(g);
+    std::size_t modelSize = g.size();
+
+    // the first block adds a parameter __p and a named node __n, which the second block uses, the local name is
+    // ignored since it does not carry the prefix
+    std::size_t begin1 = g.size();
+    auto p = cg_var(g, "__p", ComputationGraph::VarDoesntExist::Create);
+    auto n = cg_mult(g, s, p);
+    g.setVariable("__n", n);
+    g.setVariable("local_0", n);
+    auto t1 = cg_mult(g, n, cg_const(g, 2.0));
+    ComputationGraphFragment f1(g, begin1, g.size(), {t1}, modelSize, "__");
+    std::size_t begin2 = g.size();
+    auto t2 = cg_div(g, n, cg_add(g, s, p));
+    ComputationGraphFragment f2(g, begin2, g.size(), {t2}, modelSize, "__");
+    BOOST_REQUIRE(f1.valid());
+    BOOST_REQUIRE(f2.valid());
+
+    std::stringstream stream;
+    f1.write(stream);
+    f2.write(stream);
+    ComputationGraphFragment r1, r2;
+    r1.read(stream);
+    r2.read(stream);
+
+    ComputationGraph h;
+    buildModel(h);
+    auto isParameter = [](const std::string& id) { return id == "__p"; };
+    std::size_t created = 0;
+    auto createParameter = [&h, &created](const std::string& id) {
+        if (id != "__p")
+            return ComputationGraph::nan;
+        ++created;
+        return cg_var(h, id, ComputationGraph::VarDoesntExist::Create);
+    };
+
+    // the parameter is created on insertion, the second block links to it and to the named node of the first block
+    BOOST_CHECK(!r1.canInsert(h));
+    BOOST_REQUIRE(r1.canInsert(h, isParameter));
+    BOOST_CHECK(!r2.canInsert(h, isParameter));
+    auto o1 = r1.insert(h, createParameter);
+    BOOST_REQUIRE(r2.canInsert(h));
+    auto o2 = r2.insert(h, createParameter);
+    BOOST_CHECK_EQUAL(created, 1);
+    BOOST_CHECK_EQUAL(h.variable("__n"), n);
+    BOOST_CHECK(h.variables().find("local_0") == h.variables().end());
+
+    // the relinked graph is identical to the original one
+    BOOST_REQUIRE_EQUAL(h.size(), g.size());
+    BOOST_CHECK_EQUAL(o1.at(0), t1);
+    BOOST_CHECK_EQUAL(o2.at(0), t2);
+    BOOST_CHECK_EQUAL(h.variable("__p"), p);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -45,6 +45,7 @@
 #include <qle/models/irlgm1fpiecewiseconstantparametrization.hpp>
 #include <qle/models/irlgm1fpiecewiselinearparametrization.hpp>
 #include <qle/models/lgm.hpp>
+#include <qle/models/lgmconvolutionsolver2.hpp>
 #include <qle/models/lgmimplieddefaulttermstructure.hpp>
 #include <qle/models/lgmimpliedyieldtermstructure.hpp>
 #include <qle/models/linkablecalibratedmodel.hpp>
@@ -69,9 +70,13 @@
 #include <qle/pricingengines/oiccbasisswapengine.hpp>
 #include <qle/pricingengines/paymentdiscountingengine.hpp>
 
+#include <ql/cashflows/coupon.hpp>
 #include <ql/currencies/europe.hpp>
+#include <ql/exercise.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
 #include <ql/indexes/swap/euriborswap.hpp>
 #include <ql/instruments/makeswaption.hpp>
+#include <ql/instruments/makevanillaswap.hpp>
 #include <ql/math/array.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/models/shortrate/onefactormodels/gsr.hpp>
@@ -568,6 +573,83 @@ BOOST_AUTO_TEST_CASE(testLgmInvariances) {
     }
 } // testInvariances
 
+BOOST_AUTO_TEST_CASE(testBatchedRollback) {
+
+    BOOST_TEST_MESSAGE("Testing batched rollback in the LGM convolution solver...");
+
+    Handle<YieldTermStructure> flatCurve(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    auto lgm = QuantLib::ext::make_shared<LinearGaussMarkovModel>(
+        QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), flatCurve, 0.01, 0.01));
+    LgmConvolutionSolver2 solver(lgm, 5.0, 10, 5.0, 10);
+
+    Real t1 = 5.0, t0 = 2.0;
+    RandomVariable x = solver.stateGrid(t1);
+    std::vector<RandomVariable> v = {exp(RandomVariable(solver.gridSize(), 0.5) * x),
+                                     RandomVariable(solver.gridSize(), 1.0), max(x, RandomVariable(x.size(), 0.0))};
+
+    for (Real t : {t0, 0.0}) {
+        std::vector<RandomVariable> batched = solver.rollback(v, t1, t);
+        BOOST_REQUIRE_EQUAL(batched.size(), v.size());
+        for (Size i = 0; i < v.size(); ++i) {
+            RandomVariable single = solver.rollback(v[i], t1, t);
+            BOOST_CHECK_EQUAL(batched[i].deterministic(), single.deterministic());
+            BOOST_REQUIRE_EQUAL(batched[i].size(), single.size());
+            for (Size k = 0; k < single.size(); ++k)
+                BOOST_CHECK_EQUAL(batched[i][k], single[k]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBatchPricer) {
+
+    BOOST_TEST_MESSAGE("Testing batch pricing of Bermudan swaptions against the single option engine...");
+
+    Handle<YieldTermStructure> flatCurve(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    auto lgm = QuantLib::ext::make_shared<LinearGaussMarkovModel>(
+        QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), flatCurve, 0.01, 0.01));
+    auto index = QuantLib::ext::make_shared<Euribor>(6 * Months, flatCurve);
+
+    // bermudans with different forward starts, tenors and strikes, plus a swap without exercise
+    std::vector<QuantLib::ext::shared_ptr<MultiLegOption>> options;
+    std::vector<std::tuple<Period, Period, Real>> specs = {
+        {1 * Years, 5 * Years, 0.02}, {2 * Years, 10 * Years, 0.025}, {18 * Months, 7 * Years, 0.015}};
+    for (auto const& [start, tenor, strike] : specs) {
+        QuantLib::ext::shared_ptr<VanillaSwap> swap = MakeVanillaSwap(tenor, index, strike, start);
+        std::vector<Date> exerciseDates;
+        for (auto const& c : swap->fixedLeg())
+            exerciseDates.push_back(QuantLib::ext::dynamic_pointer_cast<Coupon>(c)->accrualStartDate());
+        options.push_back(QuantLib::ext::make_shared<MultiLegOption>(
+            std::vector<Leg>{swap->fixedLeg(), swap->floatingLeg()}, std::vector<bool>{true, false},
+            std::vector<Currency>{EURCurrency(), EURCurrency()},
+            QuantLib::ext::make_shared<BermudanExercise>(exerciseDates)));
+    }
+    QuantLib::ext::shared_ptr<VanillaSwap> swap = MakeVanillaSwap(5 * Years, index, 0.02, 1 * Years);
+    options.push_back(QuantLib::ext::make_shared<MultiLegOption>(
+        std::vector<Leg>{swap->fixedLeg(), swap->floatingLeg()}, std::vector<bool>{true, false},
+        std::vector<Currency>{EURCurrency(), EURCurrency()}));
+
+    NumericLgmMultiLegOptionBatchPricer pricer(lgm, 7.0, 16, 7.0, 16, flatCurve);
+    auto engine = QuantLib::ext::make_shared<NumericLgmMultiLegOptionEngine>(lgm, 7.0, 16, 7.0, 16, flatCurve);
+
+    std::vector<NumericLgmMultiLegOptionBatchPricer::Result> batch = pricer.price(options);
+    BOOST_REQUIRE_EQUAL(batch.size(), options.size());
+
+    // the options are also rolled back over the grid times of the other options, this adds discretisation error
+    Real tol = 5.0E-5;
+    for (Size i = 0; i < options.size(); ++i) {
+        options[i]->setPricingEngine(engine);
+        BOOST_TEST_MESSAGE("option #" << i << ": single " << options[i]->NPV() << " batch " << batch[i].npv);
+        BOOST_CHECK_SMALL(batch[i].npv - options[i]->NPV(), tol);
+        BOOST_CHECK_SMALL(batch[i].underlyingNpv - options[i]->underlyingNpv(), tol);
+        // a batch of one option uses the option's own time grid and reproduces the single engine
+        auto single = pricer.price({options[i]});
+        BOOST_CHECK_EQUAL(single.front().npv, options[i]->NPV());
+        BOOST_CHECK_EQUAL(single.front().underlyingNpv, options[i]->underlyingNpv());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -120,6 +120,8 @@
 #include <boost/accumulators/statistics/variates/covariate.hpp>
 #include <boost/make_shared.hpp>
 
+#include <thread>
+
 using namespace QuantLib;
 using namespace QuantExt;
 
@@ -1474,6 +1476,68 @@ BOOST_AUTO_TEST_CASE(testLgmMcWithShift) {
 
 } // testLgmMcWithShift
 
+BOOST_AUTO_TEST_CASE(testSharedStateProcessCache) {
+    BOOST_TEST_MESSAGE("Testing shared state process cache in CrossAssetStateProcess...");
+
+    Handle<YieldTermStructure> eurYts(QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    Handle<YieldTermStructure> usdYts(QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.05, Actual365Fixed()));
+    Handle<Quote> usdEurSpotToday(QuantLib::ext::make_shared<SimpleQuote>(0.90));
+
+    std::vector<QuantLib::ext::shared_ptr<Parametrization> > singleModels;
+    singleModels.push_back(QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), eurYts, 0.01, 0.01));
+    singleModels.push_back(QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(USDCurrency(), usdYts, 0.012, 0.02));
+    singleModels.push_back(QuantLib::ext::make_shared<FxBsConstantParametrization>(USDCurrency(), usdEurSpotToday, 0.15));
+
+    Matrix c(3, 3);
+    // clang-format off
+    c[0][0] =  1.0; c[0][1] = -0.2; c[0][2] =  0.8;
+    c[1][0] = -0.2; c[1][1] =  1.0; c[1][2] = -0.5;
+    c[2][0] =  0.8; c[2][1] = -0.5; c[2][2] =  1.0;
+    // clang-format on
+
+    TimeGrid grid(5.0, 10);
+    Size seed = 42, paths = 100;
+
+    for (auto discretization : {CrossAssetModel::Discretization::Euler, CrossAssetModel::Discretization::Exact}) {
+        auto model = QuantLib::ext::make_shared<CrossAssetModel>(singleModels, c, SalvagingAlgorithm::None,
+                                                                 IrModel::Measure::LGM, discretization);
+
+        // reference: the process owned by the model with the step counter based cache
+        auto process = model->stateProcess();
+        process->resetCache(grid.size() - 1);
+
+        // two further processes sharing one precomputed cache
+        auto process1 = QuantLib::ext::make_shared<CrossAssetStateProcess>(model);
+        auto process2 = QuantLib::ext::make_shared<CrossAssetStateProcess>(model);
+        auto cache = process1->warmUpCache(grid);
+        BOOST_REQUIRE_EQUAL(cache->t0.size(), grid.size() - 1);
+        process1->setCache(cache);
+        process2->setCache(cache);
+        BOOST_CHECK(process2->cache() == cache);
+
+        MultiPathGeneratorMersenneTwister pg(process, grid, seed, false);
+        MultiPathGeneratorMersenneTwister pg1(process1, grid, seed, false);
+        MultiPathGeneratorMersenneTwister pg2(process2, grid, seed, false);
+
+        for (Size i = 0; i < paths; ++i) {
+            Sample<MultiPath> path = pg.next();
+            Sample<MultiPath> path1 = pg1.next();
+            Sample<MultiPath> path2 = pg2.next();
+            for (Size k = 0; k < path.value.assetNumber(); ++k) {
+                for (Size j = 0; j < path.value[k].length(); ++j) {
+                    BOOST_CHECK_CLOSE(path1.value[k][j], path.value[k][j], 1.0E-10);
+                    BOOST_CHECK_CLOSE(path2.value[k][j], path.value[k][j], 1.0E-10);
+                }
+            }
+        }
+
+        // resetting the cache removes the shared cache
+        process1->resetCache(0);
+        BOOST_CHECK(!process1->cache());
+    }
+
+} // testSharedStateProcessCache
+
 BOOST_AUTO_TEST_CASE(testIrFxCrCirppMartingaleProperty) {
 
     BOOST_TEST_MESSAGE("Testing martingale property in ir-fx-cr(lgm)-cf(cir++) model for "
@@ -3150,6 +3214,108 @@ BOOST_AUTO_TEST_CASE(testIrFxInfCrEqMartingaleProperty) {
 
 } // testIrFxInfCrEqMartingaleProperty
 
+BOOST_AUTO_TEST_CASE(testIrFxInfCrEqSharedIntegralCache) {
+
+    BOOST_TEST_MESSAGE("Testing shared integral cache in ir-fx-inf-cr-eq model with several threads...");
+
+    TimeGrid grid(5.0, 20);
+    Size seed = 42, paths = 200, nThreads = 4;
+    std::vector<Time> times(grid.begin(), grid.end());
+
+    // INF DK and CR LGM integrals on all pairs of grid times along the paths of the given process
+    auto evaluate = [&grid, seed, paths](const QuantLib::ext::shared_ptr<CrossAssetModel>& model,
+                                         const QuantLib::ext::shared_ptr<StochasticProcess>& process) {
+        std::vector<Real> result;
+        MultiPathGeneratorMersenneTwister pg(process, grid, seed, false);
+        for (Size p = 0; p < paths; ++p) {
+            Sample<MultiPath> path = pg.next();
+            for (Size j = 0; j < grid.size(); ++j) {
+                for (Size k = j; k < grid.size(); ++k) {
+                    for (Size i = 0; i < 2; ++i) {
+                        Real z = path.value[model->pIdx(CrossAssetModel::AssetType::INF, i, 0)][j];
+                        Real y = path.value[model->pIdx(CrossAssetModel::AssetType::INF, i, 1)][j];
+                        std::pair<Real, Real> s = model->infdkI(i, grid[j], grid[k], z, y);
+                        result.push_back(s.first);
+                        result.push_back(s.second);
+                    }
+                    Real z = path.value[model->pIdx(CrossAssetModel::AssetType::CR, 0, 0)][j];
+                    Real y = path.value[model->pIdx(CrossAssetModel::AssetType::CR, 0, 1)][j];
+                    std::pair<Real, Real> s = model->crlgm1fS(0, 0, grid[j], grid[k], z, y);
+                    result.push_back(s.first);
+                    result.push_back(s.second);
+                }
+            }
+        }
+        return result;
+    };
+
+    for (Size m = 0; m < 2; ++m) {
+        // serial reference with the lazily filled caches
+        IrFxInfCrEqModelTestData d;
+        auto model = m == 0 ? d.modelExact : d.modelEuler;
+        BOOST_CHECK(!model->integralCache());
+        auto serialProcess = QuantLib::ext::make_shared<CrossAssetStateProcess>(model);
+        serialProcess->resetCache(grid.size() - 1);
+        std::vector<Real> serial = evaluate(model, serialProcess);
+
+        // build the integral table on the grid, it covers all pairs t <= T of grid times for the two INF DK and the
+        // CR LGM component
+        auto table = model->warmUpCaches(times);
+        BOOST_REQUIRE(table);
+        BOOST_CHECK(model->integralCache() == table);
+        Size pairs = grid.size() * (grid.size() + 1) / 2;
+        BOOST_CHECK_EQUAL(table->infdkV.size(), 2 * pairs);
+        BOOST_CHECK_EQUAL(table->crlgm1fV.size(), pairs);
+
+        // several threads share the model, its integral table and one state process cache
+        auto processCache = serialProcess->warmUpCache(grid);
+        std::vector<std::vector<Real>> threaded(nThreads);
+        std::vector<std::exception_ptr> errors(nThreads);
+        std::vector<std::thread> threads;
+        for (Size t = 0; t < nThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                try {
+                    auto process = QuantLib::ext::make_shared<CrossAssetStateProcess>(model);
+                    process->setCache(processCache);
+                    threaded[t] = evaluate(model, process);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        for (auto const& e : errors)
+            if (e)
+                std::rethrow_exception(e);
+
+        for (Size t = 0; t < nThreads; ++t) {
+            BOOST_REQUIRE_EQUAL(threaded[t].size(), serial.size());
+            for (Size i = 0; i < serial.size(); ++i)
+                BOOST_CHECK_CLOSE(threaded[t][i], serial[i], 1.0E-10);
+        }
+
+        // the lookups go to the installed table
+        auto poisoned = QuantLib::ext::make_shared<CrossAssetModel::IntegralCache>(*table);
+        CrossAssetModel::cache_key kInf{0, model->ccyIndex(model->infdk(0)->currency()), grid[1], grid[3]};
+        CrossAssetModel::cache_key kCr{0, model->ccyIndex(model->crlgm1f(0)->currency()), grid[1], grid[3]};
+        BOOST_REQUIRE(poisoned->infdkV.find(kInf) != poisoned->infdkV.end());
+        BOOST_REQUIRE(poisoned->crlgm1fV.find(kCr) != poisoned->crlgm1fV.end());
+        poisoned->infdkV[kInf] = std::make_pair(-1.0, -2.0);
+        poisoned->crlgm1fV[kCr] = std::make_pair(-3.0, -4.0);
+        model->setIntegralCache(poisoned);
+        BOOST_CHECK_EQUAL(model->infdkV(0, grid[1], grid[3]).second, -2.0);
+        BOOST_CHECK_EQUAL(model->crlgm1fV(0, 0, grid[1], grid[3]).second, -4.0);
+
+        // update() removes the table
+        model->update();
+        BOOST_CHECK(!model->integralCache());
+        BOOST_CHECK(model->infdkV(0, grid[1], grid[3]).second != -2.0);
+        BOOST_CHECK(model->crlgm1fV(0, 0, grid[1], grid[3]).second != -4.0);
+    }
+
+} // testIrFxInfCrEqSharedIntegralCache
+
 BOOST_AUTO_TEST_CASE(testIrFxInfCrEqMoments) {
 
     BOOST_TEST_MESSAGE("Testing analytic moments vs. Euler and exact discretization "
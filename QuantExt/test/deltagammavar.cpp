@@ -317,6 +317,49 @@ BOOST_AUTO_TEST_CASE(testCase003) {
     BOOST_CHECK_CLOSE(sdvar, mcvar, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(testDeltaGammaVarMcMultiThreaded) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded delta gamma var Monte Carlo simulation...");
+
+    // same setup as in testCase001
+
+    std::vector<double> d1{691.043, 8.62406, 9706.97, 0, 0};
+    std::vector<double> d2 = {-13.9605, 0, 0, 0, 0, 0, -0.174223, 0, 0, 0, 0, 0, -196.1,
+                              0,        0, 0, 0, 0, 0, 0,         0, 0, 0, 0, 0};
+    std::vector<double> d3 = {96.3436,   -0.828459, -6.59142,  0.583848, -0.0639266, -0.828459, 97.7309,
+                              12.4906,   -2.03511,  -0.504752, -6.59142, 12.4906,    95.12,     0.800706,
+                              0.443861,  0.583848,  -2.03511,  0.800706, 2.71239,    0.288881,  -0.0639266,
+                              -0.504752, 0.443861,  0.288881,  1.42701};
+    Array delta(d1.begin(), d1.end());
+    Matrix gamma(5, 5, d2.begin(), d2.end());
+    Matrix omega(5, 5, d3.begin(), d3.end());
+    Matrix nullGamma(5, 5, 0.0);
+
+    std::vector<Real> quantiles = {0.9, 0.99, 0.999};
+    Size paths = 1000000;
+
+    auto mc = deltaGammaVarMc<PseudoRandom>(omega, delta, gamma, quantiles, paths, 42);
+    auto mt1 = deltaGammaVarMcMt<PseudoRandom>(omega, delta, gamma, quantiles, paths, 42, 1);
+    auto mt4 = deltaGammaVarMcMt<PseudoRandom>(omega, delta, gamma, quantiles, paths, 42, 4);
+    auto mt4Delta = deltaGammaVarMcMt<PseudoRandom>(omega, delta, nullGamma, quantiles, paths, 42, 4);
+
+    for (Size i = 0; i < quantiles.size(); ++i) {
+        Real sd = deltaGammaVarSaddlepoint(omega, delta, gamma, quantiles[i]);
+        Real dVar = deltaVar(omega, delta, quantiles[i]);
+        BOOST_TEST_MESSAGE("q=" << quantiles[i] << " mc=" << mc[i] << " mt1=" << mt1[i] << " mt4=" << mt4[i]
+                                << " sd=" << sd << " mt4Delta=" << mt4Delta[i] << " dVar=" << dVar);
+        // the result must not depend on the number of threads
+        BOOST_CHECK_EQUAL(mt1[i], mt4[i]);
+        BOOST_CHECK_CLOSE(mt4[i], mc[i], 1.0);
+        BOOST_CHECK_CLOSE(mt4[i], sd, 1.0);
+        BOOST_CHECK_CLOSE(mt4Delta[i], dVar, 1.0);
+    }
+
+    // a block size that does not divide the number of paths
+    Real mtOdd = deltaGammaVarMcMt<PseudoRandom>(omega, delta, gamma, 0.99, 100003, 42, 3, NoCovarianceSalvage(), 999);
+    BOOST_CHECK_CLOSE(mtOdd, deltaGammaVarSaddlepoint(omega, delta, gamma, 0.99), 2.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
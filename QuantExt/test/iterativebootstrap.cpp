@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/math/interpolations/cubicinterpolation.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+#include <qle/termstructures/iterativebootstrap.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+void setupHelpers(std::vector<QuantLib::ext::shared_ptr<SimpleQuote>>& quotes,
+                  std::vector<QuantLib::ext::shared_ptr<RateHelper>>& helpers,
+                  const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) {
+    auto index = QuantLib::ext::make_shared<Euribor6M>();
+    quotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(0.035));
+    helpers.push_back(QuantLib::ext::make_shared<DepositRateHelper>(Handle<Quote>(quotes.back()), index));
+    std::vector<Real> swapRates = {0.033, 0.031, 0.030, 0.0295, 0.0298, 0.0305, 0.031};
+    std::vector<Integer> swapTenors = {2, 3, 5, 7, 10, 15, 20};
+    for (Size i = 0; i < swapRates.size(); ++i) {
+        quotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(swapRates[i]));
+        helpers.push_back(QuantLib::ext::make_shared<SwapRateHelper>(
+            Handle<Quote>(quotes.back()), swapTenors[i] * Years, TARGET(), Annual, ModifiedFollowing,
+            Thirty360(Thirty360::BondBasis), index, Handle<Quote>(), 0 * Days, discountCurve));
+    }
+}
+
+template <class Interpolator> void testGlobalSolver(const Interpolator& interpolator) {
+
+    Date asof(15, March, 2024);
+    Settings::instance().evaluationDate() = asof;
+
+    // each curve has its own helpers, since the helpers are linked to the curve that is bootstrapped last
+    std::vector<QuantLib::ext::shared_ptr<SimpleQuote>> quotes, globalQuotes;
+    std::vector<QuantLib::ext::shared_ptr<RateHelper>> helpers, globalHelpers;
+    setupHelpers(quotes, helpers);
+    setupHelpers(globalQuotes, globalHelpers);
+
+    typedef PiecewiseYieldCurve<Discount, Interpolator, QuantExt::IterativeBootstrap> Curve;
+    Real accuracy = 1.0E-12;
+    Curve iterative(asof, helpers, Actual365Fixed(), interpolator,
+                    typename Curve::bootstrap_type(accuracy, Null<Real>(), false, 1, 2.0, 2.0, 10, false));
+    Curve global(asof, globalHelpers, Actual365Fixed(), interpolator,
+                 typename Curve::bootstrap_type(accuracy, Null<Real>(), false, 1, 2.0, 2.0, 10, true));
+    const auto& globalBootstrap = Curve::bootstrap_type::bootstrap(global);
+
+    auto check = [&]() {
+        for (Size i = 0; i < helpers.size(); ++i) {
+            Date d = helpers[i]->pillarDate();
+            BOOST_CHECK_SMALL(global.discount(d) - iterative.discount(d), 1.0E-9);
+        }
+        // the helpers are repriced on the global curve
+        for (auto const& h : globalHelpers)
+            BOOST_CHECK_SMALL(h->quoteError(), 1.0E-10);
+    };
+
+    // the first calculation is a usual bootstrap, subsequent ones use the Newton solver
+    for (Size k = 0; k < quotes.size() + 1; ++k) {
+        if (k > 0) {
+            quotes[k - 1]->setValue(quotes[k - 1]->value() + 0.0001);
+            globalQuotes[k - 1]->setValue(globalQuotes[k - 1]->value() + 0.0001);
+        }
+        check();
+        BOOST_CHECK_EQUAL(globalBootstrap.globalSolves(), k);
+        BOOST_CHECK_EQUAL(globalBootstrap.globalSolveFailure(), "");
+    }
+
+    // a large shift where the previous curve is a poor initial guess, the result is the same whichever path is taken
+    for (Size k = 0; k < quotes.size(); ++k) {
+        quotes[k]->setValue(quotes[k]->value() + 0.02);
+        globalQuotes[k]->setValue(globalQuotes[k]->value() + 0.02);
+    }
+    check();
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(IterativeBootstrapTest)
+
+BOOST_AUTO_TEST_CASE(testGlobalSolverLocalInterpolation) {
+    BOOST_TEST_MESSAGE("Testing global solver in iterative bootstrap with log-linear interpolation...");
+    testGlobalSolver(LogLinear());
+}
+
+BOOST_AUTO_TEST_CASE(testGlobalSolverGlobalInterpolation) {
+    BOOST_TEST_MESSAGE("Testing global solver in iterative bootstrap with cubic interpolation...");
+    testGlobalSolver(Cubic(CubicInterpolation::Kruger, true));
+}
+
+BOOST_AUTO_TEST_CASE(testIncremental) {
+
+    BOOST_TEST_MESSAGE("Testing incremental iterative bootstrap...");
+
+    Date asof(15, March, 2024);
+    Settings::instance().evaluationDate() = asof;
+
+    // the helpers use an exogenous discount curve, so that we can check that changes in it are detected
+    auto discountRate = QuantLib::ext::make_shared<SimpleQuote>(0.03);
+    Handle<YieldTermStructure> discountCurve(
+        QuantLib::ext::make_shared<FlatForward>(asof, Handle<Quote>(discountRate), Actual365Fixed()));
+    std::vector<QuantLib::ext::shared_ptr<SimpleQuote>> quotes;
+    std::vector<QuantLib::ext::shared_ptr<RateHelper>> helpers;
+    setupHelpers(quotes, helpers, discountCurve);
+
+    typedef PiecewiseYieldCurve<Discount, LogLinear, QuantExt::IterativeBootstrap> Curve;
+    Real accuracy = 1.0E-12;
+    Curve full(asof, helpers, Actual365Fixed(), LogLinear(),
+               Curve::bootstrap_type(accuracy, Null<Real>(), false, 1, 2.0, 2.0, 10, false, false));
+    Curve incremental(asof, helpers, Actual365Fixed(), LogLinear(),
+                      Curve::bootstrap_type(accuracy, Null<Real>(), false, 1, 2.0, 2.0, 10, false, true));
+
+    auto check = [&full, &incremental, &helpers]() {
+        for (auto const& h : helpers) {
+            BOOST_CHECK_SMALL(incremental.discount(h->pillarDate()) - full.discount(h->pillarDate()), 1.0E-10);
+        }
+    };
+
+    check();
+
+    // shifting the last quote keeps the curve values at all earlier pillars
+    std::vector<Real> data = incremental.data();
+    quotes.back()->setValue(quotes.back()->value() + 0.0010);
+    check();
+    std::vector<Real> shiftedData = incremental.data();
+    for (Size i = 0; i + 1 < data.size(); ++i)
+        BOOST_CHECK_EQUAL(data[i], shiftedData[i]);
+    BOOST_CHECK(data.back() != shiftedData.back());
+
+    // shift quotes in the middle of the curve
+    for (Size k : {3, 1, 5}) {
+        quotes[k]->setValue(quotes[k]->value() - 0.0005);
+        check();
+    }
+
+    // a change in the discount curve affects all helpers
+    discountRate->setValue(0.025);
+    check();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,209 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/models/basket.hpp>
+#include <qle/models/gaussianlhplossmodel.hpp>
+#include <qle/models/poollossmodel.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/experimental/credit/defaultevent.hpp>
+#include <ql/experimental/credit/defaultprobabilitykey.hpp>
+#include <ql/experimental/credit/issuer.hpp>
+#include <ql/experimental/credit/pool.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// if a default date is given, the first name has defaulted at that date and the default has settled one month
+// later, the baskets then start one year before today
+struct TestData {
+    explicit TestData(const Date& defaultDate = Date()) : today(15, March, 2024), inception(today) {
+        Settings::instance().evaluationDate() = today;
+        if (defaultDate != Date())
+            inception = today - 1 * Years;
+        pool = QuantLib::ext::make_shared<Pool>();
+        DefaultProbKey key = NorthAmericaCorpDefaultKey(EURCurrency(), SeniorSec, Period(), 1.0);
+        for (Size i = 0; i < 10; ++i) {
+            names.push_back("NAME_" + std::to_string(i));
+            notionals.push_back(1.0E6 * (1.0 + 0.1 * i));
+            recoveries.push_back(0.3 + 0.02 * i);
+            Handle<DefaultProbabilityTermStructure> curve(
+                QuantLib::ext::make_shared<FlatHazardRate>(today, 0.01 + 0.005 * i, Actual365Fixed()));
+            vector<std::pair<DefaultProbKey, Handle<DefaultProbabilityTermStructure>>> probabilities(1, {key, curve});
+            DefaultEventSet events;
+            if (i == 0 && defaultDate != Date())
+                events.insert(QuantLib::ext::make_shared<DefaultEvent>(
+                    defaultDate, DefaultType(AtomicDefault::Bankruptcy, Restructuring::NoRestructuring), EURCurrency(),
+                    SeniorSec, defaultDate + 1 * Months, recoveries.back()));
+            pool->add(names.back(), Issuer(probabilities, events), key);
+        }
+        for (Size i = 1; i <= 20; ++i)
+            dates.push_back(today + 3 * i * Months);
+    }
+
+    QuantLib::ext::shared_ptr<Basket> basket(Real attach, Real detach) const {
+        return QuantLib::ext::make_shared<Basket>(inception, names, notionals, pool, attach, detach);
+    }
+
+    QuantLib::ext::shared_ptr<DefaultLossModel> poolLossModel(Size nThreads) const {
+        auto copula = QuantLib::ext::make_shared<ExtendedGaussianConstantLossLM>(
+            Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.3)), recoveries, vector<vector<Real>>(),
+            vector<vector<Real>>(), LatentModelIntegrationType::GaussianQuadrature, names.size(),
+            GaussianCopulaPolicy::initTraits());
+        return QuantLib::ext::make_shared<GaussPoolLossModel>(false, copula, 100, 5.0, -5.0, 50, false, false,
+                                                              nThreads);
+    }
+
+    Date today, inception;
+    vector<string> names;
+    vector<Real> notionals, recoveries;
+    QuantLib::ext::shared_ptr<Pool> pool;
+    vector<Date> dates;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(PoolLossModelTest)
+
+BOOST_AUTO_TEST_CASE(testBatchedExpectedTrancheLoss) {
+
+    BOOST_TEST_MESSAGE("Testing batched expected tranche loss of the pool loss model...");
+
+    TestData data;
+    auto b = data.basket(0.03, 0.07);
+    b->setLossModel(data.poolLossModel(1));
+    vector<Real> scalar;
+    for (auto const& d : data.dates)
+        scalar.push_back(b->expectedTrancheLoss(d));
+
+    for (Size nThreads : {1, 4}) {
+        b->setLossModel(data.poolLossModel(nThreads));
+        vector<Real> batched = b->expectedTrancheLoss(data.dates);
+        BOOST_REQUIRE_EQUAL(batched.size(), scalar.size());
+        for (Size j = 0; j < scalar.size(); ++j) {
+            // the same distribution is computed on each date, independent of the threads
+            BOOST_CHECK_EQUAL(batched[j], scalar[j]);
+        }
+        BOOST_CHECK(batched.back() > 0.0);
+    }
+
+    // the recovery rate is passed through, full recovery means no losses
+    vector<Real> zeroLgd = b->expectedTrancheLoss(data.dates, 1.0);
+    for (auto const& l : zeroLgd)
+        BOOST_CHECK_SMALL(l, 1.0E-8);
+}
+
+BOOST_AUTO_TEST_CASE(testBatchedExpectedTrancheLosses) {
+
+    BOOST_TEST_MESSAGE("Testing expected tranche losses of several tranches in one pass of the pool loss model...");
+
+    TestData data;
+    vector<std::pair<Real, Real>> tranches = {{0.0, 0.03}, {0.03, 0.07}, {0.0, 0.07}};
+    auto b = data.basket(0.0, 0.07);
+    b->setLossModel(data.poolLossModel(3));
+    vector<vector<Real>> losses = b->expectedTrancheLosses(data.dates, tranches);
+    BOOST_REQUIRE_EQUAL(losses.size(), tranches.size());
+
+    // the tranche with the maximum detachment shares the distribution of a basket tranche [0, 7%]
+    vector<Real> basketLosses = b->expectedTrancheLoss(data.dates);
+    for (Size j = 0; j < data.dates.size(); ++j) {
+        BOOST_REQUIRE_EQUAL(losses[2].size(), data.dates.size());
+        BOOST_CHECK_EQUAL(losses[2][j], basketLosses[j]);
+        // the tranche losses are additive up to the discretisation of the loss distribution
+        BOOST_CHECK_CLOSE(losses[0][j] + losses[1][j], losses[2][j], 0.5);
+        BOOST_CHECK(losses[0][j] <= 0.03 * 1.45E7 + 1.0E-6);
+        if (j > 0)
+            BOOST_CHECK(losses[1][j] >= losses[1][j - 1]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testGaussianLHPBatchedExpectedTrancheLosses) {
+
+    BOOST_TEST_MESSAGE("Testing batched expected tranche losses of the Gaussian LHP loss model...");
+
+    TestData data;
+    vector<std::pair<Real, Real>> tranches = {{0.0, 0.03}, {0.03, 0.07}, {0.07, 0.15}};
+    auto lhp = QuantLib::ext::make_shared<GaussianLHPLossModel>(0.3, data.recoveries);
+    auto b = data.basket(0.0, 1.0);
+    b->setLossModel(lhp);
+    vector<vector<Real>> losses = b->expectedTrancheLosses(data.dates, tranches);
+    BOOST_REQUIRE_EQUAL(losses.size(), tranches.size());
+
+    for (Size i = 0; i < tranches.size(); ++i) {
+        auto t = data.basket(tranches[i].first, tranches[i].second);
+        t->setLossModel(QuantLib::ext::make_shared<GaussianLHPLossModel>(0.3, data.recoveries));
+        vector<Real> batched = t->expectedTrancheLoss(data.dates);
+        for (Size j = 0; j < data.dates.size(); ++j) {
+            Real scalar = t->expectedTrancheLoss(data.dates[j]);
+            BOOST_CHECK_CLOSE(batched[j], scalar, 1.0E-10);
+            BOOST_CHECK_CLOSE(losses[i][j], scalar, 1.0E-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBatchedExpectedTrancheLossesWithDefaultedName) {
+
+    BOOST_TEST_MESSAGE("Testing batched expected tranche losses with a defaulted name in the basket...");
+
+    TestData data(Date(15, December, 2023));
+    vector<std::pair<Real, Real>> tranches = {{0.0, 0.03}, {0.03, 0.07}, {0.07, 0.15}};
+    auto b = data.basket(0.0, 1.0);
+    b->setLossModel(QuantLib::ext::make_shared<GaussianLHPLossModel>(0.3, data.recoveries));
+
+    // the first name has defaulted with a loss of 1m * (1 - 30%), which wipes out the first tranche (3% of 14.5m)
+    Real loss = 7.0E5;
+    BOOST_CHECK_CLOSE(b->settledLoss(), loss, 1.0E-10);
+    BOOST_CHECK_EQUAL(b->remainingSize(), data.names.size() - 1);
+
+    vector<vector<Real>> losses = b->expectedTrancheLosses(data.dates, tranches);
+    BOOST_REQUIRE_EQUAL(losses.size(), tranches.size());
+
+    for (Size i = 0; i < tranches.size(); ++i) {
+        auto t = data.basket(tranches[i].first, tranches[i].second);
+        t->setLossModel(QuantLib::ext::make_shared<GaussianLHPLossModel>(0.3, data.recoveries));
+        Real attach = tranches[i].first * 1.45E7, detach = tranches[i].second * 1.45E7;
+        BOOST_CHECK_CLOSE(t->remainingAttachmentAmount(), std::min(detach, std::max(attach, loss)), 1.0E-10);
+        BOOST_REQUIRE_EQUAL(losses[i].size(), data.dates.size());
+        for (Size j = 0; j < data.dates.size(); ++j) {
+            Real scalar = t->expectedTrancheLoss(data.dates[j]);
+            BOOST_CHECK_CLOSE(losses[i][j], scalar, 1.0E-10);
+            BOOST_CHECK(losses[i][j] >= loss);
+        }
+    }
+
+    // nothing is left of the first tranche, only the realised loss remains
+    for (auto const& l : losses[0])
+        BOOST_CHECK_CLOSE(l, loss, 1.0E-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,173 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/utilities/profiler.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <sstream>
+#include <thread>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+using namespace boost::unit_test_framework;
+
+namespace {
+void nestedZones(Size n) {
+    QLE_PROFILE_ZONE("outer");
+    for (Size i = 0; i < n; ++i) {
+        QLE_PROFILE_ZONE_CAT(std::string("inner"), "test");
+    }
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ProfilerTest)
+
+BOOST_AUTO_TEST_CASE(testDisabled) {
+
+    BOOST_TEST_MESSAGE("Testing that a disabled profiler does not record zones...");
+
+    Profiler::instance().disable();
+    Profiler::instance().clear();
+    nestedZones(3);
+    BOOST_CHECK(Profiler::instance().events().empty());
+    BOOST_CHECK(Profiler::instance().summary().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testNestedZones) {
+
+    BOOST_TEST_MESSAGE("Testing nested zones and summary...");
+
+    Profiler::instance().enable();
+    {
+        QLE_PROFILE_ZONE("root");
+        nestedZones(3);
+        std::thread t(nestedZones, 2);
+        t.join();
+    }
+    Profiler::instance().disable();
+
+    std::map<std::string, Profiler::Summary> summary = Profiler::instance().summary();
+    BOOST_REQUIRE_EQUAL(summary.size(), 5);
+    BOOST_CHECK_EQUAL(summary["root"].calls, 1);
+    BOOST_CHECK_EQUAL(summary["root/outer"].calls, 1);
+    BOOST_CHECK_EQUAL(summary["root/outer/inner"].calls, 3);
+    // the zones on the second thread are not nested into the root zone
+    BOOST_CHECK_EQUAL(summary["outer"].calls, 1);
+    BOOST_CHECK_EQUAL(summary["outer/inner"].calls, 2);
+
+    for (auto const& s : summary) {
+        BOOST_CHECK(s.second.self <= s.second.total);
+        BOOST_CHECK(s.second.max <= s.second.total);
+    }
+    BOOST_CHECK(summary["root"].total >= summary["root/outer"].total);
+    BOOST_CHECK_CLOSE(summary["root/outer"].self + summary["root/outer/inner"].total, summary["root/outer"].total,
+                      1.0E-8);
+
+    std::vector<Profiler::Event> events = Profiler::instance().events();
+    BOOST_REQUIRE_EQUAL(events.size(), 8);
+    BOOST_CHECK_EQUAL(events[0].name, "root");
+    BOOST_CHECK_EQUAL(events[0].depth, 0);
+    BOOST_CHECK_EQUAL(events[1].name, "outer");
+    BOOST_CHECK_EQUAL(events[1].depth, 1);
+    BOOST_CHECK_EQUAL(events[2].category, "test");
+    BOOST_CHECK_EQUAL(events[2].depth, 2);
+    BOOST_CHECK(events[0].thread != events[7].thread);
+
+    // recording is restarted on enable
+    Profiler::instance().enable();
+    Profiler::instance().disable();
+    BOOST_CHECK(Profiler::instance().events().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testChromeTrace) {
+
+    BOOST_TEST_MESSAGE("Testing chrome trace export...");
+
+    Profiler::instance().enable();
+    Profiler::instance().setMaxEventsPerThread(3);
+    nestedZones(4);
+    Profiler::instance().disable();
+    Profiler::instance().setMaxEventsPerThread(1000000);
+
+    BOOST_CHECK_EQUAL(Profiler::instance().events().size(), 3);
+    BOOST_CHECK_EQUAL(Profiler::instance().droppedEvents(), 2);
+    // dropped events still contribute to the summary
+    BOOST_CHECK_EQUAL(Profiler::instance().summary()["outer/inner"].calls, 4);
+
+    std::stringstream trace;
+    Profiler::instance().writeChromeTrace(trace);
+    boost::property_tree::ptree pt;
+    BOOST_REQUIRE_NO_THROW(boost::property_tree::read_json(trace, pt));
+    Size complete = 0;
+    for (auto const& e : pt.get_child("traceEvents")) {
+        if (e.second.get<std::string>("ph") == "X") {
+            ++complete;
+            BOOST_CHECK(e.second.get<double>("dur") >= 0.0);
+            BOOST_CHECK(e.second.get<double>("ts") >= 0.0);
+        }
+    }
+    BOOST_CHECK_EQUAL(complete, 3);
+}
+
+BOOST_AUTO_TEST_CASE(testThreadExit) {
+
+    BOOST_TEST_MESSAGE("Testing that zones of exited threads are kept and their buffers are reused...");
+
+    Profiler::instance().enable();
+    Profiler::instance().setMaxEventsPerThread(2);
+    for (Size i = 0; i < 10; ++i) {
+        std::thread t(nestedZones, 2);
+        t.join();
+    }
+    Profiler::instance().disable();
+    Profiler::instance().setMaxEventsPerThread(1000000);
+
+    // the zones recorded by the threads are kept after the threads exited
+    std::map<std::string, Profiler::Summary> summary = Profiler::instance().summary();
+    BOOST_CHECK_EQUAL(summary["outer"].calls, 10);
+    BOOST_CHECK_EQUAL(summary["outer/inner"].calls, 20);
+    BOOST_CHECK_EQUAL(Profiler::instance().droppedEvents(), 10);
+
+    // each thread reused the buffer released by its predecessor
+    std::vector<Profiler::Event> events = Profiler::instance().events();
+    BOOST_REQUIRE_EQUAL(events.size(), 20);
+    for (auto const& e : events) {
+        BOOST_CHECK_EQUAL(e.thread, events.front().thread);
+        BOOST_CHECK_EQUAL(e.name, "inner");
+    }
+    for (Size i = 1; i < events.size(); ++i)
+        BOOST_CHECK(events[i - 1].start <= events[i].start);
+
+    // the zones of exited threads are removed on clear
+    Profiler::instance().clear();
+    BOOST_CHECK(Profiler::instance().events().empty());
+    BOOST_CHECK(Profiler::instance().summary().empty());
+    BOOST_CHECK_EQUAL(Profiler::instance().droppedEvents(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -19,10 +19,15 @@
 #include "toplevelfixture.hpp"
 #include <boost/test/unit_test.hpp>
 #include <ql/time/calendar.hpp>
+#include <ql/time/calendars/bespokecalendar.hpp>
 #include <ql/time/calendars/austria.hpp>
 #include <ql/time/calendars/thailand.hpp>
 #include <ql/time/calendars/chile.hpp>
+#include <ql/time/calendars/jointcalendar.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/calendars/unitedkingdom.hpp>
 #include <qle/calendars/belgium.hpp>
+#include <qle/calendars/bitmapcalendar.hpp>
 #include <qle/calendars/cyprus.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/france.hpp>
@@ -537,6 +542,140 @@ BOOST_AUTO_TEST_CASE(testIrishBankHolidaysCalendar) {
     check::checkCalendars(expectedHolidays, hol);
 }
 
+BOOST_AUTO_TEST_CASE(testBitmapCalendar) {
+
+    BOOST_TEST_MESSAGE("Testing bitmap calendar against its base calendar...");
+
+    Calendar base = JointCalendar(TARGET(), UnitedKingdom());
+    Date start(3, January, 2000), end(29, December, 2030);
+    BitmapCalendar c(base, start, end);
+    BOOST_CHECK_EQUAL(c.name(), base.name());
+
+    // dates inside and around the cached range
+    for (Date d = start - 40; d <= end + 40; d += 3) {
+        BOOST_CHECK_EQUAL(c.isBusinessDay(d), base.isBusinessDay(d));
+        for (Integer n : {-300, -17, -1, 0, 1, 2, 5, 17, 300}) {
+            BOOST_CHECK_EQUAL(c.advance(d, n, Days), base.advance(d, n, Days));
+            BOOST_CHECK_EQUAL(c.advance(d, n * Days, ModifiedFollowing), base.advance(d, n * Days, ModifiedFollowing));
+        }
+        BOOST_CHECK_EQUAL(c.advance(d, 3, Months, ModifiedFollowing, true),
+                          base.advance(d, 3, Months, ModifiedFollowing, true));
+        for (Integer offset : {0, 1, 6, 64, 65, 1000}) {
+            for (bool includeFirst : {true, false}) {
+                for (bool includeLast : {true, false}) {
+                    BOOST_CHECK_EQUAL(c.businessDaysBetween(d, d + offset, includeFirst, includeLast),
+                                      base.businessDaysBetween(d, d + offset, includeFirst, includeLast));
+                    BOOST_CHECK_EQUAL(c.businessDaysBetween(d + offset, d, includeFirst, includeLast),
+                                      base.businessDaysBetween(d + offset, d, includeFirst, includeLast));
+                }
+            }
+        }
+    }
+
+    // holidays added to the bitmap calendar are taken into account
+    Date h(14, March, 2024);
+    BOOST_REQUIRE(c.isBusinessDay(h));
+    c.addHoliday(h);
+    BOOST_CHECK(!c.isBusinessDay(h));
+    BOOST_CHECK_EQUAL(c.advance(Date(13, March, 2024), 1, Days), Date(15, March, 2024));
+    BOOST_CHECK_EQUAL(c.businessDaysBetween(Date(11, March, 2024), Date(18, March, 2024)), 4);
+    c.removeHoliday(h);
+    BOOST_CHECK(c.isBusinessDay(h));
+
+    BOOST_CHECK_THROW(BitmapCalendar(base, end, start), QuantLib::Error);
+}
+
+namespace {
+
+// compares advance() and businessDaysBetween() of the bitmap calendar with the reference calendar for all dates around
+// the cached range, all conventions, end of month flags and in- and exclusion of the end points
+void checkBitmapCalendar(const BitmapCalendar& c, const Calendar& reference) {
+    std::vector<BusinessDayConvention> conventions = {Following,  ModifiedFollowing, Preceding,
+                                                      ModifiedPreceding, Unadjusted, HalfMonthModifiedFollowing,
+                                                      Nearest};
+    std::vector<Integer> ns = {-130, -70, -64, -63, -20, -5, -2, -1, 0, 1, 2, 5, 20, 63, 64, 70, 130};
+    Date from = c.startDate() - 10, to = c.endDate() + 10;
+    for (Date d = from; d <= to; ++d) {
+        BOOST_CHECK_EQUAL(c.isBusinessDay(d), reference.isBusinessDay(d));
+        for (auto unit : {Days, Weeks, Months, Years}) {
+            for (auto n : ns) {
+                for (auto convention : conventions) {
+                    for (bool endOfMonth : {false, true}) {
+                        BOOST_CHECK_EQUAL(c.advance(d, n, unit, convention, endOfMonth),
+                                          reference.advance(d, n, unit, convention, endOfMonth));
+                        BOOST_CHECK_EQUAL(c.advance(d, Period(n, unit), convention, endOfMonth),
+                                          reference.advance(d, Period(n, unit), convention, endOfMonth));
+                    }
+                }
+            }
+        }
+        for (Date e = from; e <= to; ++e) {
+            for (bool includeFirst : {true, false}) {
+                for (bool includeLast : {true, false}) {
+                    BOOST_CHECK_EQUAL(c.businessDaysBetween(d, e, includeFirst, includeLast),
+                                      reference.businessDaysBetween(d, e, includeFirst, includeLast));
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testBitmapCalendarEdges) {
+
+    BOOST_TEST_MESSAGE("Testing bitmap calendar at the edges of the cached range...");
+
+    Calendar base = JointCalendar(TARGET(), UnitedKingdom());
+
+    // the range starts on a holiday, covers exactly two blocks of 64 days resp. ends within the third block
+    Date start(25, December, 2023);
+    for (Date::serial_type days : {1, 64, 128, 131}) {
+        BitmapCalendar c(base, start, start + days - 1);
+        checkBitmapCalendar(c, base);
+    }
+
+    // the range starts and ends on business days
+    BitmapCalendar c(base, Date(2, January, 2024), Date(28, March, 2024));
+    BOOST_REQUIRE(c.isBusinessDay(c.startDate()) && c.isBusinessDay(c.endDate()));
+    checkBitmapCalendar(c, base);
+}
+
+BOOST_AUTO_TEST_CASE(testBitmapCalendarAdjustedHolidays) {
+
+    BOOST_TEST_MESSAGE("Testing bitmap calendar with added and removed holidays...");
+
+    // two bespoke calendars with identical holidays, one serves as the base of the bitmap calendar, the other one
+    // receives the same adjustments as the bitmap calendar
+    auto bespoke = [](const std::string& name) {
+        BespokeCalendar cal(name);
+        cal.addWeekend(Saturday);
+        cal.addWeekend(Sunday);
+        for (Date h : {Date(1, January, 2024), Date(29, March, 2024), Date(1, April, 2024), Date(1, May, 2024)})
+            cal.addHoliday(h);
+        return cal;
+    };
+    BespokeCalendar base = bespoke("BITMAP_BASE"), reference = bespoke("BITMAP_REFERENCE");
+    BitmapCalendar c(base, Date(1, January, 2024), Date(30, April, 2024));
+    checkBitmapCalendar(c, reference);
+
+    // added holidays inside and outside the range, a removed holiday inside the range and a removed weekend day
+    for (Date h : {Date(14, March, 2024), Date(15, March, 2024), Date(2, May, 2024)}) {
+        c.addHoliday(h);
+        reference.addHoliday(h);
+    }
+    for (Date h : {Date(29, March, 2024), Date(6, January, 2024)}) {
+        c.removeHoliday(h);
+        reference.removeHoliday(h);
+    }
+    BOOST_CHECK(!c.isBusinessDay(Date(15, March, 2024)));
+    BOOST_CHECK(c.isBusinessDay(Date(29, March, 2024)));
+    checkBitmapCalendar(c, reference);
+
+    // the adjustments do not affect the base calendar
+    BOOST_CHECK(base.isBusinessDay(Date(14, March, 2024)));
+    BOOST_CHECK(!base.isBusinessDay(Date(29, March, 2024)));
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 